@@ -16,6 +16,7 @@
 #include "tools/tool_common.h"
 #include "utils/console_logger.h"
 #include "utils/patch_registry.h"
+#include "utils/symbols.h"
 #include "utils/uuid_generator.h"
 #include "websocket_server.h"
 
@@ -44,6 +45,9 @@ static t_maxmcp* g_agent_instance = nullptr;
 void ext_main(void* r) {
     t_class* c;
 
+    // Intern hot attribute/method names before any tool can run
+    Symbols::init();
+
     c = class_new("maxmcp", (method)maxmcp_new, (method)maxmcp_free, (long)sizeof(t_maxmcp),
                   nullptr,  // No class flags
                   A_GIMME,  // Accept variable arguments
@@ -110,6 +114,7 @@ void ext_main(void* r) {
 
     CLASS_ATTR_SYM(c, "group", 0, t_maxmcp, group);
     CLASS_ATTR_LABEL(c, "group", 0, "Patch Group");
+    CLASS_ATTR_ACCESSORS(c, "group", nullptr, (method)maxmcp_group_set);
     CLASS_ATTR_BASIC(c, "group", 0);
     CLASS_ATTR_SAVE(c, "group", 0);
     CLASS_ATTR_CATEGORY(c, "group", 0, "Patch Mode");
@@ -160,6 +165,7 @@ void* maxmcp_new(t_symbol* s, long argc, t_atom* argv) {
         new (&x->patcher_name) std::string("");
         x->alias = gensym("");
         x->group = gensym("");
+        x->structure_edits = 0;
 
         // Process attributes from arguments (@mode, @alias, @group, etc.)
         attr_args_process(x, argc, argv);
@@ -195,15 +201,16 @@ void* maxmcp_new(t_symbol* s, long argc, t_atom* argv) {
 
             // Set synchronous message callback - called from LWS_CALLBACK_RECEIVE
             x->ws_server->set_sync_message_callback(
-                [x](const std::string& client_id, const std::string& message) -> std::string {
+                [x](const std::string& client_id, const std::string& message, bool binary,
+                    wire::Encoding& session_encoding) -> std::string {
                     try {
                         ConsoleLogger::log(("Sync callback: Processing message (" +
                                             std::to_string(message.length()) + " bytes)")
                                                .c_str());
 
                         // Route to MCP server (thread-safe)
-                        std::string response =
-                            MCPServer::get_instance()->handle_request_string(message);
+                        std::string response = MCPServer::get_instance()->handle_request_frame(
+                            message, binary, session_encoding);
 
                         ConsoleLogger::log(("Sync callback: Generated response (" +
                                             std::to_string(response.length()) + " bytes)")
@@ -222,7 +229,8 @@ void* maxmcp_new(t_symbol* s, long argc, t_atom* argv) {
                               {"message", std::string("Internal error: ") + e.what()}}},
                             {"id", nullptr}};
 
-                        return error_response.dump();
+                        return wire::encode(error_response,
+                                            binary ? session_encoding : wire::Encoding::Json);
                     }
                 });
 
@@ -505,3 +513,17 @@ t_max_err maxmcp_port_set(t_maxmcp* x, t_object* attr, long ac, t_atom* av) {
     }
     return MAX_ERR_NONE;
 }
+
+/**
+ * @brief Custom setter for group attribute
+ *
+ * Keeps the registry's group index in sync when @group changes after the
+ * patch has been registered (no-op during construction).
+ */
+t_max_err maxmcp_group_set(t_maxmcp* x, t_object* attr, long ac, t_atom* av) {
+    if (ac && av) {
+        x->group = atom_getsym(av);
+        PatchRegistry::update_group(x);
+    }
+    return MAX_ERR_NONE;
+}
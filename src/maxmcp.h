@@ -15,6 +15,7 @@
 #include "ext_obex.h"  // Required for new style Max object
 
 #include <atomic>
+#include <cstdint>
 #include <string>
 
 // Forward declaration
@@ -53,6 +54,7 @@ typedef struct _maxmcp {
     t_object* patcher;         ///< Reference to parent patcher object (patch mode)
     t_symbol* alias;           ///< Custom patch ID override (patch mode, @alias attribute)
     t_symbol* group;           ///< Patch group name (patch mode, @group attribute)
+    uint64_t structure_edits;  ///< Boxes/patchlines added or removed by tools (main thread)
 } t_maxmcp;
 
 // Function prototypes
@@ -70,5 +72,6 @@ void maxmcp_send_ready_bang(t_maxmcp* x, t_symbol* s, long argc, t_atom* argv);
 
 // Attribute accessors
 t_max_err maxmcp_port_set(t_maxmcp* x, t_object* attr, long ac, t_atom* av);
+t_max_err maxmcp_group_set(t_maxmcp* x, t_object* attr, long ac, t_atom* av);
 
 #endif  // MAXMCP_H
@@ -87,13 +87,13 @@ void MCPServer::stop() {
  * @brief Aggregate tool schemas from all tool modules.
  *
  * Collects schemas from:
- * - PatchTools (3 tools)
- * - ObjectTools (12 tools)
- * - ConnectionTools (4 tools)
+ * - PatchTools (5 tools)
+ * - ObjectTools (17 tools)
+ * - ConnectionTools (6 tools)
  * - StateTools (3 tools)
  * - HierarchyTools (2 tools)
- * - UtilityTools (2 tools)
- * - LayoutTools (4 tools)
+ * - UtilityTools (3 tools)
+ * - LayoutTools (7 tools)
  *
  * @return JSON array of all tool schemas
  */
@@ -154,11 +154,19 @@ json MCPServer::handle_request(const json& req) {
             client_protocol_version = req["params"]["protocolVersion"].get<std::string>();
         }
 
+        json capabilities = {{"tools", {{"listChanged", true}}}};
+
+        // Optional binary wire encoding for direct socket clients (JSON stays the default)
+        if (auto encoding = wire::negotiate(req.value("params", json::object()))) {
+            capabilities["experimental"]["maxmcp"]["wireEncoding"] =
+                wire::encoding_name(*encoding);
+        }
+
         return {{"jsonrpc", "2.0"},
                 {"id", req.contains("id") ? req["id"] : nullptr},
                 {"result",
                  {{"protocolVersion", client_protocol_version},  // Echo client's version
-                  {"capabilities", {{"tools", {{"listChanged", true}}}}},
+                  {"capabilities", capabilities},
                   {"serverInfo", {{"name", "maxmcp"}, {"version", "1.1.0"}}}}}};
 
     } else if (method == "tools/list") {
@@ -207,12 +215,15 @@ json MCPServer::handle_request(const json& req) {
                     {"error", result["error"]}};
         }
 
-        // Return result as text content for MCP
+        // Return result as text content for MCP. Pre-serialized results are
+        // passed through as-is.
+        const json& payload = result.contains("result") ? result["result"] : result;
         std::string result_text;
-        if (result.contains("result")) {
-            result_text = result["result"].dump();
+        if (payload.is_object() && payload.contains(ToolCommon::RAW_RESULT_KEY) &&
+            payload[ToolCommon::RAW_RESULT_KEY].is_string()) {
+            result_text = payload[ToolCommon::RAW_RESULT_KEY].get<std::string>();
         } else {
-            result_text = result.dump();
+            result_text = payload.dump();
         }
 
         return {{"jsonrpc", "2.0"},
@@ -247,7 +258,8 @@ json MCPServer::execute_tool(const std::string& tool, const json& params) {
     // Route to appropriate tool module
     json result;
 
-    // Try PatchTools (list_active_patches, get_patch_info, get_frontmost_patch)
+    // Try PatchTools (list_active_patches, get_patch_info, get_frontmost_patch,
+    // export_patch, import_patch_fragment)
     result = PatchTools::execute(tool, params);
     if (!result.is_null()) {
         return result;
@@ -277,7 +289,7 @@ json MCPServer::execute_tool(const std::string& tool, const json& params) {
         return result;
     }
 
-    // Try UtilityTools (get_console_log, get_avoid_rect_position)
+    // Try UtilityTools (get_console_log, get_avoid_rect_position, place_objects)
     result = UtilityTools::execute(tool, params);
     if (!result.is_null()) {
         return result;
@@ -298,11 +310,40 @@ json MCPServer::execute_tool(const std::string& tool, const json& params) {
 // ============================================================================
 
 std::string MCPServer::handle_request_string(const std::string& request_str) {
+    wire::Encoding session_encoding = wire::Encoding::Json;
+    return handle_request_frame(request_str, false, session_encoding);
+}
+
+std::string MCPServer::handle_request_frame(const std::string& payload, bool binary,
+                                            wire::Encoding& session_encoding) {
+    // Text frames are always JSON; binary frames need a negotiated binary encoding.
+    const wire::Encoding request_encoding = binary ? session_encoding : wire::Encoding::Json;
+
+    auto parse_error = [&](const std::string& message) {
+        json error_response = {{"jsonrpc", "2.0"},
+                               {"error",
+                                {{"code", ToolCommon::ErrorCode::PARSE_ERROR},
+                                 {"message", "Parse error: " + message}}},
+                               {"id", nullptr}};
+        return wire::encode(error_response, request_encoding);
+    };
+
+    if (binary && !wire::is_binary(session_encoding)) {
+        ConsoleLogger::log("Binary frame received but no binary wire encoding was negotiated");
+        return parse_error("binary frame received but no binary wire encoding was negotiated");
+    }
+
     try {
-        ConsoleLogger::log(("Received message (" + std::to_string(request_str.length()) +
-                            " bytes): " + request_str)
-                               .c_str());
-        json req = json::parse(request_str);
+        if (binary) {
+            ConsoleLogger::log(("Received " + std::string(wire::encoding_name(request_encoding)) +
+                                " message (" + std::to_string(payload.length()) + " bytes)")
+                                   .c_str());
+        } else {
+            ConsoleLogger::log(("Received message (" + std::to_string(payload.length()) +
+                                " bytes): " + payload)
+                                   .c_str());
+        }
+        json req = wire::decode(payload, request_encoding);
         json response = handle_request(req);
 
         // Check if response is null (for notifications that should not receive a response)
@@ -311,16 +352,25 @@ std::string MCPServer::handle_request_string(const std::string& request_str) {
             return std::string();  // Return truly empty string (0 bytes)
         }
 
-        return response.dump();
+        std::string encoded = wire::encode(response, request_encoding);
+
+        // initialize may switch the session encoding; it applies from the next frame on.
+        static const json::json_pointer negotiated_path(
+            "/result/capabilities/experimental/maxmcp/wireEncoding");
+        if (response.contains(negotiated_path)) {
+            if (auto encoding =
+                    wire::parse_encoding(response[negotiated_path].get<std::string>())) {
+                session_encoding = *encoding;
+            }
+        }
+
+        return encoded;
     } catch (const std::exception& e) {
         // Return JSON-RPC error
-        ConsoleLogger::log(("Parse error on message: " + request_str).c_str());
+        if (!binary) {
+            ConsoleLogger::log(("Parse error on message: " + payload).c_str());
+        }
         ConsoleLogger::log(("Exception: " + std::string(e.what())).c_str());
-        json error_response = {{"jsonrpc", "2.0"},
-                               {"error",
-                                {{"code", ToolCommon::ErrorCode::PARSE_ERROR},
-                                 {"message", std::string("Parse error: ") + e.what()}}},
-                               {"id", nullptr}};
-        return error_response.dump();
+        return parse_error(e.what());
     }
 }
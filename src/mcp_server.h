@@ -10,6 +10,8 @@
 #ifndef MCP_SERVER_H
 #define MCP_SERVER_H
 
+#include "utils/wire_codec.h"
+
 #include <atomic>
 
 #include <nlohmann/json.hpp>
@@ -108,6 +110,22 @@ class MCPServer {
      * @return JSON-RPC response string
      */
     std::string handle_request_string(const std::string& request_str);
+
+    /**
+     * @brief Handle one WebSocket frame in the session's wire encoding
+     *
+     * Text frames are JSON; binary frames are decoded with @p session_encoding
+     * (see utils/wire_codec.h). The response uses the request's encoding. An
+     * initialize request that negotiates a wire encoding updates
+     * @p session_encoding after its (JSON) response has been produced.
+     *
+     * @param payload Frame payload
+     * @param binary True if the frame was a binary frame
+     * @param session_encoding Per-connection encoding, updated on negotiation
+     * @return Encoded response, or empty for notifications
+     */
+    std::string handle_request_frame(const std::string& payload, bool binary,
+                                     wire::Encoding& session_encoding);
 };
 
 #endif  // MCP_SERVER_H
@@ -17,9 +17,19 @@
 #endif
 
 #include "maxmcp.h"
+#include "utils/batch.h"
 #include "utils/console_logger.h"
+#include "utils/field_selection.h"
+#include "utils/pagination.h"
+#include "utils/patch_graph.h"
 #include "utils/patch_helpers.h"
 #include "utils/patch_registry.h"
+#include "utils/symbols.h"
+
+#include <memory>
+#include <optional>
+#include <unordered_map>
+#include <vector>
 
 namespace ConnectionTools {
 
@@ -55,6 +65,13 @@ struct t_set_midpoints_data : t_connection_data {
           coords(std::move(coords)) {}
 };
 
+struct t_connect_batch_data {
+    t_maxmcp* patch;
+    std::vector<batch::ConnectionSpec> connections;
+    batch::OnError on_error;
+    DeferredResult* deferred_result;
+};
+
 enum class GetPatchlinesMode {
     Default,     // topology + start/end + midpoints + hidden + color
     Geometry,    // topology + start/end + midpoints (no hidden/color)
@@ -74,9 +91,38 @@ static GetPatchlinesMode parse_get_patchlines_mode(const std::string& mode_str)
     return GetPatchlinesMode::Default;
 }
 
+// Built-in fields selectable through the "fields" parameter. The enum value is
+// the index into kPatchlineFieldNames; any other name is read as a patchline attribute.
+enum PatchlineField : size_t {
+    kFieldSrcVarname,
+    kFieldOutlet,
+    kFieldDstVarname,
+    kFieldInlet,
+    kFieldStartPoint,
+    kFieldEndPoint,
+    kFieldNumMidpoints,
+    kFieldMidpoints,
+    kFieldHidden,
+    kFieldColor,
+};
+
+static const std::vector<std::string> kPatchlineFieldNames = {
+    "src_varname", "outlet",        "dst_varname", "inlet",  "start_point",
+    "end_point",   "num_midpoints", "midpoints",   "hidden", "color"};
+
 struct t_get_patchlines_data {
     t_maxmcp* patch;
     GetPatchlinesMode mode;
+    std::optional<field_selection::FieldSelection> fields;
+    pagination::PageRequest page;
+    DeferredResult* deferred_result;
+};
+
+// The main-thread callback only fills `edges`; the caller keeps its own
+// reference so it can run the analysis after the callback has deleted `data`.
+struct t_analyze_graph_data {
+    t_maxmcp* patch;
+    std::shared_ptr<patch_graph::EdgeList> edges;
     DeferredResult* deferred_result;
 };
 
@@ -139,7 +185,7 @@ static void connect_objects_deferred(t_maxmcp* patch, t_symbol* s, long argc, t_
 
     // Create connection
     t_atom result;
-    object_method_typed(patcher, gensym("connect"), 4, connect_args, &result);
+    object_method_typed(patcher, Symbols::connect, 4, connect_args, &result);
 
     // Verify connection was created by searching for matching patchline
     bool verified = false;
@@ -167,6 +213,7 @@ static void connect_objects_deferred(t_maxmcp* patch, t_symbol* s, long argc, t_
     }
 
     jpatcher_set_dirty(data->patch->patcher, 1);
+    ++data->patch->structure_edits;
 
     std::string msg = "Connected: " + data->src_varname + "[" + std::to_string(data->outlet) +
                       "] -> " + data->dst_varname + "[" + std::to_string(data->inlet) + "]";
@@ -180,6 +227,38 @@ static void connect_objects_deferred(t_maxmcp* patch, t_symbol* s, long argc, t_
                                     {"inlet", data->inlet}}}}));
 }
 
+/**
+ * Deferred callback for connect_max_objects_batch.
+ * Resolves every endpoint from one varname index and connects in a single pass.
+ */
+static void connect_batch_deferred(t_maxmcp* patch, t_symbol* s, long argc, t_atom* argv) {
+    VALIDATE_DEFERRED_ARGS("connect_batch_deferred");
+    EXTRACT_DEFERRED_DATA_WITH_RESULT(t_connect_batch_data, data, argv);
+
+    t_object* patcher = data->patch->patcher;
+    batch::Tally tally(data->on_error);
+
+    auto boxes = PatchHelpers::index_boxes_by_varname(patcher);
+    json results = PatchHelpers::connect_batch(patcher, data->connections, boxes, tally);
+
+    if (tally.succeeded_count() > 0) {
+        jpatcher_set_dirty(patcher, 1);
+        ++data->patch->structure_edits;
+    }
+    ConsoleLogger::log(("Connections made: " + std::to_string(tally.succeeded_count()) + "/" +
+                        std::to_string(data->connections.size()))
+                           .c_str());
+
+    json result = {{"status", tally.status()},
+                   {"connected", tally.succeeded_count()},
+                   {"failed", tally.failed_count()},
+                   {"connections", results}};
+    if (tally.stopped()) {
+        result["stopped"] = true;
+    }
+    COMPLETE_DEFERRED(data, (json{{"result", result}}));
+}
+
 /**
  * Deferred callback for disconnecting Max objects.
  * Executes on the Max main thread via defer().
@@ -209,6 +288,7 @@ static void disconnect_objects_deferred(t_maxmcp* patch, t_symbol* s, long argc,
 
             object_free(line);
             jpatcher_set_dirty(data->patch->patcher, 1);
+            ++data->patch->structure_edits;
             found = true;
 
             std::string msg = "Disconnected: " + data->src_varname + "[" +
@@ -238,6 +318,94 @@ static void disconnect_objects_deferred(t_maxmcp* patch, t_symbol* s, long argc,
                                     {"inlet", data->inlet}}}}));
 }
 
+// Read a patchline's midpoints as [{x, y}, ...] (empty when the cord is straight).
+static json read_line_midpoints(t_object* line, long num_midpoints) {
+    json midpoints = json::array();
+    if (num_midpoints == 0) {
+        return midpoints;
+    }
+
+    long num_values = num_midpoints * 2;
+    std::vector<double> coords(num_values, 0.0);
+    long count = object_attr_getdouble_array(line, Symbols::midpoints, num_values, coords.data());
+    // num_midpoints and count should always match in a healthy patch.
+    // Mismatch indicates internal Max state inconsistency or data
+    // corruption — log it so the user can investigate.
+    if (count != num_values) {
+        ConsoleLogger::log(("Warning: midpoint count mismatch (expected " +
+                            std::to_string(num_values) + ", got " + std::to_string(count) + ")")
+                               .c_str());
+    }
+
+    for (long i = 0; i + 1 < count; i += 2) {
+        midpoints.push_back({{"x", coords[i]}, {"y", coords[i + 1]}});
+    }
+    return midpoints;
+}
+
+// Build one get_patchlines entry from a "fields" projection. Reads only the
+// requested data; attributes the patchline does not have come back as null.
+static json project_line_fields(t_object* line, const field_selection::FieldSelection& fields,
+                                const std::vector<t_symbol*>& attr_syms) {
+    json pl = json::object();
+
+    for (size_t field : fields.builtins) {
+        const std::string& key = kPatchlineFieldNames[field];
+        switch (field) {
+        case kFieldSrcVarname:
+            pl[key] = PatchHelpers::get_box_varname((t_object*)jpatchline_get_box1(line));
+            break;
+        case kFieldOutlet:
+            pl[key] = jpatchline_get_outletnum(line);
+            break;
+        case kFieldDstVarname:
+            pl[key] = PatchHelpers::get_box_varname((t_object*)jpatchline_get_box2(line));
+            break;
+        case kFieldInlet:
+            pl[key] = jpatchline_get_inletnum(line);
+            break;
+        case kFieldStartPoint:
+        case kFieldEndPoint: {
+            double x, y;
+            if (field == kFieldStartPoint) {
+                jpatchline_get_startpoint(line, &x, &y);
+            } else {
+                jpatchline_get_endpoint(line, &x, &y);
+            }
+            pl[key] = {{"x", x}, {"y", y}};
+            break;
+        }
+        case kFieldNumMidpoints:
+            pl[key] = jpatchline_get_nummidpoints(line);
+            break;
+        case kFieldMidpoints:
+            pl[key] = read_line_midpoints(line, jpatchline_get_nummidpoints(line));
+            break;
+        case kFieldHidden:
+            pl[key] = (bool)jpatchline_get_hidden(line);
+            break;
+        case kFieldColor: {
+            t_jrgba color = {0.0, 0.0, 0.0, 1.0};
+            jpatchline_get_color(line, &color);
+            pl[key] = {{"r", color.red}, {"g", color.green}, {"b", color.blue}, {"a", color.alpha}};
+            break;
+        }
+        }
+    }
+
+    for (size_t a = 0; a < attr_syms.size(); ++a) {
+        long ac = 0;
+        t_atom* av = nullptr;
+        t_max_err err = object_attr_getvalueof(line, attr_syms[a], &ac, &av);
+        pl[fields.attributes[a]] =
+            (err == MAX_ERR_NONE && ac > 0) ? PatchHelpers::atoms_to_json(ac, av) : json();
+        if (av)
+            sysmem_freeptr(av);
+    }
+
+    return pl;
+}
+
 /**
  * Deferred callback for getting patchline information.
  * Executes on the Max main thread via defer().
@@ -260,31 +428,10 @@ static void get_patchlines_deferred(t_maxmcp* patch, t_symbol* s, long argc, t_a
         pl["end_point"] = {{"x", ex}, {"y", ey}};
         pl["num_midpoints"] = num_midpoints;
 
-        if (num_midpoints == 0) {
-            return;
+        json midpoints = read_line_midpoints(line, num_midpoints);
+        if (!midpoints.empty()) {
+            pl["midpoints"] = midpoints;
         }
-
-        long num_values = num_midpoints * 2;
-        std::vector<double> coords(num_values, 0.0);
-        long count =
-            object_attr_getdouble_array(line, gensym("midpoints"), num_values, coords.data());
-        // num_midpoints and count should always match in a healthy patch.
-        // Mismatch indicates internal Max state inconsistency or data
-        // corruption — log it so the user can investigate.
-        if (count != num_values) {
-            ConsoleLogger::log(("Warning: midpoint count mismatch (expected " +
-                                std::to_string(num_values) + ", got " + std::to_string(count) + ")")
-                                   .c_str());
-        }
-        if (count == 0) {
-            return;
-        }
-
-        json midpoints = json::array();
-        for (long i = 0; i + 1 < count; i += 2) {
-            midpoints.push_back({{"x", coords[i]}, {"y", coords[i + 1]}});
-        }
-        pl["midpoints"] = midpoints;
     };
     auto add_visual_fields = [](json& pl, t_object* line) {
         t_jrgba color = {0.0, 0.0, 0.0, 1.0};
@@ -293,8 +440,38 @@ static void get_patchlines_deferred(t_maxmcp* patch, t_symbol* s, long argc, t_a
         pl["color"] = {{"r", color.red}, {"g", color.green}, {"b", color.blue}, {"a", color.alpha}};
     };
 
+    // Pointer-only pass: fingerprints the listing for the cursor and sizes the page.
+    std::vector<t_object*> lines;
+    pagination::RevisionHash revision(data->patch->structure_edits);
     for (t_object* line = jpatcher_get_firstline(patcher); line;
          line = jpatchline_get_nextline(line)) {
+        lines.push_back(line);
+        revision.add(line);
+    }
+
+    pagination::PageWindow window;
+    json page_error = pagination::resolve_page(data->page, lines.size(), revision.value(), window);
+    if (!page_error.is_null()) {
+        COMPLETE_DEFERRED(data, page_error);
+        return;
+    }
+
+    // Projection: resolve attribute symbols once per request, not once per line.
+    std::vector<t_symbol*> attr_syms;
+    if (data->fields) {
+        for (const auto& name : data->fields->attributes) {
+            attr_syms.push_back(gensym(name.c_str()));
+        }
+    }
+
+    for (size_t i = window.begin; i < window.end; ++i) {
+        t_object* line = lines[i];
+
+        if (data->fields) {
+            patchlines.push_back(project_line_fields(line, *data->fields, attr_syms));
+            continue;
+        }
+
         t_object* box1 = (t_object*)jpatchline_get_box1(line);
         t_object* box2 = (t_object*)jpatchline_get_box2(line);
         long outlet = jpatchline_get_outletnum(line);
@@ -321,9 +498,11 @@ static void get_patchlines_deferred(t_maxmcp* patch, t_symbol* s, long argc, t_a
         patchlines.push_back(pl);
     }
 
-    COMPLETE_DEFERRED(data, (json{{"patch_id", data->patch->patch_id},
-                                  {"patchlines", patchlines},
-                                  {"count", patchlines.size()}}));
+    json result = {{"patch_id", data->patch->patch_id},
+                   {"patchlines", patchlines},
+                   {"count", patchlines.size()}};
+    pagination::add_page_fields(result, data->page, window, lines.size(), revision.value());
+    COMPLETE_DEFERRED(data, result);
 }
 
 /**
@@ -355,32 +534,7 @@ static void set_patchline_midpoints_deferred(t_maxmcp* patch, t_symbol* s, long
             continue;
         }
 
-        long count = (long)data->coords.size();
-        if (count > 0) {
-            object_attr_setdouble_array(line, gensym("midpoints"), count, data->coords.data());
-        } else {
-            // No setter API for clearing midpoints; reconnect the patchline
-            bool was_hidden = jpatchline_get_hidden(line);
-            t_jrgba saved_color;
-            jpatchline_get_color(line, &saved_color);
-
-            object_free(line);
-
-            t_atom connect_args[4];
-            atom_setobj(&connect_args[0], src_box);
-            atom_setlong(&connect_args[1], data->outlet);
-            atom_setobj(&connect_args[2], dst_box);
-            atom_setlong(&connect_args[3], data->inlet);
-            t_atom rv;
-            object_method_typed(patcher, gensym("connect"), 4, connect_args, &rv);
-
-            line =
-                PatchHelpers::find_patchline(patcher, src_box, data->outlet, dst_box, data->inlet);
-            if (line) {
-                jpatchline_set_hidden(line, was_hidden);
-                jpatchline_set_color(line, &saved_color);
-            }
-        }
+        line = PatchHelpers::set_patchline_midpoints(patcher, line, data->coords);
 
         jpatcher_set_dirty(patcher, 1);
 
@@ -391,7 +545,7 @@ static void set_patchline_midpoints_deferred(t_maxmcp* patch, t_symbol* s, long
             long num_values = new_num * 2;
             std::vector<double> readback(num_values, 0.0);
             long got =
-                object_attr_getdouble_array(line, gensym("midpoints"), num_values, readback.data());
+                object_attr_getdouble_array(line, Symbols::midpoints, num_values, readback.data());
             for (long i = 0; i + 1 < got; i += 2) {
                 midpoints_out.push_back({{"x", readback[i]}, {"y", readback[i + 1]}});
             }
@@ -424,6 +578,39 @@ static void set_patchline_midpoints_deferred(t_maxmcp* patch, t_symbol* s, long
     }
 }
 
+/**
+ * Deferred callback for analyze_patch_graph.
+ * Executes on the Max main thread via defer(). Only records boxes and
+ * patchlines as integer ids; the graph algorithms run on the request thread.
+ */
+static void analyze_patch_graph_deferred(t_maxmcp* patch, t_symbol* s, long argc, t_atom* argv) {
+    VALIDATE_DEFERRED_ARGS("analyze_patch_graph_deferred");
+    EXTRACT_DEFERRED_DATA_WITH_RESULT(t_analyze_graph_data, data, argv);
+
+    t_object* patcher = data->patch->patcher;
+    patch_graph::EdgeList& edges = *data->edges;
+
+    std::unordered_map<t_object*, int> ids;
+    for (t_object* box = jpatcher_get_firstobject(patcher); box; box = jbox_get_nextobject(box)) {
+        ids.emplace(box, static_cast<int>(edges.nodes.size()));
+        edges.nodes.push_back(
+            {PatchHelpers::get_box_varname(box), PatchHelpers::get_box_maxclass(box, "unknown")});
+    }
+
+    for (t_object* line = jpatcher_get_firstline(patcher); line;
+         line = jpatchline_get_nextline(line)) {
+        auto src = ids.find((t_object*)jpatchline_get_box1(line));
+        auto dst = ids.find((t_object*)jpatchline_get_box2(line));
+        if (src == ids.end() || dst == ids.end()) {
+            continue;
+        }
+        edges.edges.push_back({src->second, jpatchline_get_outletnum(line), dst->second,
+                               jpatchline_get_inletnum(line)});
+    }
+
+    COMPLETE_DEFERRED(data, json::object());
+}
+
 // ============================================================================
 // Tool Executors
 // ============================================================================
@@ -458,6 +645,42 @@ static json execute_connect_max_objects(const json& params) {
                                     ToolCommon::DeferredWrap::Raw);
 }
 
+/**
+ * Execute connect_max_objects_batch tool.
+ * Creates many patchcords in one deferred pass.
+ */
+static json execute_connect_max_objects_batch(const json& params) {
+    std::string patch_id = params.value("patch_id", "");
+    if (patch_id.empty()) {
+        return ToolCommon::missing_param_error("patch_id");
+    }
+
+    std::vector<batch::ConnectionSpec> connections;
+    json error = batch::parse_connection_specs(params, "connections", true, connections);
+    if (!error.is_null()) {
+        return error;
+    }
+
+    batch::OnError on_error;
+    error = batch::parse_on_error(params, on_error);
+    if (!error.is_null()) {
+        return error;
+    }
+
+    t_maxmcp* patch = PatchRegistry::find_patch(patch_id);
+    if (!patch) {
+        return ToolCommon::patch_not_found_error(patch_id);
+    }
+
+    auto* deferred_result = new DeferredResult();
+    auto* data =
+        new t_connect_batch_data{patch, std::move(connections), on_error, deferred_result};
+
+    return ToolCommon::run_deferred(patch, (method)connect_batch_deferred, "connect_batch", data,
+                                    ToolCommon::HEAVY_OPERATION_TIMEOUT, "connecting objects",
+                                    ToolCommon::DeferredWrap::Raw);
+}
+
 /**
  * Execute disconnect_max_objects tool.
  * Removes a patchcord between two objects.
@@ -505,12 +728,24 @@ static json execute_get_patchlines(const json& params) {
 
     GetPatchlinesMode mode = parse_get_patchlines_mode(params.value("mode", ""));
 
+    std::optional<field_selection::FieldSelection> fields;
+    json fields_error = field_selection::parse_fields(params, kPatchlineFieldNames, fields);
+    if (!fields_error.is_null()) {
+        return fields_error;
+    }
+
+    pagination::PageRequest page;
+    json page_error = pagination::parse_page_request(params, page);
+    if (!page_error.is_null()) {
+        return page_error;
+    }
+
     auto* deferred_result = new DeferredResult();
-    auto* data = new t_get_patchlines_data{patch, mode, deferred_result};
+    auto* data = new t_get_patchlines_data{patch, mode, std::move(fields), page, deferred_result};
 
     return ToolCommon::run_deferred(patch, (method)get_patchlines_deferred, "get_patchlines", data,
                                     ToolCommon::HEAVY_OPERATION_TIMEOUT, "getting patchlines",
-                                    ToolCommon::DeferredWrap::Always);
+                                    ToolCommon::DeferredWrap::OnSuccess);
 }
 
 /**
@@ -565,6 +800,98 @@ static json execute_set_patchline_midpoints(const json& params) {
                                     "setting patchline midpoints", ToolCommon::DeferredWrap::Raw);
 }
 
+/**
+ * Execute analyze_patch_graph tool.
+ * Extracts the patchcord graph on the main thread, then analyzes it here.
+ */
+static json execute_analyze_patch_graph(const json& params) {
+    std::string patch_id = params.value("patch_id", "");
+    if (patch_id.empty()) {
+        return ToolCommon::missing_param_error("patch_id");
+    }
+
+    patch_graph::AnalysisOptions options;
+    if (params.contains("analyses")) {
+        const json& analyses = params["analyses"];
+        if (!analyses.is_array()) {
+            return ToolCommon::make_error(ToolCommon::ErrorCode::INVALID_PARAMS,
+                                          "analyses must be an array of strings");
+        }
+        options.order = options.cycles = options.degrees = false;
+        for (const auto& name : analyses) {
+            std::string analysis = name.is_string() ? name.get<std::string>() : "";
+            if (analysis == "order") {
+                options.order = true;
+            } else if (analysis == "cycles") {
+                options.cycles = true;
+            } else if (analysis == "degrees") {
+                options.degrees = true;
+            } else {
+                return ToolCommon::make_error(ToolCommon::ErrorCode::INVALID_PARAMS,
+                                              "Unknown analysis " + name.dump() +
+                                                  " (expected order, cycles or degrees)");
+            }
+        }
+    }
+
+    std::string from = params.value("from", "");
+    std::string direction = params.value("direction", "both");
+    if (direction != "both" && direction != "downstream" && direction != "upstream") {
+        return ToolCommon::make_error(ToolCommon::ErrorCode::INVALID_PARAMS,
+                                      "direction must be 'downstream', 'upstream' or 'both'");
+    }
+    options.downstream = direction != "upstream";
+    options.upstream = direction != "downstream";
+
+    if (params.contains("max_depth")) {
+        if (!params["max_depth"].is_number_integer() || params["max_depth"].get<int>() < 1) {
+            return ToolCommon::make_error(ToolCommon::ErrorCode::INVALID_PARAMS,
+                                          "max_depth must be a positive integer");
+        }
+        options.max_depth = params["max_depth"].get<int>();
+    }
+    if (params.contains("top")) {
+        if (!params["top"].is_number_integer() || params["top"].get<int>() < 0) {
+            return ToolCommon::make_error(ToolCommon::ErrorCode::INVALID_PARAMS,
+                                          "top must be a non-negative integer");
+        }
+        options.top = params["top"].get<size_t>();
+    }
+
+    t_maxmcp* patch = PatchRegistry::find_patch(patch_id);
+    if (!patch) {
+        return ToolCommon::patch_not_found_error(patch_id);
+    }
+
+    auto edges = std::make_shared<patch_graph::EdgeList>();
+    auto* deferred_result = new DeferredResult();
+    auto* data = new t_analyze_graph_data{patch, edges, deferred_result};
+
+    json extracted = ToolCommon::run_deferred(
+        patch, (method)analyze_patch_graph_deferred, "analyze_patch_graph", data,
+        ToolCommon::HEAVY_OPERATION_TIMEOUT, "extracting the patch graph",
+        ToolCommon::DeferredWrap::Raw);
+    if (extracted.contains("error")) {
+        return extracted;
+    }
+
+    if (!from.empty()) {
+        for (size_t i = 0; i < edges->nodes.size(); ++i) {
+            if (edges->nodes[i].varname == from) {
+                options.from = static_cast<int>(i);
+                break;
+            }
+        }
+        if (options.from < 0) {
+            return ToolCommon::object_not_found_error(from);
+        }
+    }
+
+    json result = patch_graph::analyze_report(*edges, options);
+    result["patch_id"] = patch_id;
+    return {{"result", result}};
+}
+
 #endif  // MAXMCP_TEST_MODE
 
 // ============================================================================
@@ -588,6 +915,33 @@ json get_tool_schemas() {
                {{"type", "number"}, {"description", "Destination inlet index (0-based)"}}}}},
             {"required",
              json::array({"patch_id", "src_varname", "outlet", "dst_varname", "inlet"})}}}},
+         {{"name", "connect_max_objects_batch"},
+          {"description",
+           "Create several patchcords in a single pass. Returns one result per connection; "
+           "'on_error' chooses between stopping at the first failure and attempting all."},
+          {"inputSchema",
+           {{"type", "object"},
+            {"properties",
+             {{"patch_id",
+               {{"type", "string"}, {"description", "Patch ID containing the objects"}}},
+              {"connections",
+               {{"type", "array"},
+                {"description", "Connections to create, in order"},
+                {"items",
+                 {{"type", "object"},
+                  {"properties",
+                   {{"src_varname", {{"type", "string"}}},
+                    {"outlet", {{"type", "integer"}}},
+                    {"dst_varname", {{"type", "string"}}},
+                    {"inlet", {{"type", "integer"}}}}},
+                  {"required",
+                   json::array({"src_varname", "outlet", "dst_varname", "inlet"})}}}}},
+              {"on_error",
+               {{"type", "string"},
+                {"enum", json::array({"stop", "continue"})},
+                {"description", "'stop' (default): stop at the first failed connection. "
+                                "'continue': attempt every connection"}}}}},
+            {"required", json::array({"patch_id", "connections"})}}}},
          {{"name", "disconnect_max_objects"},
           {"description", "Remove a patchcord connection between two Max objects"},
           {"inputSchema",
@@ -619,7 +973,25 @@ json get_tool_schemas() {
                                 "'geometry' returns topology + start/end points + midpoints — "
                                 "for layout verification. 'connections' returns topology only "
                                 "(src_varname, outlet, dst_varname, inlet) — for connectivity "
-                                "checks and inspecting an existing patch before editing."}}}}},
+                                "checks and inspecting an existing patch before editing."}}},
+              {"fields",
+               {{"type", "array"},
+                {"items", {{"type", "string"}}},
+                {"description",
+                 "Optional projection, instead of 'mode'. Built-in fields: src_varname, outlet, "
+                 "dst_varname, inlet, start_point, end_point, num_midpoints, midpoints, hidden, "
+                 "color. Any other name is read as a patchline attribute; null when absent."}}},
+              {"limit",
+               {{"type", "integer"},
+                {"minimum", 1},
+                {"description",
+                 "Optional page size. When set (or when 'cursor' is passed) the response adds "
+                 "'total' and, if more patchlines remain, 'next_cursor'."}}},
+              {"cursor",
+               {{"type", "string"},
+                {"description",
+                 "Opaque 'next_cursor' from a previous page. Fails with an error if patchlines "
+                 "were added, removed or reordered since it was issued."}}}}},
             {"required", json::array({"patch_id"})}}}},
          {{"name", "set_patchline_midpoints"},
           {"description",
@@ -648,7 +1020,38 @@ json get_tool_schemas() {
                     {"y", {{"type", "number"}, {"description", "Y coordinate"}}}}},
                   {"required", json::array({"x", "y"})}}}}}}},
             {"required", json::array({"patch_id", "src_varname", "outlet", "dst_varname", "inlet",
-                                      "midpoints"})}}}}});
+                                      "midpoints"})}}}},
+         {{"name", "analyze_patch_graph"},
+          {"description",
+           "Analyze the patchcord graph of a patch: topological (signal/message flow) order, "
+           "feedback cycles, fan-in/fan-out statistics and, with 'from', which objects are "
+           "upstream or downstream of a given object. Unnamed objects are labelled "
+           "'maxclass#index'."},
+          {"inputSchema",
+           {{"type", "object"},
+            {"properties",
+             {{"patch_id", {{"type", "string"}, {"description", "Patch ID to analyze"}}},
+              {"analyses",
+               {{"type", "array"},
+                {"items",
+                 {{"type", "string"}, {"enum", json::array({"order", "cycles", "degrees"})}}},
+                {"description", "Optional subset of analyses to include (default: all)"}}},
+              {"from",
+               {{"type", "string"},
+                {"description", "Optional varname to report reachability from"}}},
+              {"direction",
+               {{"type", "string"},
+                {"enum", json::array({"downstream", "upstream", "both"})},
+                {"description", "Reachability direction from 'from' (default: both)"}}},
+              {"max_depth",
+               {{"type", "integer"},
+                {"minimum", 1},
+                {"description", "Optional hop limit for reachability (default: unlimited)"}}},
+              {"top",
+               {{"type", "integer"},
+                {"minimum", 0},
+                {"description", "Objects listed per fan-in/fan-out ranking (default: 10)"}}}}},
+            {"required", json::array({"patch_id"})}}}}});
 }
 
 // ============================================================================
@@ -657,20 +1060,25 @@ json get_tool_schemas() {
 
 json execute(const std::string& tool, const json& params) {
 #ifdef MAXMCP_TEST_MODE
-    if (tool == "connect_max_objects" || tool == "disconnect_max_objects" ||
-        tool == "get_patchlines" || tool == "set_patchline_midpoints") {
+    if (tool == "connect_max_objects" || tool == "connect_max_objects_batch" ||
+        tool == "disconnect_max_objects" || tool == "get_patchlines" ||
+        tool == "set_patchline_midpoints" || tool == "analyze_patch_graph") {
         return ToolCommon::test_mode_error();
     }
     return nullptr;
 #else
     if (tool == "connect_max_objects") {
         return execute_connect_max_objects(params);
+    } else if (tool == "connect_max_objects_batch") {
+        return execute_connect_max_objects_batch(params);
     } else if (tool == "disconnect_max_objects") {
         return execute_disconnect_max_objects(params);
     } else if (tool == "get_patchlines") {
         return execute_get_patchlines(params);
     } else if (tool == "set_patchline_midpoints") {
         return execute_set_patchline_midpoints(params);
+    } else if (tool == "analyze_patch_graph") {
+        return execute_analyze_patch_graph(params);
     }
     return nullptr;
 #endif
@@ -28,9 +28,11 @@ using json = nlohmann::json;
  *
  * Tools included:
  * - connect_max_objects: Create a patchcord connection between two objects
+ * - connect_max_objects_batch: Create many patchcords in one pass
  * - disconnect_max_objects: Remove a patchcord connection between two objects
  * - get_patchlines: List all patchlines with metadata (coordinates, color, etc.)
  * - set_patchline_midpoints: Set midpoint coordinates for a patchcord
+ * - analyze_patch_graph: Topological order, cycles, degrees and reachability
  *
  * @return JSON array of tool schema objects
  */
@@ -19,6 +19,7 @@
 #include "utils/console_logger.h"
 #include "utils/patch_helpers.h"
 #include "utils/patch_registry.h"
+#include "utils/symbols.h"
 
 namespace HierarchyTools {
 
@@ -94,7 +95,7 @@ static void get_subpatchers_deferred(t_maxmcp* patch, t_symbol* s, long argc, t_
 
             if (class_name == "patcher" || class_name == "bpatcher") {
                 // Try to get the subpatcher object (subpatcher may remain null if method fails)
-                object_method(box, gensym("subpatcher"), &subpatcher);
+                object_method(box, Symbols::subpatcher, &subpatcher);
                 if (subpatcher) {
                     t_symbol* sub_name = jpatcher_get_name(subpatcher);
                     name_str = (sub_name && sub_name->s_name) ? sub_name->s_name : "";
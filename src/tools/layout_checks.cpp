@@ -14,10 +14,20 @@
 
 #include "utils/format_util.h"
 #include "utils/geometry.h"
+#include "utils/geometry_batch.h"
+#include "utils/json_writer.h"
+#include "utils/spatial_index.h"
+#include "utils/work_pool.h"
 
 #include <algorithm>
+#include <cmath>
+#include <functional>
+#include <iterator>
 #include <set>
 #include <string>
+#include <string_view>
+#include <tuple>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -48,144 +58,237 @@ json cord_topology(const LayoutCord& c) {
             {"inlet", c.inlet}};
 }
 
-// Each append_*_findings helper runs one check, pushes its findings onto
-// `findings`, and returns how many it added (for the summary counters). Splitting
-// the checks out keeps run_layout_checks a flat orchestrator instead of a deeply
-// nested loop nest.
+// Each check is split into a broad phase over the whole patch (candidate pairs,
+// a spatial index) and a narrow phase that turns a contiguous range of
+// candidates, objects or cords into findings. run_layout_checks runs the broad
+// phases side by side, then the ranges as separate tasks, and concatenates
+// their findings in range order, so the result does not depend on how the
+// work was scheduled.
+
+// One finding per check. run_layout_checks and LayoutCheckCache both build
+// their findings here, so the two report exactly the same JSON.
+
+json overlap_finding(const LayoutObject& a, const LayoutObject& b, bool presentation_mode) {
+    // Only called for pairs where aabb_overlap holds, so the intersection has
+    // positive extent.
+    const geometry::Rect ov = geometry::aabb_intersection(a.rect, b.rect);
+    const double area = ov.area();
+    const std::string rect_name = presentation_mode ? "presentation_rect" : "patching_rect";
+    std::string detail = rect_name + " overlap area " + fmti(area) + " px^2 (x:" +
+                         fmti(ov.origin.x) + "-" + fmti(ov.right()) + " y:" + fmti(ov.origin.y) +
+                         "-" + fmti(ov.bottom()) + ")";
+    return {{"type", presentation_mode ? "presentation_overlap" : "overlap"},
+            {"severity", "error"},
+            {"objects", json::array({label_for(a), label_for(b)})},
+            {"detail", detail}};
+}
+
+json upward_finding(const LayoutCord& cord, double start_y, double end_y) {
+    const bool has_midpoints = !cord.midpoints.empty();
+    std::string detail = "start.y " + fmti(start_y) + " > end.y " + fmti(end_y) +
+                         ", num_midpoints " + std::to_string(cord.midpoints.size());
+    return {{"type", "upward"},
+            {"severity", has_midpoints ? "warning" : "error"},
+            {"cord", cord_topology(cord)},
+            {"detail", detail}};
+}
+
+json cord_object_finding(const LayoutCord& cord, const LayoutObject& obj,
+                         const geometry::Point& entry) {
+    std::string detail = "cord segment passes through object rect; crossing at (" +
+                         fmt1(entry.x) + ", " + fmt1(entry.y) + ")";
+    return {{"type", "cord_object"},
+            {"severity", "error"},
+            {"cord", cord_topology(cord)},
+            {"object", label_for(obj)},
+            {"detail", detail}};
+}
+
+json cord_cord_finding(const LayoutCord& a, const LayoutCord& b) {
+    return {{"type", "cord_cord"},
+            {"severity", "warning"},
+            {"cords", json::array({cord_topology(a), cord_topology(b)})},
+            {"detail", "collinear cord segments overlap"}};
+}
+
+// Findings per check, for the summary block.
+struct FindingCounts {
+    int upward = 0;
+    int overlap = 0;
+    int cord_object = 0;
+    int cord_cord = 0;
+    int presentation = 0;
+};
+
+json make_summary(const FindingCounts& n) {
+    return {{"upward", n.upward},
+            {"overlap", n.overlap},
+            {"cord_object", n.cord_object},
+            {"cord_cord", n.cord_cord},
+            {"presentation_overlap", n.presentation}};
+}
+
+json make_result(json findings, const FindingCounts& n) {
+    const bool clean = findings.empty();
+    return {{"clean", clean}, {"summary", make_summary(n)}, {"findings", std::move(findings)}};
+}
 
 // overlap / presentation_overlap: every overlapping object pair (AABB). The mode
 // only changes the label and which counter the caller credits the count to.
-int append_overlap_findings(const std::vector<LayoutObject>& objects,
-                            const LayoutCheckOptions& options, json& findings) {
-    const double eps = options.epsilon;
-    const std::string type = options.presentation_mode ? "presentation_overlap" : "overlap";
-    const std::string rect_name = options.presentation_mode ? "presentation_rect" : "patching_rect";
-    int count = 0;
-    for (size_t i = 0; i < objects.size(); ++i) {
-        for (size_t j = i + 1; j < objects.size(); ++j) {
-            const geometry::Rect& a = objects[i].rect;
-            const geometry::Rect& b = objects[j].rect;
-            if (!geometry::aabb_overlap(a, b, eps)) {
-                continue;
-            }
-            // aabb_overlap returned true, so the intersection has positive extent.
-            const geometry::Rect ov = geometry::aabb_intersection(a, b);
-            const double area = ov.area();
-            std::string detail = rect_name + " overlap area " + fmti(area) +
-                                 " px^2 (x:" + fmti(ov.origin.x) + "-" + fmti(ov.right()) +
-                                 " y:" + fmti(ov.origin.y) + "-" + fmti(ov.bottom()) + ")";
-            findings.push_back(
-                {{"type", type},
-                 {"severity", "error"},
-                 {"objects", json::array({label_for(objects[i]), label_for(objects[j])})},
-                 {"detail", detail}});
-            ++count;
-        }
+// Candidate pairs come from a sort-and-sweep broad phase, already in the
+// (i, j) order a nested loop over the objects would report them.
+void overlap_findings(const std::vector<LayoutObject>& objects,
+                      const std::vector<std::pair<int, int>>& pairs, size_t begin, size_t end,
+                      const LayoutCheckOptions& options, json& findings) {
+    for (size_t k = begin; k < end; ++k) {
+        const auto [i, j] = pairs[k];
+        findings.push_back(overlap_finding(objects[i], objects[j], options.presentation_mode));
     }
-    return count;
 }
 
 // upward: a cord segment that rises on screen. A straight (no-midpoint) upward
 // cord is an error; an upward segment of a folded cord is an intentional detour
 // (warning).
-int append_upward_findings(const std::vector<LayoutCord>& cords, double eps, json& findings) {
-    int count = 0;
-    for (const LayoutCord& cord : cords) {
-        const std::vector<geometry::Segment> segs = cord.segments();
-        const bool has_midpoints = !cord.midpoints.empty();
-        for (const geometry::Segment& seg : segs) {
-            if (!geometry::segment_is_upward(seg, eps)) {
-                continue;
-            }
-            std::string detail = "start.y " + fmti(seg.a.y) + " > end.y " + fmti(seg.b.y) +
-                                 ", num_midpoints " + std::to_string(cord.midpoints.size());
-            findings.push_back({{"type", "upward"},
-                                {"severity", has_midpoints ? "warning" : "error"},
-                                {"cord", cord_topology(cord)},
-                                {"detail", detail}});
-            ++count;
+void upward_findings(const std::vector<LayoutCord>& cords, size_t begin, size_t end, double eps,
+                     json& findings) {
+    // Every segment of the range, as columns, with the cord it belongs to
+    geometry::SegmentSoA segments;
+    std::vector<size_t> owner;
+    for (size_t c = begin; c < end; ++c) {
+        for (const geometry::Segment& seg : cords[c].segments()) {
+            segments.push_back(seg);
+            owner.push_back(c);
         }
     }
-    return count;
+
+    geometry::BitMask upward;
+    geometry::upward_mask(segments, 0, segments.size(), eps, upward);
+    geometry::for_each_set_bit(upward, [&](size_t k) {
+        findings.push_back(upward_finding(cords[owner[k]], segments.ay[k], segments.by[k]));
+    });
 }
 
 // cord_object: a cord segment passing through an unrelated object's rect. The
 // cord's own source/destination objects are excluded, and each (cord, object)
 // pair is reported at most once.
-int append_cord_object_findings(const std::vector<LayoutObject>& objects,
-                                const std::vector<LayoutCord>& cords, double eps, json& findings) {
-    int count = 0;
-    for (const LayoutCord& cord : cords) {
-        const std::vector<geometry::Segment> segs = cord.segments();
+//
+// Object rects are bucketed into a uniform grid once (the broad phase), so each
+// segment is only tested against the objects near its bounding box. Candidates
+// come back in ascending object order and are tested together with
+// segment_rect_mask, which keeps the findings in the order of the full
+// segment x object scan this replaces.
+class CrossingScan {
+  public:
+    CrossingScan(const std::vector<LayoutObject>& objects, const geometry::GridIndex& index,
+                 double eps)
+        : objects_(objects), index_(index), eps_(eps) {}
+
+    // Call fn(i) for every object i that @p seg passes through, ascending.
+    template <typename Fn>
+    void for_each(const geometry::Segment& seg, Fn fn) {
+        // segment_intersects_rect treats the rect as closed, so a crossing needs
+        // the rect to at least touch the segment's bounding box; a small negative
+        // tolerance makes the grid query report touching rects too.
+        constexpr double kTouching = -1.0;
+        const geometry::Rect bounds{std::min(seg.a.x, seg.b.x), std::min(seg.a.y, seg.b.y),
+                                    std::abs(seg.b.x - seg.a.x), std::abs(seg.b.y - seg.a.y)};
+        const std::vector<int> ids = index_.query(bounds, kTouching);
+        candidates_.clear();
+        for (int i : ids) {
+            candidates_.push_back(objects_[i].rect);
+        }
+        geometry::segment_rect_mask(seg, candidates_, 0, ids.size(), eps_, crossed_);
+        geometry::for_each_set_bit(crossed_, [&](size_t k) { fn(static_cast<size_t>(ids[k])); });
+    }
+
+  private:
+    const std::vector<LayoutObject>& objects_;
+    const geometry::GridIndex& index_;
+    double eps_;
+    geometry::RectSoA candidates_;
+    geometry::BitMask crossed_;
+};
+
+void cord_object_findings(const std::vector<LayoutObject>& objects,
+                          const geometry::GridIndex& index, const std::vector<LayoutCord>& cords,
+                          size_t begin, size_t end, double eps, json& findings) {
+    CrossingScan scan(objects, index, eps);
+    for (size_t c = begin; c < end; ++c) {
+        const LayoutCord& cord = cords[c];
         std::set<int> already_flagged;
-        for (const geometry::Segment& seg : segs) {
-            for (const LayoutObject& obj : objects) {
+        for (const geometry::Segment& seg : cord.segments()) {
+            scan.for_each(seg, [&](size_t i) {
+                const LayoutObject& obj = objects[i];
                 if (obj.id == cord.src_id || obj.id == cord.dst_id) {
-                    continue;  // a cord may legitimately touch its own endpoints
+                    return;  // a cord may legitimately touch its own endpoints
                 }
-                if (already_flagged.count(obj.id)) {
-                    continue;
+                if (!already_flagged.insert(obj.id).second) {
+                    return;
                 }
+                // The mask only says it crosses; the scalar test finds where.
                 geometry::Point entry{0.0, 0.0};
-                if (!geometry::segment_intersects_rect(seg, obj.rect, eps, &entry)) {
-                    continue;
-                }
-                already_flagged.insert(obj.id);
-                std::string detail = "cord segment passes through object rect; crossing at (" +
-                                     fmt1(entry.x) + ", " + fmt1(entry.y) + ")";
-                findings.push_back({{"type", "cord_object"},
-                                    {"severity", "error"},
-                                    {"cord", cord_topology(cord)},
-                                    {"object", label_for(obj)},
-                                    {"detail", detail}});
-                ++count;
-            }
+                geometry::segment_intersects_rect(seg, obj.rect, eps, &entry);
+                findings.push_back(cord_object_finding(cord, obj, entry));
+            });
         }
     }
-    return count;
 }
 
 // cord_cord: two cords whose axis-aligned segments collinearly overlap. Each cord
-// pair is reported at most once.
-int append_cord_cord_findings(const std::vector<LayoutCord>& cords, double eps, json& findings) {
-    // Flatten every cord into (cord index, segment) for pairwise testing.
-    struct IndexedSegment {
-        size_t cord;
-        geometry::Segment seg;
-    };
-    std::vector<IndexedSegment> all_segments;
+// pair is reported at most once, in the order a scan over all segment pairs
+// (a, b), a < b, first meets it.
+struct CordPair {
+    size_t ca, cb;
+    int a, b;
+};
+
+std::vector<CordPair> cord_cord_pairs(const std::vector<LayoutCord>& cords, double eps) {
+    // Flatten every cord into one segment list, remembering each segment's cord.
+    std::vector<geometry::Segment> all_segments;
+    std::vector<size_t> cord_of;
     for (size_t ci = 0; ci < cords.size(); ++ci) {
         for (const geometry::Segment& seg : cords[ci].segments()) {
-            all_segments.push_back({ci, seg});
+            all_segments.push_back(seg);
+            cord_of.push_back(ci);
         }
     }
-    std::set<std::pair<size_t, size_t>> flagged_pairs;
-    int count = 0;
-    for (size_t a = 0; a < all_segments.size(); ++a) {
-        for (size_t b = a + 1; b < all_segments.size(); ++b) {
-            if (all_segments[a].cord == all_segments[b].cord) {
-                continue;  // ignore a cord overlapping itself
-            }
-            if (!geometry::segments_overlap_collinear(all_segments[a].seg, all_segments[b].seg,
-                                                      eps)) {
-                continue;
-            }
-            const size_t ca = std::min(all_segments[a].cord, all_segments[b].cord);
-            const size_t cb = std::max(all_segments[a].cord, all_segments[b].cord);
-            if (!flagged_pairs.insert({ca, cb}).second) {
-                continue;
-            }
-            findings.push_back(
-                {{"type", "cord_cord"},
-                 {"severity", "warning"},
-                 {"cords", json::array({cord_topology(cords[ca]), cord_topology(cords[cb])})},
-                 {"detail", "collinear cord segments overlap"}});
-            ++count;
+
+    // One entry per overlapping segment pair of two different cords. Sorting by
+    // cord pair then segment pair keeps each cord pair's first occurrence in
+    // front; sorting the survivors by segment pair restores scan order.
+    std::vector<CordPair> hits;
+    for (const auto& [a, b] : geometry::collinear_overlap_pairs(all_segments, eps)) {
+        if (cord_of[a] == cord_of[b]) {
+            continue;  // ignore a cord overlapping itself
         }
+        hits.push_back({std::min(cord_of[a], cord_of[b]), std::max(cord_of[a], cord_of[b]), a, b});
+    }
+    std::sort(hits.begin(), hits.end(), [](const CordPair& x, const CordPair& y) {
+        return std::tie(x.ca, x.cb, x.a, x.b) < std::tie(y.ca, y.cb, y.a, y.b);
+    });
+    hits.erase(std::unique(hits.begin(), hits.end(),
+                           [](const CordPair& x, const CordPair& y) {
+                               return x.ca == y.ca && x.cb == y.cb;
+                           }),
+               hits.end());
+    std::sort(hits.begin(), hits.end(), [](const CordPair& x, const CordPair& y) {
+        return std::tie(x.a, x.b) < std::tie(y.a, y.b);
+    });
+    return hits;
+}
+
+void cord_cord_findings(const std::vector<LayoutCord>& cords, const std::vector<CordPair>& hits,
+                        size_t begin, size_t end, json& findings) {
+    for (size_t k = begin; k < end; ++k) {
+        findings.push_back(cord_cord_finding(cords[hits[k].ca], cords[hits[k].cb]));
     }
-    return count;
 }
 
+// Items per narrow-phase task. Small enough to balance across a few threads on
+// a large patch; a small patch ends up with one task per check.
+constexpr size_t kPairsPerTask = 512;
+constexpr size_t kCordsPerTask = 256;
+
 }  // namespace
 
 // ============================================================================
@@ -194,39 +297,831 @@ int append_cord_cord_findings(const std::vector<LayoutCord>& cords, double eps,
 
 json run_layout_checks(const std::vector<LayoutObject>& objects,
                        const std::vector<LayoutCord>& cords, const LayoutCheckOptions& options) {
+    return run_layout_checks(objects, cords, options, parallel::WorkPool::shared());
+}
+
+json run_layout_checks(const std::vector<LayoutObject>& objects,
+                       const std::vector<LayoutCord>& cords, const LayoutCheckOptions& options,
+                       parallel::WorkPool& pool) {
     const double eps = options.epsilon;
-    json findings = json::array();
-    int n_upward = 0, n_overlap = 0, n_cord_object = 0, n_cord_cord = 0, n_presentation = 0;
 
     // Object overlaps apply in both modes; the mode only decides the label and
-    // which summary counter the count lands in.
-    if (options.check_overlap) {
-        const int overlaps = append_overlap_findings(objects, options, findings);
-        (options.presentation_mode ? n_presentation : n_overlap) += overlaps;
+    // which summary counter the count lands in. Cords are not drawn in
+    // presentation mode, so cord-based checks run only for the patching layout.
+    const bool cord_checks = !options.presentation_mode;
+    const bool run_overlap = options.check_overlap;
+    const bool run_upward = cord_checks && options.check_upward;
+    const bool run_cord_object = cord_checks && options.check_cord_object;
+    const bool run_cord_cord = cord_checks && options.check_cord_cord;
+
+    // Object rects in input order, shared by the broad phases below
+    std::vector<geometry::Rect> rects;
+    rects.reserve(objects.size());
+    for (const LayoutObject& o : objects) {
+        rects.push_back(o.rect);
+    }
+
+    // Broad phases, side by side
+    std::vector<std::pair<int, int>> overlap_pairs;
+    geometry::GridIndex object_index;
+    std::vector<CordPair> cord_pairs;
+    std::vector<std::function<void()>> broad;
+    if (run_overlap) {
+        broad.emplace_back([&] { overlap_pairs = geometry::overlapping_pairs(rects, eps); });
+    }
+    if (run_cord_object) {
+        broad.emplace_back([&] { object_index = geometry::GridIndex::build(rects); });
+    }
+    if (run_cord_cord) {
+        broad.emplace_back([&] { cord_pairs = cord_cord_pairs(cords, eps); });
+    }
+    pool.run(broad.size(), [&](size_t i) { broad[i](); });
+
+    // Narrow phases, split into ranges. Tasks are listed in reporting order:
+    // overlap, upward, cord_object, cord_cord, each by ascending range.
+    enum class Check { Overlap, Upward, CordObject, CordCord };
+    struct Task {
+        Check check;
+        size_t begin, end;
+    };
+    std::vector<Task> tasks;
+    auto split = [&tasks](Check check, size_t count, size_t per_task) {
+        for (size_t begin = 0; begin < count; begin += per_task) {
+            tasks.push_back({check, begin, std::min(count, begin + per_task)});
+        }
+    };
+    if (run_overlap) {
+        split(Check::Overlap, overlap_pairs.size(), kPairsPerTask);
+    }
+    if (run_upward) {
+        split(Check::Upward, cords.size(), kCordsPerTask);
+    }
+    if (run_cord_object) {
+        split(Check::CordObject, cords.size(), kCordsPerTask);
+    }
+    if (run_cord_cord) {
+        split(Check::CordCord, cord_pairs.size(), kPairsPerTask);
+    }
+
+    std::vector<json> parts(tasks.size(), json::array());
+    pool.run(tasks.size(), [&](size_t t) {
+        const Task& task = tasks[t];
+        switch (task.check) {
+        case Check::Overlap:
+            overlap_findings(objects, overlap_pairs, task.begin, task.end, options, parts[t]);
+            break;
+        case Check::Upward:
+            upward_findings(cords, task.begin, task.end, eps, parts[t]);
+            break;
+        case Check::CordObject:
+            cord_object_findings(objects, object_index, cords, task.begin, task.end, eps,
+                                 parts[t]);
+            break;
+        case Check::CordCord:
+            cord_cord_findings(cords, cord_pairs, task.begin, task.end, parts[t]);
+            break;
+        }
+    });
+
+    json findings = json::array();
+    FindingCounts counts;
+    for (size_t t = 0; t < tasks.size(); ++t) {
+        const int count = static_cast<int>(parts[t].size());
+        switch (tasks[t].check) {
+        case Check::Overlap:
+            (options.presentation_mode ? counts.presentation : counts.overlap) += count;
+            break;
+        case Check::Upward:
+            counts.upward += count;
+            break;
+        case Check::CordObject:
+            counts.cord_object += count;
+            break;
+        case Check::CordCord:
+            counts.cord_cord += count;
+            break;
+        }
+        for (json& finding : parts[t]) {
+            findings.push_back(std::move(finding));
+        }
+    }
+    return make_result(std::move(findings), counts);
+}
+
+std::vector<size_t> cords_needing_route(const std::vector<LayoutObject>& objects,
+                                        const std::vector<LayoutCord>& cords, double eps) {
+    std::vector<geometry::Rect> rects;
+    rects.reserve(objects.size());
+    for (const LayoutObject& o : objects) {
+        rects.push_back(o.rect);
+    }
+    const geometry::GridIndex index = geometry::GridIndex::build(rects);
+    CrossingScan scan(objects, index, eps);
+
+    std::vector<size_t> flagged;
+    for (size_t c = 0; c < cords.size(); ++c) {
+        const LayoutCord& cord = cords[c];
+        bool found = false;
+        for (const geometry::Segment& seg : cord.segments()) {
+            found = geometry::segment_is_upward(seg, eps);
+            scan.for_each(seg, [&](size_t i) {
+                // As in cord_object_findings, a cord may touch its own endpoints
+                found = found || (objects[i].id != cord.src_id && objects[i].id != cord.dst_id);
+            });
+            if (found) {
+                break;
+            }
+        }
+        if (found) {
+            flagged.push_back(c);
+        }
+    }
+    return flagged;
+}
+
+// ============================================================================
+// Incremental checks (Max-API independent)
+// ============================================================================
+
+namespace {
+
+bool same_options(const LayoutCheckOptions& a, const LayoutCheckOptions& b) {
+    return a.epsilon == b.epsilon && a.check_upward == b.check_upward &&
+           a.check_overlap == b.check_overlap && a.check_cord_object == b.check_cord_object &&
+           a.check_cord_cord == b.check_cord_cord && a.presentation_mode == b.presentation_mode;
+}
+
+// NaN never compares equal, so an object or cord with a NaN coordinate is
+// simply re-checked on every call.
+bool same_point(const geometry::Point& a, const geometry::Point& b) {
+    return a.x == b.x && a.y == b.y;
+}
+
+bool same_rect(const geometry::Rect& a, const geometry::Rect& b) {
+    return same_point(a.origin, b.origin) && a.width == b.width && a.height == b.height;
+}
+
+std::vector<geometry::Point> route_of(const LayoutCord& cord) {
+    std::vector<geometry::Point> route;
+    route.reserve(cord.midpoints.size() + 2);
+    route.push_back(cord.start);
+    route.insert(route.end(), cord.midpoints.begin(), cord.midpoints.end());
+    route.push_back(cord.end);
+    return route;
+}
+
+bool same_route(const std::vector<geometry::Point>& route, const LayoutCord& cord) {
+    if (route.size() != cord.midpoints.size() + 2 || !same_point(route.front(), cord.start) ||
+        !same_point(route.back(), cord.end)) {
+        return false;
+    }
+    for (size_t k = 0; k < cord.midpoints.size(); ++k) {
+        if (!same_point(route[k + 1], cord.midpoints[k])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Call fn(index, segment) for each segment of @p cord's polyline, without
+// building the segment list.
+template <typename Fn>
+void for_each_segment(const LayoutCord& cord, Fn fn) {
+    geometry::Point prev = cord.start;
+    int index = 0;
+    for (const geometry::Point& m : cord.midpoints) {
+        fn(index++, geometry::Segment{prev, m});
+        prev = m;
+    }
+    fn(index, geometry::Segment{prev, cord.end});
+}
+
+bool erase_value(std::vector<LayoutKey>& keys, LayoutKey key) {
+    auto it = std::find(keys.begin(), keys.end(), key);
+    if (it == keys.end()) {
+        return false;
+    }
+    *it = keys.back();
+    keys.pop_back();
+    return true;
+}
+
+const std::string& text_of(const std::string& text) {
+    return text;
+}
+const std::string& text_of(const std::string* text) {
+    return *text;
+}
+
+// The findings of @p from that @p to lacks, counting duplicates, in order.
+template <typename From, typename To>
+std::vector<const std::string*> missing_from(const From& from, const To& to) {
+    std::unordered_map<std::string_view, int> remaining;
+    for (const auto& f : to) {
+        ++remaining[text_of(f)];
+    }
+    std::vector<const std::string*> missing;
+    for (const auto& f : from) {
+        auto it = remaining.find(text_of(f));
+        if (it != remaining.end() && it->second > 0) {
+            --it->second;
+        } else {
+            missing.push_back(&text_of(f));
+        }
+    }
+    return missing;
+}
+
+void write_findings(jsonwriter::JsonWriter& writer, const std::vector<const std::string*>& texts) {
+    writer.begin_array();
+    for (const std::string* text : texts) {
+        writer.raw_value(*text);
+    }
+    writer.end_array();
+}
+
+// Above this many rerouted segments, update_collinear sweeps the whole patch
+// instead of testing each of them against every segment.
+constexpr size_t kDirectCollinearSegments = 64;
+
+// Up to this many rerouted segments, update_crossings tests each against
+// every object rather than building a grid over them.
+constexpr size_t kDirectCrossingSegments = 32;
+
+}  // namespace
+
+size_t LayoutCheckCache::FindingIdHash::operator()(const FindingId& id) const {
+    uint64_t h = static_cast<uint64_t>(id.type);
+    for (uint64_t v : {id.a, id.b, static_cast<uint64_t>(id.segment)}) {
+        h = (h ^ v) * 0x100000001b3ull;
+        h ^= h >> 29;
+    }
+    return static_cast<size_t>(h);
+}
+
+void LayoutCheckCache::update(const LayoutSnapshot& snapshot, const LayoutCheckOptions& options,
+                              bool delta, jsonwriter::JsonWriter& writer) {
+    update(snapshot, options, delta, writer, parallel::WorkPool::shared());
+}
+
+json LayoutCheckCache::update(const LayoutSnapshot& snapshot, const LayoutCheckOptions& options,
+                              bool delta) {
+    return update(snapshot, options, delta, parallel::WorkPool::shared());
+}
+
+json LayoutCheckCache::update(const LayoutSnapshot& snapshot, const LayoutCheckOptions& options,
+                              bool delta, parallel::WorkPool& pool) {
+    jsonwriter::JsonWriter writer;
+    writer.begin_object();
+    update(snapshot, options, delta, writer, pool);
+    writer.end_object();
+    return json::parse(writer.str());
+}
+
+void LayoutCheckCache::update(const LayoutSnapshot& snapshot, const LayoutCheckOptions& options,
+                              bool delta, jsonwriter::JsonWriter& writer,
+                              parallel::WorkPool& pool) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const std::vector<LayoutObject>& objects = snapshot.objects;
+    const std::vector<LayoutCord>& cords = snapshot.cords;
+
+    object_pos_.clear();
+    cord_pos_.clear();
+    bool usable = snapshot.object_keys.size() == objects.size() &&
+                  snapshot.cord_keys.size() == cords.size();
+    for (size_t i = 0; usable && i < objects.size(); ++i) {
+        usable = object_pos_.emplace(snapshot.object_keys[i], i).second;
+    }
+    for (size_t c = 0; usable && c < cords.size(); ++c) {
+        usable = cord_pos_.emplace(snapshot.cord_keys[c], c).second;
+    }
+
+    ++revision_;
+    json summary;
+    std::vector<const std::string*> findings;
+    std::vector<std::string> uncached;
+    if (!usable) {
+        // Without an identity for every item nothing can be carried over
+        reset();
+        last_update_ = {objects.size(), cords.size(), true};
+        json result = run_layout_checks(objects, cords, options, pool);
+        summary = std::move(result["summary"]);
+        for (const json& f : result["findings"]) {
+            uncached.push_back(f.dump());
+        }
+        for (const std::string& text : uncached) {
+            findings.push_back(&text);
+        }
+    } else {
+        last_update_ = UpdateStats{};
+        if (!valid_ || !same_options(options, options_)) {
+            reset();
+            options_ = options;
+            valid_ = true;
+            last_update_.rebuilt = true;
+        }
+
+        // What changed since the last call. Anything shown in a finding bumps
+        // the item's version; only geometry changes need re-checking.
+        std::vector<bool> moved(objects.size(), false);
+        std::vector<LayoutKey> stale_objects;  // moved or gone: their hits are dropped
+        for (size_t i = 0; i < objects.size(); ++i) {
+            auto [it, added] = objects_.try_emplace(snapshot.object_keys[i]);
+            ObjectState& state = it->second;
+            const bool geometry_changed = added || !same_rect(state.rect, objects[i].rect);
+            std::string label = label_for(objects[i]);
+            if (geometry_changed || label != state.label) {
+                state.label = std::move(label);
+                state.version = ++next_version_;
+            }
+            if (geometry_changed) {
+                state.rect = objects[i].rect;
+                moved[i] = true;
+                ++last_update_.objects_changed;
+                if (!added) {
+                    stale_objects.push_back(it->first);
+                }
+            }
+        }
+        std::vector<LayoutKey> gone_objects;
+        for (const auto& [key, state] : objects_) {
+            if (object_pos_.count(key) == 0) {
+                gone_objects.push_back(key);
+                stale_objects.push_back(key);
+            }
+        }
+        last_update_.objects_changed += gone_objects.size();
+
+        std::vector<bool> rerouted(cords.size(), false);
+        std::vector<LayoutKey> stale_cords;
+        for (size_t c = 0; c < cords.size(); ++c) {
+            const LayoutCord& cord = cords[c];
+            auto [it, added] = cords_.try_emplace(snapshot.cord_keys[c]);
+            CordState& state = it->second;
+            const bool geometry_changed = added || !same_route(state.route, cord);
+            if (geometry_changed || state.src_varname != cord.src_varname ||
+                state.outlet != cord.outlet || state.dst_varname != cord.dst_varname ||
+                state.inlet != cord.inlet) {
+                state.src_varname = cord.src_varname;
+                state.outlet = cord.outlet;
+                state.dst_varname = cord.dst_varname;
+                state.inlet = cord.inlet;
+                state.version = ++next_version_;
+            }
+            if (geometry_changed) {
+                state.route = route_of(cord);
+                rerouted[c] = true;
+                ++last_update_.cords_changed;
+                if (!added) {
+                    stale_cords.push_back(it->first);
+                }
+            }
+        }
+        std::vector<LayoutKey> gone_cords;
+        for (const auto& [key, state] : cords_) {
+            if (cord_pos_.count(key) == 0) {
+                gone_cords.push_back(key);
+                stale_cords.push_back(key);
+            }
+        }
+        last_update_.cords_changed += gone_cords.size();
+
+        // The current items' states (unaffected by erasing the gone ones below)
+        object_state_.resize(objects.size());
+        for (size_t i = 0; i < objects.size(); ++i) {
+            object_state_[i] = &objects_.at(snapshot.object_keys[i]);
+        }
+        cord_state_.resize(cords.size());
+        for (size_t c = 0; c < cords.size(); ++c) {
+            cord_state_[c] = &cords_.at(snapshot.cord_keys[c]);
+        }
+
+        // Drop every hit that involves a changed item
+        for (LayoutKey key : stale_objects) {
+            ObjectState& state = objects_.at(key);
+            for (LayoutKey other : state.overlaps) {
+                erase_value(objects_.at(other).overlaps, key);
+            }
+            state.overlaps.clear();
+        }
+        if (!stale_objects.empty()) {
+            const std::set<LayoutKey> stale(stale_objects.begin(), stale_objects.end());
+            for (size_t c = 0; c < cords.size(); ++c) {
+                std::vector<Crossing>& crossings = cord_state_[c]->crossings;
+                crossings.erase(std::remove_if(crossings.begin(), crossings.end(),
+                                               [&](const Crossing& x) {
+                                                   return stale.count(x.object) > 0;
+                                               }),
+                                crossings.end());
+            }
+        }
+        for (LayoutKey key : stale_cords) {
+            CordState& state = cords_.at(key);
+            for (const auto& [other, first] : state.collinear) {
+                cords_.at(other).collinear.erase(key);
+            }
+            state.collinear.clear();
+            state.upward.clear();
+            state.crossings.clear();
+        }
+        for (LayoutKey key : gone_objects) {
+            objects_.erase(key);
+        }
+        for (LayoutKey key : gone_cords) {
+            cords_.erase(key);
+        }
+
+        // Re-test the changed items against the rest of the patch
+        const double eps = options.epsilon;
+        if (options.check_overlap) {
+            update_overlaps(snapshot, moved, eps);
+        }
+        if (!options.presentation_mode) {
+            if (options.check_upward) {
+                for (size_t c = 0; c < cords.size(); ++c) {
+                    if (!rerouted[c]) {
+                        continue;
+                    }
+                    std::vector<int>& upward = cord_state_[c]->upward;
+                    for_each_segment(cords[c], [&](int s, const geometry::Segment& seg) {
+                        if (geometry::segment_is_upward(seg, eps)) {
+                            upward.push_back(s);
+                        }
+                    });
+                }
+            }
+            if (options.check_cord_object) {
+                update_crossings(snapshot, moved, rerouted, eps, pool);
+            }
+            if (options.check_cord_cord) {
+                update_collinear(snapshot, rerouted, eps);
+            }
+        }
+        summary = render(snapshot, options, findings);
+    }
+
+    writer.key("clean");
+    writer.boolean(findings.empty());
+    writer.key("summary");
+    writer.value(summary);
+    if (delta) {
+        writer.key("delta");
+        writer.begin_object();
+        writer.key("base_revision");
+        writer.integer(static_cast<long long>(revision_ - 1));
+        writer.key("added");
+        write_findings(writer, missing_from(findings, last_findings_));
+        writer.key("removed");
+        write_findings(writer, missing_from(last_findings_, findings));
+        writer.end_object();
+    } else {
+        writer.key("findings");
+        write_findings(writer, findings);
+    }
+    writer.key("revision");
+    writer.integer(static_cast<long long>(revision_));
+
+    last_findings_.clear();
+    for (const std::string* text : findings) {
+        last_findings_.push_back(*text);
+    }
+    // Forget renderings of findings that are gone
+    for (auto it = rendered_.begin(); it != rendered_.end();) {
+        it = it->second.used == revision_ ? std::next(it) : rendered_.erase(it);
+    }
+}
+
+void LayoutCheckCache::reset() {
+    valid_ = false;
+    objects_.clear();
+    cords_.clear();
+    rendered_.clear();
+}
+
+// Overlaps of the moved objects with every object. When many moved, one
+// sweep over the whole patch is cheaper than a pass per moved object.
+void LayoutCheckCache::update_overlaps(const LayoutSnapshot& snapshot,
+                                       const std::vector<bool>& moved, double eps) {
+    const std::vector<LayoutKey>& keys = snapshot.object_keys;
+    const size_t n_moved = static_cast<size_t>(std::count(moved.begin(), moved.end(), true));
+    if (n_moved == 0) {
+        return;
+    }
+    std::vector<geometry::Rect> rects;
+    rects.reserve(snapshot.objects.size());
+    for (const LayoutObject& o : snapshot.objects) {
+        rects.push_back(o.rect);
+    }
+    auto link = [&](size_t i, size_t j) {
+        object_state_[i]->overlaps.push_back(keys[j]);
+        object_state_[j]->overlaps.push_back(keys[i]);
+    };
+
+    if (n_moved * 4 > rects.size()) {
+        for (const auto& [i, j] : geometry::overlapping_pairs(rects, eps)) {
+            if (moved[i] || moved[j]) {
+                link(i, j);
+            }
+        }
+        return;
+    }
+    const geometry::RectSoA all = geometry::RectSoA::from(rects);
+    geometry::BitMask hits;
+    for (size_t i = 0; i < rects.size(); ++i) {
+        if (!moved[i]) {
+            continue;
+        }
+        geometry::overlap_mask(rects[i], all, 0, rects.size(), eps, hits);
+        geometry::for_each_set_bit(hits, [&](size_t j) {
+            // A pair of moved objects is linked from its first member only
+            if (j != i && !(moved[j] && j < i)) {
+                link(i, j);
+            }
+        });
+    }
+}
+
+// Objects crossed by the rerouted cords (against every object, through the
+// grid as run_layout_checks does when there are many), then the moved objects
+// crossed by the cords that kept their route.
+void LayoutCheckCache::update_crossings(const LayoutSnapshot& snapshot,
+                                        const std::vector<bool>& moved,
+                                        const std::vector<bool>& rerouted, double eps,
+                                        parallel::WorkPool& pool) {
+    const std::vector<LayoutObject>& objects = snapshot.objects;
+    const std::vector<LayoutCord>& cords = snapshot.cords;
+    const std::vector<LayoutKey>& keys = snapshot.object_keys;
+
+    std::vector<size_t> changed, kept;
+    size_t changed_segments = 0;
+    for (size_t c = 0; c < cords.size(); ++c) {
+        (rerouted[c] ? changed : kept).push_back(c);
+        changed_segments += rerouted[c] ? cords[c].midpoints.size() + 1 : 0;
+    }
+    auto tasks_for = [](size_t count) { return (count + kCordsPerTask - 1) / kCordsPerTask; };
+    auto add = [&](size_t c, int s, const geometry::Segment& seg, size_t i) {
+        // The mask only says it crosses; the scalar test finds where.
+        geometry::Point entry{0.0, 0.0};
+        geometry::segment_intersects_rect(seg, objects[i].rect, eps, &entry);
+        cord_state_[c]->crossings.push_back({s, keys[i], entry});
+    };
+
+    if (changed_segments > kDirectCrossingSegments) {
+        std::vector<geometry::Rect> rects;
+        rects.reserve(objects.size());
+        for (const LayoutObject& o : objects) {
+            rects.push_back(o.rect);
+        }
+        const geometry::GridIndex index = geometry::GridIndex::build(rects);
+        pool.run(tasks_for(changed.size()), [&](size_t t) {
+            CrossingScan scan(objects, index, eps);
+            const size_t end = std::min(changed.size(), (t + 1) * kCordsPerTask);
+            for (size_t k = t * kCordsPerTask; k < end; ++k) {
+                const size_t c = changed[k];
+                for_each_segment(cords[c], [&](int s, const geometry::Segment& seg) {
+                    scan.for_each(seg, [&](size_t i) { add(c, s, seg, i); });
+                });
+            }
+        });
+    } else if (!changed.empty()) {
+        // Too few segments to pay for building the grid
+        geometry::RectSoA all;
+        all.reserve(objects.size());
+        for (const LayoutObject& o : objects) {
+            all.push_back(o.rect);
+        }
+        geometry::BitMask crossed;
+        for (size_t c : changed) {
+            for_each_segment(cords[c], [&](int s, const geometry::Segment& seg) {
+                geometry::segment_rect_mask(seg, all, 0, all.size(), eps, crossed);
+                geometry::for_each_set_bit(crossed, [&](size_t i) { add(c, s, seg, i); });
+            });
+        }
     }
 
-    // Cords are not drawn in presentation mode, so cord-based checks run only for
-    // the patching layout.
-    if (!options.presentation_mode) {
-        if (options.check_upward) {
-            n_upward += append_upward_findings(cords, eps, findings);
+    std::vector<size_t> moved_ids;
+    geometry::RectSoA moved_rects;
+    for (size_t i = 0; i < objects.size(); ++i) {
+        if (moved[i]) {
+            moved_ids.push_back(i);
+            moved_rects.push_back(objects[i].rect);
         }
-        if (options.check_cord_object) {
-            n_cord_object += append_cord_object_findings(objects, cords, eps, findings);
+    }
+    if (moved_ids.empty() || kept.empty()) {
+        return;
+    }
+    pool.run(tasks_for(kept.size()), [&](size_t t) {
+        geometry::BitMask crossed;
+        const size_t end = std::min(kept.size(), (t + 1) * kCordsPerTask);
+        for (size_t k = t * kCordsPerTask; k < end; ++k) {
+            const size_t c = kept[k];
+            for_each_segment(cords[c], [&](int s, const geometry::Segment& seg) {
+                geometry::segment_rect_mask(seg, moved_rects, 0, moved_ids.size(), eps, crossed);
+                geometry::for_each_set_bit(crossed,
+                                           [&](size_t m) { add(c, s, seg, moved_ids[m]); });
+            });
         }
-        if (options.check_cord_cord) {
-            n_cord_cord += append_cord_cord_findings(cords, eps, findings);
+    });
+}
+
+// Collinear overlaps between a rerouted cord and any other cord. A few
+// rerouted segments are tested against every segment directly; many go
+// through the bucketed sweep over the whole patch.
+void LayoutCheckCache::update_collinear(const LayoutSnapshot& snapshot,
+                                        const std::vector<bool>& rerouted, double eps) {
+    const std::vector<LayoutCord>& cords = snapshot.cords;
+    size_t n_segments = 0, n_rerouted = 0;
+    for (size_t c = 0; c < cords.size(); ++c) {
+        n_segments += cords[c].midpoints.size() + 1;
+        if (rerouted[c]) {
+            n_rerouted += cords[c].midpoints.size() + 1;
         }
     }
+    if (n_rerouted == 0) {
+        return;
+    }
+
+    // Each cord keeps the lowest (own, partner) segment pair per partner
+    auto keep_first = [](CordState& state, LayoutKey partner, std::pair<int, int> pair) {
+        auto [it, added] = state.collinear.try_emplace(partner, pair);
+        if (!added && pair < it->second) {
+            it->second = pair;
+        }
+    };
+    auto record = [&](size_t c, int sc, size_t d, int sd) {
+        keep_first(*cord_state_[c], snapshot.cord_keys[d], {sc, sd});
+        keep_first(*cord_state_[d], snapshot.cord_keys[c], {sd, sc});
+    };
 
-    return {{"clean", findings.empty()},
-            {"summary",
-             {{"upward", n_upward},
-              {"overlap", n_overlap},
-              {"cord_object", n_cord_object},
-              {"cord_cord", n_cord_cord},
-              {"presentation_overlap", n_presentation}}},
-            {"findings", findings}};
+    if (n_rerouted > kDirectCollinearSegments) {
+        // Every segment of the patch, with its cord and its index within the cord
+        std::vector<geometry::Segment> segs;
+        std::vector<size_t> owner;
+        std::vector<int> local;
+        segs.reserve(n_segments);
+        for (size_t c = 0; c < cords.size(); ++c) {
+            for_each_segment(cords[c], [&](int s, const geometry::Segment& seg) {
+                segs.push_back(seg);
+                owner.push_back(c);
+                local.push_back(s);
+            });
+        }
+        for (const auto& [a, b] : geometry::collinear_overlap_pairs(segs, eps)) {
+            if (owner[a] != owner[b] && (rerouted[owner[a]] || rerouted[owner[b]])) {
+                record(owner[a], local[a], owner[b], local[b]);
+            }
+        }
+        return;
+    }
+    for (size_t c = 0; c < cords.size(); ++c) {
+        if (!rerouted[c]) {
+            continue;
+        }
+        const std::vector<geometry::Segment> own = cords[c].segments();
+        for (size_t d = 0; d < cords.size(); ++d) {
+            // A pair of rerouted cords is recorded from the first one only
+            if (d == c || (rerouted[d] && d < c)) {
+                continue;
+            }
+            for_each_segment(cords[d], [&](int sd, const geometry::Segment& seg) {
+                for (size_t sc = 0; sc < own.size(); ++sc) {
+                    if (geometry::segments_overlap_collinear(own[sc], seg, eps)) {
+                        record(c, static_cast<int>(sc), d, sd);
+                    }
+                }
+            });
+        }
+    }
+}
+
+template <typename Make>
+const std::string& LayoutCheckCache::rendered(const FindingId& id, uint64_t version_a,
+                                              uint64_t version_b, Make make) {
+    auto [it, added] = rendered_.try_emplace(id);
+    RenderedFinding& r = it->second;
+    if (added || r.version_a != version_a || r.version_b != version_b) {
+        r.version_a = version_a;
+        r.version_b = version_b;
+        r.text = make().dump();
+    }
+    r.used = revision_;
+    return r.text;
+}
+
+// The findings of the cached hits, in run_layout_checks' order: overlaps by
+// object pair, upward by cord and segment, cord_object by cord, segment and
+// object, cord_cord by the first overlapping segment pair. Returns the summary.
+json LayoutCheckCache::render(const LayoutSnapshot& snapshot, const LayoutCheckOptions& options,
+                              std::vector<const std::string*>& findings) {
+    const std::vector<LayoutObject>& objects = snapshot.objects;
+    const std::vector<LayoutCord>& cords = snapshot.cords;
+    const bool presentation = options.presentation_mode;
+    FindingCounts counts;
+
+    const std::vector<ObjectState*>& object_state = object_state_;
+    const std::vector<CordState*>& cord_state = cord_state_;
+
+    if (options.check_overlap) {
+        std::vector<size_t> partners;
+        for (size_t i = 0; i < objects.size(); ++i) {
+            partners.clear();
+            for (LayoutKey other : object_state[i]->overlaps) {
+                const size_t j = object_pos_.at(other);
+                if (j > i) {
+                    partners.push_back(j);
+                }
+            }
+            std::sort(partners.begin(), partners.end());
+            for (size_t j : partners) {
+                const FindingId id{FindingType::Overlap, snapshot.object_keys[i],
+                                   snapshot.object_keys[j], 0};
+                findings.push_back(&rendered(
+                    id, object_state[i]->version, object_state[j]->version,
+                    [&] { return overlap_finding(objects[i], objects[j], presentation); }));
+                ++(presentation ? counts.presentation : counts.overlap);
+            }
+        }
+    }
+
+    if (!presentation && options.check_upward) {
+        for (size_t c = 0; c < cords.size(); ++c) {
+            for (int s : cord_state[c]->upward) {
+                const FindingId id{FindingType::Upward, snapshot.cord_keys[c], 0, s};
+                findings.push_back(&rendered(id, cord_state[c]->version, 0, [&] {
+                    const geometry::Segment seg = cords[c].segments()[s];
+                    return upward_finding(cords[c], seg.a.y, seg.b.y);
+                }));
+                ++counts.upward;
+            }
+        }
+    }
+
+    if (!presentation && options.check_cord_object) {
+        struct Hit {
+            int segment;
+            size_t object;
+            geometry::Point entry;
+        };
+        std::vector<Hit> hits;
+        std::vector<int> flagged;  // a cord crosses few objects
+        for (size_t c = 0; c < cords.size(); ++c) {
+            const LayoutCord& cord = cords[c];
+            hits.clear();
+            for (const Crossing& x : cord_state[c]->crossings) {
+                hits.push_back({x.segment, object_pos_.at(x.object), x.entry});
+            }
+            std::sort(hits.begin(), hits.end(), [](const Hit& a, const Hit& b) {
+                return std::tie(a.segment, a.object) < std::tie(b.segment, b.object);
+            });
+            flagged.clear();
+            for (const Hit& hit : hits) {
+                const LayoutObject& obj = objects[hit.object];
+                if (obj.id == cord.src_id || obj.id == cord.dst_id ||
+                    std::find(flagged.begin(), flagged.end(), obj.id) != flagged.end()) {
+                    continue;
+                }
+                flagged.push_back(obj.id);
+                const FindingId id{FindingType::CordObject, snapshot.cord_keys[c],
+                                   snapshot.object_keys[hit.object], hit.segment};
+                findings.push_back(
+                    &rendered(id, cord_state[c]->version, object_state[hit.object]->version,
+                              [&] { return cord_object_finding(cord, obj, hit.entry); }));
+                ++counts.cord_object;
+            }
+        }
+    }
+
+    if (!presentation && options.check_cord_cord) {
+        // Index of each cord's first segment in the patch-wide segment list
+        std::vector<size_t> first(cords.size());
+        size_t n_segments = 0;
+        for (size_t c = 0; c < cords.size(); ++c) {
+            first[c] = n_segments;
+            n_segments += cords[c].midpoints.size() + 1;
+        }
+        std::vector<CordPair> pairs;
+        for (size_t c = 0; c < cords.size(); ++c) {
+            for (const auto& [other, segments] : cord_state[c]->collinear) {
+                const size_t d = cord_pos_.at(other);
+                if (d > c) {
+                    pairs.push_back({c, d, static_cast<int>(first[c]) + segments.first,
+                                     static_cast<int>(first[d]) + segments.second});
+                }
+            }
+        }
+        std::sort(pairs.begin(), pairs.end(), [](const CordPair& x, const CordPair& y) {
+            return std::tie(x.a, x.b) < std::tie(y.a, y.b);
+        });
+        for (const CordPair& pair : pairs) {
+            const FindingId id{FindingType::CordCord, snapshot.cord_keys[pair.ca],
+                               snapshot.cord_keys[pair.cb], 0};
+            findings.push_back(
+                &rendered(id, cord_state[pair.ca]->version, cord_state[pair.cb]->version,
+                          [&] { return cord_cord_finding(cords[pair.ca], cords[pair.cb]); }));
+            ++counts.cord_cord;
+        }
+    }
+    return make_summary(counts);
 }
 
 }  // namespace LayoutTools
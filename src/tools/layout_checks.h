@@ -8,6 +8,9 @@
     then run_layout_checks() applies the geometric predicates from
     src/utils/geometry.h and returns the structured findings list.
 
+    LayoutCheckCache keeps one patch's last geometry and check results so that
+    repeated validate_layout calls only re-check what changed in between.
+
     @ingroup maxmcp
 */
 
@@ -16,11 +19,23 @@
 
 #include "utils/geometry.h"
 
+#include <cstdint>
+#include <mutex>
 #include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include <nlohmann/json.hpp>
 
+namespace jsonwriter {
+class JsonWriter;
+}
+
+namespace parallel {
+class WorkPool;
+}
+
 namespace LayoutTools {
 
 using json = nlohmann::json;
@@ -67,6 +82,22 @@ struct LayoutCord {
     }
 };
 
+/// Identity of a box or patchline across calls (the SDK glue uses its pointer).
+using LayoutKey = uint64_t;
+
+/**
+ * @brief Everything validate_layout extracts from a patcher in one pass.
+ *
+ * @c object_keys and @c cord_keys run parallel to @c objects and @c cords and
+ * identify each one across extractions; keys must be unique within a snapshot.
+ */
+struct LayoutSnapshot {
+    std::vector<LayoutObject> objects;
+    std::vector<LayoutCord> cords;
+    std::vector<LayoutKey> object_keys;
+    std::vector<LayoutKey> cord_keys;
+};
+
 /**
  * @brief Which checks to run and with what tolerance.
  */
@@ -92,6 +123,11 @@ struct LayoutCheckOptions {
  * response body { clean, summary, findings }. The geometric decisions are
  * delegated to src/utils/geometry.h.
  *
+ * The checks run concurrently on parallel::WorkPool::shared(), and the larger
+ * ones are split into ranges of objects, cords or candidate pairs. Findings
+ * are merged in a fixed order (overlap, upward, cord_object, cord_cord, each in
+ * scan order), so the result is the same on any number of threads.
+ *
  * @param objects Objects participating in the checks (rects for the active mode)
  * @param cords   Patchcords participating in the checks
  * @param options Enabled checks and tolerance
@@ -100,6 +136,158 @@ struct LayoutCheckOptions {
 json run_layout_checks(const std::vector<LayoutObject>& objects,
                        const std::vector<LayoutCord>& cords, const LayoutCheckOptions& options);
 
+/**
+ * @brief run_layout_checks() on a caller-supplied pool (tests, benchmarks).
+ */
+json run_layout_checks(const std::vector<LayoutObject>& objects,
+                       const std::vector<LayoutCord>& cords, const LayoutCheckOptions& options,
+                       parallel::WorkPool& pool);
+
+/**
+ * @brief Indices of the cords that run_layout_checks() would name in an
+ *        upward or cord_object finding, ascending.
+ *
+ * These are the cords route_cords reroutes when it is not given a list.
+ */
+std::vector<size_t> cords_needing_route(const std::vector<LayoutObject>& objects,
+                                        const std::vector<LayoutCord>& cords, double eps);
+
+/**
+ * @brief One patch's last checked geometry and what the checks found in it,
+ *        so the next validate_layout only re-checks what changed.
+ *
+ * Results are kept as hits between keyed items: overlapping object pairs,
+ * upward segments of each cord, objects crossed by each cord segment, and the
+ * first collinear segment pair of each cord pair. A hit depends only on the
+ * geometry of the items in it, so update() compares each object's rect and
+ * each cord's polyline with the cached one, drops the hits of the items that
+ * changed, appeared or disappeared, and tests only those items against the
+ * rest of the patch. Findings are rendered from the hits in
+ * run_layout_checks() order; each finding's serialized text is kept and
+ * reused until one of the items it names is moved, renamed or renumbered.
+ *
+ * Changing the options (mode, epsilon, checks) discards everything. Calls are
+ * serialized, so one cache may be shared between request threads.
+ */
+class LayoutCheckCache {
+  public:
+    /// What the last update() had to re-check.
+    struct UpdateStats {
+        size_t objects_changed = 0;  ///< new, moved or resized, or removed
+        size_t cords_changed = 0;    ///< new, rerouted, or removed
+        bool rebuilt = false;        ///< nothing could be reused
+    };
+
+    /**
+     * @brief Bring the cache up to date with @p snapshot and write the report
+     *        as members of the JSON object open in @p writer.
+     *
+     * The report is run_layout_checks(snapshot.objects, snapshot.cords, options)
+     * plus a "revision" counter that goes up on every call. With @p delta the
+     * "findings" array is replaced by "delta": { base_revision, added, removed },
+     * the findings that appeared and disappeared since the previous call.
+     * Snapshots with duplicate keys are checked from scratch and not cached.
+     */
+    void update(const LayoutSnapshot& snapshot, const LayoutCheckOptions& options, bool delta,
+                jsonwriter::JsonWriter& writer);
+    void update(const LayoutSnapshot& snapshot, const LayoutCheckOptions& options, bool delta,
+                jsonwriter::JsonWriter& writer, parallel::WorkPool& pool);
+
+    /**
+     * @brief update() returning the report as a JSON object (tests, benchmarks).
+     */
+    json update(const LayoutSnapshot& snapshot, const LayoutCheckOptions& options,
+                bool delta = false);
+    json update(const LayoutSnapshot& snapshot, const LayoutCheckOptions& options, bool delta,
+                parallel::WorkPool& pool);
+
+    /// Stats of the most recent update() (read it from the same thread).
+    const UpdateStats& last_update() const {
+        return last_update_;
+    }
+
+  private:
+    // Versions change whenever anything a finding shows about the item does.
+    struct ObjectState {
+        geometry::Rect rect;
+        std::string label;
+        uint64_t version = 0;
+        std::vector<LayoutKey> overlaps;  // objects whose rects overlap this one
+    };
+
+    // An object a cord segment passes through (the cord's endpoints included;
+    // they are skipped when rendering).
+    struct Crossing {
+        int segment;
+        LayoutKey object;
+        geometry::Point entry;
+    };
+
+    struct CordState {
+        std::vector<geometry::Point> route;  // start, midpoints..., end
+        std::string src_varname;
+        long outlet = 0;
+        std::string dst_varname;
+        long inlet = 0;
+        uint64_t version = 0;
+        std::vector<int> upward;          // upward segment indices, ascending
+        std::vector<Crossing> crossings;  // in no particular order
+        // Partner cord -> lowest (own segment, partner segment) pair that overlaps
+        std::unordered_map<LayoutKey, std::pair<int, int>> collinear;
+    };
+
+    // A finding by the items it names: the two objects of an overlap, a cord
+    // and segment (upward), a cord, object and segment (cord_object), or two
+    // cords (cord_cord). Pairs are in patch order.
+    enum class FindingType { Overlap, Upward, CordObject, CordCord };
+    struct FindingId {
+        FindingType type;
+        LayoutKey a, b;
+        int segment;
+
+        bool operator==(const FindingId& o) const {
+            return type == o.type && a == o.a && b == o.b && segment == o.segment;
+        }
+    };
+    struct FindingIdHash {
+        size_t operator()(const FindingId& id) const;
+    };
+    struct RenderedFinding {
+        uint64_t version_a, version_b;  // of the items when it was rendered
+        uint64_t used;                  // last revision that reported it
+        std::string text;
+    };
+
+    void reset();
+    void update_overlaps(const LayoutSnapshot& snapshot, const std::vector<bool>& moved,
+                         double eps);
+    void update_crossings(const LayoutSnapshot& snapshot, const std::vector<bool>& moved,
+                          const std::vector<bool>& rerouted, double eps, parallel::WorkPool& pool);
+    void update_collinear(const LayoutSnapshot& snapshot, const std::vector<bool>& rerouted,
+                          double eps);
+    json render(const LayoutSnapshot& snapshot, const LayoutCheckOptions& options,
+                std::vector<const std::string*>& findings);
+    template <typename Make>
+    const std::string& rendered(const FindingId& id, uint64_t version_a, uint64_t version_b,
+                                Make make);
+
+    std::mutex mutex_;
+    bool valid_ = false;
+    LayoutCheckOptions options_;
+    std::unordered_map<LayoutKey, ObjectState> objects_;
+    std::unordered_map<LayoutKey, CordState> cords_;
+    std::unordered_map<FindingId, RenderedFinding, FindingIdHash> rendered_;
+    // Position and state of each item of the snapshot being processed
+    std::unordered_map<LayoutKey, size_t> object_pos_;
+    std::unordered_map<LayoutKey, size_t> cord_pos_;
+    std::vector<ObjectState*> object_state_;
+    std::vector<CordState*> cord_state_;
+    std::vector<std::string> last_findings_;  // last reported, for deltas
+    uint64_t next_version_ = 0;
+    uint64_t revision_ = 0;
+    UpdateStats last_update_;
+};
+
 }  // namespace LayoutTools
 
 #endif  // LAYOUT_CHECKS_H
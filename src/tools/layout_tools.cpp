@@ -3,9 +3,11 @@
     MaxMCP - Layout Validation MCP Tools Implementation
 
     Max-facing glue for validate_layout: walks a patcher for object rects and
-    patchline geometry, then runs the pure checks in run_layout_checks() (defined
-    in layout_checks.cpp, which delegates to src/utils/geometry.h). Read-only —
-    never mutates the patch.
+    patchline geometry on the main thread, then runs the pure checks on the
+    request thread through the patch's LayoutCheckCache (layout_checks.cpp,
+    which delegates to src/utils/geometry.h), so a repeated call only
+    re-checks the boxes and cords that changed. Read-only — never mutates the
+    patch.
 
     @ingroup maxmcp
 */
@@ -13,9 +15,19 @@
 #include "layout_tools.h"
 
 #include "tool_common.h"
-
+#include "utility_tools.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
 #include <set>
 #include <string>
+#include <tuple>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -28,11 +40,16 @@
 #endif
 
 #include "maxmcp.h"
+#include "utils/auto_layout.h"
 #include "utils/console_logger.h"
+#include "utils/cord_router.h"
 #include "utils/geometry.h"
 #include "utils/io_geometry.h"
+#include "utils/json_writer.h"
 #include "utils/patch_helpers.h"
 #include "utils/patch_registry.h"
+#include "utils/spatial_index.h"
+#include "utils/symbols.h"
 
 namespace LayoutTools {
 
@@ -46,6 +63,7 @@ struct t_validate_layout_data {
     t_maxmcp* patch;
     LayoutCheckOptions options;
     std::vector<std::string> scope_varnames;
+    std::shared_ptr<LayoutSnapshot> snapshot;
     DeferredResult* deferred_result;
 };
 
@@ -79,6 +97,80 @@ struct t_align_objects_data {
     DeferredResult* deferred_result;
 };
 
+// Exactly one of rect / near is set.
+struct t_objects_in_region_data {
+    t_maxmcp* patch;
+    std::optional<geometry::Rect> rect;
+    bool contain;  // rect: whole box inside instead of any overlap
+    std::optional<geometry::Point> near;
+    size_t count;  // near: how many neighbours
+    bool presentation;
+    DeferredResult* deferred_result;
+};
+
+// What auto_layout reads on the main thread: the boxes to lay out (every box,
+// or the named ones) and the cords between them.
+struct AutoLayoutInput {
+    std::vector<t_object*> boxes;
+    std::vector<int> indices;  // patcher index per box
+    std::vector<std::string> varnames;
+    std::vector<geometry::LayeredNode> nodes;
+    std::vector<geometry::LayeredEdge> edges;
+    std::vector<geometry::Rect> others;  // boxes left alone when laying out a subset
+};
+
+struct t_auto_layout_data {
+    t_maxmcp* patch;
+    std::vector<std::string> varnames;  // empty: the whole patch
+    std::shared_ptr<AutoLayoutInput> input;
+    DeferredResult* deferred_result;
+};
+
+// New positions for auto_layout's apply pass, parallel to boxes.
+struct t_move_boxes_data {
+    t_maxmcp* patch;
+    std::vector<t_object*> boxes;
+    std::vector<geometry::Point> positions;
+    DeferredResult* deferred_result;
+};
+
+// One cord route_cords was asked for, matched against the patch by endpoints.
+struct CordRequest {
+    std::string src_varname;
+    long outlet;
+    std::string dst_varname;
+    long inlet;
+};
+
+// The nub layout of one box, for the exact outlet/inlet positions.
+struct CordBoxNubs {
+    int inlets;
+    int outlets;
+    bool draw_first_in;
+    std::string maxclass;
+};
+
+// What route_cords reads on the main thread: every box and cord of the
+// patching layout (as validate_layout sees them) plus the boxes' nubs.
+struct RouteCordsInput {
+    LayoutSnapshot snapshot;
+    std::vector<CordBoxNubs> nubs;  // parallel to snapshot.objects
+};
+
+struct t_route_cords_data {
+    t_maxmcp* patch;
+    std::shared_ptr<RouteCordsInput> input;
+    DeferredResult* deferred_result;
+};
+
+// New midpoints for route_cords' apply pass, parallel to lines (flat x, y).
+struct t_set_midpoints_batch_data {
+    t_maxmcp* patch;
+    std::vector<t_object*> lines;
+    std::vector<std::vector<double>> coords;
+    DeferredResult* deferred_result;
+};
+
 // ============================================================================
 // Production Code (Max SDK required)
 // ============================================================================
@@ -100,7 +192,8 @@ static std::vector<LayoutObject> extract_layout_objects(t_object* patcher,
                                                         const LayoutCheckOptions& options,
                                                         const std::set<std::string>& scope,
                                                         std::unordered_map<t_object*, int>& id_of,
-                                                        std::set<int>& included_ids) {
+                                                        std::set<int>& included_ids,
+                                                        std::vector<LayoutKey>& keys) {
     const bool presentation = options.presentation_mode;
     const bool use_scope = !scope.empty();
 
@@ -110,7 +203,7 @@ static std::vector<LayoutObject> extract_layout_objects(t_object* patcher,
          box = jbox_get_nextobject(box), ++index) {
         id_of[box] = index;
 
-        const bool in_presentation = object_attr_getlong(box, gensym("presentation")) != 0;
+        const bool in_presentation = object_attr_getlong(box, Symbols::presentation) != 0;
         if (presentation && !in_presentation) {
             continue;  // presentation mode only considers objects shown there
         }
@@ -134,6 +227,7 @@ static std::vector<LayoutObject> extract_layout_objects(t_object* patcher,
                            maxclass_str,
                            {rect.x, rect.y, rect.width, rect.height},
                            in_presentation});
+        keys.push_back(reinterpret_cast<uintptr_t>(box));
         included_ids.insert(index);
     }
     return objects;
@@ -145,7 +239,8 @@ static std::vector<LayoutObject> extract_layout_objects(t_object* patcher,
 static std::vector<LayoutCord> extract_layout_cords(t_object* patcher,
                                                     const std::unordered_map<t_object*, int>& id_of,
                                                     const std::set<int>& included_ids,
-                                                    bool use_scope) {
+                                                    bool use_scope,
+                                                    std::vector<LayoutKey>& keys) {
     std::vector<LayoutCord> cords;
     for (t_object* line = jpatcher_get_firstline(patcher); line;
          line = jpatchline_get_nextline(line)) {
@@ -172,7 +267,7 @@ static std::vector<LayoutCord> extract_layout_cords(t_object* patcher,
             long num_values = num_midpoints * 2;
             std::vector<double> coords(num_values, 0.0);
             long count =
-                object_attr_getdouble_array(line, gensym("midpoints"), num_values, coords.data());
+                object_attr_getdouble_array(line, Symbols::midpoints, num_values, coords.data());
             for (long i = 0; i + 1 < count; i += 2) {
                 midpoints.push_back({coords[i], coords[i + 1]});
             }
@@ -187,14 +282,15 @@ static std::vector<LayoutCord> extract_layout_cords(t_object* patcher,
                          {sx, sy},
                          {ex, ey},
                          std::move(midpoints)});
+        keys.push_back(reinterpret_cast<uintptr_t>(line));
     }
     return cords;
 }
 
 /**
  * Deferred callback for validate_layout.
- * Executes on the Max main thread via defer(). Extracts object rects and
- * patchline geometry into plain structs, then runs the pure checks.
+ * Executes on the Max main thread via defer(). Only extracts object rects and
+ * patchline geometry into plain structs; the checks run on the request thread.
  */
 static void validate_layout_deferred(t_maxmcp* patch, t_symbol* s, long argc, t_atom* argv) {
     VALIDATE_DEFERRED_ARGS("validate_layout_deferred");
@@ -203,21 +299,40 @@ static void validate_layout_deferred(t_maxmcp* patch, t_symbol* s, long argc, t_
     t_object* patcher = data->patch->patcher;
     const std::set<std::string> scope(data->scope_varnames.begin(), data->scope_varnames.end());
 
+    LayoutSnapshot& snapshot = *data->snapshot;
+
     std::unordered_map<t_object*, int> id_of;
     std::set<int> included_ids;
-    std::vector<LayoutObject> objects =
-        extract_layout_objects(patcher, data->options, scope, id_of, included_ids);
+    snapshot.objects = extract_layout_objects(patcher, data->options, scope, id_of, included_ids,
+                                              snapshot.object_keys);
 
     // Cords are not drawn in presentation mode, so only the patching layout needs them.
-    std::vector<LayoutCord> cords;
     if (!data->options.presentation_mode) {
-        cords = extract_layout_cords(patcher, id_of, included_ids, !scope.empty());
+        snapshot.cords = extract_layout_cords(patcher, id_of, included_ids, !scope.empty(),
+                                              snapshot.cord_keys);
     }
 
-    json result = run_layout_checks(objects, cords, data->options);
-    result["patch_id"] = data->patch->patch_id;
+    COMPLETE_DEFERRED(data, json::object());
+}
+
+// validate_layout's cached results, one per patch. Entries of patches that are
+// no longer registered are dropped when another patch gets its cache.
+static std::mutex layout_caches_mutex;
+static std::unordered_map<std::string, std::shared_ptr<LayoutCheckCache>> layout_caches;
 
-    COMPLETE_DEFERRED(data, result);
+static std::shared_ptr<LayoutCheckCache> layout_cache_for(const std::string& patch_id) {
+    std::lock_guard<std::mutex> lock(layout_caches_mutex);
+    auto it = layout_caches.find(patch_id);
+    if (it != layout_caches.end()) {
+        return it->second;
+    }
+    for (auto stale = layout_caches.begin(); stale != layout_caches.end();) {
+        stale = PatchRegistry::find_patch(stale->first) ? std::next(stale)
+                                                        : layout_caches.erase(stale);
+    }
+    auto cache = std::make_shared<LayoutCheckCache>();
+    layout_caches.emplace(patch_id, cache);
+    return cache;
 }
 
 /**
@@ -263,13 +378,28 @@ static json execute_validate_layout(const json& params) {
         }
     }
 
+    auto snapshot = std::make_shared<LayoutSnapshot>();
     auto* deferred_result = new DeferredResult();
-    auto* data =
-        new t_validate_layout_data{patch, options, std::move(scope_varnames), deferred_result};
+    auto* data = new t_validate_layout_data{patch, options, std::move(scope_varnames), snapshot,
+                                            deferred_result};
+
+    json extracted = ToolCommon::run_deferred(
+        patch, (method)validate_layout_deferred, "validate_layout", data,
+        ToolCommon::HEAVY_OPERATION_TIMEOUT, "extracting the layout",
+        ToolCommon::DeferredWrap::Raw);
+    if (extracted.contains("error")) {
+        return extracted;
+    }
 
-    return ToolCommon::run_deferred(patch, (method)validate_layout_deferred, "validate_layout",
-                                    data, ToolCommon::HEAVY_OPERATION_TIMEOUT, "validating layout",
-                                    ToolCommon::DeferredWrap::Always);
+    // Findings are cached as serialized text, so the report is written directly
+    const bool delta = params.value("delta", false);
+    jsonwriter::JsonWriter writer;
+    writer.begin_object();
+    writer.key("patch_id");
+    writer.string(patch_id);
+    layout_cache_for(patch_id)->update(*snapshot, options, delta, writer);
+    writer.end_object();
+    return {{"result", ToolCommon::make_raw_result(writer.take())}};
 }
 
 /**
@@ -600,6 +730,605 @@ static json execute_align_objects(const json& params) {
                                     ToolCommon::DeferredWrap::OnSuccess);
 }
 
+/**
+ * Deferred callback for get_objects_in_region.
+ * Answers the rect or nearest-neighbour query with one filtered scan over the
+ * rects of the active mode. A single query reads every rect anyway, so
+ * building a spatial index for it would only add work.
+ */
+static void objects_in_region_deferred(t_maxmcp* patch, t_symbol* s, long argc, t_atom* argv) {
+    VALIDATE_DEFERRED_ARGS("objects_in_region_deferred");
+    EXTRACT_DEFERRED_DATA_WITH_RESULT(t_objects_in_region_data, data, argv);
+
+    struct Hit {
+        t_object* box;
+        int index;
+        geometry::Rect rect;
+        double distance;
+    };
+    std::vector<Hit> hits;
+    int index = 0;
+    for (t_object* box = jpatcher_get_firstobject(data->patch->patcher); box;
+         box = jbox_get_nextobject(box), ++index) {
+        // Presentation space only holds the objects shown there
+        if (data->presentation && object_attr_getlong(box, Symbols::presentation) == 0) {
+            continue;
+        }
+        t_rect r;
+        if (data->presentation) {
+            jbox_get_presentation_rect(box, &r);
+        } else {
+            jbox_get_patching_rect(box, &r);
+        }
+        geometry::Rect rect{r.x, r.y, r.width, r.height};
+
+        if (data->near) {
+            hits.push_back({box, index, rect, geometry::point_rect_distance(*data->near, rect)});
+        } else if (data->contain ? rect.origin.x >= data->rect->origin.x &&
+                                       rect.origin.y >= data->rect->origin.y &&
+                                       rect.right() <= data->rect->right() &&
+                                       rect.bottom() <= data->rect->bottom()
+                                 : geometry::aabb_overlap(rect, *data->rect, 0.0)) {
+            hits.push_back({box, index, rect, 0.0});
+        }
+    }
+
+    if (data->near) {
+        // Closest first, patcher order among equals
+        auto by_distance = [](const Hit& a, const Hit& b) {
+            return a.distance != b.distance ? a.distance < b.distance : a.index < b.index;
+        };
+        const size_t keep = std::min(data->count, hits.size());
+        std::partial_sort(hits.begin(), hits.begin() + keep, hits.end(), by_distance);
+        hits.resize(keep);
+    }
+
+    json objects = json::array();
+    for (const Hit& hit : hits) {
+        json obj = {{"index", hit.index},
+                    {"maxclass", PatchHelpers::get_box_maxclass(hit.box, "unknown")},
+                    {"rect", rect_to_json(hit.rect)}};
+        std::string varname = PatchHelpers::get_box_varname(hit.box);
+        if (!varname.empty()) {
+            obj["varname"] = varname;
+        }
+        if (data->near) {
+            obj["distance"] = hit.distance;
+        }
+        objects.push_back(std::move(obj));
+    }
+
+    COMPLETE_DEFERRED(data, (json{{"patch_id", data->patch->patch_id},
+                                  {"objects", objects},
+                                  {"count", objects.size()}}));
+}
+
+/**
+ * Execute get_objects_in_region tool.
+ */
+static json execute_get_objects_in_region(const json& params) {
+    std::string patch_id = params.value("patch_id", "");
+    if (patch_id.empty()) {
+        return ToolCommon::missing_param_error("patch_id");
+    }
+
+    auto invalid = [](const std::string& message) {
+        return ToolCommon::make_error(ToolCommon::ErrorCode::INVALID_PARAMS, message);
+    };
+    auto numbers = [](const json& v, size_t n) {
+        return v.is_array() && v.size() == n &&
+               std::all_of(v.begin(), v.end(), [](const json& x) { return x.is_number(); });
+    };
+
+    const bool has_rect = params.contains("rect");
+    const bool has_near = params.contains("near");
+    if (has_rect == has_near) {
+        return invalid("Pass either 'rect' or 'near'");
+    }
+
+    std::optional<geometry::Rect> rect;
+    std::optional<geometry::Point> near;
+    bool contain = false;
+    size_t count = 1;
+    if (has_rect) {
+        const json& r = params["rect"];
+        if (!numbers(r, 4) || r[2].get<double>() < 0 || r[3].get<double>() < 0) {
+            return invalid("rect must be [x, y, width, height]");
+        }
+        rect = geometry::Rect{r[0].get<double>(), r[1].get<double>(), r[2].get<double>(),
+                              r[3].get<double>()};
+        const std::string mode = params.value("mode", "intersect");
+        if (mode != "intersect" && mode != "contain") {
+            return invalid("mode must be 'intersect' or 'contain'");
+        }
+        contain = mode == "contain";
+    } else {
+        const json& p = params["near"];
+        if (!numbers(p, 2)) {
+            return invalid("near must be [x, y]");
+        }
+        near = geometry::Point{p[0].get<double>(), p[1].get<double>()};
+        if (params.contains("count")) {
+            if (!params["count"].is_number_integer() || params["count"].get<long long>() < 1) {
+                return invalid("count must be a positive integer");
+            }
+            count = params["count"].get<size_t>();
+        }
+    }
+
+    const std::string space = params.value("space", "patching");
+    if (space != "patching" && space != "presentation") {
+        return invalid("space must be 'patching' or 'presentation'");
+    }
+
+    t_maxmcp* patch = PatchRegistry::find_patch(patch_id);
+    if (!patch) {
+        return ToolCommon::patch_not_found_error(patch_id);
+    }
+
+    auto* deferred_result = new DeferredResult();
+    auto* data = new t_objects_in_region_data{
+        patch, rect, contain, near, count, space == "presentation", deferred_result};
+
+    return ToolCommon::run_deferred(patch, (method)objects_in_region_deferred,
+                                    "objects_in_region", data,
+                                    ToolCommon::HEAVY_OPERATION_TIMEOUT,
+                                    "querying objects in region",
+                                    ToolCommon::DeferredWrap::OnSuccess);
+}
+
+/**
+ * Deferred callback for auto_layout's read pass.
+ * Collects the rect and nub layout of every box to lay out, and the cords
+ * joining two of them. The layout itself runs on the request thread.
+ */
+static void auto_layout_read_deferred(t_maxmcp* patch, t_symbol* s, long argc, t_atom* argv) {
+    VALIDATE_DEFERRED_ARGS("auto_layout_read_deferred");
+    EXTRACT_DEFERRED_DATA_WITH_RESULT(t_auto_layout_data, data, argv);
+
+    t_object* patcher = data->patch->patcher;
+    AutoLayoutInput& input = *data->input;
+    std::set<std::string> wanted(data->varnames.begin(), data->varnames.end());
+
+    std::unordered_map<t_object*, int> node_of;
+    int index = 0;
+    for (t_object* box = jpatcher_get_firstobject(patcher); box;
+         box = jbox_get_nextobject(box), ++index) {
+        std::string varname = PatchHelpers::get_box_varname(box);
+        t_rect rect;
+        jbox_get_patching_rect(box, &rect);
+        if (!data->varnames.empty() && wanted.erase(varname) == 0) {
+            input.others.push_back({rect.x, rect.y, rect.width, rect.height});
+            continue;
+        }
+
+        node_of[box] = static_cast<int>(input.nodes.size());
+        input.nodes.push_back({{rect.x, rect.y, rect.width, rect.height},
+                               static_cast<int>(PatchHelpers::get_inlet_count(box)),
+                               static_cast<int>(PatchHelpers::get_outlet_count(box)),
+                               jbox_get_drawfirstin(box) != 0,
+                               PatchHelpers::get_box_maxclass(box)});
+        input.boxes.push_back(box);
+        input.indices.push_back(index);
+        input.varnames.push_back(std::move(varname));
+    }
+    if (!wanted.empty()) {
+        COMPLETE_DEFERRED(data, ToolCommon::object_not_found_error(*wanted.begin()));
+        return;
+    }
+
+    for (t_object* line = jpatcher_get_firstline(patcher); line;
+         line = jpatchline_get_nextline(line)) {
+        auto src = node_of.find((t_object*)jpatchline_get_box1(line));
+        auto dst = node_of.find((t_object*)jpatchline_get_box2(line));
+        if (src == node_of.end() || dst == node_of.end()) {
+            continue;
+        }
+        input.edges.push_back({src->second, static_cast<int>(jpatchline_get_outletnum(line)),
+                               dst->second, static_cast<int>(jpatchline_get_inletnum(line))});
+    }
+
+    COMPLETE_DEFERRED(data, json::object());
+}
+
+/**
+ * Deferred callback for auto_layout's apply pass.
+ * Moves every box in one main-thread pass. Boxes deleted since the read pass
+ * are skipped.
+ */
+static void move_boxes_deferred(t_maxmcp* patch, t_symbol* s, long argc, t_atom* argv) {
+    VALIDATE_DEFERRED_ARGS("move_boxes_deferred");
+    EXTRACT_DEFERRED_DATA_WITH_RESULT(t_move_boxes_data, data, argv);
+
+    std::set<t_object*> live;
+    for (t_object* box = jpatcher_get_firstobject(data->patch->patcher); box;
+         box = jbox_get_nextobject(box)) {
+        live.insert(box);
+    }
+
+    size_t moved = 0;
+    for (size_t i = 0; i < data->boxes.size(); ++i) {
+        if (live.count(data->boxes[i]) == 0) {
+            continue;
+        }
+        t_atom pos[2];
+        atom_setfloat(&pos[0], data->positions[i].x);
+        atom_setfloat(&pos[1], data->positions[i].y);
+        object_attr_setvalueof(data->boxes[i], Symbols::patching_position, 2, pos);
+        ++moved;
+    }
+
+    COMPLETE_DEFERRED(data, (json{{"moved", moved}}));
+}
+
+/**
+ * Execute auto_layout tool.
+ * Reads the boxes and cords on the main thread, computes the layered layout
+ * here, then (unless apply is false) moves the boxes in a second main-thread
+ * pass.
+ */
+static json execute_auto_layout(const json& params) {
+    std::string patch_id = params.value("patch_id", "");
+    if (patch_id.empty()) {
+        return ToolCommon::missing_param_error("patch_id");
+    }
+
+    auto invalid = [](const std::string& message) {
+        return ToolCommon::make_error(ToolCommon::ErrorCode::INVALID_PARAMS, message);
+    };
+
+    std::vector<std::string> varnames;
+    if (params.contains("varnames")) {
+        const json& v = params["varnames"];
+        if (!v.is_array() || v.empty() ||
+            !std::all_of(v.begin(), v.end(), [](const json& x) { return x.is_string(); })) {
+            return invalid("varnames must be a non-empty array of object varnames");
+        }
+        for (const json& name : v) {
+            varnames.push_back(name.get<std::string>());
+        }
+    }
+
+    // Leaves @p out alone when the gap is absent; false when it is invalid.
+    auto read_gap = [&](const char* name, double& out) {
+        if (!params.contains(name)) {
+            return true;
+        }
+        if (!params[name].is_number() || params[name].get<double>() < 0.0) {
+            return false;
+        }
+        out = params[name].get<double>();
+        return true;
+    };
+    geometry::LayeredLayoutOptions options;
+    if (!read_gap("layer_gap", options.layer_gap)) {
+        return invalid("layer_gap must be a non-negative number");
+    }
+    if (!read_gap("object_gap", options.node_gap)) {
+        return invalid("object_gap must be a non-negative number");
+    }
+    const bool apply = params.value("apply", true);
+
+    t_maxmcp* patch = PatchRegistry::find_patch(patch_id);
+    if (!patch) {
+        return ToolCommon::patch_not_found_error(patch_id);
+    }
+
+    auto input = std::make_shared<AutoLayoutInput>();
+    auto* deferred_result = new DeferredResult();
+    auto* data = new t_auto_layout_data{patch, std::move(varnames), input, deferred_result};
+    json extracted = ToolCommon::run_deferred(
+        patch, (method)auto_layout_read_deferred, "auto_layout", data,
+        ToolCommon::HEAVY_OPERATION_TIMEOUT, "reading the patch layout",
+        ToolCommon::DeferredWrap::Raw);
+    if (extracted.contains("error")) {
+        return extracted;
+    }
+
+    const geometry::LayeredLayoutResult layout =
+        geometry::layered_layout(input->nodes, input->edges, options);
+
+    // A subset keeps the top-left corner of its bounding box; if that puts it
+    // on boxes that are not laid out, the drawing moves clear as a whole.
+    std::vector<geometry::Rect> rects = layout.rects;
+    const geometry::Point shift = UtilityTools::clear_block_offset(input->others, rects);
+    for (geometry::Rect& r : rects) {
+        r.origin.x += shift.x;
+        r.origin.y += shift.y;
+    }
+
+    std::vector<t_object*> boxes;
+    std::vector<geometry::Point> positions;
+    json moves = json::array();
+    for (size_t i = 0; i < input->nodes.size(); ++i) {
+        const geometry::Rect& from = input->nodes[i].rect;
+        const geometry::Rect& to = rects[i];
+        if (std::abs(to.origin.x - from.origin.x) <= 0.01 &&
+            std::abs(to.origin.y - from.origin.y) <= 0.01) {
+            continue;
+        }
+        json m = {{"index", input->indices[i]}, {"patching_rect", rect_to_json(to)}};
+        if (!input->varnames[i].empty()) {
+            m["varname"] = input->varnames[i];
+        }
+        moves.push_back(std::move(m));
+        boxes.push_back(input->boxes[i]);
+        positions.push_back(to.origin);
+    }
+
+    json result = {{"patch_id", patch_id},
+                   {"objects", input->nodes.size()},
+                   {"layers", layout.layer_count},
+                   {"reversed_cords", layout.reversed_edges},
+                   {"crossings", {{"before", layout.initial_crossings},
+                                  {"after", layout.crossings}}},
+                   {"moves", moves},
+                   {"applied", false}};
+    if (shift.x != 0.0 || shift.y != 0.0) {
+        result["shifted"] = json::array({shift.x, shift.y});
+    }
+    if (!apply || boxes.empty()) {
+        return {{"result", result}};
+    }
+
+    // The patch may have been closed while the layout was computed
+    if (PatchRegistry::find_patch(patch_id) != patch) {
+        return ToolCommon::make_error(ToolCommon::ErrorCode::INTERNAL_ERROR,
+                                      "Patch closed during auto_layout");
+    }
+    auto* move = new t_move_boxes_data{patch, std::move(boxes), std::move(positions),
+                                       new DeferredResult()};
+    json applied = ToolCommon::run_deferred(patch, (method)move_boxes_deferred, "auto_layout",
+                                            move, ToolCommon::HEAVY_OPERATION_TIMEOUT,
+                                            "moving objects", ToolCommon::DeferredWrap::Raw);
+    if (applied.contains("error")) {
+        return applied;
+    }
+    result["applied"] = true;
+    result["moved"] = applied["moved"];
+    return {{"result", result}};
+}
+
+/**
+ * Deferred callback for route_cords' read pass.
+ * Collects every box rect and patchline of the patching layout, as
+ * validate_layout does, plus each box's nub layout. The routing runs on the
+ * request thread.
+ */
+static void route_cords_read_deferred(t_maxmcp* patch, t_symbol* s, long argc, t_atom* argv) {
+    VALIDATE_DEFERRED_ARGS("route_cords_read_deferred");
+    EXTRACT_DEFERRED_DATA_WITH_RESULT(t_route_cords_data, data, argv);
+
+    t_object* patcher = data->patch->patcher;
+    RouteCordsInput& input = *data->input;
+
+    std::unordered_map<t_object*, int> id_of;
+    std::set<int> included_ids;
+    input.snapshot.objects = extract_layout_objects(patcher, LayoutCheckOptions{}, {}, id_of,
+                                                    included_ids, input.snapshot.object_keys);
+    input.snapshot.cords =
+        extract_layout_cords(patcher, id_of, included_ids, false, input.snapshot.cord_keys);
+
+    for (size_t i = 0; i < input.snapshot.objects.size(); ++i) {
+        t_object* box = reinterpret_cast<t_object*>(input.snapshot.object_keys[i]);
+        input.nubs.push_back({static_cast<int>(PatchHelpers::get_inlet_count(box)),
+                              static_cast<int>(PatchHelpers::get_outlet_count(box)),
+                              jbox_get_drawfirstin(box) != 0, input.snapshot.objects[i].maxclass});
+    }
+
+    COMPLETE_DEFERRED(data, json::object());
+}
+
+/**
+ * Deferred callback for route_cords' apply pass.
+ * Sets the midpoints of every routed patchline in one main-thread pass.
+ * Patchlines deleted since the read pass are skipped.
+ */
+static void set_midpoints_batch_deferred(t_maxmcp* patch, t_symbol* s, long argc, t_atom* argv) {
+    VALIDATE_DEFERRED_ARGS("set_midpoints_batch_deferred");
+    EXTRACT_DEFERRED_DATA_WITH_RESULT(t_set_midpoints_batch_data, data, argv);
+
+    t_object* patcher = data->patch->patcher;
+    std::set<t_object*> live;
+    for (t_object* line = jpatcher_get_firstline(patcher); line;
+         line = jpatchline_get_nextline(line)) {
+        live.insert(line);
+    }
+
+    size_t updated = 0;
+    for (size_t i = 0; i < data->lines.size(); ++i) {
+        if (live.count(data->lines[i]) > 0 &&
+            PatchHelpers::set_patchline_midpoints(patcher, data->lines[i], data->coords[i])) {
+            ++updated;
+        }
+    }
+    if (updated > 0) {
+        jpatcher_set_dirty(patcher, 1);
+    }
+
+    COMPLETE_DEFERRED(data, (json{{"updated", updated}}));
+}
+
+// The center of nub @p index on @p side of a box, or @p fallback (the
+// patchline's own end) when the box draws no such nub.
+static geometry::Point nub_center(const LayoutObject& object, const CordBoxNubs& nubs,
+                                  geometry::IoSide side, long index,
+                                  const geometry::Point& fallback) {
+    const bool is_inlet = (side == geometry::IoSide::Inlet);
+    for (const geometry::IoPosition& p :
+         geometry::io_positions(object.rect, is_inlet ? nubs.inlets : nubs.outlets, side,
+                                is_inlet ? nubs.draw_first_in : true, nubs.maxclass)) {
+        if (p.index == index) {
+            return p.center;
+        }
+    }
+    return fallback;
+}
+
+/**
+ * Execute route_cords tool.
+ * Reads the layout on the main thread, routes the requested cords (or every
+ * cord validate_layout flags as upward or crossing a box) here, then (unless
+ * apply is false) writes all the midpoints in a second main-thread pass.
+ */
+static json execute_route_cords(const json& params) {
+    std::string patch_id = params.value("patch_id", "");
+    if (patch_id.empty()) {
+        return ToolCommon::missing_param_error("patch_id");
+    }
+
+    auto invalid = [](const std::string& message) {
+        return ToolCommon::make_error(ToolCommon::ErrorCode::INVALID_PARAMS, message);
+    };
+
+    std::vector<CordRequest> requests;
+    if (params.contains("cords")) {
+        const json& c = params["cords"];
+        if (!c.is_array() || c.empty()) {
+            return invalid("cords must be a non-empty array of "
+                           "{src_varname, outlet, dst_varname, inlet}");
+        }
+        for (const json& cord : c) {
+            if (!cord.is_object() || !cord.contains("src_varname") ||
+                !cord["src_varname"].is_string() || !cord.contains("outlet") ||
+                !cord["outlet"].is_number_integer() || !cord.contains("dst_varname") ||
+                !cord["dst_varname"].is_string() || !cord.contains("inlet") ||
+                !cord["inlet"].is_number_integer()) {
+                return invalid("each cord needs src_varname, outlet, dst_varname and inlet");
+            }
+            requests.push_back({cord["src_varname"].get<std::string>(), cord["outlet"].get<long>(),
+                                cord["dst_varname"].get<std::string>(), cord["inlet"].get<long>()});
+        }
+    }
+
+    geometry::CordRouterOptions options;
+    if (params.contains("margin")) {
+        if (!params["margin"].is_number() || params["margin"].get<double>() <= 0.0) {
+            return invalid("margin must be a positive number");
+        }
+        options.margin = params["margin"].get<double>();
+    }
+    const bool apply = params.value("apply", true);
+
+    t_maxmcp* patch = PatchRegistry::find_patch(patch_id);
+    if (!patch) {
+        return ToolCommon::patch_not_found_error(patch_id);
+    }
+
+    auto input = std::make_shared<RouteCordsInput>();
+    auto* data = new t_route_cords_data{patch, input, new DeferredResult()};
+    json extracted = ToolCommon::run_deferred(
+        patch, (method)route_cords_read_deferred, "route_cords", data,
+        ToolCommon::HEAVY_OPERATION_TIMEOUT, "reading the patch layout",
+        ToolCommon::DeferredWrap::Raw);
+    if (extracted.contains("error")) {
+        return extracted;
+    }
+    const std::vector<LayoutObject>& objects = input->snapshot.objects;
+    const std::vector<LayoutCord>& cords = input->snapshot.cords;
+
+    // The cords to route: the named ones, or those validate_layout would flag
+    std::vector<size_t> selected;
+    if (requests.empty()) {
+        selected = cords_needing_route(objects, cords, LayoutCheckOptions{}.epsilon);
+    } else {
+        std::map<std::tuple<std::string, long, std::string, long>, size_t> cord_of;
+        for (size_t i = 0; i < cords.size(); ++i) {
+            const LayoutCord& c = cords[i];
+            cord_of.emplace(std::make_tuple(c.src_varname, c.outlet, c.dst_varname, c.inlet), i);
+        }
+        for (const CordRequest& r : requests) {
+            auto it =
+                cord_of.find(std::make_tuple(r.src_varname, r.outlet, r.dst_varname, r.inlet));
+            if (it == cord_of.end()) {
+                return invalid("Patchline not found: " + r.src_varname + "[" +
+                               std::to_string(r.outlet) + "] -> " + r.dst_varname + "[" +
+                               std::to_string(r.inlet) + "]");
+            }
+            selected.push_back(it->second);
+        }
+    }
+
+    // Every box is extracted, so a cord's src_id / dst_id index objects
+    std::vector<geometry::Rect> rects;
+    for (const LayoutObject& o : objects) {
+        rects.push_back(o.rect);
+    }
+    const geometry::CordRouter router(std::move(rects), options);
+    auto box_of = [&](int id) { return id >= 0 && static_cast<size_t>(id) < objects.size(); };
+
+    std::vector<t_object*> lines;
+    std::vector<std::vector<double>> coords;
+    json routed = json::array();
+    json unroutable = json::array();
+    for (size_t i : selected) {
+        const LayoutCord& c = cords[i];
+        const geometry::Point start =
+            box_of(c.src_id) ? nub_center(objects[c.src_id], input->nubs[c.src_id],
+                                          geometry::IoSide::Outlet, c.outlet, c.start)
+                             : c.start;
+        const geometry::Point end =
+            box_of(c.dst_id) ? nub_center(objects[c.dst_id], input->nubs[c.dst_id],
+                                          geometry::IoSide::Inlet, c.inlet, c.end)
+                             : c.end;
+        const geometry::CordRoute route = router.route(start, end, c.src_id, c.dst_id);
+
+        json entry = {{"src_varname", c.src_varname},
+                      {"outlet", c.outlet},
+                      {"dst_varname", c.dst_varname},
+                      {"inlet", c.inlet}};
+        if (!route.ok) {
+            unroutable.push_back(std::move(entry));
+            continue;
+        }
+        json midpoints = json::array();
+        std::vector<double> flat;
+        for (const geometry::Point& p : route.midpoints) {
+            midpoints.push_back({{"x", p.x}, {"y", p.y}});
+            flat.push_back(p.x);
+            flat.push_back(p.y);
+        }
+        entry["midpoints"] = std::move(midpoints);
+        routed.push_back(std::move(entry));
+
+        const bool unchanged =
+            c.midpoints.size() == route.midpoints.size() &&
+            std::equal(c.midpoints.begin(), c.midpoints.end(), route.midpoints.begin(),
+                       [](const geometry::Point& a, const geometry::Point& b) {
+                           return std::abs(a.x - b.x) <= 0.01 && std::abs(a.y - b.y) <= 0.01;
+                       });
+        if (!unchanged) {
+            lines.push_back(reinterpret_cast<t_object*>(input->snapshot.cord_keys[i]));
+            coords.push_back(std::move(flat));
+        }
+    }
+
+    json result = {{"patch_id", patch_id},
+                   {"routed", routed},
+                   {"unroutable", unroutable},
+                   {"applied", false}};
+    if (!apply || lines.empty()) {
+        return {{"result", result}};
+    }
+
+    // The patch may have been closed while the routes were computed
+    if (PatchRegistry::find_patch(patch_id) != patch) {
+        return ToolCommon::make_error(ToolCommon::ErrorCode::INTERNAL_ERROR,
+                                      "Patch closed during route_cords");
+    }
+    auto* set = new t_set_midpoints_batch_data{patch, std::move(lines), std::move(coords),
+                                               new DeferredResult()};
+    json applied = ToolCommon::run_deferred(patch, (method)set_midpoints_batch_deferred,
+                                            "route_cords", set, ToolCommon::HEAVY_OPERATION_TIMEOUT,
+                                            "setting midpoints", ToolCommon::DeferredWrap::Raw);
+    if (applied.contains("error")) {
+        return applied;
+    }
+    result["applied"] = true;
+    result["updated"] = applied["updated"];
+    return {{"result", result}};
+}
+
 #endif  // MAXMCP_TEST_MODE
 
 // ============================================================================
@@ -624,7 +1353,8 @@ json get_tool_schemas() {
              "findings list. Replaces the manual Phase 8 checks of organize-patch: object "
              "overlaps, upward patchcords, patchcords crossing unrelated objects, and "
              "collinear overlapping cords. Call this before saving and fix findings until "
-             "'clean' is true."},
+             "'clean' is true. Results are cached per patch, so repeated calls only "
+             "re-check the objects and cords that changed."},
             {"inputSchema", {
                 {"type", "object"},
                 {"properties", {
@@ -651,6 +1381,11 @@ json get_tool_schemas() {
                     {"epsilon", {
                         {"type", "number"},
                         {"description", "Tolerance in pixels for all checks (default: 2.0)."}}},
+                    {"delta", {
+                        {"type", "boolean"},
+                        {"description", "Return only the findings added and removed since "
+                                        "the previous validate_layout call on this patch, "
+                                        "instead of the full list (default: false)."}}},
                 }},
                 {"required", json::array({"patch_id"})},
             }},
@@ -740,6 +1475,121 @@ json get_tool_schemas() {
                 {"required", json::array({"patch_id", "varnames", "mode"})},
             }},
         },
+        {
+            {"name", "get_objects_in_region"},
+            {"description",
+             "Spatial query over object rects. With 'rect', return the objects overlapping it "
+             "(or, with mode 'contain', lying entirely inside it). With 'near', return the "
+             "'count' objects closest to that point, nearest first, with their distance. "
+             "Answers 'what is here / near here' without listing the whole patch."},
+            {"inputSchema", {
+                {"type", "object"},
+                {"properties", {
+                    {"patch_id", {{"type", "string"}, {"description", "Patch ID to query"}}},
+                    {"rect", {
+                        {"type", "array"},
+                        {"items", {{"type", "number"}}},
+                        {"description", "Region [x, y, width, height]. Use either rect or near."}}},
+                    {"mode", {
+                        {"type", "string"},
+                        {"enum", json::array({"intersect", "contain"})},
+                        {"description", "With rect: 'intersect' (default, touching edges do not "
+                                        "count) or 'contain'."}}},
+                    {"near", {
+                        {"type", "array"},
+                        {"items", {{"type", "number"}}},
+                        {"description", "Point [x, y]; distance is measured to the closest "
+                                        "point of each rect (0 inside it)."}}},
+                    {"count", {
+                        {"type", "integer"},
+                        {"minimum", 1},
+                        {"description", "With near: number of objects to return (default 1)."}}},
+                    {"space", {
+                        {"type", "string"},
+                        {"enum", json::array({"patching", "presentation"})},
+                        {"description", "Coordinate space. 'presentation' only considers "
+                                        "objects shown in presentation. Default 'patching'."}}},
+                }},
+                {"required", json::array({"patch_id"})},
+            }},
+        },
+        {
+            {"name", "auto_layout"},
+            {"description",
+             "Lay the patch out top to bottom along its patchcords (layered drawing): "
+             "feedback cords are kept as the only upward ones, boxes are ordered to minimize "
+             "cord crossings, and each box is placed so its cords run as straight down as the "
+             "order allows. Boxes without cords are packed below. Sizes never change and the "
+             "drawing keeps its top-left corner. Moves the boxes unless 'apply' is false."},
+            {"inputSchema", {
+                {"type", "object"},
+                {"properties", {
+                    {"patch_id", {{"type", "string"},
+                                  {"description", "Patch ID to lay out"}}},
+                    {"varnames", {
+                        {"type", "array"},
+                        {"items", {{"type", "string"}}},
+                        {"description", "Lay out only these objects (and the cords between "
+                                        "them). The other objects stay where they are; if the "
+                                        "drawing would land on one, it is moved clear as a "
+                                        "whole. Default: every object in the patch."}}},
+                    {"layer_gap", {
+                        {"type", "number"},
+                        {"minimum", 0},
+                        {"description", "Vertical space between layers in px (default 30)."}}},
+                    {"object_gap", {
+                        {"type", "number"},
+                        {"minimum", 0},
+                        {"description", "Horizontal space between objects of one layer in px "
+                                        "(default 20)."}}},
+                    {"apply", {
+                        {"type", "boolean"},
+                        {"description", "Move the objects (default true). With false, only "
+                                        "return the new patching_rects."}}},
+                }},
+                {"required", json::array({"patch_id"})},
+            }},
+        },
+        {
+            {"name", "route_cords"},
+            {"description",
+             "Route patchcords orthogonally around the boxes: computes midpoints so each cord "
+             "leaves its outlet going down, runs in horizontal and vertical segments with as "
+             "few bends as possible, and enters its inlet from above, starting and ending "
+             "exactly on the nubs. Routes the given cords, or by default every cord "
+             "validate_layout reports as upward or crossing an object. Writes all midpoints "
+             "in one pass unless 'apply' is false."},
+            {"inputSchema", {
+                {"type", "object"},
+                {"properties", {
+                    {"patch_id", {{"type", "string"},
+                                  {"description", "Patch ID containing the cords"}}},
+                    {"cords", {
+                        {"type", "array"},
+                        {"items", {
+                            {"type", "object"},
+                            {"properties", {
+                                {"src_varname", {{"type", "string"}}},
+                                {"outlet",      {{"type", "integer"}}},
+                                {"dst_varname", {{"type", "string"}}},
+                                {"inlet",       {{"type", "integer"}}}}},
+                            {"required", json::array({"src_varname", "outlet",
+                                                      "dst_varname", "inlet"})}}},
+                        {"description", "Cords to route. Default: every upward cord and "
+                                        "every cord crossing an object."}}},
+                    {"margin", {
+                        {"type", "number"},
+                        {"exclusiveMinimum", 0},
+                        {"description", "Clearance kept around boxes in px (default 10); "
+                                        "narrower gaps between boxes are split evenly."}}},
+                    {"apply", {
+                        {"type", "boolean"},
+                        {"description", "Set the midpoints (default true). With false, only "
+                                        "return the routes."}}},
+                }},
+                {"required", json::array({"patch_id"})},
+            }},
+        },
     });
 }
 // clang-format on
@@ -781,6 +1631,30 @@ json execute(const std::string& tool, const json& params) {
 #endif
     }
 
+    if (tool == "get_objects_in_region") {
+#ifdef MAXMCP_TEST_MODE
+        return ToolCommon::test_mode_error();
+#else
+        return execute_get_objects_in_region(params);
+#endif
+    }
+
+    if (tool == "auto_layout") {
+#ifdef MAXMCP_TEST_MODE
+        return ToolCommon::test_mode_error();
+#else
+        return execute_auto_layout(params);
+#endif
+    }
+
+    if (tool == "route_cords") {
+#ifdef MAXMCP_TEST_MODE
+        return ToolCommon::test_mode_error();
+#else
+        return execute_route_cords(params);
+#endif
+    }
+
     return nullptr;
 }
 
@@ -6,6 +6,10 @@
     - validate_layout: machine-check Phase 8 of organize-patch (overlaps, upward
       cords, cord-vs-object crossings, collinear cord overlaps) and return a
       structured findings list. Read-only — never modifies the patch.
+    - auto_layout: layered (top-to-bottom) layout of the patch along its cords;
+      the layout itself lives in src/utils/auto_layout.h.
+    - route_cords: orthogonal midpoints for patchcords, around the boxes; the
+      router lives in src/utils/cord_router.h.
 
     This header is the Max-facing glue: the MCP dispatch and schema. The plain data
     structures (LayoutObject / LayoutCord / LayoutCheckOptions) and the pure check
@@ -40,7 +44,9 @@ using json = nlohmann::json;
 /**
  * @brief Get the JSON schemas for all layout tools.
  *
- * @return JSON array of tool schemas (validate_layout)
+ * @return JSON array of tool schemas (validate_layout, get_io_position,
+ *         suggest_alignment, align_objects, get_objects_in_region, auto_layout,
+ *         route_cords)
  */
 json get_tool_schemas();
 
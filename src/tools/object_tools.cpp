@@ -9,11 +9,22 @@
 
 #include "maxmcp.h"
 #include "tool_common.h"
+#include "utils/batch.h"
+#include "utils/columnar.h"
 #include "utils/console_logger.h"
+#include "utils/field_selection.h"
+#include "utils/object_query.h"
+#include "utils/pagination.h"
 #include "utils/patch_helpers.h"
 #include "utils/patch_registry.h"
+#include "utils/symbols.h"
 
+#include <memory>
+#include <optional>
 #include <set>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
 #include <vector>
 
 #ifndef MAXMCP_TEST_MODE
@@ -29,14 +40,28 @@ namespace ObjectTools {
 // Data Structures for Deferred Callbacks
 // ============================================================================
 
-struct t_add_object_data {
-    t_maxmcp* patch;
+// One object to create, shared by add_max_object and add_max_objects
+struct ObjectSpec {
     std::string obj_type;
-    double x;
-    double y;
+    double x = 0.0;
+    double y = 0.0;
     std::string varname;
     json arguments;
     json attributes;
+};
+
+struct t_add_object_data {
+    t_maxmcp* patch;
+    ObjectSpec spec;
+    ToolCommon::DeferredResult* deferred_result;
+};
+
+struct t_add_objects_data {
+    t_maxmcp* patch;
+    std::vector<ObjectSpec> objects;
+    std::vector<batch::ConnectionSpec> connections;
+    batch::OnError on_error;
+    std::shared_ptr<std::vector<t_object*>> created;  ///< Box per item, when asked for
     ToolCommon::DeferredResult* deferred_result;
 };
 
@@ -61,6 +86,13 @@ struct t_get_attribute_data {
     ToolCommon::DeferredResult* deferred_result;
 };
 
+struct t_attributes_data {
+    t_maxmcp* patch;
+    batch::AttributeRequest request;
+    batch::OnError on_error;  // writes only
+    ToolCommon::DeferredResult* deferred_result;
+};
+
 enum class GetObjectsMode {
     Default,  // index, varname, maxclass, text, position, size
     Layout,   // varname, position, size
@@ -80,9 +112,73 @@ static GetObjectsMode parse_get_objects_mode(const std::string& mode_str) {
     return GetObjectsMode::Default;
 }
 
+// Built-in fields selectable through the "fields" parameter. The enum value is
+// the index into kObjectFieldNames; any other name is read as a box attribute.
+enum ObjectField : size_t {
+    kFieldIndex,
+    kFieldVarname,
+    kFieldMaxclass,
+    kFieldText,
+    kFieldPosition,
+    kFieldSize,
+    kFieldPresentationRect,
+    kFieldHidden,
+    kFieldPresentation,
+};
+
+static const std::vector<std::string> kObjectFieldNames = {
+    "index", "varname",           "maxclass", "text",        "position",
+    "size",  "presentation_rect", "hidden",   "presentation"};
+
+#ifndef MAXMCP_TEST_MODE
+// Built-in fields emitted by each preset mode, in output order.
+static std::vector<size_t> builtin_fields_for_mode(GetObjectsMode mode) {
+    switch (mode) {
+    case GetObjectsMode::Layout:
+        return {kFieldVarname, kFieldPosition, kFieldSize};
+    case GetObjectsMode::Identity:
+        return {kFieldIndex, kFieldVarname, kFieldMaxclass, kFieldText};
+    case GetObjectsMode::Default:
+    default:
+        return {kFieldIndex, kFieldVarname, kFieldMaxclass, kFieldText, kFieldPosition, kFieldSize};
+    }
+}
+#endif  // MAXMCP_TEST_MODE
+
 struct t_get_objects_data {
     t_maxmcp* patch;
     GetObjectsMode mode;
+    std::optional<field_selection::FieldSelection> fields;
+    bool columnar;
+    pagination::PageRequest page;
+    ToolCommon::DeferredResult* deferred_result;
+};
+
+// Boxes of a text query that passed every other predicate, with their texts
+// copied out so the regex runs on the request thread, not Max's main thread.
+struct QueryCandidates {
+    std::vector<t_object*> boxes;
+    std::vector<int> indexes;
+    std::vector<std::string> texts;
+    uint64_t revision = 0;  ///< Box-list fingerprint when collected
+};
+
+struct t_query_objects_data {
+    t_maxmcp* patch;
+    object_query::Query query;
+    field_selection::FieldSelection fields;
+    std::shared_ptr<QueryCandidates> candidates;  ///< Set for text queries: collect only
+    ToolCommon::DeferredResult* deferred_result;
+};
+
+// Projects the text query matches picked from QueryCandidates.
+struct t_query_project_data {
+    t_maxmcp* patch;
+    std::string patch_id;  ///< To re-check in the registry before touching the patch
+    std::shared_ptr<QueryCandidates> candidates;
+    std::vector<size_t> selected;  ///< Positions in candidates, in patcher order
+    bool truncated;
+    field_selection::FieldSelection fields;
     ToolCommon::DeferredResult* deferred_result;
 };
 
@@ -118,6 +214,13 @@ struct t_replace_text_data {
     ToolCommon::DeferredResult* deferred_result;
 };
 
+struct t_replace_texts_data {
+    t_maxmcp* patch;
+    std::vector<std::pair<std::string, std::string>> items;  // (varname, new_text)
+    batch::OnError on_error;
+    ToolCommon::DeferredResult* deferred_result;
+};
+
 struct t_assign_varnames_data {
     t_maxmcp* patch;
     json assignments;
@@ -136,15 +239,17 @@ struct t_get_value_data {
 
 #ifndef MAXMCP_TEST_MODE
 
-static void add_object_deferred(t_maxmcp* patch, t_symbol* s, long argc, t_atom* argv) {
-    VALIDATE_DEFERRED_ARGS("add_object_deferred");
-    EXTRACT_DEFERRED_DATA_WITH_RESULT(t_add_object_data, data, argv);
-
+// Create one object from a spec: box text, position, varname, attributes and
+// textfield content. Returns nullptr if Max could not instantiate the box text;
+// obj_string receives the text that was tried either way. Attribute names are
+// interned through attr_syms, which callers share across a whole request.
+static t_object* create_object(t_object* patcher, const ObjectSpec& spec,
+                               Symbols::Cache& attr_syms, std::string& obj_string) {
     // Build object string with arguments
-    std::string obj_string = data->obj_type;
+    obj_string = spec.obj_type;
 
-    if (!data->arguments.is_null() && data->arguments.is_array()) {
-        for (const auto& arg : data->arguments) {
+    if (!spec.arguments.is_null() && spec.arguments.is_array()) {
+        for (const auto& arg : spec.arguments) {
             obj_string += " ";
             if (arg.is_number_integer()) {
                 obj_string += std::to_string(arg.get<int>());
@@ -157,46 +262,62 @@ static void add_object_deferred(t_maxmcp* patch, t_symbol* s, long argc, t_atom*
     }
 
     // Create object using newobject_fromboxtext (same as typing in object box)
-    t_object* obj = (t_object*)newobject_fromboxtext(data->patch->patcher, obj_string.c_str());
+    t_object* obj = (t_object*)newobject_fromboxtext(patcher, obj_string.c_str());
+    if (!obj) {
+        return nullptr;
+    }
 
-    if (obj) {
-        // Set position
-        t_atom pos[2];
-        atom_setfloat(&pos[0], data->x);
-        atom_setfloat(&pos[1], data->y);
-        object_attr_setvalueof(obj, gensym("patching_position"), 2, pos);
-        // Set varname if provided
-        if (!data->varname.empty()) {
-            object_attr_setsym(obj, gensym("varname"), gensym(data->varname.c_str()));
-        }
+    // Set position
+    t_atom pos[2];
+    atom_setfloat(&pos[0], spec.x);
+    atom_setfloat(&pos[1], spec.y);
+    object_attr_setvalueof(obj, Symbols::patching_position, 2, pos);
+    // Set varname if provided
+    if (!spec.varname.empty()) {
+        object_attr_setsym(obj, Symbols::varname, gensym(spec.varname.c_str()));
+    }
 
-        // Set attributes if provided
-        if (!data->attributes.is_null() && data->attributes.is_object()) {
-            for (auto& [attr_name, attr_value] : data->attributes.items()) {
-                PatchHelpers::set_box_attribute(obj, attr_name, attr_value);
-            }
+    // Set attributes if provided
+    if (!spec.attributes.is_null() && spec.attributes.is_object()) {
+        for (auto& [attr_name, attr_value] : spec.attributes.items()) {
+            PatchHelpers::set_box_attribute(obj, attr_syms.get(attr_name), attr_value);
         }
+    }
 
-        // Set text content for textfield-content objects (message, comment, textedit).
-        // newobject_fromboxtext handles arguments for normal objects (e.g. "metro 500"),
-        // but does NOT populate displayed text for these types.
-        if (PatchHelpers::is_textfield_content_type(data->obj_type)) {
-            std::string text_content = PatchHelpers::build_text_from_arguments(data->arguments);
-            if (!text_content.empty()) {
-                PatchHelpers::set_textfield_content(obj, text_content);
-            }
+    // Set text content for textfield-content objects (message, comment, textedit).
+    // newobject_fromboxtext handles arguments for normal objects (e.g. "metro 500"),
+    // but does NOT populate displayed text for these types.
+    if (PatchHelpers::is_textfield_content_type(spec.obj_type)) {
+        std::string text_content = PatchHelpers::build_text_from_arguments(spec.arguments);
+        if (!text_content.empty()) {
+            PatchHelpers::set_textfield_content(obj, text_content);
         }
+    }
+
+    object_method(obj, Symbols::bringtofront);
+    object_attr_setlong(obj, Symbols::presentation, 1);
+    return obj;
+}
+
+static void add_object_deferred(t_maxmcp* patch, t_symbol* s, long argc, t_atom* argv) {
+    VALIDATE_DEFERRED_ARGS("add_object_deferred");
+    EXTRACT_DEFERRED_DATA_WITH_RESULT(t_add_object_data, data, argv);
 
-        object_method(obj, gensym("bringtofront"));
-        object_attr_setlong(obj, gensym("presentation"), 1);
+    const ObjectSpec& spec = data->spec;
+    Symbols::Cache attr_syms;
+    std::string obj_string;
+    t_object* obj = create_object(data->patch->patcher, spec, attr_syms, obj_string);
+
+    if (obj) {
         jpatcher_set_dirty(data->patch->patcher, 1);
+        ++data->patch->structure_edits;
         ConsoleLogger::log(("Object created: " + obj_string).c_str());
 
         COMPLETE_DEFERRED(data, (json{{"result",
                                        {{"status", "success"},
-                                        {"obj_type", data->obj_type},
-                                        {"position", json::array({data->x, data->y})},
-                                        {"varname", data->varname}}}}));
+                                        {"obj_type", spec.obj_type},
+                                        {"position", json::array({spec.x, spec.y})},
+                                        {"varname", spec.varname}}}}));
     } else {
         std::string msg = "Failed to create object: " + obj_string;
         ConsoleLogger::log(msg.c_str());
@@ -204,6 +325,77 @@ static void add_object_deferred(t_maxmcp* patch, t_symbol* s, long argc, t_atom*
     }
 }
 
+static void add_objects_deferred(t_maxmcp* patch, t_symbol* s, long argc, t_atom* argv) {
+    VALIDATE_DEFERRED_ARGS("add_objects_deferred");
+    EXTRACT_DEFERRED_DATA_WITH_RESULT(t_add_objects_data, data, argv);
+
+    t_object* patcher = data->patch->patcher;
+    batch::Tally tally(data->on_error);
+
+    Symbols::Cache attr_syms;
+    json object_results = json::array();
+    std::vector<std::pair<std::string, t_object*>> created_names;
+    if (data->created) {
+        data->created->assign(data->objects.size(), nullptr);
+    }
+    for (size_t i = 0; i < data->objects.size() && !tally.stopped(); ++i) {
+        const ObjectSpec& spec = data->objects[i];
+        std::string obj_string;
+        t_object* obj = create_object(patcher, spec, attr_syms, obj_string);
+        if (!obj) {
+            object_results.push_back(
+                batch::item_error(i, "Failed to create object: " + obj_string));
+            tally.failed();
+            continue;
+        }
+
+        object_results.push_back(
+            batch::item_success(i, {{"obj_type", spec.obj_type},
+                                    {"position", json::array({spec.x, spec.y})},
+                                    {"varname", spec.varname}}));
+        tally.succeeded();
+        if (data->created) {
+            (*data->created)[i] = obj;
+        }
+        if (!spec.varname.empty()) {
+            created_names.emplace_back(spec.varname, obj);
+        }
+    }
+    const size_t created = tally.succeeded_count();
+
+    json connection_results = json::array();
+    if (!data->connections.empty() && !tally.stopped()) {
+        // One patcher scan resolves every endpoint. Objects created above win
+        // over older boxes that happen to share their varname.
+        auto boxes = PatchHelpers::index_boxes_by_varname(patcher);
+        for (const auto& [name, obj] : created_names) {
+            boxes[name] = obj;
+        }
+        connection_results =
+            PatchHelpers::connect_batch(patcher, data->connections, boxes, tally);
+    }
+    const size_t connected = tally.succeeded_count() - created;
+
+    if (tally.succeeded_count() > 0) {
+        jpatcher_set_dirty(patcher, 1);
+        ++data->patch->structure_edits;
+    }
+    ConsoleLogger::log(("Objects created: " + std::to_string(created) + ", connections made: " +
+                        std::to_string(connected))
+                           .c_str());
+
+    json result = {{"status", tally.status()},
+                   {"created", created},
+                   {"connected", connected},
+                   {"failed", tally.failed_count()},
+                   {"objects", object_results},
+                   {"connections", connection_results}};
+    if (tally.stopped()) {
+        result["stopped"] = true;
+    }
+    COMPLETE_DEFERRED(data, (json{{"result", result}}));
+}
+
 static void remove_object_deferred(t_maxmcp* patch, t_symbol* s, long argc, t_atom* argv) {
     VALIDATE_DEFERRED_ARGS("remove_object_deferred");
     EXTRACT_DEFERRED_DATA_WITH_RESULT(t_remove_object_data, data, argv);
@@ -213,6 +405,7 @@ static void remove_object_deferred(t_maxmcp* patch, t_symbol* s, long argc, t_at
     if (box) {
         object_free(box);
         jpatcher_set_dirty(data->patch->patcher, 1);
+        ++data->patch->structure_edits;
         ConsoleLogger::log(("Object removed: " + data->varname).c_str());
         COMPLETE_DEFERRED(data,
                           (json{{"result", {{"status", "success"}, {"varname", data->varname}}}}));
@@ -287,6 +480,386 @@ static void get_attribute_deferred(t_maxmcp* patch, t_symbol* s, long argc, t_at
                {{"varname", data->varname}, {"attribute", data->attribute}, {"value", value}}}}));
 }
 
+// Call fn(box, index) for every box the selector matches, in patcher order.
+template <typename Fn>
+static void for_each_selected_box(t_object* patcher, const batch::BoxSelector& selector, Fn fn) {
+    int index = 0;
+    for (t_object* box = jpatcher_get_firstobject(patcher); box;
+         box = jbox_get_nextobject(box), ++index) {
+        t_rect rect;
+        jbox_get_patching_rect(box, &rect);
+        if (selector.matches(PatchHelpers::get_box_maxclass(box, ""),
+                             geometry::Rect{rect.x, rect.y, rect.width, rect.height})) {
+            fn(box, index);
+        }
+    }
+}
+
+// Read one attribute; null when the box does not have it.
+static json read_box_attribute(t_object* box, t_symbol* attr) {
+    long ac = 0;
+    t_atom* av = nullptr;
+    t_max_err err = object_attr_getvalueof(box, attr, &ac, &av);
+    json value = (err == MAX_ERR_NONE && ac > 0) ? PatchHelpers::atoms_to_json(ac, av) : json();
+    if (av) {
+        sysmem_freeptr(av);
+    }
+    return value;
+}
+
+static void set_attributes_deferred(t_maxmcp* patch, t_symbol* s, long argc, t_atom* argv) {
+    VALIDATE_DEFERRED_ARGS("set_attributes_deferred");
+    EXTRACT_DEFERRED_DATA_WITH_RESULT(t_attributes_data, data, argv);
+
+    const batch::AttributeRequest& request = data->request;
+    t_object* patcher = data->patch->patcher;
+
+    // Each distinct attribute name and value is converted exactly once
+    std::vector<t_symbol*> syms;
+    syms.reserve(request.names.size());
+    for (const auto& name : request.names.values()) {
+        syms.push_back(gensym(name.get_ref<const std::string&>().c_str()));
+    }
+    std::vector<std::vector<t_atom>> atoms;
+    atoms.reserve(request.values.size());
+    for (const auto& value : request.values.values()) {
+        atoms.push_back(PatchHelpers::json_to_atoms(value));
+    }
+    auto apply = [&](t_object* box, size_t name, size_t value) {
+        std::vector<t_atom>& av = atoms[value];
+        return object_attr_setvalueof(box, syms[name], static_cast<long>(av.size()),
+                                      av.data()) == MAX_ERR_NONE;
+    };
+
+    batch::Tally tally(data->on_error);
+    json results = json::array();
+
+    if (request.selector) {
+        for_each_selected_box(patcher, *request.selector, [&](t_object* box, int index) {
+            if (tally.stopped()) {
+                return;
+            }
+            std::string failed;
+            for (const auto& [name, value] : request.attributes) {
+                if (!apply(box, name, value)) {
+                    failed += (failed.empty() ? "" : ", ") +
+                              request.names.values()[name].get<std::string>();
+                }
+            }
+            json fields = {{"varname", PatchHelpers::get_box_varname(box)},
+                           {"maxclass", PatchHelpers::get_box_maxclass(box, "unknown")}};
+            if (failed.empty()) {
+                results.push_back(batch::item_success(index, std::move(fields)));
+                tally.succeeded();
+            } else {
+                json entry = batch::item_error(index, "Failed to set attribute: " + failed);
+                entry.update(fields);
+                results.push_back(std::move(entry));
+                tally.failed();
+            }
+        });
+    } else {
+        auto boxes = PatchHelpers::index_boxes_by_varname(patcher);
+        for (size_t i = 0; i < request.items.size() && !tally.stopped(); ++i) {
+            const batch::AttributeItem& item = request.items[i];
+            const std::string& attribute =
+                request.names.values()[item.attribute].get_ref<const std::string&>();
+            auto it = boxes.find(item.varname);
+            if (it == boxes.end()) {
+                results.push_back(batch::item_error(i, "Object not found: " + item.varname));
+                tally.failed();
+            } else if (!apply(it->second, item.attribute, item.value)) {
+                results.push_back(batch::item_error(i, "Failed to set attribute: " + attribute));
+                tally.failed();
+            } else {
+                results.push_back(
+                    batch::item_success(i, {{"varname", item.varname}, {"attribute", attribute}}));
+                tally.succeeded();
+            }
+        }
+    }
+
+    if (tally.succeeded_count() > 0) {
+        jpatcher_set_dirty(patcher, 1);
+    }
+    ConsoleLogger::log(("Attributes set: " + std::to_string(tally.succeeded_count()) + " ok, " +
+                        std::to_string(tally.failed_count()) + " failed")
+                           .c_str());
+
+    json result = {{"status", tally.status()},
+                   {"succeeded", tally.succeeded_count()},
+                   {"failed", tally.failed_count()},
+                   {"results", results}};
+    if (tally.stopped()) {
+        result["stopped"] = true;
+    }
+    COMPLETE_DEFERRED(data, (json{{"result", result}}));
+}
+
+static void get_attributes_deferred(t_maxmcp* patch, t_symbol* s, long argc, t_atom* argv) {
+    VALIDATE_DEFERRED_ARGS("get_attributes_deferred");
+    EXTRACT_DEFERRED_DATA_WITH_RESULT(t_attributes_data, data, argv);
+
+    const batch::AttributeRequest& request = data->request;
+    t_object* patcher = data->patch->patcher;
+
+    std::vector<t_symbol*> syms;
+    syms.reserve(request.names.size());
+    for (const auto& name : request.names.values()) {
+        syms.push_back(gensym(name.get_ref<const std::string&>().c_str()));
+    }
+
+    // Reads never stop early
+    batch::Tally tally(batch::OnError::Continue);
+    json results = json::array();
+
+    if (request.selector) {
+        for_each_selected_box(patcher, *request.selector, [&](t_object* box, int index) {
+            json values = json::object();
+            for (const auto& [name, unused] : request.attributes) {
+                (void)unused;
+                values[request.names.values()[name].get<std::string>()] =
+                    read_box_attribute(box, syms[name]);
+            }
+            results.push_back(batch::item_success(
+                index, {{"varname", PatchHelpers::get_box_varname(box)},
+                        {"maxclass", PatchHelpers::get_box_maxclass(box, "unknown")},
+                        {"attributes", std::move(values)}}));
+            tally.succeeded();
+        });
+    } else {
+        auto boxes = PatchHelpers::index_boxes_by_varname(patcher);
+        for (size_t i = 0; i < request.items.size(); ++i) {
+            const batch::AttributeItem& item = request.items[i];
+            const std::string& attribute =
+                request.names.values()[item.attribute].get_ref<const std::string&>();
+            auto it = boxes.find(item.varname);
+            if (it == boxes.end()) {
+                results.push_back(batch::item_error(i, "Object not found: " + item.varname));
+                tally.failed();
+                continue;
+            }
+            json value = read_box_attribute(it->second, syms[item.attribute]);
+            if (value.is_null()) {
+                results.push_back(
+                    batch::item_error(i, "Attribute not found or has no value: " + attribute));
+                tally.failed();
+                continue;
+            }
+            results.push_back(batch::item_success(
+                i, {{"varname", item.varname}, {"attribute", attribute}, {"value", value}}));
+            tally.succeeded();
+        }
+    }
+
+    COMPLETE_DEFERRED(data, (json{{"result",
+                                   {{"status", tally.status()},
+                                    {"count", results.size()},
+                                    {"results", results}}}}));
+}
+
+// Build one get_objects_in_patch entry from a "fields" projection. Reads only
+// the requested data; attributes the box does not have come back as null.
+static json project_box_fields(t_object* box, int index,
+                               const field_selection::FieldSelection& fields,
+                               const std::vector<t_symbol*>& attr_syms) {
+    json obj_info = json::object();
+
+    for (size_t field : fields.builtins) {
+        const std::string& key = kObjectFieldNames[field];
+        switch (field) {
+        case kFieldIndex:
+            obj_info[key] = index;
+            break;
+        case kFieldVarname: {
+            std::string varname_str = PatchHelpers::get_box_varname(box);
+            if (!varname_str.empty()) {
+                obj_info[key] = varname_str;
+            }
+            break;
+        }
+        case kFieldMaxclass:
+            obj_info[key] = PatchHelpers::get_box_maxclass(box, "unknown");
+            break;
+        case kFieldText:
+            obj_info[key] = PatchHelpers::get_box_text(box);
+            break;
+        case kFieldPosition:
+        case kFieldSize: {
+            t_rect rect;
+            jbox_get_patching_rect(box, &rect);
+            obj_info[key] = field == kFieldPosition ? json::array({rect.x, rect.y})
+                                                    : json::array({rect.width, rect.height});
+            break;
+        }
+        case kFieldPresentationRect: {
+            t_rect rect;
+            jbox_get_presentation_rect(box, &rect);
+            obj_info[key] = json::array({rect.x, rect.y, rect.width, rect.height});
+            break;
+        }
+        case kFieldHidden:
+            obj_info[key] = jbox_get_hidden(box) != 0;
+            break;
+        case kFieldPresentation:
+            obj_info[key] = jbox_get_presentation(box) != 0;
+            break;
+        }
+    }
+
+    for (size_t a = 0; a < attr_syms.size(); ++a) {
+        long ac = 0;
+        t_atom* av = nullptr;
+        t_max_err err = object_attr_getvalueof(box, attr_syms[a], &ac, &av);
+        obj_info[fields.attributes[a]] =
+            (err == MAX_ERR_NONE && ac > 0) ? PatchHelpers::atoms_to_json(ac, av) : json();
+        if (av)
+            sysmem_freeptr(av);
+    }
+
+    return obj_info;
+}
+
+// Columnar encoding of a get_objects_in_patch page (encoding: "columnar").
+// Each requested field is read straight into a typed column and the whole
+// response is serialized with JsonWriter, without a per-box JSON DOM. "index"
+// is implied by row order and reported once as index_start.
+static std::string encode_objects_columnar(const std::string& patch_id,
+                                           const std::vector<t_object*>& boxes,
+                                           const pagination::PageRequest& page,
+                                           const pagination::PageWindow& window,
+                                           uint64_t revision,
+                                           const std::vector<size_t>& builtins,
+                                           const std::vector<std::string>& attr_names,
+                                           const std::vector<t_symbol*>& attr_syms) {
+    using columnar::Kind;
+
+    const size_t rows = window.end - window.begin;
+    columnar::ColumnBuilder columns(rows);
+
+    // Declare columns in request order; rect fields expand to one column per component.
+    std::vector<std::pair<size_t, columnar::ColumnId>> field_columns;
+    for (size_t field : builtins) {
+        switch (field) {
+        case kFieldIndex:
+            break;
+        case kFieldVarname:
+        case kFieldText:
+            field_columns.emplace_back(field,
+                                       columns.add_column(kObjectFieldNames[field], Kind::String));
+            break;
+        case kFieldMaxclass:
+            field_columns.emplace_back(field, columns.add_column("maxclass", Kind::Interned));
+            break;
+        case kFieldPosition:
+            field_columns.emplace_back(field, columns.add_column("x", Kind::Number));
+            columns.add_column("y", Kind::Number);
+            break;
+        case kFieldSize:
+            field_columns.emplace_back(field, columns.add_column("width", Kind::Number));
+            columns.add_column("height", Kind::Number);
+            break;
+        case kFieldPresentationRect:
+            field_columns.emplace_back(field, columns.add_column("presentation_x", Kind::Number));
+            columns.add_column("presentation_y", Kind::Number);
+            columns.add_column("presentation_width", Kind::Number);
+            columns.add_column("presentation_height", Kind::Number);
+            break;
+        case kFieldHidden:
+        case kFieldPresentation:
+            field_columns.emplace_back(field,
+                                       columns.add_column(kObjectFieldNames[field], Kind::Flag));
+            break;
+        }
+    }
+    std::vector<columnar::ColumnId> attr_columns;
+    for (const auto& name : attr_names) {
+        attr_columns.push_back(columns.add_column(name, Kind::Value));
+    }
+
+    for (size_t i = window.begin; i < window.end; ++i) {
+        t_object* box = boxes[i];
+
+        for (const auto& [field, col] : field_columns) {
+            switch (field) {
+            case kFieldVarname: {
+                std::string varname_str = PatchHelpers::get_box_varname(box);
+                if (varname_str.empty()) {
+                    columns.push_null(col);
+                } else {
+                    columns.push_string(col, varname_str);
+                }
+                break;
+            }
+            case kFieldMaxclass:
+                columns.push_interned(col, PatchHelpers::get_box_maxclass(box, "unknown"));
+                break;
+            case kFieldText:
+                columns.push_string(col, PatchHelpers::get_box_text(box));
+                break;
+            case kFieldPosition:
+            case kFieldSize: {
+                t_rect rect;
+                jbox_get_patching_rect(box, &rect);
+                columns.push_number(col, field == kFieldPosition ? rect.x : rect.width);
+                columns.push_number(col + 1, field == kFieldPosition ? rect.y : rect.height);
+                break;
+            }
+            case kFieldPresentationRect: {
+                t_rect rect;
+                jbox_get_presentation_rect(box, &rect);
+                columns.push_number(col, rect.x);
+                columns.push_number(col + 1, rect.y);
+                columns.push_number(col + 2, rect.width);
+                columns.push_number(col + 3, rect.height);
+                break;
+            }
+            case kFieldHidden:
+                columns.push_flag(col, jbox_get_hidden(box) != 0);
+                break;
+            case kFieldPresentation:
+                columns.push_flag(col, jbox_get_presentation(box) != 0);
+                break;
+            }
+        }
+
+        for (size_t a = 0; a < attr_syms.size(); ++a) {
+            long ac = 0;
+            t_atom* av = nullptr;
+            t_max_err err = object_attr_getvalueof(box, attr_syms[a], &ac, &av);
+            if (err == MAX_ERR_NONE && ac > 0) {
+                columns.push_value(attr_columns[a], PatchHelpers::atoms_to_json(ac, av));
+            } else {
+                columns.push_null(attr_columns[a]);
+            }
+            if (av)
+                sysmem_freeptr(av);
+        }
+    }
+
+    jsonwriter::JsonWriter writer;
+    writer.begin_object();
+    writer.key("patch_id");
+    writer.string(patch_id);
+    writer.key("encoding");
+    writer.string("columnar");
+    writer.key("count");
+    writer.integer(static_cast<long long>(rows));
+    writer.key("index_start");
+    writer.integer(static_cast<long long>(window.begin));
+    columns.write(writer);
+    if (page.paginated) {
+        writer.key("total");
+        writer.integer(static_cast<long long>(boxes.size()));
+        if (window.has_more) {
+            writer.key("next_cursor");
+            writer.string(pagination::encode_cursor(pagination::Cursor{revision, window.end}));
+        }
+    }
+    writer.end_object();
+    return writer.take();
+}
+
 static void get_objects_deferred(t_maxmcp* patch, t_symbol* s, long argc, t_atom* argv) {
     VALIDATE_DEFERRED_ARGS("get_objects_deferred");
     EXTRACT_DEFERRED_DATA_WITH_RESULT(t_get_objects_data, data, argv);
@@ -304,11 +877,51 @@ static void get_objects_deferred(t_maxmcp* patch, t_symbol* s, long argc, t_atom
         obj["size"] = json::array({rect.width, rect.height});
     };
 
+    // Pointer-only pass: fingerprints the listing for the cursor and sizes the
+    // page without reading any attributes.
+    std::vector<t_object*> boxes;
+    pagination::RevisionHash revision(data->patch->structure_edits);
+    for (t_object* box = jpatcher_get_firstobject(data->patch->patcher); box;
+         box = jbox_get_nextobject(box)) {
+        boxes.push_back(box);
+        revision.add(box);
+    }
+
+    pagination::PageWindow window;
+    json page_error = pagination::resolve_page(data->page, boxes.size(), revision.value(), window);
+    if (!page_error.is_null()) {
+        COMPLETE_DEFERRED(data, page_error);
+        return;
+    }
+
+    // Projection: resolve attribute symbols once per request, not once per box.
+    std::vector<t_symbol*> attr_syms;
+    if (data->fields) {
+        for (const auto& name : data->fields->attributes) {
+            attr_syms.push_back(gensym(name.c_str()));
+        }
+    }
+
+    if (data->columnar) {
+        std::string text = encode_objects_columnar(
+            data->patch->patch_id, boxes, data->page, window, revision.value(),
+            data->fields ? data->fields->builtins : builtin_fields_for_mode(data->mode),
+            data->fields ? data->fields->attributes : std::vector<std::string>{}, attr_syms);
+        COMPLETE_DEFERRED(data, ToolCommon::make_raw_result(std::move(text)));
+        return;
+    }
+
     json objects = json::array();
-    t_object* patcher = data->patch->patcher;
-    int index = 0;
 
-    for (t_object* box = jpatcher_get_firstobject(patcher); box; box = jbox_get_nextobject(box)) {
+    for (size_t i = window.begin; i < window.end; ++i) {
+        t_object* box = boxes[i];
+        int index = static_cast<int>(i);
+
+        if (data->fields) {
+            objects.push_back(project_box_fields(box, index, *data->fields, attr_syms));
+            continue;
+        }
+
         std::string varname_str = PatchHelpers::get_box_varname(box);
 
         json obj_info = json::object();
@@ -330,12 +943,152 @@ static void get_objects_deferred(t_maxmcp* patch, t_symbol* s, long argc, t_atom
         }
 
         objects.push_back(obj_info);
-        index++;
     }
 
-    COMPLETE_DEFERRED(data, (json{{"patch_id", data->patch->patch_id},
-                                  {"objects", objects},
-                                  {"count", objects.size()}}));
+    json result = {{"patch_id", data->patch->patch_id},
+                   {"objects", objects},
+                   {"count", objects.size()}};
+    pagination::add_page_fields(result, data->page, window, boxes.size(), revision.value());
+    COMPLETE_DEFERRED(data, result);
+}
+
+// Class, flag, region and attribute predicates for one box. Stage 1 reads
+// only what the jbox getters return; attribute values are read only for
+// boxes that passed it.
+static bool matches_except_text(t_object* box, const object_query::Query& query,
+                                const std::vector<t_symbol*>& predicate_syms) {
+    object_query::BoxView view;
+    view.maxclass = PatchHelpers::get_box_maxclass(box, "");
+    t_object* obj = jbox_get_object(box);
+    t_symbol* obj_class = obj ? object_classname(obj) : nullptr;
+    view.object_class = (obj_class && obj_class->s_name) ? obj_class->s_name : "";
+    view.hidden = jbox_get_hidden(box) != 0;
+    view.presentation = jbox_get_presentation(box) != 0;
+    if (query.region) {
+        t_rect rect;
+        if (query.region->presentation) {
+            jbox_get_presentation_rect(box, &rect);
+            view.presentation_rect = {rect.x, rect.y, rect.width, rect.height};
+        } else {
+            jbox_get_patching_rect(box, &rect);
+            view.patching_rect = {rect.x, rect.y, rect.width, rect.height};
+        }
+    }
+    if (!query.matches_frame(view)) {
+        return false;
+    }
+
+    for (t_symbol* sym : predicate_syms) {
+        view.attributes.push_back(read_box_attribute(box, sym));
+    }
+    return query.matches_attributes(view);
+}
+
+// Box-list fingerprint, so the projection pass can tell the candidates'
+// pointers are still live
+static uint64_t box_list_revision(t_maxmcp* patch) {
+    pagination::RevisionHash revision(patch->structure_edits);
+    for (t_object* box = jpatcher_get_firstobject(patch->patcher); box;
+         box = jbox_get_nextobject(box)) {
+        revision.add(box);
+    }
+    return revision.value();
+}
+
+// Without a text predicate, filters and projects in one pass. With one, only
+// collects the candidates and their texts for the request thread to search.
+static void query_objects_deferred(t_maxmcp* patch, t_symbol* s, long argc, t_atom* argv) {
+    VALIDATE_DEFERRED_ARGS("query_objects_deferred");
+    EXTRACT_DEFERRED_DATA_WITH_RESULT(t_query_objects_data, data, argv);
+
+    const object_query::Query& query = data->query;
+
+    // Predicate and projection attributes share one symbol lookup per name
+    Symbols::Cache attr_syms;
+    std::vector<t_symbol*> predicate_syms;
+    for (const auto& pred : query.attributes) {
+        predicate_syms.push_back(attr_syms.get(pred.name));
+    }
+
+    if (data->candidates) {
+        QueryCandidates& candidates = *data->candidates;
+        int index = 0;
+        for (t_object* box = jpatcher_get_firstobject(data->patch->patcher); box;
+             box = jbox_get_nextobject(box), ++index) {
+            if (matches_except_text(box, query, predicate_syms)) {
+                candidates.boxes.push_back(box);
+                candidates.indexes.push_back(index);
+                candidates.texts.push_back(PatchHelpers::get_box_text(box));
+            }
+        }
+        candidates.revision = box_list_revision(data->patch);
+        COMPLETE_DEFERRED(data, json::object());
+        return;
+    }
+
+    std::vector<t_symbol*> field_syms;
+    for (const auto& name : data->fields.attributes) {
+        field_syms.push_back(attr_syms.get(name));
+    }
+
+    json objects = json::array();
+    bool truncated = false;
+    int index = 0;
+    for (t_object* box = jpatcher_get_firstobject(data->patch->patcher); box;
+         box = jbox_get_nextobject(box), ++index) {
+        if (!matches_except_text(box, query, predicate_syms)) {
+            continue;
+        }
+
+        if (query.limit && objects.size() == *query.limit) {
+            truncated = true;
+            break;
+        }
+        objects.push_back(project_box_fields(box, index, data->fields, field_syms));
+    }
+
+    json result = {{"patch_id", data->patch->patch_id},
+                   {"objects", objects},
+                   {"count", objects.size()}};
+    if (truncated) {
+        result["truncated"] = true;
+    }
+    COMPLETE_DEFERRED(data, result);
+}
+
+static void query_project_deferred(t_maxmcp* patch, t_symbol* s, long argc, t_atom* argv) {
+    VALIDATE_DEFERRED_ARGS("query_project_deferred");
+    EXTRACT_DEFERRED_DATA_WITH_RESULT(t_query_project_data, data, argv);
+
+    if (PatchRegistry::find_patch(data->patch_id) != data->patch) {
+        COMPLETE_DEFERRED(data, ToolCommon::patch_not_found_error(data->patch_id));
+        return;
+    }
+    const QueryCandidates& candidates = *data->candidates;
+    if (box_list_revision(data->patch) != candidates.revision) {
+        COMPLETE_DEFERRED(data, ToolCommon::make_error(ToolCommon::ErrorCode::INTERNAL_ERROR,
+                                                       "Patch changed during query_objects; "
+                                                       "retry the query"));
+        return;
+    }
+
+    Symbols::Cache attr_syms;
+    std::vector<t_symbol*> field_syms;
+    for (const auto& name : data->fields.attributes) {
+        field_syms.push_back(attr_syms.get(name));
+    }
+
+    json objects = json::array();
+    for (size_t i : data->selected) {
+        objects.push_back(project_box_fields(candidates.boxes[i], candidates.indexes[i],
+                                             data->fields, field_syms));
+    }
+
+    json result = {{"patch_id", data->patch_id}, {"objects", objects}, {"count", objects.size()}};
+    if (data->truncated) {
+        result["truncated"] = true;
+    }
+    COMPLETE_DEFERRED(data, result);
 }
 
 static void get_io_info_deferred(t_maxmcp* patch, t_symbol* s, long argc, t_atom* argv) {
@@ -412,6 +1165,15 @@ static void redraw_deferred(t_maxmcp* patch, t_symbol* s, long argc, t_atom* arg
     COMPLETE_DEFERRED(data, (json{{"success", true}, {"varname", data->varname}}));
 }
 
+// Create the replacement box for a box of the given maxclass. Textfield
+// content types are created empty and filled in by the caller.
+static t_object* create_replacement_box(t_object* patcher, const std::string& maxclass,
+                                        const std::string& new_text) {
+    const std::string& box_text =
+        PatchHelpers::is_textfield_content_type(maxclass) ? maxclass : new_text;
+    return (t_object*)newobject_fromboxtext(patcher, box_text.c_str());
+}
+
 /**
  * Deferred callback for replacing object box text.
  * Saves connections, deletes object, recreates with new text, restores connections.
@@ -440,16 +1202,11 @@ static void replace_object_text_deferred(t_maxmcp* patch, t_symbol* s, long argc
     // --- 2. Delete the old box ---
     object_free(box);
     box = nullptr;
+    ++data->patch->structure_edits;
 
     // --- 3. Create new box ---
-    t_object* new_box = nullptr;
     bool is_textfield_type = PatchHelpers::is_textfield_content_type(maxclass_str);
-
-    if (is_textfield_type) {
-        new_box = (t_object*)newobject_fromboxtext(patcher, maxclass_str.c_str());
-    } else {
-        new_box = (t_object*)newobject_fromboxtext(patcher, data->new_text.c_str());
-    }
+    t_object* new_box = create_replacement_box(patcher, maxclass_str, data->new_text);
 
     if (!new_box) {
         std::string msg = "Failed to recreate object with text: " + data->new_text;
@@ -460,7 +1217,7 @@ static void replace_object_text_deferred(t_maxmcp* patch, t_symbol* s, long argc
 
     // --- 4. Restore state ---
     PatchHelpers::restore_box_attributes(new_box, saved_attrs);
-    object_attr_setsym(new_box, gensym("varname"), gensym(data->varname.c_str()));
+    object_attr_setsym(new_box, Symbols::varname, gensym(data->varname.c_str()));
 
     if (is_textfield_type) {
         PatchHelpers::set_textfield_content(new_box, data->new_text);
@@ -481,6 +1238,127 @@ static void replace_object_text_deferred(t_maxmcp* patch, t_symbol* s, long argc
                                     {"reconnected", reconnected}}}}));
 }
 
+/**
+ * Deferred callback for replace_object_text_batch.
+ *
+ * Unlike the single-box version, each replacement box is created before the
+ * old one is freed, so a box whose new text does not instantiate stays in
+ * place with its connections intact. Connections of every target are
+ * snapshotted in one patchline scan up front and restored in one pass at the
+ * end, after all replacements, so lines between two replaced boxes land on
+ * both new boxes.
+ */
+static void replace_texts_deferred(t_maxmcp* patch, t_symbol* s, long argc, t_atom* argv) {
+    VALIDATE_DEFERRED_ARGS("replace_texts_deferred");
+    EXTRACT_DEFERRED_DATA_WITH_RESULT(t_replace_texts_data, data, argv);
+
+    t_object* patcher = data->patch->patcher;
+    auto boxes = PatchHelpers::index_boxes_by_varname(patcher);
+
+    // --- 1. Resolve targets and snapshot their connections once ---
+    std::vector<t_object*> targets(data->items.size(), nullptr);
+    std::unordered_set<t_object*> target_set;
+    for (size_t i = 0; i < data->items.size(); ++i) {
+        auto it = boxes.find(data->items[i].first);
+        if (it != boxes.end()) {
+            targets[i] = it->second;
+            target_set.insert(it->second);
+        }
+    }
+    auto saved_lines = PatchHelpers::save_patchlines_touching(patcher, target_set);
+
+    // --- 2. Recreate each target ---
+    batch::Tally tally(data->on_error);
+    json results = json::array();
+    std::unordered_map<t_object*, t_object*> replaced;  // old box -> new box
+    std::unordered_map<t_object*, size_t> result_of;    // old box -> index in results
+
+    for (size_t i = 0; i < data->items.size() && !tally.stopped(); ++i) {
+        const auto& [varname, new_text] = data->items[i];
+        t_object* old_box = targets[i];
+        if (!old_box) {
+            results.push_back(batch::item_error(i, "Object not found: " + varname));
+            tally.failed();
+            continue;
+        }
+
+        std::string maxclass_str = PatchHelpers::get_box_maxclass(old_box);
+        std::string old_text = PatchHelpers::get_box_text(old_box);
+        t_object* new_box = create_replacement_box(patcher, maxclass_str, new_text);
+        if (!new_box) {
+            // The old box was never touched, so neither were its connections
+            results.push_back(
+                batch::item_error(i, "Failed to recreate object with text: " + new_text));
+            tally.failed();
+            continue;
+        }
+
+        PatchHelpers::restore_box_attributes(new_box,
+                                             PatchHelpers::save_box_attributes(old_box));
+        object_free(old_box);
+        ++data->patch->structure_edits;
+        object_attr_setsym(new_box, Symbols::varname, gensym(varname.c_str()));
+        if (PatchHelpers::is_textfield_content_type(maxclass_str)) {
+            PatchHelpers::set_textfield_content(new_box, new_text);
+        }
+
+        replaced.emplace(old_box, new_box);
+        result_of.emplace(old_box, results.size());
+        results.push_back(batch::item_success(i, {{"varname", varname},
+                                                  {"old_text", old_text},
+                                                  {"new_text", new_text},
+                                                  {"reconnected", 0},
+                                                  {"lost", 0}}));
+        tally.succeeded();
+    }
+
+    // --- 3. Restore every connection of the replaced boxes in one pass ---
+    long reconnected = 0;
+    long lost = 0;
+    if (!replaced.empty()) {
+        auto present = PatchHelpers::restore_patchlines(patcher, saved_lines, replaced);
+        for (size_t l = 0; l < saved_lines.size(); ++l) {
+            const auto& pl = saved_lines[l];
+            if (!replaced.count(pl.src_box) && !replaced.count(pl.dst_box)) {
+                continue;
+            }
+            const char* counter = present[l] ? "reconnected" : "lost";
+            if (present[l]) {
+                ++reconnected;
+            } else {
+                ++lost;
+            }
+            for (t_object* end : {pl.src_box, pl.dst_box}) {
+                auto it = result_of.find(end);
+                if (it != result_of.end()) {
+                    json& entry = results[it->second];
+                    entry[counter] = entry[counter].get<long>() + 1;
+                }
+                if (pl.src_box == pl.dst_box) {
+                    break;
+                }
+            }
+        }
+        jpatcher_set_dirty(patcher, 1);
+    }
+
+    ConsoleLogger::log(("Object texts replaced: " + std::to_string(replaced.size()) + " (" +
+                        std::to_string(reconnected) + " connections restored, " +
+                        std::to_string(lost) + " lost)")
+                           .c_str());
+
+    json result = {{"status", tally.status()},
+                   {"replaced", tally.succeeded_count()},
+                   {"failed", tally.failed_count()},
+                   {"reconnected", reconnected},
+                   {"lost_connections", lost},
+                   {"results", results}};
+    if (tally.stopped()) {
+        result["stopped"] = true;
+    }
+    COMPLETE_DEFERRED(data, (json{{"result", result}}));
+}
+
 static void assign_varnames_deferred(t_maxmcp* patch, t_symbol* s, long argc, t_atom* argv) {
     VALIDATE_DEFERRED_ARGS("assign_varnames_deferred");
     EXTRACT_DEFERRED_DATA_WITH_RESULT(t_assign_varnames_data, data, argv);
@@ -519,7 +1397,7 @@ static void assign_varnames_deferred(t_maxmcp* patch, t_symbol* s, long argc, t_
         std::string varname = assignment["varname"].get<std::string>();
         t_object* box = boxes[idx];
 
-        object_attr_setsym(box, gensym("varname"), gensym(varname.c_str()));
+        object_attr_setsym(box, Symbols::varname, gensym(varname.c_str()));
 
         std::string maxclass_str = PatchHelpers::get_box_maxclass(box, "unknown");
 
@@ -620,12 +1498,65 @@ json get_tool_schemas() {
                             json{{"type", "array"}, {"items", json{{"type", "number"}}}}
                         })}}},
                         {"description",
-                            "Object attributes as a JSON object. Each value must be a JSON "
-                            "number, string, or array of numbers WITHOUT surrounding quotes. "
-                            "e.g., {\"bgcolor\": [1.0, 0.5, 0.0, 1.0]}"}
+                            "Object attributes as a JSON object. Each value must be a JSON "
+                            "number, string, or array of numbers WITHOUT surrounding quotes. "
+                            "e.g., {\"bgcolor\": [1.0, 0.5, 0.0, 1.0]}"}
+                    }}
+                }},
+                {"required", json::array({"patch_id", "obj_type", "position"})}
+            }}
+        },
+        // ---- add_max_objects ----
+        {
+            {"name", "add_max_objects"},
+            {"description",
+                "Add several Max objects (and optionally connect them) in a single pass. "
+                "Each object takes the same fields as add_max_object. Connections may "
+                "reference varnames of objects created earlier in the same call. Returns "
+                "one result per object and per connection."},
+            {"inputSchema", {
+                {"type", "object"},
+                {"properties", {
+                    {"patch_id", {{"type", "string"}, {"description", "Patch ID to add objects to"}}},
+                    {"objects", {
+                        {"type", "array"},
+                        {"items", {
+                            {"type", "object"},
+                            {"properties", {
+                                {"obj_type", {{"type", "string"}}},
+                                {"position", {{"type", "array"}, {"items", {{"type", "number"}}}}},
+                                {"varname", {{"type", "string"}}},
+                                {"arguments", {{"type", "array"}}},
+                                {"attributes", {{"type", "object"}}}
+                            }},
+                            {"required", json::array({"obj_type", "position"})}
+                        }},
+                        {"description", "Objects to create, in order (see add_max_object)"}
+                    }},
+                    {"connections", {
+                        {"type", "array"},
+                        {"items", {
+                            {"type", "object"},
+                            {"properties", {
+                                {"src_varname", {{"type", "string"}}},
+                                {"outlet", {{"type", "integer"}}},
+                                {"dst_varname", {{"type", "string"}}},
+                                {"inlet", {{"type", "integer"}}}
+                            }},
+                            {"required",
+                                json::array({"src_varname", "outlet", "dst_varname", "inlet"})}
+                        }},
+                        {"description", "Patchcords to create after all objects (optional)"}
+                    }},
+                    {"on_error", {
+                        {"type", "string"},
+                        {"enum", json::array({"stop", "continue"})},
+                        {"description",
+                            "'stop' (default): stop at the first failed item. "
+                            "'continue': attempt every item"}
                     }}
                 }},
-                {"required", json::array({"patch_id", "obj_type", "position"})}
+                {"required", json::array({"patch_id", "objects"})}
             }}
         },
         // ---- remove_max_object ----
@@ -660,6 +1591,107 @@ json get_tool_schemas() {
                             "'layout' returns only varname, position, size — for "
                             "layout/positioning work. 'identity' returns only index, "
                             "varname, maxclass, text — for naming and inspection."}
+                    }},
+                    {"fields", {
+                        {"type", "array"},
+                        {"items", {{"type", "string"}}},
+                        {"description",
+                            "Optional projection, instead of 'mode'. Built-in fields: index, "
+                            "varname, maxclass, text, position, size, presentation_rect, "
+                            "hidden, presentation. Any other name is read as a box attribute "
+                            "(e.g. 'bgcolor', 'fontsize'); null when the box has no such "
+                            "attribute."}
+                    }},
+                    {"encoding", {
+                        {"type", "string"},
+                        {"enum", json::array({"rows", "columnar"})},
+                        {"description",
+                            "Optional response layout. 'rows' (default) returns one object per "
+                            "box. 'columnar' returns parallel arrays under 'columns' (position/"
+                            "size split into x, y, width, height), class names as ids into "
+                            "'tables.maxclass', attribute fields under 'attributes', and "
+                            "'index_start' in place of per-box indices — several times smaller "
+                            "for large patches."}
+                    }},
+                    {"limit", {
+                        {"type", "integer"},
+                        {"minimum", 1},
+                        {"description",
+                            "Optional page size. When set (or when 'cursor' is passed) the "
+                            "response adds 'total' and, if more objects remain, 'next_cursor'."}
+                    }},
+                    {"cursor", {
+                        {"type", "string"},
+                        {"description",
+                            "Opaque 'next_cursor' from a previous page. Fails with an error if "
+                            "objects were added, removed or reordered since it was issued."}
+                    }}
+                }},
+                {"required", json::array({"patch_id"})}
+            }}
+        },
+        // ---- query_objects ----
+        {
+            {"name", "query_objects"},
+            {"description",
+                "Find objects matching a filter without listing the whole patch. All 'where' "
+                "predicates must hold. Returns only the matches, projected like "
+                "get_objects_in_patch (default fields: index, varname, maxclass, text)."},
+            {"inputSchema", {
+                {"type", "object"},
+                {"properties", {
+                    {"patch_id", {{"type", "string"}, {"description", "Patch ID to query"}}},
+                    {"where", {
+                        {"type", "object"},
+                        {"properties", {
+                            {"maxclass", {
+                                {"description",
+                                    "Class name or array of names. Matches the box class "
+                                    "(e.g. 'message') or the class of the object in an object "
+                                    "box (e.g. 'send~')"}
+                            }},
+                            {"text", {
+                                {"type", "string"},
+                                {"description", "Regular expression searched in the box text (e.g. '^p voice')"}
+                            }},
+                            {"attributes", {
+                                {"type", "array"},
+                                {"items", {
+                                    {"type", "object"},
+                                    {"properties", {
+                                        {"name", {{"type", "string"}}},
+                                        {"op", {{"type", "string"}, {"enum", json::array({"==", "!=", "<", "<=", ">", ">="})}}},
+                                        {"value", {{"description", "Number, string or array; numbers only for <, <=, >, >="}}}
+                                    }},
+                                    {"required", json::array({"name", "value"})}
+                                }},
+                                {"description", "Attribute comparisons; op defaults to '=='. A missing attribute never matches"}
+                            }},
+                            {"region", {
+                                {"type", "object"},
+                                {"properties", {
+                                    {"rect", {{"type", "array"}, {"items", {{"type", "number"}}}, {"description", "[x, y, width, height]"}}},
+                                    {"mode", {{"type", "string"}, {"enum", json::array({"intersect", "contain"})}}},
+                                    {"space", {{"type", "string"}, {"enum", json::array({"patching", "presentation"})}}}
+                                }},
+                                {"required", json::array({"rect"})}
+                            }},
+                            {"hidden", {{"type", "boolean"}}},
+                            {"presentation", {{"type", "boolean"}, {"description", "Whether the box is in presentation mode"}}}
+                        }},
+                        {"description", "Filter; omit to match every object"}
+                    }},
+                    {"fields", {
+                        {"type", "array"},
+                        {"items", {{"type", "string"}}},
+                        {"description", "Projection, as in get_objects_in_patch"}
+                    }},
+                    {"limit", {
+                        {"type", "integer"},
+                        {"minimum", 1},
+                        {"description",
+                            "Stop after this many matches; the response then has "
+                            "'truncated': true if more objects matched"}
                     }}
                 }},
                 {"required", json::array({"patch_id"})}
@@ -714,6 +1746,97 @@ json get_tool_schemas() {
                 {"required", json::array({"patch_id", "varname", "attribute"})}
             }}
         },
+        // ---- set_object_attributes ----
+        {
+            {"name", "set_object_attributes"},
+            {"description",
+                "Set attributes on many objects in one pass. Pass either 'items' "
+                "({varname, attribute, value} triples) or a 'selector' with an 'attributes' "
+                "map applied to every matching box. Returns one result per item or box."},
+            {"inputSchema", {
+                {"type", "object"},
+                {"properties", {
+                    {"patch_id", {{"type", "string"}, {"description", "Patch ID containing the objects"}}},
+                    {"items", {
+                        {"type", "array"},
+                        {"items", {
+                            {"type", "object"},
+                            {"properties", {
+                                {"varname", {{"type", "string"}}},
+                                {"attribute", {{"type", "string"}}},
+                                {"value", {{"description", "Number, string or array of them"}}}
+                            }},
+                            {"required", json::array({"varname", "attribute", "value"})}
+                        }},
+                        {"description", "Explicit writes, applied in order"}
+                    }},
+                    {"selector", {
+                        {"type", "object"},
+                        {"properties", {
+                            {"maxclass", {{"type", "string"}}},
+                            {"region", {{"type", "array"}, {"items", {{"type", "number"}}}}}
+                        }},
+                        {"description",
+                            "Select boxes by maxclass and/or a patching region [x, y, w, h] "
+                            "(boxes overlapping it). Both criteria must hold when both are given."}
+                    }},
+                    {"attributes", {
+                        {"type", "object"},
+                        {"description",
+                            "With 'selector': {attribute: value} applied to every selected box, "
+                            "e.g. {\"fontsize\": 14, \"textcolor\": [1, 0, 0, 1]}"}
+                    }},
+                    {"on_error", {
+                        {"type", "string"},
+                        {"enum", json::array({"stop", "continue"})},
+                        {"description",
+                            "'stop' (default): stop at the first failed item. "
+                            "'continue': attempt every item"}
+                    }}
+                }},
+                {"required", json::array({"patch_id"})}
+            }}
+        },
+        // ---- get_object_attributes ----
+        {
+            {"name", "get_object_attributes"},
+            {"description",
+                "Read attributes from many objects in one pass. Pass either 'items' "
+                "({varname, attribute} pairs) or a 'selector' with a list of 'attributes' "
+                "to read from every matching box (missing attributes come back as null)."},
+            {"inputSchema", {
+                {"type", "object"},
+                {"properties", {
+                    {"patch_id", {{"type", "string"}, {"description", "Patch ID containing the objects"}}},
+                    {"items", {
+                        {"type", "array"},
+                        {"items", {
+                            {"type", "object"},
+                            {"properties", {
+                                {"varname", {{"type", "string"}}},
+                                {"attribute", {{"type", "string"}}}
+                            }},
+                            {"required", json::array({"varname", "attribute"})}
+                        }},
+                        {"description", "Explicit reads"}
+                    }},
+                    {"selector", {
+                        {"type", "object"},
+                        {"properties", {
+                            {"maxclass", {{"type", "string"}}},
+                            {"region", {{"type", "array"}, {"items", {{"type", "number"}}}}}
+                        }},
+                        {"description", "Same as set_object_attributes"}
+                    }},
+                    {"attributes", {
+                        {"type", "array"},
+                        {"items", {{"type", "string"}}},
+                        {"description", "With 'selector': attribute names to read"}
+                    }}
+                }},
+                {"required", json::array({"patch_id"})}
+            }}
+        },
         // ---- get_object_io_info ----
         {
             {"name", "get_object_io_info"},
@@ -794,6 +1917,42 @@ json get_tool_schemas() {
                 {"required", json::array({"patch_id", "varname", "new_text"})}
             }}
         },
+        // ---- replace_object_text_batch ----
+        {
+            {"name", "replace_object_text_batch"},
+            {"description",
+                "Replace the box text of many objects in one pass (see replace_object_text). "
+                "Connections of all targets are saved once and restored after every box has "
+                "been recreated, including connections between two replaced boxes. A box "
+                "whose new text fails to instantiate is left unchanged with its connections. "
+                "Returns one result per item."},
+            {"inputSchema", {
+                {"type", "object"},
+                {"properties", {
+                    {"patch_id", {{"type", "string"}, {"description", "Patch ID containing the objects"}}},
+                    {"items", {
+                        {"type", "array"},
+                        {"items", {
+                            {"type", "object"},
+                            {"properties", {
+                                {"varname", {{"type", "string"}}},
+                                {"new_text", {{"type", "string"}}}
+                            }},
+                            {"required", json::array({"varname", "new_text"})}
+                        }},
+                        {"description", "Boxes to replace; each varname at most once"}
+                    }},
+                    {"on_error", {
+                        {"type", "string"},
+                        {"enum", json::array({"stop", "continue"})},
+                        {"description",
+                            "'stop' (default): stop at the first failed item. "
+                            "'continue': attempt every item"}
+                    }}
+                }},
+                {"required", json::array({"patch_id", "items"})}
+            }}
+        },
         // ---- assign_varnames ----
         {
             {"name", "assign_varnames"},
@@ -854,39 +2013,53 @@ json get_tool_schemas() {
 
 #ifndef MAXMCP_TEST_MODE
 
-json execute_add_max_object(const json& params) {
-    std::string patch_id = params.value("patch_id", "");
-    std::string obj_type = params.value("obj_type", "");
-    std::string varname = params.value("varname", "");
-    json arguments = params.value("arguments", json::array());
+// Parse one object description (add_max_object params or an add_max_objects
+// item) into spec. Returns an error message, or "" on success.
+static std::string parse_object_spec(const json& item, ObjectSpec& spec) {
+    spec.obj_type = item.value("obj_type", "");
+    spec.varname = item.value("varname", "");
+    spec.arguments = item.value("arguments", json::array());
 
-    json attributes = json::object();
-    if (params.contains("attributes")) {
-        if (params["attributes"].is_string()) {
+    spec.attributes = json::object();
+    if (item.contains("attributes")) {
+        if (item["attributes"].is_string()) {
             try {
-                attributes = json::parse(params["attributes"].get<std::string>());
+                spec.attributes = json::parse(item["attributes"].get<std::string>());
             } catch (const json::exception& e) {
-                return ToolCommon::make_error(ToolCommon::ErrorCode::INVALID_PARAMS,
-                                              "Invalid attributes JSON: " + std::string(e.what()));
+                return "Invalid attributes JSON: " + std::string(e.what());
             }
-        } else if (params["attributes"].is_object()) {
-            attributes = params["attributes"];
+        } else if (item["attributes"].is_object()) {
+            spec.attributes = item["attributes"];
         }
     }
 
-    if (patch_id.empty() || obj_type.empty()) {
-        return ToolCommon::make_error(ToolCommon::ErrorCode::INVALID_PARAMS,
-                                      "Missing required parameters: patch_id and obj_type");
+    if (spec.obj_type.empty()) {
+        return "Missing required parameter: obj_type";
     }
 
-    if (!params.contains("position") || !params["position"].is_array() ||
-        params["position"].size() < 2) {
+    if (!item.contains("position") || !item["position"].is_array() ||
+        item["position"].size() < 2 || !item["position"][0].is_number() ||
+        !item["position"][1].is_number()) {
+        return "Invalid position parameter: must be array [x, y]";
+    }
+
+    spec.x = item["position"][0].get<double>();
+    spec.y = item["position"][1].get<double>();
+    return "";
+}
+
+json execute_add_max_object(const json& params) {
+    std::string patch_id = params.value("patch_id", "");
+    if (patch_id.empty() || params.value("obj_type", "").empty()) {
         return ToolCommon::make_error(ToolCommon::ErrorCode::INVALID_PARAMS,
-                                      "Invalid position parameter: must be array [x, y]");
+                                      "Missing required parameters: patch_id and obj_type");
     }
 
-    double x = params["position"][0].get<double>();
-    double y = params["position"][1].get<double>();
+    ObjectSpec spec;
+    std::string error = parse_object_spec(params, spec);
+    if (!error.empty()) {
+        return ToolCommon::make_error(ToolCommon::ErrorCode::INVALID_PARAMS, error);
+    }
 
     t_maxmcp* patch = PatchRegistry::find_patch(patch_id);
     if (!patch) {
@@ -894,14 +2067,81 @@ json execute_add_max_object(const json& params) {
     }
 
     auto* deferred_result = new ToolCommon::DeferredResult();
-    auto* data = new t_add_object_data{patch,   obj_type,  x,          y,
-                                       varname, arguments, attributes, deferred_result};
+    auto* data = new t_add_object_data{patch, std::move(spec), deferred_result};
 
     return ToolCommon::run_deferred(patch, (method)add_object_deferred, "add_object", data,
                                     ToolCommon::DEFAULT_DEFER_TIMEOUT, "creating object",
                                     ToolCommon::DeferredWrap::Raw);
 }
 
+// add_max_objects; fills @p created with the box per item when it is set
+static json add_objects(const json& params, std::shared_ptr<std::vector<t_object*>> created) {
+    std::string patch_id = params.value("patch_id", "");
+    if (patch_id.empty()) {
+        return ToolCommon::missing_param_error("patch_id");
+    }
+    if (!params.contains("objects") || !params["objects"].is_array() ||
+        params["objects"].empty()) {
+        return ToolCommon::make_error(ToolCommon::ErrorCode::INVALID_PARAMS,
+                                      "objects must be a non-empty array");
+    }
+
+    // Validate every item up front so a malformed request creates nothing
+    const json& items = params["objects"];
+    std::vector<ObjectSpec> objects(items.size());
+    for (size_t i = 0; i < items.size(); ++i) {
+        std::string where = "objects[" + std::to_string(i) + "]";
+        if (!items[i].is_object()) {
+            return ToolCommon::make_error(ToolCommon::ErrorCode::INVALID_PARAMS,
+                                          where + " must be an object");
+        }
+        std::string error = parse_object_spec(items[i], objects[i]);
+        if (!error.empty()) {
+            return ToolCommon::make_error(ToolCommon::ErrorCode::INVALID_PARAMS,
+                                          where + ": " + error);
+        }
+    }
+
+    std::vector<batch::ConnectionSpec> connections;
+    json error = batch::parse_connection_specs(params, "connections", false, connections);
+    if (!error.is_null()) {
+        return error;
+    }
+
+    batch::OnError on_error;
+    error = batch::parse_on_error(params, on_error);
+    if (!error.is_null()) {
+        return error;
+    }
+
+    t_maxmcp* patch = PatchRegistry::find_patch(patch_id);
+    if (!patch) {
+        return ToolCommon::patch_not_found_error(patch_id);
+    }
+
+    auto* deferred_result = new ToolCommon::DeferredResult();
+    auto* data = new t_add_objects_data{patch, std::move(objects), std::move(connections),
+                                        on_error, std::move(created), deferred_result};
+
+    return ToolCommon::run_deferred(patch, (method)add_objects_deferred, "add_objects", data,
+                                    ToolCommon::HEAVY_OPERATION_TIMEOUT, "creating objects",
+                                    ToolCommon::DeferredWrap::Raw);
+}
+
+json execute_add_max_objects(const json& params) {
+    return add_objects(params, nullptr);
+}
+
+json add_max_objects(const json& params, std::vector<t_object*>& created) {
+    // Shared with the callback, which may still run after a timeout
+    auto boxes = std::make_shared<std::vector<t_object*>>();
+    json result = add_objects(params, boxes);
+    if (!result.contains("error")) {
+        created = *boxes;
+    }
+    return result;
+}
+
 json execute_remove_max_object(const json& params) {
     std::string patch_id = params.value("patch_id", "");
     std::string varname = params.value("varname", "");
@@ -938,13 +2178,108 @@ json execute_get_objects_in_patch(const json& params) {
 
     GetObjectsMode mode = parse_get_objects_mode(params.value("mode", ""));
 
+    std::optional<field_selection::FieldSelection> fields;
+    json fields_error = field_selection::parse_fields(params, kObjectFieldNames, fields);
+    if (!fields_error.is_null()) {
+        return fields_error;
+    }
+
+    pagination::PageRequest page;
+    json page_error = pagination::parse_page_request(params, page);
+    if (!page_error.is_null()) {
+        return page_error;
+    }
+
+    std::string encoding = params.value("encoding", "rows");
+    if (encoding != "rows" && encoding != "columnar") {
+        return ToolCommon::make_error(ToolCommon::ErrorCode::INVALID_PARAMS,
+                                      "encoding must be 'rows' or 'columnar'");
+    }
+
     auto* deferred_result = new ToolCommon::DeferredResult();
-    t_get_objects_data* data = new t_get_objects_data{patch, mode, deferred_result};
+    t_get_objects_data* data = new t_get_objects_data{
+        patch, mode, std::move(fields), encoding == "columnar", page, deferred_result};
 
     return ToolCommon::run_deferred(patch, (method)get_objects_deferred, "get_objects", data,
                                     ToolCommon::HEAVY_OPERATION_TIMEOUT,
                                     "waiting for patch object list",
-                                    ToolCommon::DeferredWrap::Always);
+                                    ToolCommon::DeferredWrap::OnSuccess);
+}
+
+json execute_query_objects(const json& params) {
+    std::string patch_id = params.value("patch_id", "");
+    if (patch_id.empty()) {
+        return ToolCommon::missing_param_error("patch_id");
+    }
+
+    object_query::Query query;
+    json error = object_query::parse_query(params, query);
+    if (!error.is_null()) {
+        return error;
+    }
+
+    std::optional<field_selection::FieldSelection> fields;
+    error = field_selection::parse_fields(params, kObjectFieldNames, fields);
+    if (!error.is_null()) {
+        return error;
+    }
+    if (!fields) {
+        fields = field_selection::FieldSelection{
+            builtin_fields_for_mode(GetObjectsMode::Identity), {}};
+    }
+
+    t_maxmcp* patch = PatchRegistry::find_patch(patch_id);
+    if (!patch) {
+        return ToolCommon::patch_not_found_error(patch_id);
+    }
+
+    if (!query.needs_text()) {
+        auto* deferred_result = new ToolCommon::DeferredResult();
+        auto* data = new t_query_objects_data{patch, std::move(query), std::move(*fields),
+                                              nullptr, deferred_result};
+
+        return ToolCommon::run_deferred(patch, (method)query_objects_deferred, "query_objects",
+                                        data, ToolCommon::HEAVY_OPERATION_TIMEOUT,
+                                        "querying objects", ToolCommon::DeferredWrap::OnSuccess);
+    }
+
+    // Text query: collect candidates and texts on the main thread, search them
+    // here, then project the matches in a second main-thread pass
+    auto candidates = std::make_shared<QueryCandidates>();
+    auto* deferred_result = new ToolCommon::DeferredResult();
+    auto* data = new t_query_objects_data{patch, query, *fields, candidates, deferred_result};
+    json collected = ToolCommon::run_deferred(patch, (method)query_objects_deferred,
+                                              "query_objects", data,
+                                              ToolCommon::HEAVY_OPERATION_TIMEOUT,
+                                              "querying objects", ToolCommon::DeferredWrap::Raw);
+    if (collected.contains("error")) {
+        return collected;
+    }
+
+    std::vector<size_t> selected;
+    bool truncated = false;
+    for (size_t i = 0; i < candidates->texts.size(); ++i) {
+        if (!query.matches_text(candidates->texts[i])) {
+            continue;
+        }
+        if (query.limit && selected.size() == *query.limit) {
+            truncated = true;
+            break;
+        }
+        selected.push_back(i);
+    }
+
+    if (PatchRegistry::find_patch(patch_id) != patch) {
+        return ToolCommon::patch_not_found_error(patch_id);
+    }
+    auto* project_result = new ToolCommon::DeferredResult();
+    auto* project = new t_query_project_data{
+        patch, patch_id, candidates, std::move(selected), truncated, std::move(*fields),
+        project_result};
+    return ToolCommon::run_deferred(patch, (method)query_project_deferred, "query_project",
+                                    project, ToolCommon::HEAVY_OPERATION_TIMEOUT,
+                                    "projecting query matches",
+                                    ToolCommon::DeferredWrap::OnSuccess);
 }
 
 json execute_set_object_attribute(const json& params) {
@@ -1001,6 +2336,63 @@ json execute_get_object_attribute(const json& params) {
                                     ToolCommon::DeferredWrap::Raw);
 }
 
+json execute_set_object_attributes(const json& params) {
+    std::string patch_id = params.value("patch_id", "");
+    if (patch_id.empty()) {
+        return ToolCommon::missing_param_error("patch_id");
+    }
+
+    batch::AttributeRequest request;
+    json error = batch::parse_attribute_request(params, true, request);
+    if (!error.is_null()) {
+        return error;
+    }
+
+    batch::OnError on_error;
+    error = batch::parse_on_error(params, on_error);
+    if (!error.is_null()) {
+        return error;
+    }
+
+    t_maxmcp* patch = PatchRegistry::find_patch(patch_id);
+    if (!patch) {
+        return ToolCommon::patch_not_found_error(patch_id);
+    }
+
+    auto* deferred_result = new ToolCommon::DeferredResult();
+    auto* data = new t_attributes_data{patch, std::move(request), on_error, deferred_result};
+
+    return ToolCommon::run_deferred(patch, (method)set_attributes_deferred, "set_attributes",
+                                    data, ToolCommon::HEAVY_OPERATION_TIMEOUT,
+                                    "setting attributes", ToolCommon::DeferredWrap::Raw);
+}
+
+json execute_get_object_attributes(const json& params) {
+    std::string patch_id = params.value("patch_id", "");
+    if (patch_id.empty()) {
+        return ToolCommon::missing_param_error("patch_id");
+    }
+
+    batch::AttributeRequest request;
+    json error = batch::parse_attribute_request(params, false, request);
+    if (!error.is_null()) {
+        return error;
+    }
+
+    t_maxmcp* patch = PatchRegistry::find_patch(patch_id);
+    if (!patch) {
+        return ToolCommon::patch_not_found_error(patch_id);
+    }
+
+    auto* deferred_result = new ToolCommon::DeferredResult();
+    auto* data =
+        new t_attributes_data{patch, std::move(request), batch::OnError::Continue, deferred_result};
+
+    return ToolCommon::run_deferred(patch, (method)get_attributes_deferred, "get_attributes",
+                                    data, ToolCommon::HEAVY_OPERATION_TIMEOUT,
+                                    "getting attributes", ToolCommon::DeferredWrap::Raw);
+}
+
 json execute_get_object_io_info(const json& params) {
     std::string patch_id = params.value("patch_id", "");
     std::string varname = params.value("varname", "");
@@ -1119,6 +2511,61 @@ json execute_replace_object_text(const json& params) {
                                     "replacing object text", ToolCommon::DeferredWrap::Raw);
 }
 
+json execute_replace_object_text_batch(const json& params) {
+    std::string patch_id = params.value("patch_id", "");
+    if (patch_id.empty()) {
+        return ToolCommon::missing_param_error("patch_id");
+    }
+    if (!params.contains("items") || !params["items"].is_array() || params["items"].empty()) {
+        return ToolCommon::make_error(ToolCommon::ErrorCode::INVALID_PARAMS,
+                                      "items must be a non-empty array");
+    }
+
+    const json& items = params["items"];
+    std::vector<std::pair<std::string, std::string>> parsed;
+    std::set<std::string> seen;
+    parsed.reserve(items.size());
+    for (size_t i = 0; i < items.size(); ++i) {
+        const json& item = items[i];
+        std::string where = "items[" + std::to_string(i) + "]";
+        if (!item.is_object() || !item.contains("varname") || !item["varname"].is_string() ||
+            !item.contains("new_text") || !item["new_text"].is_string()) {
+            return ToolCommon::make_error(ToolCommon::ErrorCode::INVALID_PARAMS,
+                                          where + " needs string varname and new_text");
+        }
+        std::string varname = item["varname"].get<std::string>();
+        std::string new_text = item["new_text"].get<std::string>();
+        if (varname.empty() || new_text.empty()) {
+            return ToolCommon::make_error(ToolCommon::ErrorCode::INVALID_PARAMS,
+                                          where + " needs non-empty varname and new_text");
+        }
+        if (!seen.insert(varname).second) {
+            return ToolCommon::make_error(ToolCommon::ErrorCode::INVALID_PARAMS,
+                                          where + " repeats varname: " + varname);
+        }
+        parsed.emplace_back(std::move(varname), std::move(new_text));
+    }
+
+    batch::OnError on_error;
+    json error = batch::parse_on_error(params, on_error);
+    if (!error.is_null()) {
+        return error;
+    }
+
+    t_maxmcp* patch = PatchRegistry::find_patch(patch_id);
+    if (!patch) {
+        return ToolCommon::patch_not_found_error(patch_id);
+    }
+
+    auto* deferred_result = new ToolCommon::DeferredResult();
+    auto* data = new t_replace_texts_data{patch, std::move(parsed), on_error, deferred_result};
+
+    return ToolCommon::run_deferred(patch, (method)replace_texts_deferred,
+                                    "replace_object_text_batch", data,
+                                    ToolCommon::HEAVY_OPERATION_TIMEOUT, "replacing object texts",
+                                    ToolCommon::DeferredWrap::Raw);
+}
+
 json execute_assign_varnames(const json& params) {
     std::string patch_id = params.value("patch_id", "");
 
@@ -1196,10 +2643,13 @@ json execute_get_object_value(const json& params) {
 
 json execute(const std::string& tool, const json& params) {
 #ifdef MAXMCP_TEST_MODE
-    if (tool == "add_max_object" || tool == "remove_max_object" || tool == "get_objects_in_patch" ||
+    if (tool == "add_max_object" || tool == "add_max_objects" || tool == "remove_max_object" ||
+        tool == "get_objects_in_patch" || tool == "query_objects" ||
         tool == "set_object_attribute" || tool == "get_object_attribute" ||
-        tool == "get_object_io_info" || tool == "get_object_hidden" ||
-        tool == "set_object_hidden" || tool == "redraw_object" || tool == "replace_object_text" ||
+        tool == "set_object_attributes" || tool == "get_object_attributes" ||
+        tool == "get_object_io_info" ||
+        tool == "get_object_hidden" || tool == "set_object_hidden" || tool == "redraw_object" ||
+        tool == "replace_object_text" || tool == "replace_object_text_batch" ||
         tool == "assign_varnames" || tool == "get_object_value") {
         return ToolCommon::test_mode_error();
     }
@@ -1207,14 +2657,22 @@ json execute(const std::string& tool, const json& params) {
 #else
     if (tool == "add_max_object") {
         return execute_add_max_object(params);
+    } else if (tool == "add_max_objects") {
+        return execute_add_max_objects(params);
     } else if (tool == "remove_max_object") {
         return execute_remove_max_object(params);
     } else if (tool == "get_objects_in_patch") {
         return execute_get_objects_in_patch(params);
+    } else if (tool == "query_objects") {
+        return execute_query_objects(params);
     } else if (tool == "set_object_attribute") {
         return execute_set_object_attribute(params);
     } else if (tool == "get_object_attribute") {
         return execute_get_object_attribute(params);
+    } else if (tool == "set_object_attributes") {
+        return execute_set_object_attributes(params);
+    } else if (tool == "get_object_attributes") {
+        return execute_get_object_attributes(params);
     } else if (tool == "get_object_io_info") {
         return execute_get_object_io_info(params);
     } else if (tool == "get_object_hidden") {
@@ -1225,6 +2683,8 @@ json execute(const std::string& tool, const json& params) {
         return execute_redraw_object(params);
     } else if (tool == "replace_object_text") {
         return execute_replace_object_text(params);
+    } else if (tool == "replace_object_text_batch") {
+        return execute_replace_object_text_batch(params);
     } else if (tool == "assign_varnames") {
         return execute_assign_varnames(params);
     } else if (tool == "get_object_value") {
@@ -11,6 +11,7 @@
 #define OBJECT_TOOLS_H
 
 #include <string>
+#include <vector>
 
 #include <nlohmann/json.hpp>
 
@@ -28,16 +29,21 @@ using json = nlohmann::json;
  *
  * Tools included:
  * - add_max_object
+ * - add_max_objects
  * - remove_max_object
  * - get_objects_in_patch
+ * - query_objects
  * - set_object_attribute
  * - get_object_attribute
+ * - set_object_attributes
+ * - get_object_attributes
  * - get_object_value
  * - get_object_io_info
  * - get_object_hidden
  * - set_object_hidden
  * - redraw_object
  * - replace_object_text
+ * - replace_object_text_batch
  * - assign_varnames
  *
  * @return JSON array of tool schema objects
@@ -55,4 +61,23 @@ json execute(const std::string& tool, const json& params);
 
 }  // namespace ObjectTools
 
+#ifndef MAXMCP_TEST_MODE
+
+#include "ext.h"
+
+namespace ObjectTools {
+
+/**
+ * add_max_objects for tools that build on it (place_objects).
+ *
+ * Same parameters and result as the tool. On success, @p created holds the
+ * box made for each item, or nullptr where none was; a later main-thread pass
+ * must check the boxes are still in the patcher before using them.
+ */
+json add_max_objects(const json& params, std::vector<t_object*>& created);
+
+}  // namespace ObjectTools
+
+#endif  // MAXMCP_TEST_MODE
+
 #endif  // OBJECT_TOOLS_H
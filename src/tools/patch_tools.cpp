@@ -7,12 +7,543 @@
 
 #include "patch_tools.h"
 
+#include "maxmcp.h"
 #include "tool_common.h"
 #include "utils/console_logger.h"
+#include "utils/json_writer.h"
+#include "utils/maxpat.h"
+#include "utils/pagination.h"
+#include "utils/patch_helpers.h"
 #include "utils/patch_registry.h"
+#include "utils/symbols.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <tuple>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#ifndef MAXMCP_TEST_MODE
+#include "ext.h"
+#include "ext_obex.h"
+
+#include "jpatcher_api.h"
+#endif
 
 namespace PatchTools {
 
+using ToolCommon::DeferredResult;
+
+// export_patch response size limits (bytes of .maxpat text per response)
+constexpr long long kDefaultExportChunkBytes = 256 * 1024;
+constexpr long long kMinExportChunkBytes = 1024;
+
+// Main-thread time one export capture slice may use before yielding
+constexpr auto kExportSliceBudget = std::chrono::milliseconds(10);
+
+// Exports too large for one response, parked until their chunks are fetched
+static maxpat::ExportStore& export_store() {
+    static maxpat::ExportStore store;
+    return store;
+}
+
+// ============================================================================
+// Data Structures for Deferred Callbacks
+// ============================================================================
+
+// Completion state of one export, shared by the executor and the capture
+// slices: a slice still queued when the executor times out finds the job
+// cancelled instead of writing to a result nobody waits for.
+struct ExportJob {
+    DeferredResult result;
+    std::atomic<bool> cancelled{false};
+};
+
+struct t_export_patch_data {
+    t_maxmcp* patch;
+    std::string patch_id;  ///< To re-check in the registry before each slice
+    bool recursive;
+    std::shared_ptr<maxpat::PatcherSnapshot> snapshot;  ///< Shared with the executor
+    std::vector<t_object*> boxes;                       ///< Capture order, fixed by slice 1
+    uint64_t revision;                                  ///< Box-list fingerprint at slice 1
+    size_t next_box;                                    ///< First box of the next slice
+    bool started;
+    std::shared_ptr<ExportJob> job;
+};
+
+struct t_import_fragment_data {
+    t_maxmcp* patch;
+    maxpat::Fragment fragment;  ///< Validated, offset already applied
+    DeferredResult* deferred_result;
+};
+
+// ============================================================================
+// Deferred Callbacks (executed on Max main thread)
+// ============================================================================
+
+#ifndef MAXMCP_TEST_MODE
+
+// Walk the box list, returning its fingerprint and optionally the boxes.
+// @p structure_edits is the owning patch's edit counter (0 for subpatchers).
+static uint64_t collect_boxes(t_object* patcher, uint64_t structure_edits,
+                              std::vector<t_object*>* boxes) {
+    pagination::RevisionHash revision(structure_edits);
+    for (t_object* box = jpatcher_get_firstobject(patcher); box != nullptr;
+         box = jbox_get_nextobject(box)) {
+        revision.add(box);
+        if (boxes) {
+            boxes->push_back(box);
+        }
+    }
+    return revision.value();
+}
+
+static void capture_atoms(const std::vector<t_atom>& atoms, std::vector<maxpat::AtomValue>& out) {
+    out.reserve(atoms.size());
+    for (const t_atom& atom : atoms) {
+        maxpat::AtomValue value;
+        switch (atom_gettype(&atom)) {
+        case A_LONG:
+            value.type = maxpat::AtomValue::Type::Long;
+            value.number = static_cast<double>(atom_getlong(&atom));
+            break;
+        case A_FLOAT:
+            value.type = maxpat::AtomValue::Type::Float;
+            value.number = atom_getfloat(&atom);
+            break;
+        case A_SYM: {
+            t_symbol* sym = atom_getsym(&atom);
+            value.type = maxpat::AtomValue::Type::Symbol;
+            value.symbol = (sym && sym->s_name) ? sym->s_name : "";
+            break;
+        }
+        default:
+            continue;  // Object pointers etc. have no file representation
+        }
+        out.push_back(std::move(value));
+    }
+}
+
+// Patcher saved inside the box in a .maxpat: [p]/[patcher] subpatchers and
+// bpatchers with embed=1. Abstractions are saved by name only and reload
+// from disk, so they are never inlined.
+static t_object* embedded_subpatcher(t_object* box, const maxpat::BoxSnapshot& snap) {
+    bool embedded = false;
+    if (snap.maxclass == "newobj") {
+        std::string head = snap.text.substr(0, snap.text.find(' '));
+        embedded = (head == "p" || head == "patcher");
+    } else if (snap.maxclass == "bpatcher") {
+        embedded = (object_attr_getlong(box, Symbols::embed) == 1);
+    }
+    if (!embedded) {
+        return nullptr;
+    }
+
+    long index = 0;
+    return (t_object*)object_subpatcher(jbox_get_object(box), &index, nullptr);
+}
+
+static void capture_patcher(t_object* patcher, bool recursive, maxpat::PatcherSnapshot& out);
+
+static void capture_box(t_object* box, bool recursive, maxpat::BoxSnapshot& out) {
+    out.maxclass = PatchHelpers::get_box_maxclass(box, "newobj");
+    out.numinlets = std::max(0L, PatchHelpers::get_inlet_count(box));
+    out.numoutlets = std::max(0L, PatchHelpers::get_outlet_count(box));
+    if (out.maxclass == "newobj" || PatchHelpers::is_textfield_content_type(out.maxclass)) {
+        out.text = PatchHelpers::get_box_text(box);
+    }
+
+    std::vector<PatchHelpers::SavedAttribute> saved = PatchHelpers::save_box_attributes(box);
+    out.attributes.reserve(saved.size());
+    for (const auto& attr : saved) {
+        maxpat::BoxAttribute captured;
+        captured.name = (attr.name && attr.name->s_name) ? attr.name->s_name : "";
+        capture_atoms(attr.values, captured.values);
+        if (!captured.name.empty()) {
+            out.attributes.push_back(std::move(captured));
+        }
+    }
+
+    if (recursive) {
+        if (t_object* subpatcher = embedded_subpatcher(box, out)) {
+            out.subpatcher = std::make_unique<maxpat::PatcherSnapshot>();
+            capture_patcher(subpatcher, true, *out.subpatcher);
+        }
+    }
+}
+
+static void capture_lines(t_object* patcher, const std::vector<t_object*>& boxes,
+                          std::vector<maxpat::LineSnapshot>& out) {
+    std::unordered_map<t_object*, size_t> index_of;
+    index_of.reserve(boxes.size());
+    for (size_t i = 0; i < boxes.size(); ++i) {
+        index_of.emplace(boxes[i], i);
+    }
+
+    for (t_object* line = jpatcher_get_firstline(patcher); line;
+         line = jpatchline_get_nextline(line)) {
+        auto src = index_of.find((t_object*)jpatchline_get_box1(line));
+        auto dst = index_of.find((t_object*)jpatchline_get_box2(line));
+        if (src == index_of.end() || dst == index_of.end()) {
+            continue;
+        }
+
+        maxpat::LineSnapshot captured;
+        captured.source = src->second;
+        captured.outlet = jpatchline_get_outletnum(line);
+        captured.destination = dst->second;
+        captured.inlet = jpatchline_get_inletnum(line);
+        captured.hidden = jpatchline_get_hidden(line) != 0;
+
+        long num_midpoints = jpatchline_get_nummidpoints(line);
+        if (num_midpoints > 0) {
+            long num_values = num_midpoints * 2;
+            captured.midpoints.resize(num_values, 0.0);
+            object_attr_getdouble_array(line, Symbols::midpoints, num_values,
+                                        captured.midpoints.data());
+        }
+        out.push_back(std::move(captured));
+    }
+}
+
+// Unsliced capture, used for embedded subpatchers
+static void capture_patcher(t_object* patcher, bool recursive, maxpat::PatcherSnapshot& out) {
+    std::vector<t_object*> boxes;
+    collect_boxes(patcher, 0, &boxes);
+    out.boxes.resize(boxes.size());
+    for (size_t i = 0; i < boxes.size(); ++i) {
+        capture_box(boxes[i], recursive, out.boxes[i]);
+    }
+    capture_lines(patcher, boxes, out.lines);
+}
+
+// Finish an export job: hand the result to the executor and free the slice data
+static void complete_export(t_export_patch_data* data, const json& result) {
+    data->job->result.result = result;
+    data->job->result.notify();
+    delete data;
+}
+
+// Defer callback for export_patch. Captures top-level boxes in time slices of
+// kExportSliceBudget, re-queueing itself with defer_low() in between so the
+// scheduler and UI keep running; lines are captured with the final slice.
+//
+// Each slice first checks that the executor is still waiting and that the
+// patch is still registered, since either can change while a slice is queued.
+static void export_patch_deferred(t_maxmcp* patch, t_symbol* s, long argc, t_atom* argv) {
+    VALIDATE_DEFERRED_ARGS("export_patch_deferred");
+    t_export_patch_data* data = static_cast<t_export_patch_data*>(atom_getobj(argv));
+    if (!data || !data->job) {
+        ConsoleLogger::log("ERROR: Invalid deferred callback data (data/job null)");
+        delete data;
+        return;
+    }
+    if (data->job->cancelled) {
+        delete data;
+        return;
+    }
+    if (PatchRegistry::find_patch(data->patch_id) != data->patch || !data->patch->patcher) {
+        complete_export(data, ToolCommon::make_error(ToolCommon::ErrorCode::INTERNAL_ERROR,
+                                                     "Patch closed during export"));
+        return;
+    }
+
+    t_object* patcher = data->patch->patcher;
+    maxpat::PatcherSnapshot& snapshot = *data->snapshot;
+
+    if (!data->started) {
+        data->started = true;
+        data->revision = collect_boxes(patcher, data->patch->structure_edits, &data->boxes);
+        snapshot.boxes.resize(data->boxes.size());
+    } else if (collect_boxes(patcher, data->patch->structure_edits, nullptr) != data->revision) {
+        // Boxes were added or removed between slices; the pointers held from
+        // slice 1 may be dangling, so stop rather than resume.
+        complete_export(data, ToolCommon::make_error(
+                                  ToolCommon::ErrorCode::INTERNAL_ERROR,
+                                  "Patch changed during export; retry export_patch"));
+        return;
+    }
+
+    auto slice_end = std::chrono::steady_clock::now() + kExportSliceBudget;
+    while (data->next_box < data->boxes.size()) {
+        capture_box(data->boxes[data->next_box], data->recursive, snapshot.boxes[data->next_box]);
+        ++data->next_box;
+        if (std::chrono::steady_clock::now() >= slice_end) {
+            break;
+        }
+    }
+
+    if (data->next_box < data->boxes.size()) {
+        t_atom a;
+        atom_setobj(&a, data);
+        defer_low(data->patch, (method)export_patch_deferred, gensym("export_patch"), 1, &a);
+        return;
+    }
+
+    capture_lines(patcher, data->boxes, snapshot.lines);
+    complete_export(data, json{{"box_count", snapshot.boxes.size()},
+                               {"line_count", snapshot.lines.size()}});
+}
+
+// Defer callback for import_patch_fragment. Creates every box, then every
+// line, in one main-thread pass and marks the patcher dirty once at the end.
+static void import_fragment_deferred(t_maxmcp* patch, t_symbol* s, long argc, t_atom* argv) {
+    VALIDATE_DEFERRED_ARGS("import_fragment_deferred");
+    EXTRACT_DEFERRED_DATA_WITH_RESULT(t_import_fragment_data, data, argv);
+
+    t_object* patcher = data->patch->patcher;
+    const maxpat::Fragment& fragment = data->fragment;
+
+    std::unordered_set<std::string> taken;
+    for (t_object* box = jpatcher_get_firstobject(patcher); box; box = jbox_get_nextobject(box)) {
+        std::string varname = PatchHelpers::get_box_varname(box);
+        if (!varname.empty()) {
+            taken.insert(std::move(varname));
+        }
+    }
+    std::vector<std::string> varnames = maxpat::assign_fragment_varnames(fragment, taken);
+
+    // ---- Boxes ----
+    std::vector<t_object*> created(fragment.boxes.size(), nullptr);
+    std::unordered_set<t_object*> created_set;
+    json id_map = json::object();
+    json errors = json::array();
+    long skipped_attributes = 0;
+    Symbols::Cache attr_syms;
+
+    for (size_t i = 0; i < fragment.boxes.size(); ++i) {
+        const maxpat::FragmentBox& src = fragment.boxes[i];
+        const std::string& box_text = (src.maxclass == "newobj") ? src.text : src.maxclass;
+
+        t_object* box = (t_object*)newobject_fromboxtext(patcher, box_text.c_str());
+        if (!box) {
+            errors.push_back({{"id", src.id}, {"error", "Failed to create object: " + box_text}});
+            continue;
+        }
+
+        if (src.has_rect) {
+            t_atom rect[4];
+            for (int k = 0; k < 4; ++k) {
+                atom_setfloat(&rect[k], src.rect[k]);
+            }
+            object_attr_setvalueof(box, Symbols::patching_rect, 4, rect);
+        }
+        object_attr_setsym(box, Symbols::varname, gensym(varnames[i].c_str()));
+
+        for (const auto& [attr_name, attr_value] : src.attributes.items()) {
+            if (!PatchHelpers::set_box_attribute(box, attr_syms.get(attr_name), attr_value)) {
+                ++skipped_attributes;
+            }
+        }
+
+        // newobject_fromboxtext does not populate message/comment text
+        if (!src.text.empty() && PatchHelpers::is_textfield_content_type(src.maxclass)) {
+            PatchHelpers::set_textfield_content(box, src.text);
+        }
+
+        created[i] = box;
+        created_set.insert(box);
+        id_map[src.id] = varnames[i];
+    }
+
+    // ---- Lines ----
+    for (size_t i = 0; i < fragment.lines.size(); ++i) {
+        const maxpat::FragmentLine& line = fragment.lines[i];
+        t_object* src_box = created[line.source];
+        t_object* dst_box = created[line.destination];
+        if (!src_box || !dst_box) {
+            continue;  // Endpoint creation failure is already reported
+        }
+
+        t_atom connect_args[4];
+        atom_setobj(&connect_args[0], src_box);
+        atom_setlong(&connect_args[1], line.outlet);
+        atom_setobj(&connect_args[2], dst_box);
+        atom_setlong(&connect_args[3], line.inlet);
+        t_atom rv;
+        object_method_typed(patcher, Symbols::connect, 4, connect_args, &rv);
+    }
+
+    // Verify and style the new cords with one scan (connect's return value is
+    // unreliable), instead of a find_patchline() scan per line.
+    using CordKey = std::tuple<t_object*, long, t_object*, long>;
+    std::map<CordKey, t_object*> cords;
+    for (t_object* cord = jpatcher_get_firstline(patcher); cord;
+         cord = jpatchline_get_nextline(cord)) {
+        t_object* box1 = (t_object*)jpatchline_get_box1(cord);
+        if (created_set.count(box1)) {
+            cords.emplace(CordKey{box1, jpatchline_get_outletnum(cord),
+                                  (t_object*)jpatchline_get_box2(cord),
+                                  jpatchline_get_inletnum(cord)},
+                          cord);
+        }
+    }
+
+    long connected = 0;
+    for (size_t i = 0; i < fragment.lines.size(); ++i) {
+        const maxpat::FragmentLine& line = fragment.lines[i];
+        t_object* src_box = created[line.source];
+        t_object* dst_box = created[line.destination];
+        if (!src_box || !dst_box) {
+            errors.push_back({{"line", i}, {"error", "Endpoint object was not created"}});
+            continue;
+        }
+
+        auto it = cords.find(CordKey{src_box, line.outlet, dst_box, line.inlet});
+        if (it == cords.end()) {
+            errors.push_back({{"line", i},
+                              {"error", "Connect failed: " + fragment.boxes[line.source].id + "[" +
+                                            std::to_string(line.outlet) + "] -> " +
+                                            fragment.boxes[line.destination].id + "[" +
+                                            std::to_string(line.inlet) + "]"}});
+            continue;
+        }
+        if (line.hidden) {
+            jpatchline_set_hidden(it->second, 1);
+        }
+        if (!line.midpoints.empty()) {
+            std::vector<double> midpoints(line.midpoints);
+            object_attr_setdouble_array(it->second, Symbols::midpoints, (long)midpoints.size(),
+                                        midpoints.data());
+        }
+        ++connected;
+    }
+
+    if (!created_set.empty()) {
+        jpatcher_set_dirty(patcher, 1);
+        ++data->patch->structure_edits;
+    }
+    ConsoleLogger::log(("Fragment imported: " + std::to_string(created_set.size()) +
+                        " objects, " + std::to_string(connected) + " connections")
+                           .c_str());
+
+    json result = {{"status", errors.empty() ? "success" : "partial"},
+                   {"created", created_set.size()},
+                   {"connected", connected},
+                   {"id_map", id_map},
+                   {"skipped_attributes", skipped_attributes}};
+    if (!errors.empty()) {
+        result["errors"] = errors;
+    }
+    COMPLETE_DEFERRED(data, (json{{"result", result}}));
+}
+
+#endif  // MAXMCP_TEST_MODE
+
+// ============================================================================
+// export_patch helpers
+// ============================================================================
+
+struct ExportOptions {
+    bool recursive = false;
+    size_t chunk_bytes = kDefaultExportChunkBytes;
+};
+
+static json parse_export_options(const json& params, ExportOptions& options) {
+    if (params.contains("recursive")) {
+        if (!params["recursive"].is_boolean()) {
+            return ToolCommon::make_error(ToolCommon::ErrorCode::INVALID_PARAMS,
+                                          "recursive must be a boolean");
+        }
+        options.recursive = params["recursive"].get<bool>();
+    }
+    if (params.contains("chunk_bytes")) {
+        const json& value = params["chunk_bytes"];
+        if (!value.is_number_integer() || value.get<long long>() < kMinExportChunkBytes) {
+            return ToolCommon::make_error(ToolCommon::ErrorCode::INVALID_PARAMS,
+                                          "chunk_bytes must be an integer >= " +
+                                              std::to_string(kMinExportChunkBytes));
+        }
+        options.chunk_bytes = static_cast<size_t>(value.get<long long>());
+    }
+    return nullptr;
+}
+
+#ifndef MAXMCP_TEST_MODE
+
+// Serialize a finished capture (runs on the tool executor thread). Documents
+// that fit in one chunk are embedded as "maxpat"; larger ones are split and
+// the first chunk is returned alongside the export_id for the rest.
+static json build_export_result(const std::string& patch_id,
+                                const maxpat::PatcherSnapshot& snapshot, size_t chunk_bytes) {
+    std::string document = maxpat::to_maxpat(snapshot);
+
+    jsonwriter::JsonWriter w(std::min(document.size(), chunk_bytes) + 256);
+    w.begin_object();
+    w.key("patch_id");
+    w.string(patch_id);
+    w.key("format");
+    w.string("maxpat");
+    w.key("box_count");
+    w.integer(static_cast<long long>(snapshot.boxes.size()));
+    w.key("line_count");
+    w.integer(static_cast<long long>(snapshot.lines.size()));
+
+    if (document.size() <= chunk_bytes) {
+        w.key("maxpat");
+        w.raw_value(document);
+    } else {
+        size_t total_bytes = document.size();
+        std::vector<std::string> chunks = maxpat::split_chunks(document, chunk_bytes);
+        size_t chunk_count = chunks.size();
+        std::string first = chunks.front();
+        std::string export_id = export_store().put(std::move(chunks));
+
+        w.key("export_id");
+        w.string(export_id);
+        w.key("chunk");
+        w.integer(0);
+        w.key("chunk_count");
+        w.integer(static_cast<long long>(chunk_count));
+        w.key("total_bytes");
+        w.integer(static_cast<long long>(total_bytes));
+        w.key("data");
+        w.string(first);
+    }
+    w.end_object();
+
+    return ToolCommon::make_raw_result(w.take());
+}
+
+#endif  // MAXMCP_TEST_MODE
+
+// Serve a later chunk of a chunked export
+static json fetch_export_chunk(const json& params) {
+    const json& id = params["export_id"];
+    if (!id.is_string() || id.get<std::string>().empty()) {
+        return ToolCommon::make_error(ToolCommon::ErrorCode::INVALID_PARAMS,
+                                      "export_id must be a non-empty string");
+    }
+    if (!params.contains("chunk")) {
+        return ToolCommon::missing_param_error("chunk");
+    }
+    if (!params["chunk"].is_number_integer() || params["chunk"].get<long long>() < 0) {
+        return ToolCommon::make_error(ToolCommon::ErrorCode::INVALID_PARAMS,
+                                      "chunk must be a non-negative integer");
+    }
+
+    std::string export_id = id.get<std::string>();
+    size_t index = static_cast<size_t>(params["chunk"].get<long long>());
+    std::string chunk;
+    size_t chunk_count = 0;
+    if (!export_store().fetch(export_id, index, chunk, chunk_count)) {
+        return ToolCommon::make_error(
+            ToolCommon::ErrorCode::INVALID_PARAMS,
+            "Unknown or expired export_id, or chunk out of range: " + export_id);
+    }
+
+    return {{"result",
+             {{"export_id", export_id},
+              {"chunk", index},
+              {"chunk_count", chunk_count},
+              {"data", std::move(chunk)}}}};
+}
+
 // ============================================================================
 // Tool Schemas
 // ============================================================================
@@ -43,7 +574,67 @@ json get_tool_schemas() {
          // get_frontmost_patch
          {{"name", "get_frontmost_patch"},
           {"description", "Get the currently focused/frontmost patch"},
-          {"inputSchema", {{"type", "object"}, {"properties", json::object()}}}}});
+          {"inputSchema", {{"type", "object"}, {"properties", json::object()}}}},
+
+         // export_patch
+         {{"name", "export_patch"},
+          {"description",
+           "Export a whole patch as .maxpat JSON (boxes with all saveable attributes, "
+           "patchlines with midpoints) in one call. Documents larger than chunk_bytes "
+           "are returned in chunks: the first response carries export_id and "
+           "chunk_count; fetch the rest with export_id + chunk and concatenate 'data'."},
+          {"inputSchema",
+           {{"type", "object"},
+            {"properties",
+             {{"patch_id", {{"type", "string"}, {"description", "Patch ID to export"}}},
+              {"recursive",
+               {{"type", "boolean"},
+                {"description",
+                 "Embed subpatchers ([p] and embedded bpatchers) under each box's "
+                 "'patcher' key (default: false)"}}},
+              {"chunk_bytes",
+               {{"type", "integer"},
+                {"minimum", kMinExportChunkBytes},
+                {"description", "Maximum .maxpat bytes per response (default: 262144)"}}},
+              {"export_id",
+               {{"type", "string"},
+                {"description", "Fetch a further chunk of an earlier chunked export"}}},
+              {"chunk",
+               {{"type", "integer"},
+                {"minimum", 0},
+                {"description", "Chunk index to fetch (with export_id)"}}}}}}}},
+
+         // import_patch_fragment
+         {{"name", "import_patch_fragment"},
+          {"description",
+           "Create boxes and patchlines given in .maxpat form (e.g. from export_patch or a "
+           "reference patch) in a single main-thread pass. Coordinates are shifted by "
+           "'offset', varnames are made unique within the patch, and the result maps each "
+           "source box id to the varname it was created with."},
+          {"inputSchema",
+           {{"type", "object"},
+            {"properties",
+             {{"patch_id", {{"type", "string"}, {"description", "Patch ID to import into"}}},
+              {"boxes",
+               {{"type", "array"},
+                {"items", {{"type", "object"}}},
+                {"description",
+                 "Boxes as {\"box\": {\"id\", \"maxclass\", \"text\", \"patching_rect\", "
+                 "...attributes}} (bare box objects are accepted too)"}}},
+              {"lines",
+               {{"type", "array"},
+                {"items", {{"type", "object"}}},
+                {"description",
+                 "Patchlines as {\"patchline\": {\"source\": [id, outlet], "
+                 "\"destination\": [id, inlet], \"midpoints\", \"hidden\"}}"}}},
+              {"offset",
+               {{"type", "array"},
+                {"items", {{"type", "number"}}},
+                {"minItems", 2},
+                {"maxItems", 2},
+                {"description", "[dx, dy] added to every patching_rect and midpoint, and "
+                                "to presentation_rect of presentation boxes"}}}}},
+            {"required", json::array({"patch_id", "boxes"})}}}}});
 }
 
 // ============================================================================
@@ -55,9 +646,9 @@ json execute(const std::string& tool, const json& params) {
         // Get list of active patches from global registry
         // Optionally filter by group
         std::string group_filter = params.value("group", "");
-        json result = PatchRegistry::list_patches(group_filter);
-        ConsoleLogger::log(("MCP: list_active_patches result: " + result.dump()).c_str());
-        return result;
+        std::string result_text = PatchRegistry::list_patches_text(group_filter);
+        ConsoleLogger::log(("MCP: list_active_patches result: " + result_text).c_str());
+        return ToolCommon::make_raw_result(std::move(result_text));
 
     } else if (tool == "get_patch_info") {
         // Get detailed information about a patch
@@ -72,6 +663,102 @@ json execute(const std::string& tool, const json& params) {
     } else if (tool == "get_frontmost_patch") {
         // Get the currently focused patch
         return PatchRegistry::get_frontmost_patch();
+
+    } else if (tool == "export_patch") {
+        // Continuation of a chunked export: served from the store, no patch access
+        if (params.contains("export_id")) {
+            return fetch_export_chunk(params);
+        }
+
+        std::string patch_id = params.value("patch_id", "");
+        if (patch_id.empty()) {
+            return ToolCommon::missing_param_error("patch_id");
+        }
+
+        ExportOptions options;
+        json options_error = parse_export_options(params, options);
+        if (!options_error.is_null()) {
+            return options_error;
+        }
+
+#ifdef MAXMCP_TEST_MODE
+        return ToolCommon::test_mode_error();
+#else
+        t_maxmcp* patch = PatchRegistry::find_patch(patch_id);
+        if (!patch) {
+            return ToolCommon::patch_not_found_error(patch_id);
+        }
+
+        // Not run_deferred(): the capture re-queues itself, so the job must
+        // outlive a timeout here (see ExportJob)
+        auto snapshot = std::make_shared<maxpat::PatcherSnapshot>();
+        auto job = std::make_shared<ExportJob>();
+        t_export_patch_data* data = new t_export_patch_data{
+            patch, patch_id, options.recursive, snapshot, {}, 0, 0, false, job};
+
+        t_atom a;
+        atom_setobj(&a, data);
+        defer(patch, (method)export_patch_deferred, gensym("export_patch"), 1, &a);
+
+        if (!job->result.wait_for(ToolCommon::HEAVY_OPERATION_TIMEOUT)) {
+            job->cancelled = true;
+            return ToolCommon::timeout_error("exporting patch");
+        }
+        json captured = job->result.result;
+        if (captured.contains("error")) {
+            return captured;
+        }
+
+        return {{"result", build_export_result(patch_id, *snapshot, options.chunk_bytes)}};
+#endif
+
+    } else if (tool == "import_patch_fragment") {
+        std::string patch_id = params.value("patch_id", "");
+        if (patch_id.empty()) {
+            return ToolCommon::missing_param_error("patch_id");
+        }
+        if (!params.contains("boxes")) {
+            return ToolCommon::missing_param_error("boxes");
+        }
+
+        double dx = 0.0;
+        double dy = 0.0;
+        if (params.contains("offset")) {
+            const json& offset = params["offset"];
+            if (!offset.is_array() || offset.size() != 2 || !offset[0].is_number() ||
+                !offset[1].is_number()) {
+                return ToolCommon::make_error(ToolCommon::ErrorCode::INVALID_PARAMS,
+                                              "offset must be [dx, dy]");
+            }
+            dx = offset[0].get<double>();
+            dy = offset[1].get<double>();
+        }
+
+        // Validate and resolve the whole fragment before touching the patch
+        maxpat::Fragment fragment;
+        json parse_error = maxpat::parse_fragment(
+            params["boxes"], params.contains("lines") ? params["lines"] : json(), dx, dy, fragment);
+        if (!parse_error.is_null()) {
+            return parse_error;
+        }
+
+#ifdef MAXMCP_TEST_MODE
+        return ToolCommon::test_mode_error();
+#else
+        t_maxmcp* patch = PatchRegistry::find_patch(patch_id);
+        if (!patch) {
+            return ToolCommon::patch_not_found_error(patch_id);
+        }
+
+        DeferredResult* deferred_result = new DeferredResult();
+        t_import_fragment_data* data =
+            new t_import_fragment_data{patch, std::move(fragment), deferred_result};
+
+        return ToolCommon::run_deferred(patch, (method)import_fragment_deferred,
+                                        "import_patch_fragment", data,
+                                        ToolCommon::HEAVY_OPERATION_TIMEOUT,
+                                        "importing patch fragment", ToolCommon::DeferredWrap::Raw);
+#endif
     }
 
     // Unknown tool - return nullptr to signal not handled
@@ -6,6 +6,8 @@
     - list_active_patches
     - get_patch_info
     - get_frontmost_patch
+    - export_patch
+    - import_patch_fragment
 
     @ingroup maxmcp
 */
@@ -32,6 +34,8 @@ using json = nlohmann::json;
  * - list_active_patches: List all registered MaxMCP client patches
  * - get_patch_info: Get detailed information about a specific patch
  * - get_frontmost_patch: Get the currently focused patch
+ * - export_patch: Export a whole patch as .maxpat JSON (chunked when large)
+ * - import_patch_fragment: Create .maxpat boxes/lines in one deferred pass
  *
  * @return JSON array of tool schemas
  */
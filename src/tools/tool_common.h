@@ -347,6 +347,22 @@ inline json method_not_found_error(const std::string& method) {
     return make_error(ErrorCode::METHOD_NOT_FOUND, "Method not found: " + method);
 }
 
+/**
+ * Key under which a tool returns result text it has already serialized
+ * (e.g. the columnar listing encoding). MCPServer copies the string into the
+ * tools/call content verbatim instead of dumping a JSON DOM.
+ */
+constexpr const char* RAW_RESULT_KEY = "raw_result_text";
+
+/**
+ * Wrap pre-serialized JSON text as a tool result.
+ * @param text Complete JSON document for the tools/call content
+ * @return JSON object carrying the text under RAW_RESULT_KEY
+ */
+inline json make_raw_result(std::string text) {
+    return {{RAW_RESULT_KEY, std::move(text)}};
+}
+
 /**
  * Create a test mode error response.
  * @return JSON error object
@@ -11,10 +11,15 @@
 
 #include "utility_tools.h"
 
+#include "object_tools.h"
 #include "tool_common.h"
 
 #include <algorithm>
 #include <cmath>
+#include <cstdint>
+#include <iterator>
+#include <unordered_map>
+#include <utility>
 
 #ifndef MAXMCP_TEST_MODE
 #include "ext.h"
@@ -25,6 +30,7 @@
 #include "maxmcp.h"
 #include "utils/console_logger.h"
 #include "utils/patch_registry.h"
+#include "utils/symbols.h"
 
 namespace UtilityTools {
 
@@ -50,27 +56,13 @@ constexpr double PLACE_MARGIN = 50.0;        // gap used when stacking to the ri
 constexpr double PLACE_GAP = 8.0;            // minimum visual gap between objects
 constexpr double PLACE_GRID = 15.0;          // search step (matches Max default grid)
 constexpr double PLACE_MAX_RADIUS = 4000.0;  // give up beyond this many px
+constexpr int PLACE_FIRST_STEPS = 16;        // grid steps searched before widening
+constexpr double PLACE_BLOCK_ASPECT = 3.0;   // width / height of a packed group
 
 // Reuse the shared geometry point so the placement search and the layout tools
 // speak the same coordinate type (see src/utils/geometry.h).
 using Point = geometry::Point;
 
-// A width x height rect at (x, y) is valid when it stays in the visible area
-// and clears every existing rect (keeping PLACE_GAP of separation).
-bool position_is_free(double x, double y, double width, double height,
-                      const std::vector<Rect>& existing) {
-    if (x < 0.0 || y < 0.0) {
-        return false;
-    }
-    const Rect candidate{x, y, width, height};
-    for (const Rect& r : existing) {
-        if (rects_conflict(candidate, r, PLACE_GAP)) {
-            return false;
-        }
-    }
-    return true;
-}
-
 double rightmost_edge(const std::vector<Rect>& existing) {
     double edge = 0.0;
     for (const Rect& r : existing) {
@@ -99,29 +91,209 @@ Point search_anchor(const std::vector<Rect>& existing, bool has_near, double nea
     return {rightmost_edge(existing) + PLACE_MARGIN, 50.0};
 }
 
-// Nearest (Euclidean) free spot on the square ring at Chebyshev distance
-// `radius` from the anchor. Returns false if the ring has no free spot.
-bool nearest_free_on_ring(const Point& anchor, double radius, double width, double height,
-                          const std::vector<Rect>& existing, Point& out) {
-    bool found = false;
-    double best_dist2 = 0.0;
-    for (double dx = -radius; dx <= radius; dx += PLACE_GRID) {
-        for (double dy = -radius; dy <= radius; dy += PLACE_GRID) {
-            const bool on_perimeter = std::max(std::fabs(dx), std::fabs(dy)) >= radius;
-            if (!on_perimeter ||
-                !position_is_free(anchor.x + dx, anchor.y + dy, width, height, existing)) {
-                continue;
+// Which grid steps i put a span of @p size at origin + i * PLACE_GRID within
+// PLACE_GAP of [lo, hi]: the same test, and the same floating-point
+// expressions, as one axis of rects_conflict(). The steps form one run; false
+// if it misses [-limit, limit], else @p first / @p last are clipped to it.
+bool blocked_steps(double origin, double size, double lo, double hi, int limit, int& first,
+                   int& last) {
+    const double eps = -PLACE_GAP;
+    auto at = [&](int i) { return origin + i * PLACE_GRID; };
+    // Blocked from the first step whose far end passes lo ...
+    auto past_lo = [&](int i) { return !(at(i) + size <= lo + eps); };
+    // ... to the last step that starts before hi.
+    auto before_hi = [&](int i) { return !(hi <= at(i) + eps); };
+
+    const double f = std::floor((lo + eps - size - origin) / PLACE_GRID);
+    const double l = std::ceil((hi - eps - origin) / PLACE_GRID);
+    if (f > limit + 1 || l < -limit - 1) {
+        return false;
+    }
+    first = static_cast<int>(std::max<double>(f, -limit - 1));
+    last = static_cast<int>(std::min<double>(l, limit + 1));
+    // The estimates are within a step; settle them with the exact tests
+    while (first > -limit - 1 && past_lo(first - 1)) {
+        --first;
+    }
+    while (first <= limit && !past_lo(first)) {
+        ++first;
+    }
+    while (last < limit + 1 && before_hi(last + 1)) {
+        ++last;
+    }
+    while (last >= -limit && !before_hi(last)) {
+        --last;
+    }
+    first = std::max(first, -limit);
+    last = std::min(last, limit);
+    return first <= last;
+}
+
+// Free-space index for one placement: the grid of candidate positions
+// anchor + (i, j) * PLACE_GRID with |i|, |j| <= steps, stored as the sorted,
+// merged runs of blocked i in each row j. A position is blocked when it
+// leaves the visible area or a width x height rect there conflicts with an
+// existing rect, so each existing rect blocks one run of i in each row it
+// reaches and is looked at once, instead of being tested at every candidate.
+class FreeGrid {
+  public:
+    FreeGrid(const std::vector<Rect>& existing, const Point& anchor, double width, double height,
+             int steps)
+        : steps_(steps), row_start_(2 * steps + 2, 0) {
+        // One row's worth of blocked steps: rows j0..j1, steps run.first..run.last
+        struct Piece {
+            int j0, j1;
+            Run run;
+        };
+        std::vector<Piece> pieces;
+
+        // Left of x = 0 and above y = 0 is off the visible area
+        int left = -steps - 1;
+        while (left < steps && anchor.x + (left + 1) * PLACE_GRID < 0.0) {
+            ++left;
+        }
+        int top = -steps - 1;
+        while (top < steps && anchor.y + (top + 1) * PLACE_GRID < 0.0) {
+            ++top;
+        }
+        if (top >= -steps) {
+            pieces.push_back({-steps, top, {-steps, steps}});
+        }
+        if (left >= -steps && top < steps) {
+            pieces.push_back({top + 1, steps, {-steps, left}});
+        }
+
+        for (const Rect& r : existing) {
+            Piece p{};
+            if (blocked_steps(anchor.y, height, r.origin.y, r.bottom(), steps, p.j0, p.j1) &&
+                blocked_steps(anchor.x, width, r.origin.x, r.right(), steps, p.run.first,
+                              p.run.last)) {
+                pieces.push_back(p);
+            }
+        }
+
+        // Bucket the runs by row, then sort and merge each row's runs,
+        // adjacent ones included, so the steps next to a run are free.
+        for (const Piece& p : pieces) {
+            for (int j = p.j0; j <= p.j1; ++j) {
+                ++row_start_[j + steps + 1];
             }
-            const double dist2 = dx * dx + dy * dy;
-            if (!found || dist2 < best_dist2) {
+        }
+        for (size_t k = 1; k < row_start_.size(); ++k) {
+            row_start_[k] += row_start_[k - 1];
+        }
+        runs_.resize(row_start_.back());
+        std::vector<size_t> fill(row_start_.begin(), row_start_.end() - 1);
+        for (const Piece& p : pieces) {
+            for (int j = p.j0; j <= p.j1; ++j) {
+                runs_[fill[j + steps]++] = p.run;
+            }
+        }
+        size_t n = 0;
+        for (size_t row = 0; row + 1 < row_start_.size(); ++row) {
+            const auto begin = runs_.begin() + row_start_[row];
+            const auto end = runs_.begin() + row_start_[row + 1];
+            std::sort(begin, end);
+            row_start_[row] = n;
+            const size_t row_first = n;
+            for (auto it = begin; it != end; ++it) {
+                if (n > row_first && it->first <= runs_[n - 1].last + 1) {
+                    runs_[n - 1].last = std::max(runs_[n - 1].last, it->last);
+                } else {
+                    runs_[n++] = *it;
+                }
+            }
+        }
+        row_start_.back() = n;
+        runs_.resize(n);
+    }
+
+    bool free(int i, int j) const {
+        return run_at(i, j) == nullptr;
+    }
+
+    /**
+     * The free position at the smallest Chebyshev distance (in steps) from
+     * the anchor, nearest by Euclidean distance among those, ties going to
+     * the smallest i then j: the spot the ring-by-ring scan finds. False if
+     * there is none within the grid.
+     */
+    bool nearest(int& best_i, int& best_j) const {
+        // The ring: the smallest max(|j|, nearest free |i| in row j)
+        int ring = steps_ + 1;
+        for (int d = 0; d <= steps_ && d < ring; ++d) {
+            for (int j : {-d, d}) {
+                ring = std::min(ring, std::max(d, nearest_in_row(j)));
+            }
+        }
+        if (ring > steps_) {
+            return false;
+        }
+
+        bool found = false;
+        long best = 0;
+        auto consider = [&](int i, int j) {
+            const long dist2 = static_cast<long>(i) * i + static_cast<long>(j) * j;
+            if (!found || dist2 < best ||
+                (dist2 == best && (i < best_i || (i == best_i && j < best_j)))) {
                 found = true;
-                best_dist2 = dist2;
-                out = {anchor.x + dx, anchor.y + dy};
+                best = dist2;
+                best_i = i;
+                best_j = j;
+            }
+        };
+        for (int j = -ring; j <= ring; ++j) {
+            if (j == -ring || j == ring) {
+                // A whole side of the ring: the free i nearest 0 (never past
+                // the ring, which is the nearest any row gets)
+                const int m = nearest_in_row(j);
+                if (m <= ring) {
+                    consider(free(-m, j) ? -m : m, j);
+                }
+            } else {
+                for (int i : {-ring, ring}) {
+                    if (free(i, j)) {
+                        consider(i, j);
+                    }
+                }
             }
         }
+        return found;
     }
-    return found;
-}
+
+  private:
+    struct Run {
+        int first, last;
+        bool operator<(const Run& other) const {
+            return first < other.first;
+        }
+    };
+
+    // The blocked run containing i in row j, or nullptr
+    const Run* run_at(int i, int j) const {
+        const auto begin = runs_.begin() + row_start_[j + steps_];
+        const auto end = runs_.begin() + row_start_[j + steps_ + 1];
+        auto it = std::upper_bound(begin, end, Run{i, i});
+        if (it == begin || std::prev(it)->last < i) {
+            return nullptr;
+        }
+        return &*std::prev(it);
+    }
+
+    // The smallest |i| free in row j (past steps_ if none within the grid)
+    int nearest_in_row(int j) const {
+        const Run* run = run_at(0, j);
+        if (run == nullptr) {
+            return 0;
+        }
+        // Runs are merged, so the steps just outside this one are free
+        return std::min(-(run->first - 1), run->last + 1);
+    }
+
+    int steps_;
+    std::vector<Run> runs_;          // row by row, sorted and merged
+    std::vector<size_t> row_start_;  // runs of row j: [row_start_[j + steps_], next)
+};
 
 }  // namespace
 
@@ -131,14 +303,21 @@ PlacedPosition find_avoid_rect_position(const std::vector<Rect>& existing, doubl
     std::string desc;
     const Point anchor = search_anchor(existing, has_near, near_x, near_y, desc);
 
-    if (position_is_free(anchor.x, anchor.y, width, height, existing)) {
-        return {anchor, "Placed " + desc};
-    }
-
-    Point spot{};
-    for (double radius = PLACE_GRID; radius <= PLACE_MAX_RADIUS; radius += PLACE_GRID) {
-        if (nearest_free_on_ring(anchor, radius, width, height, existing, spot)) {
-            return {spot, "Found nearest free position " + desc};
+    // A free spot within the grid's steps is the one the full search finds,
+    // so start with a small grid around the anchor and widen it as needed.
+    const int max_steps = static_cast<int>(PLACE_MAX_RADIUS / PLACE_GRID);
+    for (int steps = PLACE_FIRST_STEPS;; steps = std::min(steps * 4, max_steps)) {
+        const FreeGrid grid(existing, anchor, width, height, steps);
+        int i = 0, j = 0;
+        if (grid.nearest(i, j)) {
+            if (i == 0 && j == 0) {
+                return {anchor, "Placed " + desc};
+            }
+            return {{anchor.x + i * PLACE_GRID, anchor.y + j * PLACE_GRID},
+                    "Found nearest free position " + desc};
+        }
+        if (steps == max_steps) {
+            break;
         }
     }
 
@@ -146,6 +325,163 @@ PlacedPosition find_avoid_rect_position(const std::vector<Rect>& existing, doubl
     return {{rightmost_edge(existing) + PLACE_MARGIN, 50.0}, "Fallback: placed to the far right"};
 }
 
+namespace {
+
+// Requests placed together: packed into rows, then placed as one rect
+struct PlaceBlock {
+    std::vector<size_t> members;  // request indices, in request order
+    std::vector<Point> offsets;   // of each member from the block's top-left
+    double width = 0.0, height = 0.0;
+    const PlaceRequest* anchor = nullptr;  // first member with an anchor
+};
+
+// Pack the block's members left to right into rows PLACE_GRID apart, starting
+// a new row past a width that makes the block about PLACE_BLOCK_ASPECT times
+// as wide as it is tall.
+void pack_block(PlaceBlock& block, const std::vector<PlaceRequest>& requests) {
+    double widest = 0.0, area = 0.0;
+    for (size_t m : block.members) {
+        const PlaceRequest& r = requests[m];
+        widest = std::max(widest, r.width);
+        area += (r.width + PLACE_GRID) * (r.height + PLACE_GRID);
+    }
+    const double row_width = std::max(widest, std::sqrt(area * PLACE_BLOCK_ASPECT));
+
+    double x = 0.0, y = 0.0, row_height = 0.0;
+    for (size_t m : block.members) {
+        const PlaceRequest& r = requests[m];
+        if (x > 0.0 && x + r.width > row_width) {
+            y += row_height + PLACE_GRID;
+            x = 0.0;
+            row_height = 0.0;
+        }
+        block.offsets.push_back({x, y});
+        block.width = std::max(block.width, x + r.width);
+        block.height = std::max(block.height, y + r.height);
+        x += r.width + PLACE_GRID;
+        row_height = std::max(row_height, r.height);
+    }
+}
+
+}  // namespace
+
+std::vector<PlacedPosition> place_rects(const std::vector<Rect>& existing,
+                                        const std::vector<PlaceRequest>& requests) {
+    // Group the requests into blocks, in order of their first member
+    std::vector<PlaceBlock> blocks;
+    std::unordered_map<std::string, size_t> block_of_group;
+    size_t loose = SIZE_MAX;  // the block of ungrouped requests without an anchor
+    for (size_t i = 0; i < requests.size(); ++i) {
+        const PlaceRequest& r = requests[i];
+        size_t b = blocks.size();
+        if (!r.group.empty()) {
+            b = block_of_group.emplace(r.group, blocks.size()).first->second;
+        } else if (!r.has_near) {
+            if (loose == SIZE_MAX) {
+                loose = blocks.size();
+            }
+            b = loose;
+        }
+        if (b == blocks.size()) {
+            blocks.emplace_back();
+        }
+        blocks[b].members.push_back(i);
+        if (r.has_near && !blocks[b].anchor) {
+            blocks[b].anchor = &r;
+        }
+    }
+    for (PlaceBlock& block : blocks) {
+        pack_block(block, requests);
+    }
+
+    // Anchored blocks first, in request order, then the largest first
+    std::vector<size_t> order(blocks.size());
+    for (size_t b = 0; b < order.size(); ++b) {
+        order[b] = b;
+    }
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        const PlaceBlock& x = blocks[a];
+        const PlaceBlock& y = blocks[b];
+        if ((x.anchor != nullptr) != (y.anchor != nullptr)) {
+            return x.anchor != nullptr;
+        }
+        return x.anchor == nullptr && x.width * x.height > y.width * y.height;
+    });
+
+    std::vector<Rect> placed(existing);
+    std::vector<PlacedPosition> result(requests.size());
+    for (size_t b : order) {
+        const PlaceBlock& block = blocks[b];
+        const PlaceRequest* anchor = block.anchor;
+        const PlacedPosition at =
+            find_avoid_rect_position(placed, block.width, block.height, anchor != nullptr,
+                                     anchor ? anchor->near_x : 0.0, anchor ? anchor->near_y : 0.0);
+        for (size_t k = 0; k < block.members.size(); ++k) {
+            const PlaceRequest& r = requests[block.members[k]];
+            const Point p{at.position.x + block.offsets[k].x, at.position.y + block.offsets[k].y};
+            std::string rationale = at.rationale;
+            if (!r.group.empty()) {
+                rationale += " (group '" + r.group + "')";
+            }
+            result[block.members[k]] = {p, std::move(rationale)};
+            placed.push_back({p.x, p.y, r.width, r.height});
+        }
+    }
+    return result;
+}
+
+std::vector<geometry::Point> settle_rects(const std::vector<Rect>& existing,
+                                          const std::vector<Rect>& created) {
+    std::vector<Rect> placed(existing);
+    std::vector<geometry::Point> positions;
+    for (const Rect& r : created) {
+        const bool clear = std::none_of(placed.begin(), placed.end(), [&](const Rect& other) {
+            return rects_conflict(r, other, PLACE_GAP);
+        });
+        const Point p = clear ? r.origin
+                              : find_avoid_rect_position(placed, r.width, r.height, true,
+                                                         r.origin.x, r.origin.y)
+                                    .position;
+        positions.push_back(p);
+        placed.push_back({p.x, p.y, r.width, r.height});
+    }
+    return positions;
+}
+
+geometry::Point clear_block_offset(const std::vector<Rect>& existing,
+                                   const std::vector<Rect>& block) {
+    if (block.empty()) {
+        return {0.0, 0.0};
+    }
+    bool clear = true;
+    for (const Rect& r : block) {
+        for (const Rect& e : existing) {
+            if (rects_conflict(r, e, PLACE_GAP)) {
+                clear = false;
+                break;
+            }
+        }
+        if (!clear) {
+            break;
+        }
+    }
+    if (clear) {
+        return {0.0, 0.0};
+    }
+
+    double left = block[0].origin.x, top = block[0].origin.y;
+    double right = block[0].right(), bottom = block[0].bottom();
+    for (const Rect& r : block) {
+        left = std::min(left, r.origin.x);
+        top = std::min(top, r.origin.y);
+        right = std::max(right, r.right());
+        bottom = std::max(bottom, r.bottom());
+    }
+    const PlacedPosition at =
+        find_avoid_rect_position(existing, right - left, bottom - top, true, left, top);
+    return {at.position.x - left, at.position.y - top};
+}
+
 // ============================================================================
 // Data Structures for Deferred Callbacks
 // ============================================================================
@@ -160,12 +496,36 @@ struct t_get_position_data {
     DeferredResult* deferred_result;
 };
 
+struct t_place_objects_data {
+    t_maxmcp* patch;
+    std::vector<PlaceRequest> requests;
+    DeferredResult* deferred_result;
+};
+
+// The objects place_objects created, to be re-placed by their real size.
+struct t_settle_objects_data {
+    t_maxmcp* patch;
+    std::vector<t_object*> boxes;  // per request, nullptr where none was created
+    DeferredResult* deferred_result;
+};
+
 // ============================================================================
 // Deferred Callbacks
 // ============================================================================
 
 #ifndef MAXMCP_TEST_MODE
 
+// The patching rectangle of every existing object
+static std::vector<Rect> patching_rects(t_object* patcher) {
+    std::vector<Rect> rects;
+    for (t_object* box = jpatcher_get_firstobject(patcher); box; box = jbox_get_nextobject(box)) {
+        t_rect rect;
+        jbox_get_patching_rect(box, &rect);
+        rects.push_back({rect.x, rect.y, rect.width, rect.height});
+    }
+    return rects;
+}
+
 /**
  * @brief Deferred callback for finding an empty position
  *
@@ -177,16 +537,7 @@ static void get_position_deferred(t_maxmcp* patch, t_symbol* s, long argc, t_ato
     VALIDATE_DEFERRED_ARGS("get_position_deferred");
     EXTRACT_DEFERRED_DATA_WITH_RESULT(t_get_position_data, data, argv);
 
-    t_object* patcher = data->patch->patcher;
-
-    // Collect the patching rectangle of every existing object.
-    std::vector<Rect> existing;
-    for (t_object* box = jpatcher_get_firstobject(patcher); box; box = jbox_get_nextobject(box)) {
-        t_rect rect;
-        jbox_get_patching_rect(box, &rect);
-        existing.push_back({rect.x, rect.y, rect.width, rect.height});
-    }
-
+    const std::vector<Rect> existing = patching_rects(data->patch->patcher);
     PlacedPosition placed = find_avoid_rect_position(existing, data->width, data->height,
                                                      data->has_near, data->near_x, data->near_y);
 
@@ -202,6 +553,101 @@ static void get_position_deferred(t_maxmcp* patch, t_symbol* s, long argc, t_ato
                                   {"rationale", rationale}}));
 }
 
+/**
+ * @brief Deferred callback for placing several objects
+ *
+ * Executed on main thread via defer(). Collects the existing rectangles once
+ * and places every request against them with place_rects().
+ */
+static void place_objects_deferred(t_maxmcp* patch, t_symbol* s, long argc, t_atom* argv) {
+    VALIDATE_DEFERRED_ARGS("place_objects_deferred");
+    EXTRACT_DEFERRED_DATA_WITH_RESULT(t_place_objects_data, data, argv);
+
+    const std::vector<PlacedPosition> placed =
+        place_rects(patching_rects(data->patch->patcher), data->requests);
+
+    json placements = json::array();
+    for (size_t i = 0; i < placed.size(); ++i) {
+        placements.push_back({{"index", i},
+                              {"position", json::array({placed[i].position.x,
+                                                        placed[i].position.y})},
+                              {"width", data->requests[i].width},
+                              {"height", data->requests[i].height},
+                              {"rationale", placed[i].rationale}});
+    }
+
+    COMPLETE_DEFERRED(data, (json{{"placements", placements}, {"count", placements.size()}}));
+}
+
+/**
+ * @brief Deferred callback for settling objects place_objects created
+ *
+ * Executed on main thread via defer(). Reads every box once, tells the
+ * created ones apart by the boxes add_max_objects returned, and moves those
+ * that settle_rects() re-places. Created boxes removed in the meantime are
+ * not found in the patcher and are skipped.
+ */
+static void settle_objects_deferred(t_maxmcp* patch, t_symbol* s, long argc, t_atom* argv) {
+    VALIDATE_DEFERRED_ARGS("settle_objects_deferred");
+    EXTRACT_DEFERRED_DATA_WITH_RESULT(t_settle_objects_data, data, argv);
+
+    std::unordered_map<t_object*, size_t> request_of;
+    for (size_t i = 0; i < data->boxes.size(); ++i) {
+        if (data->boxes[i]) {
+            request_of.emplace(data->boxes[i], i);
+        }
+    }
+
+    std::vector<Rect> existing;
+    std::vector<size_t> found;  // request index per created box
+    std::vector<t_object*> boxes;
+    std::vector<Rect> rects;
+    for (t_object* box = jpatcher_get_firstobject(data->patch->patcher); box;
+         box = jbox_get_nextobject(box)) {
+        t_rect rect;
+        jbox_get_patching_rect(box, &rect);
+        auto it = request_of.find(box);
+        if (it == request_of.end()) {
+            existing.push_back({rect.x, rect.y, rect.width, rect.height});
+            continue;
+        }
+        found.push_back(it->second);
+        boxes.push_back(box);
+        rects.push_back({rect.x, rect.y, rect.width, rect.height});
+    }
+
+    // Settle in request order
+    std::vector<size_t> order(found.size());
+    for (size_t k = 0; k < order.size(); ++k) {
+        order[k] = k;
+    }
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return found[a] < found[b]; });
+    std::vector<Rect> created;
+    for (size_t k : order) {
+        created.push_back(rects[k]);
+    }
+    const std::vector<Point> settled = settle_rects(existing, created);
+
+    json objects = json::array();
+    for (size_t n = 0; n < order.size(); ++n) {
+        const size_t k = order[n];
+        const bool moved = settled[n].x != rects[k].origin.x || settled[n].y != rects[k].origin.y;
+        if (moved) {
+            t_atom pos[2];
+            atom_setfloat(&pos[0], settled[n].x);
+            atom_setfloat(&pos[1], settled[n].y);
+            object_attr_setvalueof(boxes[k], Symbols::patching_position, 2, pos);
+        }
+        objects.push_back({{"index", found[k]},
+                           {"position", json::array({settled[n].x, settled[n].y})},
+                           {"width", rects[k].width},
+                           {"height", rects[k].height},
+                           {"moved", moved}});
+    }
+
+    COMPLETE_DEFERRED(data, (json{{"objects", objects}}));
+}
+
 #endif  // MAXMCP_TEST_MODE
 
 // ============================================================================
@@ -241,7 +687,53 @@ json get_tool_schemas() {
                {{"type", "number"},
                 {"description",
                  "Optional target y. Provide with near_x to search near a point."}}}}},
-            {"required", json::array({"patch_id"})}}}}});
+            {"required", json::array({"patch_id"})}}}},
+
+         // place_objects
+         {{"name", "place_objects"},
+          {"description",
+           "Find non-overlapping positions for several new objects in one pass, clear of the "
+           "existing objects and of each other. Objects sharing a 'group' are packed together "
+           "in request order; near_x/near_y anchor an object (or its group). With create, the "
+           "objects are then created at those positions as by add_max_objects, and any that "
+           "come out larger than their width/height and overlap are moved clear."},
+          {"inputSchema",
+           {{"type", "object"},
+            {"properties",
+             {{"patch_id", {{"type", "string"}, {"description", "Patch ID to place objects in"}}},
+              {"objects",
+               {{"type", "array"},
+                {"items",
+                 {{"type", "object"},
+                  {"properties",
+                   {{"width",
+                     {{"type", "number"},
+                      {"description", "Width to reserve (default: 50)"}}},
+                    {"height",
+                     {{"type", "number"},
+                      {"description", "Height to reserve (default: 20)"}}},
+                    {"near_x", {{"type", "number"}}},
+                    {"near_y", {{"type", "number"}}},
+                    {"group", {{"type", "string"}}},
+                    {"obj_type", {{"type", "string"}}},
+                    {"varname", {{"type", "string"}}},
+                    {"arguments", {{"type", "array"}}},
+                    {"attributes", {{"type", "object"}}}}}}},
+                {"description",
+                 "Objects to place, in order. With create, each also takes the fields of an "
+                 "add_max_objects item except position."}}},
+              {"create",
+               {{"type", "boolean"},
+                {"description", "Create the objects at the computed positions (default: false)"}}},
+              {"connections",
+               {{"type", "array"},
+                {"items", {{"type", "object"}}},
+                {"description", "With create: patchcords to make, as in add_max_objects"}}},
+              {"on_error",
+               {{"type", "string"},
+                {"enum", json::array({"stop", "continue"})},
+                {"description", "With create: as in add_max_objects (default: 'stop')"}}}}},
+            {"required", json::array({"patch_id", "objects"})}}}}});
 }
 
 // ============================================================================
@@ -295,6 +787,138 @@ static json execute_get_avoid_rect_position(const json& params) {
                                     ToolCommon::DeferredWrap::Always);
 }
 
+/**
+ * @brief Execute place_objects tool
+ *
+ * Places every object in one main-thread pass; with create, hands the
+ * objects and their positions to add_max_objects.
+ */
+static json execute_place_objects(const json& params) {
+    std::string patch_id = params.value("patch_id", "");
+    if (patch_id.empty()) {
+        return ToolCommon::missing_param_error("patch_id");
+    }
+    if (!params.contains("objects") || !params["objects"].is_array() ||
+        params["objects"].empty()) {
+        return ToolCommon::make_error(ToolCommon::ErrorCode::INVALID_PARAMS,
+                                      "objects must be a non-empty array");
+    }
+    const bool create = params.value("create", false);
+
+    const json& items = params["objects"];
+    std::vector<PlaceRequest> requests(items.size());
+    for (size_t i = 0; i < items.size(); ++i) {
+        const json& item = items[i];
+        auto invalid = [&](const std::string& message) {
+            return ToolCommon::make_error(ToolCommon::ErrorCode::INVALID_PARAMS,
+                                          "objects[" + std::to_string(i) + "]: " + message);
+        };
+        if (!item.is_object()) {
+            return invalid("must be an object");
+        }
+        PlaceRequest& r = requests[i];
+        for (const char* name : {"width", "height", "near_x", "near_y"}) {
+            if (item.contains(name) && !item[name].is_number()) {
+                return invalid(std::string(name) + " must be a number");
+            }
+        }
+        r.width = item.value("width", 50.0);
+        r.height = item.value("height", 20.0);
+        if (r.width <= 0.0 || r.height <= 0.0) {
+            return invalid("width and height must be positive");
+        }
+        if (item.contains("near_x") != item.contains("near_y")) {
+            return invalid("near_x and near_y must be given together");
+        }
+        r.has_near = item.contains("near_x");
+        r.near_x = item.value("near_x", 0.0);
+        r.near_y = item.value("near_y", 0.0);
+        if (item.contains("group") && !item["group"].is_string()) {
+            return invalid("group must be a string");
+        }
+        r.group = item.value("group", "");
+        if (create && item.value("obj_type", "").empty()) {
+            return invalid("Missing required parameter: obj_type");
+        }
+    }
+
+    t_maxmcp* patch = PatchRegistry::find_patch(patch_id);
+    if (!patch) {
+        return ToolCommon::patch_not_found_error(patch_id);
+    }
+
+    auto* deferred_result = new DeferredResult();
+    auto* data = new t_place_objects_data{patch, requests, deferred_result};
+    json placed = ToolCommon::run_deferred(patch, (method)place_objects_deferred, "place_objects",
+                                           data, ToolCommon::HEAVY_OPERATION_TIMEOUT,
+                                           "placing objects", ToolCommon::DeferredWrap::Raw);
+    if (placed.contains("error")) {
+        return placed;
+    }
+
+    json result = {{"patch_id", patch_id},
+                   {"placements", placed["placements"]},
+                   {"count", placed["count"]}};
+    if (!create) {
+        return {{"result", result}};
+    }
+
+    // The same objects, at their positions, for add_max_objects
+    json objects = json::array();
+    for (size_t i = 0; i < items.size(); ++i) {
+        json object = items[i];
+        for (const char* name : {"width", "height", "near_x", "near_y", "group"}) {
+            object.erase(name);
+        }
+        object["position"] = placed["placements"][i]["position"];
+        objects.push_back(std::move(object));
+    }
+    json add_params = {{"patch_id", patch_id}, {"objects", objects}};
+    for (const char* name : {"connections", "on_error"}) {
+        if (params.contains(name)) {
+            add_params[name] = params[name];
+        }
+    }
+    std::vector<t_object*> boxes;
+    json created = ObjectTools::add_max_objects(add_params, boxes);
+    if (created.contains("error")) {
+        return created;
+    }
+    result["created"] = created["result"];
+
+    // The boxes may come out larger than the size they were placed with:
+    // re-place any that now overlap, by their real size. The patch may have
+    // been closed since the objects were created.
+    if (PatchRegistry::find_patch(patch_id) != patch) {
+        return ToolCommon::make_error(ToolCommon::ErrorCode::INTERNAL_ERROR,
+                                      "Patch closed during place_objects");
+    }
+    boxes.resize(items.size(), nullptr);
+    auto* settle = new t_settle_objects_data{patch, std::move(boxes), new DeferredResult()};
+    json settled = ToolCommon::run_deferred(patch, (method)settle_objects_deferred,
+                                            "place_objects", settle,
+                                            ToolCommon::DEFAULT_DEFER_TIMEOUT,
+                                            "settling created objects",
+                                            ToolCommon::DeferredWrap::Raw);
+    if (settled.contains("error")) {
+        return settled;
+    }
+
+    size_t moved = 0;
+    for (const json& object : settled["objects"]) {
+        json& placement = result["placements"][object["index"].get<size_t>()];
+        placement["position"] = object["position"];
+        placement["width"] = object["width"];
+        placement["height"] = object["height"];
+        if (object["moved"].get<bool>()) {
+            placement["moved"] = true;
+            ++moved;
+        }
+    }
+    result["moved"] = moved;
+    return {{"result", result}};
+}
+
 #endif  // MAXMCP_TEST_MODE
 
 // ============================================================================
@@ -309,6 +933,12 @@ json execute(const std::string& tool, const json& params) {
         return ToolCommon::test_mode_error();
 #else
         return execute_get_avoid_rect_position(params);
+#endif
+    } else if (tool == "place_objects") {
+#ifdef MAXMCP_TEST_MODE
+        return ToolCommon::test_mode_error();
+#else
+        return execute_place_objects(params);
 #endif
     }
 
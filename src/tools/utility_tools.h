@@ -5,6 +5,7 @@
     Tools for utility operations:
     - get_console_log
     - get_avoid_rect_position
+    - place_objects
 
     @ingroup maxmcp
 */
@@ -85,12 +86,78 @@ bool rects_conflict(const Rect& a, const Rect& b, double gap);
 PlacedPosition find_avoid_rect_position(const std::vector<Rect>& existing, double width,
                                         double height, bool has_near, double near_x, double near_y);
 
+/**
+ * @brief One object to place with place_rects().
+ */
+struct PlaceRequest {
+    double width = 50.0;
+    double height = 20.0;
+    bool has_near = false;  ///< Whether near_x/near_y anchor this request
+    double near_x = 0.0;
+    double near_y = 0.0;
+    std::string group;  ///< Requests sharing a non-empty group are kept together
+};
+
+/**
+ * @brief Place several new objects at once, clear of @p existing and of
+ *        each other.
+ *
+ * Pure geometry, like find_avoid_rect_position(), which places each block:
+ *
+ * - The requests of one group are packed into rows, in request order, to
+ *   form a block about three times as wide as it is tall. Ungrouped requests with an anchor are a
+ *   block each, and all ungrouped requests without one share a block.
+ * - A block's anchor is the first anchor among its requests; a block
+ *   without one goes to the right of everything placed so far.
+ * - Anchored blocks are placed first, in request order, then the others,
+ *   largest first. Each placed object is avoided by the blocks after it.
+ *
+ * @param existing Existing object rectangles to avoid
+ * @param requests The objects to place
+ * @return One position per request, in request order
+ */
+std::vector<PlacedPosition> place_rects(const std::vector<Rect>& existing,
+                                        const std::vector<PlaceRequest>& requests);
+
+/**
+ * @brief Final positions for objects created at place_rects() positions.
+ *
+ * A created box can come out larger than the size it was placed with (e.g.
+ * longer text). Going through @p created in order, a rect that conflicts
+ * with @p existing or with an earlier created rect is moved to the nearest
+ * free spot to its own top-left corner (find_avoid_rect_position()); the
+ * others stay where they are.
+ *
+ * @param existing Rectangles of the objects that were already there
+ * @param created  Real rectangles of the created objects
+ * @return One position per created rect, in order
+ */
+std::vector<geometry::Point> settle_rects(const std::vector<Rect>& existing,
+                                          const std::vector<Rect>& created);
+
+/**
+ * @brief Offset that moves @p block, as a whole, clear of @p existing.
+ *
+ * Zero when no rect of @p block conflicts with @p existing (see
+ * rects_conflict(), with the placement gap). Otherwise the bounding box of
+ * @p block is placed with find_avoid_rect_position(), anchored at its current
+ * top-left corner, and the offset to that spot is returned. Used by
+ * auto_layout to keep a laid-out subset off the boxes it leaves alone.
+ *
+ * @param existing Rectangles to keep clear of
+ * @param block    Rectangles that move together
+ * @return How far to move every rect of @p block
+ */
+geometry::Point clear_block_offset(const std::vector<Rect>& existing,
+                                   const std::vector<Rect>& block);
+
 /**
  * @brief Get the JSON schemas for all utility tools
  *
  * Returns an array of tool definitions for:
  * - get_console_log: Retrieve recent Max Console messages
  * - get_avoid_rect_position: Find empty position for placing new objects
+ * - place_objects: Place (and optionally create) several new objects at once
  *
  * @return JSON array of tool schemas
  */
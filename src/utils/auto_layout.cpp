@@ -0,0 +1,667 @@
+/**
+    @file auto_layout.cpp
+    MaxMCP - Layered (Sugiyama-style) layout of a patch for auto_layout
+
+    @ingroup maxmcp
+*/
+
+#include "auto_layout.h"
+
+#include "io_geometry.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <queue>
+#include <tuple>
+#include <utility>
+
+namespace geometry {
+
+namespace {
+
+// Rows of unconnected boxes wrap at the drawing's width, but never narrower.
+constexpr double kMinPackWidth = 600.0;
+
+// Coordinate passes: each is one sweep down and one sweep up.
+constexpr int kCoordinatePasses = 4;
+
+// Stop ordering after this many sweeps without fewer crossings.
+constexpr int kStallSweeps = 4;
+
+// Where cords attach to a box, as x offsets from its left edge, by logical
+// inlet/outlet index. NaN for an inlet that is not drawn.
+struct Ports {
+    std::vector<double> inlet;
+    std::vector<double> outlet;
+};
+
+std::vector<double> port_offsets(const LayeredNode& node, IoSide side) {
+    const int count = side == IoSide::Inlet ? node.inlets : node.outlets;
+    std::vector<double> offsets(std::max(count, 0), std::numeric_limits<double>::quiet_NaN());
+    for (const IoPosition& p :
+         io_positions(node.rect, count, side, node.draw_first_in, node.maxclass)) {
+        if (p.index >= 0 && p.index < count) {
+            offsets[p.index] = p.center.x - node.rect.origin.x;
+        }
+    }
+    return offsets;
+}
+
+// A nub that is not drawn, or not there at all, attaches at the box center.
+double port_at(const std::vector<double>& offsets, int index, double width) {
+    if (index >= 0 && static_cast<size_t>(index) < offsets.size() && !std::isnan(offsets[index])) {
+        return offsets[index];
+    }
+    return width / 2;
+}
+
+// One piece of a cord between adjacent layers. Offsets are from the left edge
+// of each end's box (0 for a dummy node).
+struct Link {
+    int upper;
+    int lower;
+    double upper_offset;
+    double lower_offset;
+    double weight;
+};
+
+// Straightness weights of Gansner et al.: a piece between two dummies (the
+// middle of a long cord) should bend least.
+double link_weight(bool upper_dummy, bool lower_dummy) {
+    if (upper_dummy && lower_dummy) {
+        return 8.0;
+    }
+    return upper_dummy || lower_dummy ? 2.0 : 1.0;
+}
+
+// Number of pairs i < j with keys[i] > keys[j], sorting @p keys.
+size_t count_inversions(std::vector<double>& keys, std::vector<double>& scratch) {
+    const size_t n = keys.size();
+    scratch.resize(n);
+    size_t inversions = 0;
+    for (size_t width = 1; width < n; width *= 2) {
+        for (size_t lo = 0; lo < n; lo += 2 * width) {
+            const size_t mid = std::min(lo + width, n);
+            const size_t hi = std::min(lo + 2 * width, n);
+            size_t i = lo, j = mid, k = lo;
+            while (i < mid && j < hi) {
+                if (keys[j] < keys[i]) {
+                    inversions += mid - i;
+                    scratch[k++] = keys[j++];
+                } else {
+                    scratch[k++] = keys[i++];
+                }
+            }
+            while (i < mid) {
+                scratch[k++] = keys[i++];
+            }
+            while (j < hi) {
+                scratch[k++] = keys[j++];
+            }
+        }
+        keys.swap(scratch);
+    }
+    return inversions;
+}
+
+// Eades-Lin-Smyth greedy feedback arc set: peel sinks off the back and
+// sources off the front; when neither is left, move the box with the most
+// outgoing minus incoming cords to the front. Cords pointing backwards in
+// the resulting sequence close feedback cycles. Ties go to the box higher on
+// screen, then to the lower index. O((V + E) log V).
+std::vector<int> acyclic_order(const std::vector<LayeredNode>& nodes,
+                               const std::vector<LayeredEdge>& cords,
+                               const std::vector<char>& connected) {
+    const int n = static_cast<int>(nodes.size());
+    std::vector<std::vector<int>> succ(n), pred(n);
+    for (const LayeredEdge& e : cords) {
+        succ[e.src].push_back(e.dst);
+        pred[e.dst].push_back(e.src);
+    }
+    std::vector<int> out_degree(n), in_degree(n);
+    std::vector<char> removed(n, 1);
+    std::vector<int> sinks, sources;
+    // (out - in, -y, -index): the top is the box to move next
+    std::priority_queue<std::tuple<int, double, int>> best;
+    size_t remaining = 0;
+    for (int v = n - 1; v >= 0; --v) {
+        if (!connected[v]) {
+            continue;
+        }
+        removed[v] = 0;
+        ++remaining;
+        out_degree[v] = static_cast<int>(succ[v].size());
+        in_degree[v] = static_cast<int>(pred[v].size());
+        if (out_degree[v] == 0) {
+            sinks.push_back(v);
+        } else if (in_degree[v] == 0) {
+            sources.push_back(v);
+        } else {
+            best.emplace(out_degree[v] - in_degree[v], -nodes[v].rect.origin.y, -v);
+        }
+    }
+
+    std::vector<int> front, back;
+    auto remove = [&](int v) {
+        removed[v] = 1;
+        --remaining;
+        for (int w : succ[v]) {
+            if (!removed[w] && --in_degree[w] == 0 && out_degree[w] > 0) {
+                sources.push_back(w);
+            } else if (!removed[w]) {
+                best.emplace(out_degree[w] - in_degree[w], -nodes[w].rect.origin.y, -w);
+            }
+        }
+        for (int u : pred[v]) {
+            if (!removed[u] && --out_degree[u] == 0) {
+                sinks.push_back(u);
+            } else if (!removed[u]) {
+                best.emplace(out_degree[u] - in_degree[u], -nodes[u].rect.origin.y, -u);
+            }
+        }
+    };
+    while (remaining > 0) {
+        if (!sinks.empty()) {
+            const int v = sinks.back();
+            sinks.pop_back();
+            if (!removed[v]) {
+                back.push_back(v);
+                remove(v);
+            }
+        } else if (!sources.empty()) {
+            const int v = sources.back();
+            sources.pop_back();
+            if (!removed[v]) {
+                front.push_back(v);
+                remove(v);
+            }
+        } else {
+            const auto [delta, y, minus_v] = best.top();
+            best.pop();
+            const int v = -minus_v;
+            (void)y;
+            if (!removed[v] && delta == out_degree[v] - in_degree[v]) {
+                front.push_back(v);
+                remove(v);
+            }
+        }
+    }
+    front.insert(front.end(), back.rbegin(), back.rend());
+    return front;
+}
+
+class Layering {
+  public:
+    Layering(const std::vector<LayeredNode>& nodes, const std::vector<LayeredEdge>& edges,
+             const LayeredLayoutOptions& options, LayeredLayoutResult& result)
+        : nodes_(nodes), options_(options), result_(result) {
+        build(edges);
+    }
+
+    void run() {
+        if (layers_.empty()) {
+            return;
+        }
+        result_.initial_crossings = crossings();
+        order();
+        result_.crossings = crossings();
+        assign_x();
+        assign_y();
+    }
+
+    // Whether any box has a cord; if so, the drawing's bottom and right edge.
+    bool empty() const {
+        return layers_.empty();
+    }
+    double bottom() const {
+        return bottom_;
+    }
+    double right() const {
+        return right_;
+    }
+
+  private:
+    bool is_dummy(int v) const {
+        return static_cast<size_t>(v) >= nodes_.size();
+    }
+    double width(int v) const {
+        return is_dummy(v) ? 0.0 : nodes_[v].rect.width;
+    }
+
+    // Position within the layer, plus where on the box the link attaches.
+    double upper_key(const Link& link) const {
+        return pos_[link.upper] + attach_fraction(link.upper, link.upper_offset);
+    }
+    double lower_key(const Link& link) const {
+        return pos_[link.lower] + attach_fraction(link.lower, link.lower_offset);
+    }
+    double attach_fraction(int v, double offset) const {
+        const double w = width(v);
+        if (w <= 0.0) {
+            return 0.5;
+        }
+        return std::clamp(offset / w, 0.0, 0.999);
+    }
+
+    void build(const std::vector<LayeredEdge>& edges);
+    size_t crossings();
+    void order();
+    void reorder(const std::vector<int>& layer_nodes, bool from_above);
+    void assign_x();
+    void place(const std::vector<int>& layer_nodes, bool above, bool below);
+    void assign_y();
+
+    const std::vector<LayeredNode>& nodes_;
+    const LayeredLayoutOptions& options_;
+    LayeredLayoutResult& result_;
+
+    std::vector<Link> links_;
+    std::vector<std::vector<int>> up_, down_;  // link ids per node
+    std::vector<std::vector<int>> layers_;     // node ids, left to right
+    std::vector<int> layer_of_;                // per node, dummies included
+    std::vector<double> pos_;                  // index within the layer
+    std::vector<double> x_;                    // left edge
+
+    std::vector<double> keys_, scratch_;
+    std::vector<std::pair<double, double>> pairs_;
+    double bottom_ = 0.0, right_ = 0.0;
+};
+
+void Layering::build(const std::vector<LayeredEdge>& edges) {
+    const int n = static_cast<int>(nodes_.size());
+
+    // Self-loops and bad ids dropped
+    std::vector<LayeredEdge> cords;
+    std::vector<char> connected(n, 0);
+    for (const LayeredEdge& e : edges) {
+        if (e.src >= 0 && e.src < n && e.dst >= 0 && e.dst < n && e.src != e.dst) {
+            cords.push_back(e);
+            connected[e.src] = connected[e.dst] = 1;
+        }
+    }
+    if (cords.empty()) {
+        return;
+    }
+
+    // Cycle breaking: the cords pointing backwards in a near-topological
+    // sequence are laid out reversed, which leaves the sequence topological.
+    const std::vector<int> sequence = acyclic_order(nodes_, cords, connected);
+    std::vector<int> rank(n, -1);
+    for (size_t i = 0; i < sequence.size(); ++i) {
+        rank[sequence[i]] = static_cast<int>(i);
+    }
+
+    // Longest-path layers over the acyclic cords (top -> bottom).
+    struct Arc {
+        int top, bottom;
+        double top_offset, bottom_offset;
+    };
+    std::vector<Arc> arcs;
+    arcs.reserve(cords.size());
+    std::vector<Ports> ports(n);
+    for (int v = 0; v < n; ++v) {
+        if (connected[v]) {
+            ports[v] = {port_offsets(nodes_[v], IoSide::Inlet),
+                        port_offsets(nodes_[v], IoSide::Outlet)};
+        }
+    }
+    std::vector<std::vector<int>> arcs_from(n), arcs_to(n);
+    for (size_t c = 0; c < cords.size(); ++c) {
+        const LayeredEdge& e = cords[c];
+        const double out_x = port_at(ports[e.src].outlet, e.outlet, nodes_[e.src].rect.width);
+        const double in_x = port_at(ports[e.dst].inlet, e.inlet, nodes_[e.dst].rect.width);
+        // A reversed cord still leaves the (now lower) source's outlet and
+        // enters the (now upper) destination's inlet.
+        const bool reversed = rank[e.src] > rank[e.dst];
+        arcs.push_back(reversed ? Arc{e.dst, e.src, in_x, out_x} : Arc{e.src, e.dst, out_x, in_x});
+        arcs_from[arcs.back().top].push_back(static_cast<int>(c));
+        arcs_to[arcs.back().bottom].push_back(static_cast<int>(c));
+        result_.reversed_edges += reversed;
+    }
+
+    std::vector<int>& layer = result_.layer;
+    for (int v : sequence) {
+        layer[v] = 0;
+    }
+    for (int v : sequence) {
+        for (int c : arcs_from[v]) {
+            layer[arcs[c].bottom] = std::max(layer[arcs[c].bottom], layer[v] + 1);
+        }
+    }
+    // ... which puts every box as high as it can go, sources at the top.
+    // From the bottom up, pull a box with more cords below it than above it
+    // down to just above its highest successor: that shortens more cords
+    // than it stretches.
+    for (auto it = sequence.rbegin(); it != sequence.rend(); ++it) {
+        if (arcs_from[*it].size() > arcs_to[*it].size()) {
+            int lowest = std::numeric_limits<int>::max();
+            for (int c : arcs_from[*it]) {
+                lowest = std::min(lowest, layer[arcs[c].bottom]);
+            }
+            layer[*it] = lowest - 1;
+        }
+    }
+    // Close up the layers that emptied.
+    std::vector<int> renumber;
+    for (int v : sequence) {
+        if (static_cast<size_t>(layer[v]) >= renumber.size()) {
+            renumber.resize(layer[v] + 1, 0);
+        }
+        renumber[layer[v]] = 1;
+    }
+    std::partial_sum(renumber.begin(), renumber.end(), renumber.begin());
+    for (int v : sequence) {
+        layer[v] = renumber[layer[v]] - 1;
+    }
+    const int layer_count = renumber.back();
+    result_.layer_count = layer_count;
+    layers_.assign(layer_count, {});
+    layer_of_.assign(layer.begin(), layer.end());
+
+    // Split cords spanning several layers into links through dummy nodes.
+    std::vector<double> center_x(n);
+    for (int v = 0; v < n; ++v) {
+        center_x[v] = nodes_[v].rect.origin.x + nodes_[v].rect.width / 2;
+    }
+    std::vector<double> initial_x(center_x);
+    for (const Arc& arc : arcs) {
+        int prev = arc.top;
+        double prev_offset = arc.top_offset;
+        const int span = layer[arc.bottom] - layer[arc.top];
+        for (int step = 1; step < span; ++step) {
+            const int dummy = static_cast<int>(layer_of_.size());
+            layer_of_.push_back(layer[arc.top] + step);
+            initial_x.push_back(center_x[arc.top] +
+                                (center_x[arc.bottom] - center_x[arc.top]) * step / span);
+            links_.push_back({prev, dummy, prev_offset, 0.0,
+                              link_weight(is_dummy(prev), true)});
+            prev = dummy;
+            prev_offset = 0.0;
+        }
+        links_.push_back({prev, arc.bottom, prev_offset, arc.bottom_offset,
+                          link_weight(is_dummy(prev), false)});
+    }
+    result_.dummy_nodes = layer_of_.size() - n;
+
+    const size_t total = layer_of_.size();
+    up_.assign(total, {});
+    down_.assign(total, {});
+    for (size_t l = 0; l < links_.size(); ++l) {
+        down_[links_[l].upper].push_back(static_cast<int>(l));
+        up_[links_[l].lower].push_back(static_cast<int>(l));
+    }
+
+    // Initial order: the boxes' current left-to-right order.
+    for (size_t v = 0; v < total; ++v) {
+        if (layer_of_[v] >= 0) {
+            layers_[layer_of_[v]].push_back(static_cast<int>(v));
+        }
+    }
+    pos_.assign(total, 0.0);
+    for (std::vector<int>& nodes : layers_) {
+        std::stable_sort(nodes.begin(), nodes.end(),
+                         [&](int a, int b) { return initial_x[a] < initial_x[b]; });
+        for (size_t i = 0; i < nodes.size(); ++i) {
+            pos_[nodes[i]] = static_cast<double>(i);
+        }
+    }
+}
+
+size_t Layering::crossings() {
+    size_t total = 0;
+    for (const std::vector<int>& nodes : layers_) {
+        pairs_.clear();
+        for (int v : nodes) {
+            for (int l : down_[v]) {
+                pairs_.emplace_back(upper_key(links_[l]), lower_key(links_[l]));
+            }
+        }
+        std::sort(pairs_.begin(), pairs_.end());
+        keys_.clear();
+        for (const auto& pair : pairs_) {
+            keys_.push_back(pair.second);
+        }
+        total += count_inversions(keys_, scratch_);
+    }
+    return total;
+}
+
+void Layering::reorder(const std::vector<int>& layer_nodes, bool from_above) {
+    std::vector<std::pair<double, int>> keyed;
+    keyed.reserve(layer_nodes.size());
+    for (int v : layer_nodes) {
+        const std::vector<int>& links = from_above ? up_[v] : down_[v];
+        double key = pos_[v];
+        if (!links.empty()) {
+            double sum = 0.0;
+            for (int l : links) {
+                sum += from_above ? upper_key(links_[l]) : lower_key(links_[l]);
+            }
+            key = sum / static_cast<double>(links.size());
+        }
+        keyed.emplace_back(key, v);
+    }
+    std::stable_sort(keyed.begin(), keyed.end(),
+                     [](const auto& a, const auto& b) { return a.first < b.first; });
+    for (size_t i = 0; i < keyed.size(); ++i) {
+        pos_[keyed[i].second] = static_cast<double>(i);
+    }
+}
+
+void Layering::order() {
+    size_t best = result_.initial_crossings;
+    std::vector<double> best_pos = pos_;
+    int stall = 0;
+    for (int sweep = 0; sweep < options_.sweeps && best > 0 && stall < kStallSweeps; ++sweep) {
+        const bool down = sweep % 2 == 0;
+        const int count = static_cast<int>(layers_.size());
+        for (int i = 1; i < count; ++i) {
+            reorder(layers_[down ? i : count - 1 - i], down);
+        }
+        const size_t now = crossings();
+        if (now < best) {
+            best = now;
+            best_pos = pos_;
+            stall = 0;
+        } else {
+            ++stall;
+        }
+    }
+    pos_ = std::move(best_pos);
+    for (std::vector<int>& nodes : layers_) {
+        std::sort(nodes.begin(), nodes.end(), [&](int a, int b) { return pos_[a] < pos_[b]; });
+    }
+}
+
+// Least-squares x for one layer: each node wants the x that makes its links
+// to the chosen neighbouring layer(s) vertical; the order, widths and gaps
+// are hard constraints. Substituting y_i = x_i - (space taken by nodes
+// 0..i-1) turns them into y_i <= y_{i+1}, an isotonic regression solved
+// exactly by pooling adjacent violators.
+void Layering::place(const std::vector<int>& layer_nodes, bool above, bool below) {
+    const size_t count = layer_nodes.size();
+    struct Block {
+        double weight, weighted_sum;
+        size_t first;
+    };
+    std::vector<Block> blocks;
+    blocks.reserve(count);
+    std::vector<double> prefix(count, 0.0);
+    for (size_t i = 0; i < count; ++i) {
+        const int v = layer_nodes[i];
+        if (i > 0) {
+            const int u = layer_nodes[i - 1];
+            const double gap = is_dummy(u) || is_dummy(v) ? options_.node_gap / 2
+                                                          : options_.node_gap;
+            prefix[i] = prefix[i - 1] + width(u) + gap;
+        }
+
+        double weight = 0.0, sum = 0.0;
+        auto pull = [&](const std::vector<int>& links, bool from_above) {
+            for (int l : links) {
+                const Link& link = links_[l];
+                const double target = from_above
+                                          ? x_[link.upper] + link.upper_offset - link.lower_offset
+                                          : x_[link.lower] + link.lower_offset - link.upper_offset;
+                weight += link.weight;
+                sum += link.weight * target;
+            }
+        };
+        if (above) {
+            pull(up_[v], true);
+        }
+        if (below) {
+            pull(down_[v], false);
+        }
+        if (weight == 0.0) {
+            // Nothing on the requested side: follow the other one, or stay.
+            pull(above ? down_[v] : up_[v], !above);
+        }
+        if (weight == 0.0) {
+            weight = 0.01;
+            sum = weight * x_[v];
+        }
+
+        blocks.push_back({weight, sum - weight * prefix[i], i});
+        while (blocks.size() > 1) {
+            const Block& last = blocks.back();
+            Block& prev = blocks[blocks.size() - 2];
+            if (prev.weighted_sum / prev.weight <= last.weighted_sum / last.weight) {
+                break;
+            }
+            prev.weight += last.weight;
+            prev.weighted_sum += last.weighted_sum;
+            blocks.pop_back();
+        }
+    }
+    for (size_t b = 0; b < blocks.size(); ++b) {
+        const double y = blocks[b].weighted_sum / blocks[b].weight;
+        const size_t end = b + 1 < blocks.size() ? blocks[b + 1].first : count;
+        for (size_t i = blocks[b].first; i < end; ++i) {
+            x_[layer_nodes[i]] = y + prefix[i];
+        }
+    }
+}
+
+void Layering::assign_x() {
+    x_.assign(layer_of_.size(), 0.0);
+    for (const std::vector<int>& nodes : layers_) {
+        double cursor = 0.0;
+        for (size_t i = 0; i < nodes.size(); ++i) {
+            if (i > 0) {
+                cursor += width(nodes[i - 1]) + (is_dummy(nodes[i - 1]) || is_dummy(nodes[i])
+                                                     ? options_.node_gap / 2
+                                                     : options_.node_gap);
+            }
+            x_[nodes[i]] = cursor;
+        }
+    }
+
+    const int count = static_cast<int>(layers_.size());
+    for (int pass = 0; pass < kCoordinatePasses; ++pass) {
+        for (int i = 1; i < count; ++i) {
+            place(layers_[i], true, false);
+        }
+        for (int i = count - 2; i >= 0; --i) {
+            place(layers_[i], false, true);
+        }
+    }
+    // A last balancing pass lets every box settle between both neighbours.
+    for (int i = 0; i < count; ++i) {
+        place(layers_[i], true, true);
+    }
+}
+
+void Layering::assign_y() {
+    const size_t n = nodes_.size();
+    double left = std::numeric_limits<double>::infinity();
+    double top = std::numeric_limits<double>::infinity();
+    for (size_t v = 0; v < n; ++v) {
+        top = std::min(top, nodes_[v].rect.origin.y);
+        left = std::min(left, nodes_[v].rect.origin.x);
+    }
+    double min_x = std::numeric_limits<double>::infinity();
+    for (const std::vector<int>& nodes : layers_) {
+        for (int v : nodes) {
+            if (!is_dummy(v)) {
+                min_x = std::min(min_x, x_[v]);
+            }
+        }
+    }
+
+    double y = top;
+    right_ = left;
+    for (const std::vector<int>& nodes : layers_) {
+        double height = 0.0;
+        for (int v : nodes) {
+            if (is_dummy(v)) {
+                continue;
+            }
+            Rect& rect = result_.rects[v];
+            rect.origin = {left + x_[v] - min_x, y};
+            height = std::max(height, rect.height);
+            right_ = std::max(right_, rect.right());
+        }
+        y += height + options_.layer_gap;
+    }
+    bottom_ = y - options_.layer_gap;
+}
+
+}  // namespace
+
+LayeredLayoutResult layered_layout(const std::vector<LayeredNode>& nodes,
+                                   const std::vector<LayeredEdge>& edges,
+                                   const LayeredLayoutOptions& options) {
+    LayeredLayoutResult result;
+    result.rects.reserve(nodes.size());
+    for (const LayeredNode& node : nodes) {
+        result.rects.push_back(node.rect);
+    }
+    result.layer.assign(nodes.size(), -1);
+    if (nodes.empty()) {
+        return result;
+    }
+
+    Layering layering(nodes, edges, options, result);
+    layering.run();
+
+    // Pack the unconnected boxes in rows below the drawing, in their current
+    // reading order (top to bottom, then left to right).
+    std::vector<int> loose;
+    double left = std::numeric_limits<double>::infinity();
+    double top = std::numeric_limits<double>::infinity();
+    for (size_t v = 0; v < nodes.size(); ++v) {
+        left = std::min(left, nodes[v].rect.origin.x);
+        top = std::min(top, nodes[v].rect.origin.y);
+        if (result.layer[v] < 0) {
+            loose.push_back(static_cast<int>(v));
+        }
+    }
+    std::stable_sort(loose.begin(), loose.end(), [&](int a, int b) {
+        const Point& pa = nodes[a].rect.origin;
+        const Point& pb = nodes[b].rect.origin;
+        return pa.y != pb.y ? pa.y < pb.y : pa.x < pb.x;
+    });
+
+    const double limit =
+        left + std::max(kMinPackWidth, layering.empty() ? 0.0 : layering.right() - left);
+    double x = left;
+    double y = layering.empty() ? top : layering.bottom() + options.layer_gap;
+    double row_height = 0.0;
+    for (int v : loose) {
+        Rect& rect = result.rects[v];
+        if (x > left && x + rect.width > limit) {
+            x = left;
+            y += row_height + options.node_gap;
+            row_height = 0.0;
+        }
+        rect.origin = {x, y};
+        x += rect.width + options.node_gap;
+        row_height = std::max(row_height, rect.height);
+    }
+    return result;
+}
+
+}  // namespace geometry
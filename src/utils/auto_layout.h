@@ -0,0 +1,93 @@
+/**
+    @file auto_layout.h
+    MaxMCP - Layered (Sugiyama-style) layout of a patch for auto_layout
+
+    Lays boxes out top to bottom along their patchcords, in the usual four
+    steps of a layered drawing:
+
+      1. Cycle breaking: cords closing a feedback loop are reversed (for
+         layout only) so the graph becomes acyclic.
+      2. Layering: longest-path layers, with sources pulled down next to
+         their first successor. Cords spanning several layers get a chain of
+         zero-width dummy nodes, one per crossed layer.
+      3. Ordering: barycenter sweeps, alternating down and up, that keep the
+         order with the fewest cord crossings between adjacent layers.
+      4. Coordinates: every layer shares a top y; within a layer, x is the
+         weighted least-squares fit (pool-adjacent-violators) of the x each
+         box would need for its cords to run straight down, subject to the
+         box order, the real box widths and the gap. Cords attach at the
+         inlet/outlet positions of io_geometry, so a one-to-one cord between
+         two boxes comes out vertical whenever the order allows it.
+
+    Boxes without any cord are packed in rows below the drawing. The drawing
+    keeps the top-left corner of the input rects' bounding box, and box sizes
+    never change.
+
+    tests/bench/bench_auto_layout.cpp times whole layouts of 500 to 5000
+    boxes and reports the crossings left after ordering.
+
+    @ingroup maxmcp
+*/
+
+#ifndef AUTO_LAYOUT_H
+#define AUTO_LAYOUT_H
+
+#include "geometry.h"
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace geometry {
+
+/**
+ * @brief One box to lay out: its current rect and what its nubs look like.
+ *
+ * The inlet/outlet counts, drawfirstin and maxclass are passed to
+ * io_positions() to find where cords attach.
+ */
+struct LayeredNode {
+    Rect rect;
+    int inlets = 0;
+    int outlets = 0;
+    bool draw_first_in = true;
+    std::string maxclass;
+};
+
+/// One cord, outlet of @c src -> inlet of @c dst, by node index.
+struct LayeredEdge {
+    int src;
+    int outlet;
+    int dst;
+    int inlet;
+};
+
+struct LayeredLayoutOptions {
+    double layer_gap = 30.0;  ///< Vertical space between the boxes of adjacent layers
+    double node_gap = 20.0;   ///< Horizontal space between boxes of one layer
+    int sweeps = 16;          ///< Upper bound on ordering sweeps
+};
+
+struct LayeredLayoutResult {
+    std::vector<Rect> rects;  ///< New rect per node, in input order
+    std::vector<int> layer;   ///< Layer per node (0 at the top); -1 when unconnected
+    int layer_count = 0;
+    int reversed_edges = 0;  ///< Cords reversed to break feedback cycles
+    size_t dummy_nodes = 0;  ///< Layer crossings of cords spanning several layers
+    size_t initial_crossings = 0;  ///< Crossings between adjacent layers, input order
+    size_t crossings = 0;          ///< The same after ordering
+};
+
+/**
+ * @brief Lay out @p nodes along @p edges.
+ *
+ * Edges naming a node out of range, and self-loops, are ignored. Ties are
+ * broken by node index, so the result is deterministic.
+ */
+LayeredLayoutResult layered_layout(const std::vector<LayeredNode>& nodes,
+                                   const std::vector<LayeredEdge>& edges,
+                                   const LayeredLayoutOptions& options = {});
+
+}  // namespace geometry
+
+#endif  // AUTO_LAYOUT_H
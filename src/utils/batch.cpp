@@ -0,0 +1,232 @@
+/**
+    @file batch.cpp
+    MaxMCP - Shared parameter parsing and result shaping for bulk tools
+
+    @ingroup maxmcp
+*/
+
+#include "batch.h"
+
+#include "tools/tool_common.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace batch {
+
+json parse_on_error(const json& params, OnError& out) {
+    out = OnError::Stop;
+    if (!params.contains("on_error")) {
+        return nullptr;
+    }
+
+    const json& value = params["on_error"];
+    if (value == "stop") {
+        out = OnError::Stop;
+    } else if (value == "continue") {
+        out = OnError::Continue;
+    } else {
+        return ToolCommon::make_error(ToolCommon::ErrorCode::INVALID_PARAMS,
+                                      "on_error must be 'stop' or 'continue'");
+    }
+    return nullptr;
+}
+
+json parse_connection_specs(const json& params, const std::string& key, bool require_items,
+                            std::vector<ConnectionSpec>& out) {
+    out.clear();
+    if (!params.contains(key)) {
+        return require_items ? ToolCommon::missing_param_error(key) : json(nullptr);
+    }
+
+    const json& items = params[key];
+    if (!items.is_array() || (require_items && items.empty())) {
+        return ToolCommon::make_error(ToolCommon::ErrorCode::INVALID_PARAMS,
+                                      key + " must be a non-empty array");
+    }
+
+    out.reserve(items.size());
+    for (size_t i = 0; i < items.size(); ++i) {
+        const json& item = items[i];
+        auto non_empty_string = [&item](const char* field) {
+            return item.contains(field) && item[field].is_string() &&
+                   !item[field].get<std::string>().empty();
+        };
+        auto port = [&item](const char* field) {
+            return item.contains(field) && item[field].is_number_integer() &&
+                   item[field].get<long>() >= 0;
+        };
+
+        if (!item.is_object() || !non_empty_string("src_varname") ||
+            !non_empty_string("dst_varname") || !port("outlet") || !port("inlet")) {
+            return ToolCommon::make_error(
+                ToolCommon::ErrorCode::INVALID_PARAMS,
+                key + "[" + std::to_string(i) +
+                    "] needs src_varname, outlet, dst_varname and inlet (ports >= 0)");
+        }
+
+        out.push_back({item["src_varname"].get<std::string>(), item["outlet"].get<long>(),
+                       item["dst_varname"].get<std::string>(), item["inlet"].get<long>()});
+    }
+    return nullptr;
+}
+
+json item_success(size_t index, json fields) {
+    json entry = {{"index", index}, {"status", "success"}};
+    if (fields.is_object()) {
+        entry.update(std::move(fields));
+    }
+    return entry;
+}
+
+json item_error(size_t index, const std::string& message) {
+    return {{"index", index}, {"status", "error"}, {"error", message}};
+}
+
+std::string Tally::status() const {
+    if (failed_ == 0) {
+        return "success";
+    }
+    return succeeded_ > 0 ? "partial" : "failed";
+}
+
+// ============================================================================
+// Bulk attribute access
+// ============================================================================
+
+namespace {
+
+json invalid(const std::string& message) {
+    return ToolCommon::make_error(ToolCommon::ErrorCode::INVALID_PARAMS, message);
+}
+
+bool is_non_empty_string(const json& value) {
+    return value.is_string() && !value.get_ref<const std::string&>().empty();
+}
+
+// Anything PatchHelpers::json_to_atoms turns into at least one atom
+bool is_attribute_value(const json& value) {
+    auto scalar = [](const json& v) { return v.is_number() || v.is_string(); };
+    if (value.is_array()) {
+        return !value.empty() && std::all_of(value.begin(), value.end(), scalar);
+    }
+    return scalar(value);
+}
+
+}  // namespace
+
+bool BoxSelector::matches(const std::string& box_maxclass, const geometry::Rect& box_rect) const {
+    if (!maxclass.empty() && box_maxclass != maxclass) {
+        return false;
+    }
+    return !region || geometry::aabb_overlap(box_rect, *region, 0.0);
+}
+
+json parse_selector(const json& value, BoxSelector& out) {
+    out = BoxSelector{};
+    if (!value.is_object()) {
+        return invalid("selector must be an object");
+    }
+
+    if (value.contains("maxclass")) {
+        if (!is_non_empty_string(value["maxclass"])) {
+            return invalid("selector.maxclass must be a non-empty string");
+        }
+        out.maxclass = value["maxclass"].get<std::string>();
+    }
+
+    if (value.contains("region")) {
+        const json& r = value["region"];
+        if (!r.is_array() || r.size() != 4 ||
+            !std::all_of(r.begin(), r.end(), [](const json& v) { return v.is_number(); }) ||
+            r[2].get<double>() < 0 || r[3].get<double>() < 0) {
+            return invalid("selector.region must be [x, y, width, height]");
+        }
+        out.region = geometry::Rect{r[0].get<double>(), r[1].get<double>(), r[2].get<double>(),
+                                    r[3].get<double>()};
+    }
+
+    if (out.maxclass.empty() && !out.region) {
+        return invalid("selector needs 'maxclass' and/or 'region'");
+    }
+    return nullptr;
+}
+
+size_t ValuePool::add(const json& value) {
+    auto [it, inserted] = index_.emplace(value.dump(), values_.size());
+    if (inserted) {
+        values_.push_back(value);
+    }
+    return it->second;
+}
+
+json parse_attribute_request(const json& params, bool with_values, AttributeRequest& out) {
+    out = AttributeRequest{};
+    const bool has_items = params.contains("items");
+    const bool has_selector = params.contains("selector");
+    if (has_items == has_selector) {
+        return invalid("Pass either 'items' or 'selector' with 'attributes'");
+    }
+
+    if (has_items) {
+        const json& items = params["items"];
+        if (!items.is_array() || items.empty()) {
+            return invalid("items must be a non-empty array");
+        }
+        out.items.reserve(items.size());
+        for (size_t i = 0; i < items.size(); ++i) {
+            const json& item = items[i];
+            const std::string where = "items[" + std::to_string(i) + "]";
+            if (!item.is_object() || !item.contains("varname") ||
+                !is_non_empty_string(item["varname"]) || !item.contains("attribute") ||
+                !is_non_empty_string(item["attribute"])) {
+                return invalid(where + (with_values ? " needs varname, attribute and value"
+                                                    : " needs varname and attribute"));
+            }
+
+            AttributeItem parsed{item["varname"].get<std::string>(),
+                                 out.names.add(item["attribute"]), 0};
+            if (with_values) {
+                if (!item.contains("value") || !is_attribute_value(item["value"])) {
+                    return invalid(where +
+                                   ".value must be a number, string or array of them");
+                }
+                parsed.value = out.values.add(item["value"]);
+            }
+            out.items.push_back(std::move(parsed));
+        }
+        return nullptr;
+    }
+
+    BoxSelector selector;
+    json error = parse_selector(params["selector"], selector);
+    if (!error.is_null()) {
+        return error;
+    }
+    out.selector = std::move(selector);
+
+    const json* attributes = params.contains("attributes") ? &params["attributes"] : nullptr;
+    if (with_values) {
+        if (!attributes || !attributes->is_object() || attributes->empty()) {
+            return invalid("attributes must be a non-empty {name: value} object");
+        }
+        for (const auto& [name, value] : attributes->items()) {
+            if (name.empty() || !is_attribute_value(value)) {
+                return invalid("attributes." + name +
+                               " must be a number, string or array of them");
+            }
+            out.attributes.emplace_back(out.names.add(name), out.values.add(value));
+        }
+    } else {
+        if (!attributes || !attributes->is_array() || attributes->empty() ||
+            !std::all_of(attributes->begin(), attributes->end(), is_non_empty_string)) {
+            return invalid("attributes must be a non-empty array of attribute names");
+        }
+        for (const json& name : *attributes) {
+            out.attributes.emplace_back(out.names.add(name), 0);
+        }
+    }
+    return nullptr;
+}
+
+}  // namespace batch
@@ -0,0 +1,199 @@
+/**
+    @file batch.h
+    MaxMCP - Shared parameter parsing and result shaping for bulk tools
+
+    Bulk tools (add_max_objects, connect_max_objects_batch, ...) take an array
+    of items, validate every item before deferring, run them all in a single
+    main-thread pass and report one result per item. Items never fail the
+    whole call; an item error is recorded as
+
+        {"index": 3, "status": "error", "error": "..."}
+
+    and, depending on "on_error", processing either stops there ("stop", the
+    default) or moves on to the next item ("continue").
+
+    set_object_attributes / get_object_attributes address boxes either by
+    explicit (varname, attribute[, value]) items or by a BoxSelector plus an
+    attribute map. Attribute names and values are pooled while parsing so the
+    main-thread pass converts each distinct one to a symbol / atoms only once.
+
+    @ingroup maxmcp
+*/
+
+#ifndef BATCH_H
+#define BATCH_H
+
+#include "geometry.h"
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+namespace batch {
+
+using json = nlohmann::json;
+
+enum class OnError {
+    Stop,      ///< Stop at the first failed item; later items are not attempted
+    Continue,  ///< Attempt every item
+};
+
+/**
+ * @brief Parse the optional "on_error" parameter ("stop" | "continue").
+ * @return Error JSON for any other value, nullptr otherwise
+ */
+json parse_on_error(const json& params, OnError& out);
+
+/**
+ * @brief One patchcord to create, as given to connect_max_objects.
+ */
+struct ConnectionSpec {
+    std::string src_varname;
+    long outlet = 0;
+    std::string dst_varname;
+    long inlet = 0;
+};
+
+/**
+ * @brief Parse params[@p key] as an array of connection items.
+ *
+ * Each item needs non-empty src_varname/dst_varname and non-negative integer
+ * outlet/inlet. A missing key yields an empty list.
+ *
+ * @param require_items If true, a missing or empty array is an error
+ * @return Error JSON naming the first bad item, nullptr otherwise
+ */
+json parse_connection_specs(const json& params, const std::string& key, bool require_items,
+                            std::vector<ConnectionSpec>& out);
+
+/// Per-item success entry: {"index": i, "status": "success", ...fields}.
+json item_success(size_t index, json fields = json::object());
+
+/// Per-item error entry: {"index": i, "status": "error", "error": message}.
+json item_error(size_t index, const std::string& message);
+
+/**
+ * @brief Tracks per-item outcomes and the on_error policy during a pass.
+ */
+class Tally {
+  public:
+    explicit Tally(OnError mode) : mode_(mode) {}
+
+    void succeeded() {
+        ++succeeded_;
+    }
+    void failed() {
+        ++failed_;
+        if (mode_ == OnError::Stop) {
+            stopped_ = true;
+        }
+    }
+
+    /// True when a failure ends the pass (OnError::Stop).
+    bool stops_on_failure() const {
+        return mode_ == OnError::Stop;
+    }
+    /// True once an item failed under OnError::Stop.
+    bool stopped() const {
+        return stopped_;
+    }
+    size_t succeeded_count() const {
+        return succeeded_;
+    }
+    size_t failed_count() const {
+        return failed_;
+    }
+
+    /// "success" (no failures), "partial" (some succeeded) or "failed".
+    std::string status() const;
+
+  private:
+    OnError mode_;
+    size_t succeeded_ = 0;
+    size_t failed_ = 0;
+    bool stopped_ = false;
+};
+
+// ============================================================================
+// Bulk attribute access
+// ============================================================================
+
+/**
+ * @brief Picks boxes by maxclass and/or patching_rect region.
+ *
+ * Both criteria must hold when both are given. A box is in the region when
+ * its patching_rect overlaps it, like a marquee selection in the editor.
+ */
+struct BoxSelector {
+    std::string maxclass;                  ///< "" matches any maxclass
+    std::optional<geometry::Rect> region;  ///< Unset matches anywhere
+
+    bool matches(const std::string& box_maxclass, const geometry::Rect& box_rect) const;
+};
+
+/**
+ * @brief Parse {"maxclass": "comment", "region": [x, y, w, h]}.
+ * @return Error JSON if neither criterion is given or one is malformed
+ */
+json parse_selector(const json& value, BoxSelector& out);
+
+/**
+ * @brief Deduplicating store of JSON values, indexed in insertion order.
+ */
+class ValuePool {
+  public:
+    /// Index of @p value, adding it if it was not seen before.
+    size_t add(const json& value);
+
+    const std::vector<json>& values() const {
+        return values_;
+    }
+    size_t size() const {
+        return values_.size();
+    }
+
+  private:
+    std::unordered_map<std::string, size_t> index_;  // serialized value -> index
+    std::vector<json> values_;
+};
+
+/// One explicit (varname, attribute[, value]) item; indices point into the pools.
+struct AttributeItem {
+    std::string varname;
+    size_t attribute = 0;
+    size_t value = 0;  ///< Unused for reads
+};
+
+/**
+ * @brief A parsed set_object_attributes / get_object_attributes request.
+ *
+ * Exactly one form is filled: @c items, or @c selector with @c attributes.
+ */
+struct AttributeRequest {
+    ValuePool names;   ///< Distinct attribute names (JSON strings)
+    ValuePool values;  ///< Distinct values to write
+    std::vector<AttributeItem> items;
+    std::optional<BoxSelector> selector;
+    std::vector<std::pair<size_t, size_t>> attributes;  ///< (name, value) per selected box
+};
+
+/**
+ * @brief Parse params["items"] or params["selector"] + params["attributes"].
+ *
+ * For writes (@p with_values) items are {varname, attribute, value} and
+ * "attributes" is a {name: value} map; for reads items are {varname,
+ * attribute} and "attributes" is an array of names. Values must be a number,
+ * a string or a non-empty array of them.
+ *
+ * @return Error JSON naming the first bad item, nullptr otherwise
+ */
+json parse_attribute_request(const json& params, bool with_values, AttributeRequest& out);
+
+}  // namespace batch
+
+#endif  // BATCH_H
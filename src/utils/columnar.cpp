@@ -0,0 +1,106 @@
+/**
+    @file columnar.cpp
+    MaxMCP - Columnar (struct-of-arrays) encoding for large listings
+
+    @ingroup maxmcp
+*/
+
+#include "columnar.h"
+
+namespace columnar {
+
+uint32_t StringTable::intern(const std::string& value) {
+    auto it = ids_.find(value);
+    if (it != ids_.end()) {
+        return it->second;
+    }
+    uint32_t id = static_cast<uint32_t>(entries_.size());
+    ids_.emplace(value, id);
+    entries_.push_back(value);
+    return id;
+}
+
+ColumnId ColumnBuilder::add_column(const std::string& name, Kind kind) {
+    columns_.push_back(Column{name, kind, {}, 0, {}});
+    // Rough per-cell estimate; only avoids the first few reallocations.
+    columns_.back().cells.reserve(reserve_rows_ * 4);
+    return columns_.size() - 1;
+}
+
+std::string& ColumnBuilder::next_cell(ColumnId column) {
+    Column& col = columns_[column];
+    if (col.rows++ > 0) {
+        col.cells.push_back(',');
+    }
+    return col.cells;
+}
+
+void ColumnBuilder::push_number(ColumnId column, double value) {
+    jsonwriter::append_number(next_cell(column), value);
+}
+
+void ColumnBuilder::push_string(ColumnId column, const std::string& value) {
+    jsonwriter::append_string(next_cell(column), value);
+}
+
+void ColumnBuilder::push_null(ColumnId column) {
+    next_cell(column) += "null";
+}
+
+void ColumnBuilder::push_interned(ColumnId column, const std::string& value) {
+    uint32_t id = columns_[column].table.intern(value);
+    next_cell(column) += std::to_string(id);
+}
+
+void ColumnBuilder::push_flag(ColumnId column, bool value) {
+    next_cell(column).push_back(value ? '1' : '0');
+}
+
+void ColumnBuilder::push_value(ColumnId column, const nlohmann::json& value) {
+    next_cell(column) += value.dump();
+}
+
+void ColumnBuilder::write(jsonwriter::JsonWriter& writer) const {
+    bool has_values = false;
+    bool has_tables = false;
+    for (const auto& col : columns_) {
+        has_values = has_values || col.kind == Kind::Value;
+        has_tables = has_tables || col.kind == Kind::Interned;
+    }
+
+    auto write_section = [&](const char* section, bool values) {
+        writer.key(section);
+        writer.begin_object();
+        for (const auto& col : columns_) {
+            if ((col.kind == Kind::Value) != values) {
+                continue;
+            }
+            writer.key(col.name);
+            writer.raw_array(col.cells);
+        }
+        writer.end_object();
+    };
+
+    write_section("columns", false);
+    if (has_values) {
+        write_section("attributes", true);
+    }
+    if (has_tables) {
+        writer.key("tables");
+        writer.begin_object();
+        for (const auto& col : columns_) {
+            if (col.kind != Kind::Interned) {
+                continue;
+            }
+            writer.key(col.name);
+            writer.begin_array();
+            for (const auto& entry : col.table.entries()) {
+                writer.string(entry);
+            }
+            writer.end_array();
+        }
+        writer.end_object();
+    }
+}
+
+}  // namespace columnar
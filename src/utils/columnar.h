@@ -0,0 +1,105 @@
+/**
+    @file columnar.h
+    MaxMCP - Columnar (struct-of-arrays) encoding for large listings
+
+    Row-wise listings repeat every key per element ({"varname":..,"maxclass":..}
+    x N) and wrap each position/size in its own small array. The columnar shape
+    stores one parallel array per field instead, and replaces high-repetition
+    strings (class names) with small integer ids into a per-column string table:
+
+        "columns": {"varname": ["osc1", null], "maxclass": [0, 1], "x": [..], ..},
+        "tables":  {"maxclass": ["cycle~", "dac~"]}
+
+    Row i of the listing is element i of every column. Values are collected into
+    typed vectors and serialized with JsonWriter, so no per-element JSON DOM is
+    ever built.
+
+    @ingroup maxmcp
+*/
+
+#ifndef COLUMNAR_H
+#define COLUMNAR_H
+
+#include "json_writer.h"
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+namespace columnar {
+
+/**
+ * @brief Interns strings to dense ids in first-seen order.
+ */
+class StringTable {
+  public:
+    uint32_t intern(const std::string& value);
+    const std::vector<std::string>& entries() const {
+        return entries_;
+    }
+
+  private:
+    std::unordered_map<std::string, uint32_t> ids_;
+    std::vector<std::string> entries_;
+};
+
+/**
+ * @brief Column kinds and their wire form.
+ *
+ * - Number:   JSON numbers.
+ * - String:   JSON strings, null for rows pushed with push_null().
+ * - Interned: integer ids into tables[<column name>].
+ * - Flag:     0/1 (denser than true/false for boolean columns).
+ * - Value:    arbitrary JSON per row; written under "attributes" rather than
+ *             "columns" so caller-named attributes never collide with built-ins.
+ */
+enum class Kind { Number, String, Interned, Flag, Value };
+
+using ColumnId = size_t;
+
+/**
+ * @brief Builder for one columnar listing.
+ */
+class ColumnBuilder {
+  public:
+    explicit ColumnBuilder(size_t reserve_rows = 0) : reserve_rows_(reserve_rows) {}
+
+    /// Declare a column; columns are written in declaration order.
+    ColumnId add_column(const std::string& name, Kind kind);
+
+    void push_number(ColumnId column, double value);
+    void push_string(ColumnId column, const std::string& value);
+    void push_null(ColumnId column);
+    void push_interned(ColumnId column, const std::string& value);
+    void push_flag(ColumnId column, bool value);
+    void push_value(ColumnId column, const nlohmann::json& value);
+
+    /**
+     * @brief Write "columns", then "attributes" / "tables" when non-empty, as
+     *        keys of the object currently open in @p writer.
+     */
+    void write(jsonwriter::JsonWriter& writer) const;
+
+  private:
+    struct Column {
+        std::string name;
+        Kind kind;
+        // Comma-separated serialized elements (the array body without brackets),
+        // appended as rows are pushed so write() only splices it in.
+        std::string cells;
+        size_t rows = 0;
+        StringTable table;
+    };
+
+    std::string& next_cell(ColumnId column);
+
+    size_t reserve_rows_;
+    std::vector<Column> columns_;
+};
+
+}  // namespace columnar
+
+#endif  // COLUMNAR_H
@@ -0,0 +1,356 @@
+/**
+    @file cord_router.cpp
+    MaxMCP - Orthogonal patchcord routing implementation
+
+    @ingroup maxmcp
+*/
+
+#include "cord_router.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+
+namespace geometry {
+
+namespace {
+
+// The first window around the two nubs, grown 2x per failed search
+constexpr double kInitialPad = 60.0;
+// Least clearance of a box next to a closer one
+constexpr double kMinClearance = 1.0;
+// States one route() may expand over all its windows before giving up
+constexpr size_t kMaxExpansions = 200000;
+// Coordinates closer than this are the same line; a segment must enter a box
+// by more than this to be blocked (absorbs the rounding of inflated rects).
+constexpr double kEps = 1e-6;
+
+// Headings; (d + 2) % 4 is the opposite one
+enum Heading : int { Right = 0, Down = 1, Left = 2, Up = 3 };
+constexpr int kDx[4] = {1, 0, -1, 0};
+constexpr int kDy[4] = {0, 1, 0, -1};
+
+Rect inflate(const Rect& r, double by) {
+    return {r.origin.x - by, r.origin.y - by, r.width + 2 * by, r.height + 2 * by};
+}
+
+Rect bounding(const Point& a, const Point& b) {
+    return {std::min(a.x, b.x), std::min(a.y, b.y), std::abs(b.x - a.x), std::abs(b.y - a.y)};
+}
+
+bool covers(const Rect& outer, const Rect& inner) {
+    return outer.origin.x <= inner.origin.x && outer.origin.y <= inner.origin.y &&
+           outer.right() >= inner.right() && outer.bottom() >= inner.bottom();
+}
+
+// Whether the axis-aligned segment a-b enters the interior of @p r
+bool enters(const Point& a, const Point& b, const Rect& r) {
+    if (a.x == b.x) {
+        return r.origin.x + kEps < a.x && a.x < r.right() - kEps &&
+               std::max(std::min(a.y, b.y), r.origin.y) + kEps <
+                   std::min(std::max(a.y, b.y), r.bottom());
+    }
+    return r.origin.y + kEps < a.y && a.y < r.bottom() - kEps &&
+           std::max(std::min(a.x, b.x), r.origin.x) + kEps <
+               std::min(std::max(a.x, b.x), r.right());
+}
+
+void sort_unique(std::vector<double>& v) {
+    std::sort(v.begin(), v.end());
+    v.erase(std::unique(v.begin(), v.end(), [](double a, double b) { return b - a <= kEps; }),
+            v.end());
+}
+
+// The line of a sorted_unique() list that @p value was merged into
+size_t index_of(const std::vector<double>& v, double value) {
+    return static_cast<size_t>(std::lower_bound(v.begin(), v.end(), value - kEps) - v.begin());
+}
+
+// A lower bound on the turns left from heading @p d to reach a point @p dx,
+// @p dy away and leave it heading down.
+int min_turns(int d, double dx, double dy) {
+    if (d == Right || d == Left) {
+        return 1;
+    }
+    if (dx != 0.0) {
+        return 2;
+    }
+    return d == Down && dy >= 0.0 ? 0 : 2;
+}
+
+// Drops the points lying on a straight line through their neighbours.
+std::vector<Point> simplify(const std::vector<Point>& points) {
+    std::vector<Point> out;
+    for (const Point& p : points) {
+        if (!out.empty() && out.back().x == p.x && out.back().y == p.y) {
+            continue;
+        }
+        if (out.size() >= 2) {
+            const Point& a = out[out.size() - 2];
+            const Point& b = out.back();
+            if ((a.x == b.x && b.x == p.x) || (a.y == b.y && b.y == p.y)) {
+                out.back() = p;
+                continue;
+            }
+        }
+        out.push_back(p);
+    }
+    return out;
+}
+
+// One search window: the candidate lines, and A* over their crossings. Grid
+// edges are tested against the boxes only when the search reaches them, and
+// only the states it visits are stored, so a wide window costs no more than
+// the part of it the search explores.
+class RoutingGrid {
+  public:
+    RoutingGrid(std::vector<double> xs, std::vector<double> ys)
+        : xs_(std::move(xs)), ys_(std::move(ys)), nx_(xs_.size()), ny_(ys_.size()) {}
+
+    size_t node_at(double x, double y) const {
+        return index_of(ys_, y) * nx_ + index_of(xs_, x);
+    }
+
+    /**
+     * A* from node @p from (heading down) to node @p to, arriving so that the
+     * cord can leave it heading down. @p blocked(a, b) says whether the grid
+     * edge a-b runs through a box. Each expanded state uses up one unit of
+     * @p budget; returns the node path, or an empty one when there is no path
+     * or the budget ran out.
+     */
+    template <typename Blocked>
+    std::vector<Point> search(size_t from, size_t to, double bend_penalty, size_t& budget,
+                              Blocked blocked) const {
+        struct Visit {
+            double g;
+            size_t parent;
+        };
+        constexpr size_t kNone = std::numeric_limits<size_t>::max();
+        const size_t goal = nx_ * ny_ * 4;  // pseudo-state: arrived and turned down
+        std::unordered_map<size_t, Visit> visits;
+        std::unordered_map<size_t, bool> edge_blocked;  // by lower node * 2 + vertical
+        const Point target = node(to);
+
+        auto h = [&](size_t n, int d) {
+            const Point p = node(n);
+            const double dx = target.x - p.x, dy = target.y - p.y;
+            return std::abs(dx) + std::abs(dy) + bend_penalty * min_turns(d, dx, dy);
+        };
+        auto g_of = [&](size_t s) {
+            auto it = visits.find(s);
+            return it == visits.end() ? std::numeric_limits<double>::infinity() : it->second.g;
+        };
+
+        // (f, -g, state): among equal f, the state furthest along comes first,
+        // which keeps A* from fanning out over the many equally long paths.
+        using Entry = std::tuple<double, double, size_t>;
+        std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> open;
+        const size_t start = from * 4 + Down;
+        visits[start] = {0.0, kNone};
+        open.emplace(h(from, Down), -0.0, start);
+
+        bool found = false;
+        while (!open.empty() && budget > 0) {
+            const auto [f, neg_g, s] = open.top();
+            open.pop();
+            if (s == goal) {
+                found = true;
+                break;
+            }
+            const size_t n = s / 4;
+            const int d = static_cast<int>(s % 4);
+            const double g = visits[s].g;
+            if (-neg_g > g + 1e-9) {
+                continue;  // stale entry
+            }
+            --budget;
+            if (n == to) {
+                const double cost = g + (d == Down ? 0.0 : bend_penalty);
+                if (cost < g_of(goal)) {
+                    visits[goal] = {cost, s};
+                    open.emplace(cost, -cost, goal);
+                }
+            }
+            const size_t i = n % nx_, j = n / nx_;
+            for (int nd = 0; nd < 4; ++nd) {
+                if (nd == (d + 2) % 4) {
+                    continue;  // no U-turns on the spot
+                }
+                if ((nd == Left && i == 0) || (nd == Right && i + 1 == nx_) ||
+                    (nd == Up && j == 0) || (nd == Down && j + 1 == ny_)) {
+                    continue;
+                }
+                const size_t next = (j + kDy[nd]) * nx_ + (i + kDx[nd]);
+                const Point a = node(n), b = node(next);
+                const size_t edge = std::min(n, next) * 2 + (nd == Up || nd == Down);
+                auto cached = edge_blocked.find(edge);
+                if (cached == edge_blocked.end()) {
+                    cached = edge_blocked.emplace(edge, blocked(a, b)).first;
+                }
+                if (cached->second) {
+                    continue;
+                }
+                const double cost =
+                    g + std::abs(b.x - a.x) + std::abs(b.y - a.y) + (nd == d ? 0.0 : bend_penalty);
+                const size_t ns = next * 4 + nd;
+                if (cost < g_of(ns)) {
+                    visits[ns] = {cost, s};
+                    open.emplace(cost + h(next, nd), -cost, ns);
+                }
+            }
+        }
+
+        std::vector<Point> path;
+        if (!found) {
+            return path;
+        }
+        for (size_t s = visits[goal].parent; s != kNone; s = visits[s].parent) {
+            path.push_back(node(s / 4));
+        }
+        std::reverse(path.begin(), path.end());
+        return path;
+    }
+
+  private:
+    Point node(size_t n) const {
+        return {xs_[n % nx_], ys_[n / nx_]};
+    }
+
+    std::vector<double> xs_, ys_;
+    size_t nx_, ny_;
+};
+
+}  // namespace
+
+CordRouter::CordRouter(std::vector<Rect> boxes, CordRouterOptions options)
+    : boxes_(std::move(boxes)),
+      options_(options),
+      index_(GridIndex::suggest_cell_size(boxes_)),
+      clearance_(boxes_.size(), options.margin),
+      bounds_{0.0, 0.0, 0.0, 0.0} {
+    for (size_t i = 0; i < boxes_.size(); ++i) {
+        index_.insert(static_cast<int>(i), boxes_[i]);
+        const Rect& r = boxes_[i];
+        if (i == 0) {
+            bounds_ = r;
+            continue;
+        }
+        const double left = std::min(bounds_.origin.x, r.origin.x);
+        const double top = std::min(bounds_.origin.y, r.origin.y);
+        bounds_ = {left, top, std::max(bounds_.right(), r.right()) - left,
+                   std::max(bounds_.bottom(), r.bottom()) - top};
+    }
+
+    // Two boxes closer than two margins split the gap between them, so a
+    // channel only closes where the boxes (nearly) touch.
+    const double floor = std::min(options_.margin, kMinClearance);
+    for (size_t i = 0; i < boxes_.size(); ++i) {
+        const Rect& a = boxes_[i];
+        for (int j : index_.query(inflate(a, 2 * options_.margin))) {
+            if (static_cast<size_t>(j) == i) {
+                continue;
+            }
+            const Rect& b = boxes_[j];
+            const double gap = std::max({b.origin.x - a.right(), a.origin.x - b.right(),
+                                         b.origin.y - a.bottom(), a.origin.y - b.bottom()});
+            clearance_[i] = std::min(clearance_[i], std::max(gap / 2, floor));
+        }
+    }
+}
+
+CordRoute CordRouter::route(const Point& start, const Point& end, int src, int dst) const {
+    CordRoute result;
+    const double margin = options_.margin;
+    auto own = [&](int id) { return id == src || id == dst; };
+
+    // How far the cord runs straight out of the outlet and into the inlet:
+    // the margin, or half the drop when the inlet is closer than two margins,
+    // and no more than the clearance of its own boxes.
+    const double drop = end.y - start.y;
+    double stub = drop >= 2 * margin || drop <= 2 * kMinClearance ? margin : drop / 2;
+    for (int id : {src, dst}) {
+        if (id >= 0 && static_cast<size_t>(id) < boxes_.size()) {
+            stub = std::min(stub, clearance_[id]);
+        }
+    }
+    const Point start_stub{start.x, start.y + stub};
+    const Point end_stub{end.x, end.y - stub};
+
+    // The cord's own boxes keep the stub's clearance, so the stubs start on
+    // their inflated outline.
+    auto obstacle = [&](int id) {
+        return inflate(boxes_[id], own(id) ? stub : clearance_[id]);
+    };
+    // Whether the segment a-b runs through any box (@p skip_own: but its own two)
+    auto blocked = [&](const Point& a, const Point& b, bool skip_own) {
+        for (int id : index_.query(bounding(a, b), -margin - 1.0)) {
+            if (!(skip_own && own(id)) && enters(a, b, obstacle(id))) {
+                return true;
+            }
+        }
+        return false;
+    };
+
+    // The stubs are fixed, so they must not run through any other box
+    if (blocked(start, start_stub, true) || blocked(end_stub, end, true)) {
+        return result;
+    }
+
+    const Rect everything = inflate(bounds_, margin);
+    size_t budget = kMaxExpansions;
+    for (double pad = kInitialPad; budget > 0; pad *= 2) {
+        const Rect window = inflate(bounding(start_stub, end_stub), pad);
+
+        std::vector<double> xs{start.x, end.x};
+        std::vector<double> ys{start_stub.y, end_stub.y};
+        for (int id : index_.query(window, -margin)) {
+            const Rect r = obstacle(id);
+            xs.push_back(r.origin.x);
+            xs.push_back(r.right());
+            ys.push_back(r.origin.y);
+            ys.push_back(r.bottom());
+        }
+        sort_unique(xs);
+        sort_unique(ys);
+
+        const RoutingGrid grid(std::move(xs), std::move(ys));
+        const std::vector<Point> nodes = grid.search(
+            grid.node_at(start_stub.x, start_stub.y), grid.node_at(end_stub.x, end_stub.y),
+            options_.bend_penalty, budget,
+            [&](const Point& a, const Point& b) { return blocked(a, b, false); });
+        if (!nodes.empty()) {
+            std::vector<Point> points{start};
+            for (Point p : nodes) {
+                // Undo the merging of lines within kEps of the nub lines
+                for (double x : {start.x, end.x}) {
+                    p.x = std::abs(p.x - x) <= kEps ? x : p.x;
+                }
+                for (double y : {start_stub.y, end_stub.y}) {
+                    p.y = std::abs(p.y - y) <= kEps ? y : p.y;
+                }
+                points.push_back(p);
+            }
+            points.push_back(end);
+            points = simplify(points);
+
+            result.ok = true;
+            result.midpoints.assign(points.begin() + 1, points.end() - 1);
+            for (size_t k = 1; k < points.size(); ++k) {
+                result.length += std::abs(points[k].x - points[k - 1].x) +
+                                 std::abs(points[k].y - points[k - 1].y);
+            }
+            return result;
+        }
+        if (covers(window, everything)) {
+            break;
+        }
+    }
+    return result;
+}
+
+}  // namespace geometry
@@ -0,0 +1,78 @@
+/**
+    @file cord_router.h
+    MaxMCP - Orthogonal patchcord routing around box rects, for route_cords
+
+    Computes patchline midpoints so a cord runs in horizontal and vertical
+    segments around the boxes instead of straight through them. A route leaves
+    the outlet going down and enters the inlet from above; its first and last
+    points are the nub centers the caller passes in (from io_positions()).
+
+    Each cord is routed on a sparse orthogonal visibility graph: the candidate
+    lines are the sides of the boxes near the cord, pushed out by a clearance,
+    plus the vertical through each nub and the horizontal just below the outlet
+    and just above the inlet. A* searches the crossings of those lines for the
+    path with the fewest bends, then the shortest, taking (position, heading)
+    as the state so every turn is charged. Grid edges are tested against a
+    GridIndex over all the boxes only when the search reaches them, and the
+    window of candidate lines starts around the two nubs and is widened until
+    a route is found.
+
+    Every box keeps the margin as clearance, except that two boxes closer than
+    twice the margin split the gap between them (down to 1 px), so the gaps
+    between tightly packed boxes stay open.
+
+    The per-cord cost and the share of cords that find a route on dense
+    layouts are measured by tests/bench/bench_cord_router.cpp.
+
+    @ingroup maxmcp
+*/
+
+#ifndef CORD_ROUTER_H
+#define CORD_ROUTER_H
+
+#include "geometry.h"
+#include "spatial_index.h"
+
+#include <vector>
+
+namespace geometry {
+
+struct CordRouterOptions {
+    double margin = 10.0;        ///< Clearance kept around boxes, in px
+    double bend_penalty = 60.0;  ///< Extra length a route may take to save one bend
+};
+
+/**
+ * @brief One routed cord. @c midpoints are the bend points between the
+ *        outlet and the inlet (empty for a straight vertical cord).
+ */
+struct CordRoute {
+    bool ok = false;  ///< false when no route exists (e.g. a nub inside another box)
+    std::vector<Point> midpoints;
+    double length = 0.0;
+};
+
+class CordRouter {
+  public:
+    /// Route around @p boxes (ids 0..n-1, as used by route()).
+    explicit CordRouter(std::vector<Rect> boxes, CordRouterOptions options = {});
+
+    /**
+     * @brief Route a cord from the outlet at @p start to the inlet at @p end.
+     *
+     * @p src and @p dst are the ids of the cord's own boxes (-1 if none); the
+     * route may touch them at its ends but keeps clear of every box otherwise.
+     */
+    CordRoute route(const Point& start, const Point& end, int src, int dst) const;
+
+  private:
+    std::vector<Rect> boxes_;
+    CordRouterOptions options_;
+    GridIndex index_;
+    std::vector<double> clearance_;  // per box: the margin, or half the gap to a closer box
+    Rect bounds_;  // of every box, to know when widening the window is useless
+};
+
+}  // namespace geometry
+
+#endif  // CORD_ROUTER_H
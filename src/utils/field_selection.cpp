@@ -0,0 +1,61 @@
+/**
+    @file field_selection.cpp
+    MaxMCP - "fields" projection parameter for listing tools
+
+    @ingroup maxmcp
+*/
+
+#include "field_selection.h"
+
+#include "tools/tool_common.h"
+
+#include <algorithm>
+
+namespace field_selection {
+
+bool FieldSelection::has(size_t index) const {
+    return std::find(builtins.begin(), builtins.end(), index) != builtins.end();
+}
+
+json parse_fields(const json& params, const std::vector<std::string>& builtin_names,
+                  std::optional<FieldSelection>& out) {
+    out.reset();
+    if (!params.contains("fields")) {
+        return nullptr;
+    }
+
+    const json& fields = params["fields"];
+    if (!fields.is_array() || fields.empty()) {
+        return ToolCommon::make_error(ToolCommon::ErrorCode::INVALID_PARAMS,
+                                      "fields must be a non-empty array of field names");
+    }
+    if (params.contains("mode")) {
+        return ToolCommon::make_error(ToolCommon::ErrorCode::INVALID_PARAMS,
+                                      "Pass either 'mode' or 'fields', not both");
+    }
+
+    FieldSelection selection;
+    for (const auto& field : fields) {
+        if (!field.is_string() || field.get<std::string>().empty()) {
+            return ToolCommon::make_error(ToolCommon::ErrorCode::INVALID_PARAMS,
+                                          "fields must contain only non-empty strings");
+        }
+        const std::string name = field.get<std::string>();
+
+        auto it = std::find(builtin_names.begin(), builtin_names.end(), name);
+        if (it != builtin_names.end()) {
+            size_t index = static_cast<size_t>(it - builtin_names.begin());
+            if (!selection.has(index)) {
+                selection.builtins.push_back(index);
+            }
+        } else if (std::find(selection.attributes.begin(), selection.attributes.end(), name) ==
+                   selection.attributes.end()) {
+            selection.attributes.push_back(name);
+        }
+    }
+
+    out = std::move(selection);
+    return nullptr;
+}
+
+}  // namespace field_selection
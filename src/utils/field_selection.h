@@ -0,0 +1,56 @@
+/**
+    @file field_selection.h
+    MaxMCP - "fields" projection parameter for listing tools
+
+    get_objects_in_patch and get_patchlines accept an optional "fields" array
+    naming exactly what each element should carry. A name is either one of the
+    tool's built-in fields (looked up in the caller's name table) or, failing
+    that, treated as a Max attribute to read from the box / patchline. Parsing
+    splits the request once, up front, so the main-thread loop only switches on
+    pre-resolved built-ins and iterates pre-resolved attribute names.
+
+    @ingroup maxmcp
+*/
+
+#ifndef FIELD_SELECTION_H
+#define FIELD_SELECTION_H
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+namespace field_selection {
+
+using json = nlohmann::json;
+
+/**
+ * @brief A parsed "fields" parameter.
+ *
+ * Both lists keep request order with duplicates removed.
+ */
+struct FieldSelection {
+    std::vector<size_t> builtins;         ///< Indexes into the caller's built-in name table
+    std::vector<std::string> attributes;  ///< Names to read as Max attributes
+
+    /// True if the built-in at @p index was requested.
+    bool has(size_t index) const;
+};
+
+/**
+ * @brief Parse the optional "fields" tool parameter.
+ *
+ * @param params Tool parameters
+ * @param builtin_names The tool's built-in field names (index = field id)
+ * @param out Receives the selection when "fields" is present, reset otherwise
+ * @return Error JSON if "fields" is not a non-empty array of non-empty strings,
+ *         or is combined with "mode"; nullptr otherwise
+ */
+json parse_fields(const json& params, const std::vector<std::string>& builtin_names,
+                  std::optional<FieldSelection>& out);
+
+}  // namespace field_selection
+
+#endif  // FIELD_SELECTION_H
@@ -0,0 +1,451 @@
+/**
+    @file geometry_batch.cpp
+    MaxMCP - Batch geometry predicates over struct-of-arrays rects and segments
+
+    Each predicate has a scalar kernel (also used for the tail of a range) and,
+    on x86, SSE2 and AVX2 kernels over 2 and 4 lanes. The vector kernels mirror
+    the scalar expressions operation for operation. Where the scalar code
+    branches, they use the comparison whose NaN behaviour matches the branch:
+    an ordered compare for "if (a < b)", an unordered negated compare for
+    "if (!(a < b))". std::max / std::min become a compare-and-select, not
+    max/min instructions, which differ for NaN and signed zeros.
+
+    @ingroup maxmcp
+*/
+
+#include "geometry_batch.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__x86_64__) || defined(_M_X64) || (defined(__i386__) && defined(__SSE2__))
+#define GEOMETRY_BATCH_X86 1
+#include <immintrin.h>
+#if defined(__GNUC__) || defined(__clang__)
+// Built for the baseline ISA; the AVX2 kernels are compiled for AVX2 on their
+// own and only called when the CPU reports it.
+#define GEOMETRY_BATCH_AVX2 1
+#define AVX2_TARGET __attribute__((target("avx2")))
+#elif defined(__AVX2__)
+#define GEOMETRY_BATCH_AVX2 1
+#define AVX2_TARGET
+#endif
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace geometry {
+
+// ============================================================================
+// Columns
+// ============================================================================
+
+RectSoA RectSoA::from(const std::vector<Rect>& rects) {
+    RectSoA soa;
+    soa.reserve(rects.size());
+    for (const Rect& r : rects) {
+        soa.push_back(r);
+    }
+    return soa;
+}
+
+void RectSoA::reserve(size_t n) {
+    x0.reserve(n);
+    y0.reserve(n);
+    x1.reserve(n);
+    y1.reserve(n);
+}
+
+void RectSoA::clear() {
+    x0.clear();
+    y0.clear();
+    x1.clear();
+    y1.clear();
+}
+
+void RectSoA::swap_remove(size_t i) {
+    for (std::vector<double>* column : {&x0, &y0, &x1, &y1}) {
+        (*column)[i] = column->back();
+        column->pop_back();
+    }
+}
+
+void SegmentSoA::reserve(size_t n) {
+    ax.reserve(n);
+    ay.reserve(n);
+    bx.reserve(n);
+    by.reserve(n);
+}
+
+void SegmentSoA::clear() {
+    ax.clear();
+    ay.clear();
+    bx.clear();
+    by.clear();
+}
+
+int lowest_bit(uint64_t word) {
+#if defined(_MSC_VER)
+    unsigned long index = 0;
+    _BitScanForward64(&index, word);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctzll(word);
+#endif
+}
+
+SimdLevel simd_level() {
+    static const SimdLevel level = [] {
+#if defined(GEOMETRY_BATCH_X86) && defined(GEOMETRY_BATCH_AVX2) && \
+    (defined(__GNUC__) || defined(__clang__))
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") ? SimdLevel::Avx2 : SimdLevel::Sse2;
+#elif defined(GEOMETRY_BATCH_AVX2)
+        return SimdLevel::Avx2;
+#elif defined(GEOMETRY_BATCH_X86)
+        return SimdLevel::Sse2;
+#else
+        return SimdLevel::Scalar;
+#endif
+    }();
+    return level;
+}
+
+const char* simd_level_name(SimdLevel level) {
+    switch (level) {
+    case SimdLevel::Avx2:
+        return "avx2";
+    case SimdLevel::Sse2:
+        return "sse2";
+    case SimdLevel::Scalar:
+        break;
+    }
+    return "scalar";
+}
+
+namespace {
+
+SimdLevel capped(SimdLevel level) {
+    return std::min(level, simd_level());
+}
+
+// ============================================================================
+// Scalar kernels (one item; also the tail of every vector kernel)
+// ============================================================================
+
+// aabb_overlap(r, rects[i], eps), with r's far edges and eps-shifted near edges
+// computed once per batch exactly as aabb_overlap computes them.
+struct OverlapQuery {
+    double x0, y0, x1, y1;  // r.origin.x, r.origin.y, r.right(), r.bottom()
+    double x0_eps, y0_eps;  // r.origin.x + eps, r.origin.y + eps
+    double eps;
+
+    OverlapQuery(const Rect& r, double e)
+        : x0(r.origin.x), y0(r.origin.y), x1(r.right()), y1(r.bottom()),
+          x0_eps(r.origin.x + e), y0_eps(r.origin.y + e), eps(e) {}
+
+    bool test(const RectSoA& b, size_t i) const {
+        return !(x1 <= b.x0[i] + eps || b.x1[i] <= x0_eps || y1 <= b.y0[i] + eps ||
+                 b.y1[i] <= y0_eps);
+    }
+};
+
+// segment_intersects_rect(s, rects[i], eps, nullptr). The clip directions p[k]
+// and the segment length depend on the segment only.
+struct SegmentQuery {
+    double ax, ay;
+    double p[4];
+    double length;
+    double eps;
+
+    SegmentQuery(const Segment& s, double e) : ax(s.a.x), ay(s.a.y), eps(e) {
+        const double dx = s.b.x - s.a.x;
+        const double dy = s.b.y - s.a.y;
+        p[0] = -dx;
+        p[1] = dx;
+        p[2] = -dy;
+        p[3] = dy;
+        length = std::hypot(dx, dy);
+    }
+
+    bool test(const RectSoA& r, size_t i) const {
+        const double q[4] = {ax - r.x0[i], r.x1[i] - ax, ay - r.y0[i], r.y1[i] - ay};
+        double u1 = 0.0;
+        double u2 = 1.0;
+        for (int k = 0; k < 4; ++k) {
+            if (p[k] == 0.0) {
+                if (q[k] < 0.0) {
+                    return false;
+                }
+                continue;
+            }
+            const double t = q[k] / p[k];
+            if (p[k] < 0.0) {
+                u1 = std::max(u1, t);
+            } else {
+                u2 = std::min(u2, t);
+            }
+        }
+        if (u1 > u2) {
+            return false;
+        }
+        return !(length * (u2 - u1) <= eps);
+    }
+};
+
+bool upward_test(const SegmentSoA& s, size_t i, double eps) {
+    return (s.ay[i] - s.by[i]) > eps;
+}
+
+// Items [from, n) of a batch starting at begin, one at a time.
+template <typename Test>
+void scalar_tail(size_t begin, size_t from, size_t n, uint64_t* out, Test test) {
+    for (size_t k = from; k < n; ++k) {
+        out[k >> 6] |= static_cast<uint64_t>(test(begin + k)) << (k & 63);
+    }
+}
+
+// ============================================================================
+// SSE2 kernels (2 lanes)
+// ============================================================================
+
+#if defined(GEOMETRY_BATCH_X86)
+
+// mask ? b : a
+inline __m128d select2(__m128d mask, __m128d a, __m128d b) {
+    return _mm_or_pd(_mm_and_pd(mask, b), _mm_andnot_pd(mask, a));
+}
+
+void overlap_sse2(const OverlapQuery& q, const RectSoA& b, size_t begin, size_t n,
+                  uint64_t* out) {
+    const __m128d x0_eps = _mm_set1_pd(q.x0_eps), y0_eps = _mm_set1_pd(q.y0_eps);
+    const __m128d x1 = _mm_set1_pd(q.x1), y1 = _mm_set1_pd(q.y1), eps = _mm_set1_pd(q.eps);
+    size_t k = 0;
+    for (; k + 2 <= n; k += 2) {
+        const size_t i = begin + k;
+        const __m128d apart = _mm_or_pd(
+            _mm_or_pd(_mm_cmple_pd(x1, _mm_add_pd(_mm_loadu_pd(&b.x0[i]), eps)),
+                      _mm_cmple_pd(_mm_loadu_pd(&b.x1[i]), x0_eps)),
+            _mm_or_pd(_mm_cmple_pd(y1, _mm_add_pd(_mm_loadu_pd(&b.y0[i]), eps)),
+                      _mm_cmple_pd(_mm_loadu_pd(&b.y1[i]), y0_eps)));
+        const uint64_t bits = ~static_cast<unsigned>(_mm_movemask_pd(apart)) & 0x3u;
+        out[k >> 6] |= bits << (k & 63);
+    }
+    scalar_tail(begin, k, n, out, [&](size_t i) { return q.test(b, i); });
+}
+
+void segment_sse2(const SegmentQuery& s, const RectSoA& r, size_t begin, size_t n,
+                  uint64_t* out) {
+    const __m128d ax = _mm_set1_pd(s.ax), ay = _mm_set1_pd(s.ay);
+    const __m128d zero = _mm_setzero_pd(), one = _mm_set1_pd(1.0);
+    const __m128d length = _mm_set1_pd(s.length), eps = _mm_set1_pd(s.eps);
+    size_t k = 0;
+    for (; k + 2 <= n; k += 2) {
+        const size_t i = begin + k;
+        const __m128d q[4] = {_mm_sub_pd(ax, _mm_loadu_pd(&r.x0[i])),
+                              _mm_sub_pd(_mm_loadu_pd(&r.x1[i]), ax),
+                              _mm_sub_pd(ay, _mm_loadu_pd(&r.y0[i])),
+                              _mm_sub_pd(_mm_loadu_pd(&r.y1[i]), ay)};
+        __m128d inside = _mm_cmpeq_pd(zero, zero);
+        __m128d u1 = zero, u2 = one;
+        for (int e = 0; e < 4; ++e) {
+            if (s.p[e] == 0.0) {
+                inside = _mm_and_pd(inside, _mm_cmpnlt_pd(q[e], zero));
+                continue;
+            }
+            const __m128d t = _mm_div_pd(q[e], _mm_set1_pd(s.p[e]));
+            if (s.p[e] < 0.0) {
+                u1 = select2(_mm_cmplt_pd(u1, t), u1, t);
+            } else {
+                u2 = select2(_mm_cmplt_pd(t, u2), u2, t);
+            }
+        }
+        const __m128d hit = _mm_and_pd(
+            inside, _mm_and_pd(_mm_cmpngt_pd(u1, u2),
+                               _mm_cmpnle_pd(_mm_mul_pd(length, _mm_sub_pd(u2, u1)), eps)));
+        out[k >> 6] |= static_cast<uint64_t>(_mm_movemask_pd(hit)) << (k & 63);
+    }
+    scalar_tail(begin, k, n, out, [&](size_t i) { return s.test(r, i); });
+}
+
+void upward_sse2(const SegmentSoA& s, size_t begin, size_t n, double e, uint64_t* out) {
+    const __m128d eps = _mm_set1_pd(e);
+    size_t k = 0;
+    for (; k + 2 <= n; k += 2) {
+        const size_t i = begin + k;
+        const __m128d rise = _mm_sub_pd(_mm_loadu_pd(&s.ay[i]), _mm_loadu_pd(&s.by[i]));
+        const __m128d up = _mm_cmpgt_pd(rise, eps);
+        out[k >> 6] |= static_cast<uint64_t>(_mm_movemask_pd(up)) << (k & 63);
+    }
+    scalar_tail(begin, k, n, out, [&](size_t i) { return upward_test(s, i, e); });
+}
+
+#endif  // GEOMETRY_BATCH_X86
+
+// ============================================================================
+// AVX2 kernels (4 lanes)
+// ============================================================================
+
+#if defined(GEOMETRY_BATCH_AVX2)
+
+AVX2_TARGET void overlap_avx2(const OverlapQuery& q, const RectSoA& b, size_t begin, size_t n,
+                              uint64_t* out) {
+    const __m256d x0_eps = _mm256_set1_pd(q.x0_eps), y0_eps = _mm256_set1_pd(q.y0_eps);
+    const __m256d x1 = _mm256_set1_pd(q.x1), y1 = _mm256_set1_pd(q.y1);
+    const __m256d eps = _mm256_set1_pd(q.eps);
+    size_t k = 0;
+    for (; k + 4 <= n; k += 4) {
+        const size_t i = begin + k;
+        const __m256d apart = _mm256_or_pd(
+            _mm256_or_pd(
+                _mm256_cmp_pd(x1, _mm256_add_pd(_mm256_loadu_pd(&b.x0[i]), eps), _CMP_LE_OQ),
+                _mm256_cmp_pd(_mm256_loadu_pd(&b.x1[i]), x0_eps, _CMP_LE_OQ)),
+            _mm256_or_pd(
+                _mm256_cmp_pd(y1, _mm256_add_pd(_mm256_loadu_pd(&b.y0[i]), eps), _CMP_LE_OQ),
+                _mm256_cmp_pd(_mm256_loadu_pd(&b.y1[i]), y0_eps, _CMP_LE_OQ)));
+        const uint64_t bits = ~static_cast<unsigned>(_mm256_movemask_pd(apart)) & 0xFu;
+        out[k >> 6] |= bits << (k & 63);
+    }
+    scalar_tail(begin, k, n, out, [&](size_t i) { return q.test(b, i); });
+}
+
+AVX2_TARGET void segment_avx2(const SegmentQuery& s, const RectSoA& r, size_t begin, size_t n,
+                              uint64_t* out) {
+    const __m256d ax = _mm256_set1_pd(s.ax), ay = _mm256_set1_pd(s.ay);
+    const __m256d zero = _mm256_setzero_pd(), one = _mm256_set1_pd(1.0);
+    const __m256d length = _mm256_set1_pd(s.length), eps = _mm256_set1_pd(s.eps);
+    size_t k = 0;
+    for (; k + 4 <= n; k += 4) {
+        const size_t i = begin + k;
+        const __m256d q[4] = {_mm256_sub_pd(ax, _mm256_loadu_pd(&r.x0[i])),
+                              _mm256_sub_pd(_mm256_loadu_pd(&r.x1[i]), ax),
+                              _mm256_sub_pd(ay, _mm256_loadu_pd(&r.y0[i])),
+                              _mm256_sub_pd(_mm256_loadu_pd(&r.y1[i]), ay)};
+        __m256d inside = _mm256_cmp_pd(zero, zero, _CMP_EQ_OQ);
+        __m256d u1 = zero, u2 = one;
+        for (int e = 0; e < 4; ++e) {
+            if (s.p[e] == 0.0) {
+                inside = _mm256_and_pd(inside, _mm256_cmp_pd(q[e], zero, _CMP_NLT_UQ));
+                continue;
+            }
+            const __m256d t = _mm256_div_pd(q[e], _mm256_set1_pd(s.p[e]));
+            if (s.p[e] < 0.0) {
+                u1 = _mm256_blendv_pd(u1, t, _mm256_cmp_pd(u1, t, _CMP_LT_OQ));
+            } else {
+                u2 = _mm256_blendv_pd(u2, t, _mm256_cmp_pd(t, u2, _CMP_LT_OQ));
+            }
+        }
+        const __m256d interior = _mm256_mul_pd(length, _mm256_sub_pd(u2, u1));
+        const __m256d hit =
+            _mm256_and_pd(inside, _mm256_and_pd(_mm256_cmp_pd(u1, u2, _CMP_NGT_UQ),
+                                                _mm256_cmp_pd(interior, eps, _CMP_NLE_UQ)));
+        out[k >> 6] |= static_cast<uint64_t>(_mm256_movemask_pd(hit)) << (k & 63);
+    }
+    scalar_tail(begin, k, n, out, [&](size_t i) { return s.test(r, i); });
+}
+
+AVX2_TARGET void upward_avx2(const SegmentSoA& s, size_t begin, size_t n, double e,
+                             uint64_t* out) {
+    const __m256d eps = _mm256_set1_pd(e);
+    size_t k = 0;
+    for (; k + 4 <= n; k += 4) {
+        const size_t i = begin + k;
+        const __m256d rise =
+            _mm256_sub_pd(_mm256_loadu_pd(&s.ay[i]), _mm256_loadu_pd(&s.by[i]));
+        const __m256d up = _mm256_cmp_pd(rise, eps, _CMP_GT_OQ);
+        out[k >> 6] |= static_cast<uint64_t>(_mm256_movemask_pd(up)) << (k & 63);
+    }
+    scalar_tail(begin, k, n, out, [&](size_t i) { return upward_test(s, i, e); });
+}
+
+#endif  // GEOMETRY_BATCH_AVX2
+
+}  // namespace
+
+// ============================================================================
+// Dispatch
+// ============================================================================
+
+void overlap_mask(const Rect& r, const RectSoA& rects, size_t begin, size_t end, double eps,
+                  uint64_t* out, SimdLevel level) {
+    const size_t n = end > begin ? end - begin : 0;
+    std::fill(out, out + mask_words(n), uint64_t{0});
+    const OverlapQuery query(r, eps);
+    switch (capped(level)) {
+#if defined(GEOMETRY_BATCH_AVX2)
+    case SimdLevel::Avx2:
+        overlap_avx2(query, rects, begin, n, out);
+        return;
+#endif
+#if defined(GEOMETRY_BATCH_X86)
+    case SimdLevel::Sse2:
+        overlap_sse2(query, rects, begin, n, out);
+        return;
+#endif
+    default:
+        scalar_tail(begin, 0, n, out, [&](size_t i) { return query.test(rects, i); });
+    }
+}
+
+void overlap_mask(const Rect& r, const RectSoA& rects, size_t begin, size_t end, double eps,
+                  BitMask& out, SimdLevel level) {
+    out.resize(mask_words(end > begin ? end - begin : 0));
+    overlap_mask(r, rects, begin, end, eps, out.data(), level);
+}
+
+void segment_rect_mask(const Segment& s, const RectSoA& rects, size_t begin, size_t end,
+                       double eps, uint64_t* out, SimdLevel level) {
+    const size_t n = end > begin ? end - begin : 0;
+    std::fill(out, out + mask_words(n), uint64_t{0});
+    const SegmentQuery query(s, eps);
+    switch (capped(level)) {
+#if defined(GEOMETRY_BATCH_AVX2)
+    case SimdLevel::Avx2:
+        segment_avx2(query, rects, begin, n, out);
+        return;
+#endif
+#if defined(GEOMETRY_BATCH_X86)
+    case SimdLevel::Sse2:
+        segment_sse2(query, rects, begin, n, out);
+        return;
+#endif
+    default:
+        scalar_tail(begin, 0, n, out, [&](size_t i) { return query.test(rects, i); });
+    }
+}
+
+void segment_rect_mask(const Segment& s, const RectSoA& rects, size_t begin, size_t end,
+                       double eps, BitMask& out, SimdLevel level) {
+    out.resize(mask_words(end > begin ? end - begin : 0));
+    segment_rect_mask(s, rects, begin, end, eps, out.data(), level);
+}
+
+void upward_mask(const SegmentSoA& segments, size_t begin, size_t end, double eps, uint64_t* out,
+                 SimdLevel level) {
+    const size_t n = end > begin ? end - begin : 0;
+    std::fill(out, out + mask_words(n), uint64_t{0});
+    switch (capped(level)) {
+#if defined(GEOMETRY_BATCH_AVX2)
+    case SimdLevel::Avx2:
+        upward_avx2(segments, begin, n, eps, out);
+        return;
+#endif
+#if defined(GEOMETRY_BATCH_X86)
+    case SimdLevel::Sse2:
+        upward_sse2(segments, begin, n, eps, out);
+        return;
+#endif
+    default:
+        scalar_tail(begin, 0, n, out, [&](size_t i) { return upward_test(segments, i, eps); });
+    }
+}
+
+void upward_mask(const SegmentSoA& segments, size_t begin, size_t end, double eps, BitMask& out,
+                 SimdLevel level) {
+    out.resize(mask_words(end > begin ? end - begin : 0));
+    upward_mask(segments, begin, end, eps, out.data(), level);
+}
+
+}  // namespace geometry
@@ -0,0 +1,149 @@
+/**
+    @file geometry_batch.h
+    MaxMCP - Batch geometry predicates over struct-of-arrays rects and segments
+
+    The predicates in geometry.h take one Rect or Segment at a time, and the
+    layout structs keep their rect next to strings. Here rects and segments are
+    stored as coordinate columns (RectSoA: x0, y0, x1, y1; SegmentSoA: ax, ay,
+    bx, by), and one rect or segment is tested against a whole range of them
+    at once, producing a bitmask. On x86 the kernels use SSE2, or AVX2 when the
+    CPU has it (checked at run time); elsewhere a scalar loop over the columns
+    runs instead.
+
+    Every kernel evaluates exactly the same floating-point expressions, in the
+    same order, as its scalar counterpart in geometry.cpp, so the masks agree
+    bit for bit with aabb_overlap, segment_intersects_rect and
+    segment_is_upward (NaN and signed-zero cases included). RectSoA stores
+    right()/bottom() as computed from the Rect, never recomputed from x1 - x0.
+
+    The unit tests compare every kernel level the CPU supports against the
+    scalar predicates on the same inputs, so a kernel that drifts fails there.
+
+    @ingroup maxmcp
+*/
+
+#ifndef GEOMETRY_BATCH_H
+#define GEOMETRY_BATCH_H
+
+#include "geometry.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace geometry {
+
+/**
+ * @brief Rects as coordinate columns: top-left (x0, y0), bottom-right (x1, y1).
+ */
+struct RectSoA {
+    std::vector<double> x0, y0, x1, y1;
+
+    static RectSoA from(const std::vector<Rect>& rects);
+
+    size_t size() const {
+        return x0.size();
+    }
+    bool empty() const {
+        return x0.empty();
+    }
+    void reserve(size_t n);
+    void clear();
+    void push_back(const Rect& r) {
+        x0.push_back(r.origin.x);
+        y0.push_back(r.origin.y);
+        x1.push_back(r.right());
+        y1.push_back(r.bottom());
+    }
+    /// Move the last rect into slot @p i and drop the last slot.
+    void swap_remove(size_t i);
+};
+
+/**
+ * @brief Segments as coordinate columns: start (ax, ay), end (bx, by).
+ */
+struct SegmentSoA {
+    std::vector<double> ax, ay, bx, by;
+
+    size_t size() const {
+        return ax.size();
+    }
+    void reserve(size_t n);
+    void clear();
+    void push_back(const Segment& s) {
+        ax.push_back(s.a.x);
+        ay.push_back(s.a.y);
+        bx.push_back(s.b.x);
+        by.push_back(s.b.y);
+    }
+};
+
+/// One bit per tested item: item begin + k is bit k % 64 of word k / 64.
+using BitMask = std::vector<uint64_t>;
+
+/// Words needed for a mask over @p count items.
+inline size_t mask_words(size_t count) {
+    return (count + 63) / 64;
+}
+
+/// Index of the lowest set bit of a non-zero @p word.
+int lowest_bit(uint64_t word);
+
+/// Call fn(k) for every set bit k of @p words, ascending.
+template <typename Fn>
+void for_each_set_bit(const uint64_t* words, size_t word_count, Fn fn) {
+    for (size_t w = 0; w < word_count; ++w) {
+        for (uint64_t bits = words[w]; bits != 0; bits &= bits - 1) {
+            fn(w * 64 + static_cast<size_t>(lowest_bit(bits)));
+        }
+    }
+}
+
+template <typename Fn>
+void for_each_set_bit(const BitMask& mask, Fn fn) {
+    for_each_set_bit(mask.data(), mask.size(), fn);
+}
+
+/// Instruction sets the kernels can use, in increasing order.
+enum class SimdLevel { Scalar, Sse2, Avx2 };
+
+/// The best level this CPU supports (detected once).
+SimdLevel simd_level();
+
+/// "scalar", "sse2" or "avx2".
+const char* simd_level_name(SimdLevel level);
+
+// Each kernel tests items [begin, end) and writes mask_words(end - begin) words
+// to @p out. @p level is capped at simd_level(); pass a lower one to force a
+// narrower kernel (tests, benchmarks).
+
+/**
+ * @brief aabb_overlap(@p r, rects[i], @p eps) for i in [begin, end).
+ */
+void overlap_mask(const Rect& r, const RectSoA& rects, size_t begin, size_t end, double eps,
+                  uint64_t* out, SimdLevel level = simd_level());
+void overlap_mask(const Rect& r, const RectSoA& rects, size_t begin, size_t end, double eps,
+                  BitMask& out, SimdLevel level = simd_level());
+
+/**
+ * @brief segment_intersects_rect(@p s, rects[i], @p eps, nullptr) for i in
+ *        [begin, end).
+ *
+ * Callers that need the entry point call the scalar function for the hits.
+ */
+void segment_rect_mask(const Segment& s, const RectSoA& rects, size_t begin, size_t end,
+                       double eps, uint64_t* out, SimdLevel level = simd_level());
+void segment_rect_mask(const Segment& s, const RectSoA& rects, size_t begin, size_t end,
+                       double eps, BitMask& out, SimdLevel level = simd_level());
+
+/**
+ * @brief segment_is_upward(segments[i], @p eps) for i in [begin, end).
+ */
+void upward_mask(const SegmentSoA& segments, size_t begin, size_t end, double eps, uint64_t* out,
+                 SimdLevel level = simd_level());
+void upward_mask(const SegmentSoA& segments, size_t begin, size_t end, double eps, BitMask& out,
+                 SimdLevel level = simd_level());
+
+}  // namespace geometry
+
+#endif  // GEOMETRY_BATCH_H
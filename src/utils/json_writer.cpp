@@ -0,0 +1,183 @@
+/**
+    @file json_writer.cpp
+    MaxMCP - Streaming JSON text writer
+
+    @ingroup maxmcp
+*/
+
+#include "json_writer.h"
+
+#include <clocale>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace jsonwriter {
+
+void append_string(std::string& out, const std::string& value) {
+    static const char* kHex = "0123456789abcdef";
+
+    out.push_back('"');
+    for (char ch : value) {
+        unsigned char c = static_cast<unsigned char>(ch);
+        switch (c) {
+        case '"':
+            out += "\\\"";
+            break;
+        case '\\':
+            out += "\\\\";
+            break;
+        case '\n':
+            out += "\\n";
+            break;
+        case '\r':
+            out += "\\r";
+            break;
+        case '\t':
+            out += "\\t";
+            break;
+        case '\b':
+            out += "\\b";
+            break;
+        case '\f':
+            out += "\\f";
+            break;
+        default:
+            if (c < 0x20) {
+                out += "\\u00";
+                out.push_back(kHex[c >> 4]);
+                out.push_back(kHex[c & 0xf]);
+            } else {
+                // UTF-8 multi-byte sequences pass through unchanged.
+                out.push_back(ch);
+            }
+        }
+    }
+    out.push_back('"');
+}
+
+void append_number(std::string& out, double value) {
+    if (!std::isfinite(value)) {
+        out += "null";
+        return;
+    }
+
+    char buf[32];
+    // Integral values in the exactly-representable range print without a fraction.
+    if (std::fabs(value) < 9007199254740992.0 && value == std::floor(value)) {
+        std::snprintf(buf, sizeof(buf), "%lld", static_cast<long long>(value));
+        out += buf;
+        return;
+    }
+
+    // Shortest of %.15g / %.17g that reads back to the same double, so typical
+    // coordinates (100.5, 0.25) stay short while nothing loses precision.
+    std::snprintf(buf, sizeof(buf), "%.15g", value);
+    if (std::strtod(buf, nullptr) != value) {
+        std::snprintf(buf, sizeof(buf), "%.17g", value);
+    }
+
+    // snprintf and strtod both follow LC_NUMERIC, so the round trip above holds
+    // in any locale, but the host may use ',' as its decimal separator. Swap
+    // the locale's separator back to '.' (as nlohmann::json does).
+    const char* point = std::localeconv()->decimal_point;
+    if (point[0] != '\0' && std::strcmp(point, ".") != 0) {
+        if (char* at = std::strstr(buf, point)) {
+            size_t len = std::strlen(point);
+            *at = '.';
+            std::memmove(at + 1, at + len, std::strlen(at + len) + 1);
+        }
+    }
+    out += buf;
+}
+
+JsonWriter::JsonWriter(size_t reserve_bytes) {
+    out_.reserve(reserve_bytes);
+}
+
+void JsonWriter::before_value() {
+    if (after_key_) {
+        after_key_ = false;
+        return;
+    }
+    if (!first_in_scope_.empty()) {
+        if (!first_in_scope_.back()) {
+            out_.push_back(',');
+        }
+        first_in_scope_.back() = false;
+    }
+}
+
+void JsonWriter::begin_object() {
+    before_value();
+    out_.push_back('{');
+    first_in_scope_.push_back(true);
+}
+
+void JsonWriter::end_object() {
+    first_in_scope_.pop_back();
+    out_.push_back('}');
+}
+
+void JsonWriter::begin_array() {
+    before_value();
+    out_.push_back('[');
+    first_in_scope_.push_back(true);
+}
+
+void JsonWriter::end_array() {
+    first_in_scope_.pop_back();
+    out_.push_back(']');
+}
+
+void JsonWriter::key(const std::string& name) {
+    before_value();
+    append_string(out_, name);
+    out_.push_back(':');
+    after_key_ = true;
+}
+
+void JsonWriter::string(const std::string& value) {
+    before_value();
+    append_string(out_, value);
+}
+
+void JsonWriter::number(double value) {
+    before_value();
+    append_number(out_, value);
+}
+
+void JsonWriter::integer(long long value) {
+    before_value();
+    out_ += std::to_string(value);
+}
+
+void JsonWriter::boolean(bool value) {
+    before_value();
+    out_ += value ? "true" : "false";
+}
+
+void JsonWriter::null() {
+    before_value();
+    out_ += "null";
+}
+
+void JsonWriter::value(const nlohmann::json& value) {
+    before_value();
+    out_ += value.dump();
+}
+
+void JsonWriter::raw_array(const std::string& body) {
+    before_value();
+    out_.push_back('[');
+    out_ += body;
+    out_.push_back(']');
+}
+
+void JsonWriter::raw_value(const std::string& text) {
+    before_value();
+    out_ += text;
+}
+
+}  // namespace jsonwriter
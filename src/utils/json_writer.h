@@ -0,0 +1,85 @@
+/**
+    @file json_writer.h
+    MaxMCP - Streaming JSON text writer
+
+    Appends JSON tokens straight into a std::string, tracking commas and
+    nesting itself, so large responses can be produced without first building
+    an nlohmann::json DOM. Used by the columnar listing encoding; output is
+    plain RFC 8259 JSON that nlohmann (or any client) parses back.
+
+    Numbers are written in their shortest round-trip form (integral values
+    without a trailing ".0"); NaN and infinities become null, as JSON has no
+    spelling for them.
+
+    @ingroup maxmcp
+*/
+
+#ifndef JSON_WRITER_H
+#define JSON_WRITER_H
+
+#include <string>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+namespace jsonwriter {
+
+/**
+ * @brief Append @p value to @p out as a quoted, escaped JSON string.
+ */
+void append_string(std::string& out, const std::string& value);
+
+/**
+ * @brief Append @p value to @p out as a JSON number (shortest round-trip form).
+ *
+ * Always uses '.' as the decimal separator, whatever LC_NUMERIC is set to.
+ */
+void append_number(std::string& out, double value);
+
+/**
+ * @brief Incremental JSON writer.
+ *
+ * Call key() before each value inside an object. Misuse (unbalanced
+ * begin/end, key() outside an object) is a programming error and is not
+ * diagnosed.
+ */
+class JsonWriter {
+  public:
+    explicit JsonWriter(size_t reserve_bytes = 0);
+
+    void begin_object();
+    void end_object();
+    void begin_array();
+    void end_array();
+    void key(const std::string& name);
+
+    void string(const std::string& value);
+    void number(double value);
+    void integer(long long value);
+    void boolean(bool value);
+    void null();
+    /// Write an existing nlohmann value verbatim (compact dump).
+    void value(const nlohmann::json& value);
+    /// Write an array whose comma-separated, already-serialized body is @p body.
+    void raw_array(const std::string& body);
+    /// Write an already-serialized JSON value verbatim.
+    void raw_value(const std::string& text);
+
+    const std::string& str() const {
+        return out_;
+    }
+    std::string take() {
+        return std::move(out_);
+    }
+
+  private:
+    void before_value();
+
+    std::string out_;
+    std::vector<bool> first_in_scope_;
+    bool after_key_ = false;
+};
+
+}  // namespace jsonwriter
+
+#endif  // JSON_WRITER_H
@@ -0,0 +1,390 @@
+/**
+    @file maxpat.cpp
+    MaxMCP - .maxpat snapshot model, serializer, export store and fragment parser
+
+    @ingroup maxmcp
+*/
+
+#include "maxpat.h"
+
+#include "tools/tool_common.h"
+
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+
+namespace maxpat {
+
+namespace {
+
+// Keys write_box() emits itself; attributes with these names are skipped.
+const std::unordered_set<std::string> kStructuralKeys = {
+    "id", "maxclass", "text", "numinlets", "numoutlets", "patcher",
+};
+
+void write_atom(const AtomValue& atom, jsonwriter::JsonWriter& w) {
+    switch (atom.type) {
+    case AtomValue::Type::Long:
+        w.integer(static_cast<long long>(atom.number));
+        break;
+    case AtomValue::Type::Float:
+        w.number(atom.number);
+        break;
+    case AtomValue::Type::Symbol:
+        w.string(atom.symbol);
+        break;
+    }
+}
+
+void write_patcher(const PatcherSnapshot& snapshot, jsonwriter::JsonWriter& w);
+
+void write_box(const BoxSnapshot& box, size_t index, jsonwriter::JsonWriter& w) {
+    w.begin_object();
+    w.key("box");
+    w.begin_object();
+    w.key("id");
+    w.string(box_id(index));
+    w.key("maxclass");
+    w.string(box.maxclass);
+    w.key("numinlets");
+    w.integer(box.numinlets);
+    w.key("numoutlets");
+    w.integer(box.numoutlets);
+    if (!box.text.empty()) {
+        w.key("text");
+        w.string(box.text);
+    }
+    for (const auto& attr : box.attributes) {
+        if (attr.values.empty() || kStructuralKeys.count(attr.name)) {
+            continue;
+        }
+        w.key(attr.name);
+        if (attr.values.size() == 1) {
+            write_atom(attr.values.front(), w);
+        } else {
+            w.begin_array();
+            for (const auto& atom : attr.values) {
+                write_atom(atom, w);
+            }
+            w.end_array();
+        }
+    }
+    if (box.subpatcher) {
+        w.key("patcher");
+        write_patcher(*box.subpatcher, w);
+    }
+    w.end_object();
+    w.end_object();
+}
+
+void write_line(const LineSnapshot& line, jsonwriter::JsonWriter& w) {
+    w.begin_object();
+    w.key("patchline");
+    w.begin_object();
+    w.key("source");
+    w.begin_array();
+    w.string(box_id(line.source));
+    w.integer(line.outlet);
+    w.end_array();
+    w.key("destination");
+    w.begin_array();
+    w.string(box_id(line.destination));
+    w.integer(line.inlet);
+    w.end_array();
+    if (line.hidden) {
+        w.key("hidden");
+        w.integer(1);
+    }
+    if (!line.midpoints.empty()) {
+        w.key("midpoints");
+        w.begin_array();
+        for (double v : line.midpoints) {
+            w.number(v);
+        }
+        w.end_array();
+    }
+    w.end_object();
+    w.end_object();
+}
+
+void write_patcher(const PatcherSnapshot& snapshot, jsonwriter::JsonWriter& w) {
+    w.begin_object();
+    w.key("fileversion");
+    w.integer(1);
+    w.key("boxes");
+    w.begin_array();
+    for (size_t i = 0; i < snapshot.boxes.size(); ++i) {
+        write_box(snapshot.boxes[i], i, w);
+    }
+    w.end_array();
+    w.key("lines");
+    w.begin_array();
+    for (const auto& line : snapshot.lines) {
+        write_line(line, w);
+    }
+    w.end_array();
+    w.end_object();
+}
+
+bool is_utf8_continuation(unsigned char c) {
+    return (c & 0xC0) == 0x80;
+}
+
+// Keys an imported box never passes on as attributes: handled explicitly
+// (id, maxclass, text, varname, patching_rect) or recomputed by Max.
+const std::unordered_set<std::string> kFragmentSkippedKeys = {
+    "id",         "maxclass",  "text",      "varname",  "patching_rect",
+    "numinlets",  "numoutlets", "outlettype", "inlettype", "patcher",
+};
+
+// [x, y, width, height]
+bool is_rect(const nlohmann::json& value) {
+    return value.is_array() && value.size() == 4 &&
+           std::all_of(value.begin(), value.end(),
+                       [](const nlohmann::json& v) { return v.is_number(); });
+}
+
+// "presentation": 1 / true
+bool is_enabled(const nlohmann::json& value) {
+    return value.is_boolean() ? value.get<bool>() : value.is_number() && value != 0;
+}
+
+nlohmann::json fragment_error(const std::string& message) {
+    return ToolCommon::make_error(ToolCommon::ErrorCode::INVALID_PARAMS, message);
+}
+
+// Unwrap {"box": {...}} / {"patchline": {...}}; bare objects pass through
+const nlohmann::json& unwrap(const nlohmann::json& entry, const char* key) {
+    auto it = entry.find(key);
+    return (it != entry.end() && it->is_object()) ? *it : entry;
+}
+
+// Parse ["obj-1", 0] into a box index and port
+bool parse_endpoint(const nlohmann::json& value,
+                    const std::unordered_map<std::string, size_t>& index_of, size_t& index,
+                    long& port) {
+    if (!value.is_array() || value.size() != 2 || !value[0].is_string() ||
+        !value[1].is_number_integer() || value[1].get<long>() < 0) {
+        return false;
+    }
+    auto it = index_of.find(value[0].get<std::string>());
+    if (it == index_of.end()) {
+        return false;
+    }
+    index = it->second;
+    port = value[1].get<long>();
+    return true;
+}
+
+}  // namespace
+
+std::string box_id(size_t index) {
+    return "obj-" + std::to_string(index + 1);
+}
+
+void write_document(const PatcherSnapshot& snapshot, jsonwriter::JsonWriter& writer) {
+    writer.begin_object();
+    writer.key("patcher");
+    write_patcher(snapshot, writer);
+    writer.end_object();
+}
+
+std::string to_maxpat(const PatcherSnapshot& snapshot) {
+    // Rough per-element sizes keep reallocation down for large patches
+    jsonwriter::JsonWriter writer(256 * snapshot.boxes.size() + 96 * snapshot.lines.size() + 64);
+    write_document(snapshot, writer);
+    return writer.take();
+}
+
+std::vector<std::string> split_chunks(const std::string& text, size_t max_bytes) {
+    // A UTF-8 sequence is at most 4 bytes, so backing off never empties a chunk
+    max_bytes = std::max<size_t>(max_bytes, 4);
+
+    std::vector<std::string> chunks;
+    size_t begin = 0;
+    while (begin < text.size()) {
+        size_t end = std::min(begin + max_bytes, text.size());
+        while (end < text.size() && end > begin &&
+               is_utf8_continuation(static_cast<unsigned char>(text[end]))) {
+            --end;
+        }
+        chunks.push_back(text.substr(begin, end - begin));
+        begin = end;
+    }
+    return chunks;
+}
+
+// ============================================================================
+// Fragment import
+// ============================================================================
+
+nlohmann::json parse_fragment(const nlohmann::json& boxes, const nlohmann::json& lines, double dx,
+                              double dy, Fragment& out) {
+    if (!boxes.is_array() || boxes.empty()) {
+        return fragment_error("boxes must be a non-empty array");
+    }
+    if (!lines.is_null() && !lines.is_array()) {
+        return fragment_error("lines must be an array");
+    }
+
+    std::unordered_map<std::string, size_t> index_of;
+    out.boxes.clear();
+    out.boxes.reserve(boxes.size());
+    for (size_t i = 0; i < boxes.size(); ++i) {
+        const std::string where = "boxes[" + std::to_string(i) + "]";
+        if (!boxes[i].is_object()) {
+            return fragment_error(where + " must be an object");
+        }
+        const nlohmann::json& src = unwrap(boxes[i], "box");
+
+        FragmentBox box;
+        if (!src.contains("id") || !src["id"].is_string() || src["id"].get<std::string>().empty()) {
+            return fragment_error(where + " needs a string 'id'");
+        }
+        box.id = src["id"].get<std::string>();
+        if (!src.contains("maxclass") || !src["maxclass"].is_string() ||
+            src["maxclass"].get<std::string>().empty()) {
+            return fragment_error(where + " needs a string 'maxclass'");
+        }
+        box.maxclass = src["maxclass"].get<std::string>();
+        if (src.contains("text") && src["text"].is_string()) {
+            box.text = src["text"].get<std::string>();
+        }
+        if (box.maxclass == "newobj" && box.text.empty()) {
+            return fragment_error(where + " is a newobj without 'text'");
+        }
+        if (src.contains("varname") && src["varname"].is_string()) {
+            box.varname = src["varname"].get<std::string>();
+        }
+        if (src.contains("patching_rect")) {
+            const nlohmann::json& rect = src["patching_rect"];
+            if (!is_rect(rect)) {
+                return fragment_error(where + ".patching_rect must be [x, y, width, height]");
+            }
+            box.has_rect = true;
+            box.rect = {rect[0].get<double>() + dx, rect[1].get<double>() + dy,
+                        rect[2].get<double>(), rect[3].get<double>()};
+        }
+        for (const auto& [key, value] : src.items()) {
+            if (!kFragmentSkippedKeys.count(key)) {
+                box.attributes[key] = value;
+            }
+        }
+        // A presentation box moves with the fragment in presentation mode too
+        auto presentation = box.attributes.find("presentation");
+        auto prect = box.attributes.find("presentation_rect");
+        if (presentation != box.attributes.end() && is_enabled(*presentation) &&
+            prect != box.attributes.end() && is_rect(*prect)) {
+            (*prect)[0] = (*prect)[0].get<double>() + dx;
+            (*prect)[1] = (*prect)[1].get<double>() + dy;
+        }
+
+        if (!index_of.emplace(box.id, i).second) {
+            return fragment_error("Duplicate box id: " + box.id);
+        }
+        out.boxes.push_back(std::move(box));
+    }
+
+    out.lines.clear();
+    if (lines.is_null()) {
+        return nullptr;
+    }
+    out.lines.reserve(lines.size());
+    for (size_t i = 0; i < lines.size(); ++i) {
+        const std::string where = "lines[" + std::to_string(i) + "]";
+        if (!lines[i].is_object()) {
+            return fragment_error(where + " must be an object");
+        }
+        const nlohmann::json& src = unwrap(lines[i], "patchline");
+
+        FragmentLine line;
+        if (!src.contains("source") ||
+            !parse_endpoint(src["source"], index_of, line.source, line.outlet)) {
+            return fragment_error(where + ".source must be [box id, outlet] naming a fragment box");
+        }
+        if (!src.contains("destination") ||
+            !parse_endpoint(src["destination"], index_of, line.destination, line.inlet)) {
+            return fragment_error(where +
+                                  ".destination must be [box id, inlet] naming a fragment box");
+        }
+        if (src.contains("hidden")) {
+            const nlohmann::json& hidden = src["hidden"];
+            line.hidden = hidden.is_boolean() ? hidden.get<bool>()
+                                              : (hidden.is_number() && hidden.get<double>() != 0);
+        }
+        if (src.contains("midpoints")) {
+            const nlohmann::json& mids = src["midpoints"];
+            if (!mids.is_array() || mids.size() % 2 != 0 ||
+                !std::all_of(mids.begin(), mids.end(),
+                             [](const nlohmann::json& v) { return v.is_number(); })) {
+                return fragment_error(where + ".midpoints must be a flat [x1, y1, ...] array");
+            }
+            line.midpoints.reserve(mids.size());
+            for (size_t k = 0; k < mids.size(); ++k) {
+                line.midpoints.push_back(mids[k].get<double>() + (k % 2 == 0 ? dx : dy));
+            }
+        }
+        out.lines.push_back(std::move(line));
+    }
+    return nullptr;
+}
+
+std::vector<std::string> assign_fragment_varnames(const Fragment& fragment,
+                                                  std::unordered_set<std::string>& taken) {
+    std::vector<std::string> names;
+    names.reserve(fragment.boxes.size());
+    for (const auto& box : fragment.boxes) {
+        const std::string& base = box.varname.empty() ? box.id : box.varname;
+        std::string name = base;
+        for (int suffix = 2; taken.count(name); ++suffix) {
+            name = base + "_" + std::to_string(suffix);
+        }
+        taken.insert(name);
+        names.push_back(std::move(name));
+    }
+    return names;
+}
+
+// ============================================================================
+// ExportStore
+// ============================================================================
+
+ExportStore::ExportStore(size_t capacity) : capacity_(std::max<size_t>(capacity, 1)) {}
+
+std::string ExportStore::put(std::vector<std::string> chunks) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::string id = "export-" + std::to_string(next_id_++);
+    if (entries_.size() >= capacity_) {
+        entries_.pop_front();
+    }
+    entries_.push_back({id, std::move(chunks)});
+    return id;
+}
+
+bool ExportStore::fetch(const std::string& id, size_t index, std::string& chunk,
+                        size_t& chunk_count) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = std::find_if(entries_.begin(), entries_.end(),
+                           [&id](const Entry& entry) { return entry.id == id; });
+    if (it == entries_.end() || index >= it->chunks.size()) {
+        return false;
+    }
+
+    chunk_count = it->chunks.size();
+    if (index + 1 == chunk_count) {
+        // Last chunk: hand it over and free the export
+        chunk = std::move(it->chunks[index]);
+        entries_.erase(it);
+    } else {
+        chunk = it->chunks[index];
+    }
+    return true;
+}
+
+size_t ExportStore::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.size();
+}
+
+}  // namespace maxpat
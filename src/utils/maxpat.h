@@ -0,0 +1,220 @@
+/**
+    @file maxpat.h
+    MaxMCP - .maxpat snapshot model, serializer, export store and fragment parser
+
+    export_patch splits its work in two: a compact capture of the patcher on
+    the Max main thread (PatcherSnapshot: plain strings and numbers, no Max
+    types), then serialization to .maxpat JSON on the tool executor thread.
+    Large documents are split into UTF-8-safe chunks and parked in an
+    ExportStore so the client can fetch the remainder chunk by chunk.
+
+    import_patch_fragment goes the other way: parse_fragment() validates boxes
+    and lines given in the same form and resolves line endpoints to box
+    indices off the main thread, so the deferred callback only creates.
+
+    Document shape (the subset of the Max file format export_patch writes):
+
+        {"patcher": {"fileversion": 1,
+                     "boxes": [{"box": {"id": "obj-1", "maxclass": "newobj",
+                                        "numinlets": 2, "numoutlets": 1,
+                                        "text": "cycle~ 440",
+                                        "patching_rect": [..], ..}}],
+                     "lines": [{"patchline": {"source": ["obj-1", 0],
+                                              "destination": ["obj-2", 0]}}]}}
+
+    @ingroup maxmcp
+*/
+
+#ifndef MAXPAT_H
+#define MAXPAT_H
+
+#include "json_writer.h"
+
+#include <array>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+namespace maxpat {
+
+/**
+ * @brief One captured atom (A_LONG, A_FLOAT or A_SYM).
+ */
+struct AtomValue {
+    enum class Type { Long, Float, Symbol };
+    Type type = Type::Long;
+    double number = 0.0;
+    std::string symbol;
+};
+
+/**
+ * @brief A saveable box attribute. One value is written as a scalar, several
+ * as an array (matching how Max itself saves e.g. varname vs patching_rect).
+ */
+struct BoxAttribute {
+    std::string name;
+    std::vector<AtomValue> values;
+};
+
+struct PatcherSnapshot;
+
+struct BoxSnapshot {
+    std::string maxclass;
+    std::string text;  ///< Written only when non-empty
+    long numinlets = 0;
+    long numoutlets = 0;
+    std::vector<BoxAttribute> attributes;
+    std::unique_ptr<PatcherSnapshot> subpatcher;  ///< Embedded patcher, if captured
+};
+
+/**
+ * @brief A patchline; source/destination are indices into the owning
+ * PatcherSnapshot::boxes.
+ */
+struct LineSnapshot {
+    size_t source = 0;
+    long outlet = 0;
+    size_t destination = 0;
+    long inlet = 0;
+    bool hidden = false;
+    std::vector<double> midpoints;  ///< flat [x1, y1, x2, y2, ...]
+};
+
+struct PatcherSnapshot {
+    std::vector<BoxSnapshot> boxes;
+    std::vector<LineSnapshot> lines;
+};
+
+/**
+ * @brief Box id used in the document: "obj-<index + 1>", as Max numbers them.
+ */
+std::string box_id(size_t index);
+
+/**
+ * @brief Write {"patcher": {...}} as the next value of @p writer.
+ *
+ * Attributes named like a structural key (id, maxclass, text, numinlets,
+ * numoutlets, patcher) are skipped so they cannot shadow it.
+ */
+void write_document(const PatcherSnapshot& snapshot, jsonwriter::JsonWriter& writer);
+
+/**
+ * @brief Serialize @p snapshot as a standalone .maxpat document.
+ */
+std::string to_maxpat(const PatcherSnapshot& snapshot);
+
+/**
+ * @brief Split @p text into pieces of at most @p max_bytes bytes.
+ *
+ * Boundaries never fall inside a UTF-8 multi-byte sequence, so every piece is
+ * valid UTF-8 on its own and can travel as a JSON string. Concatenating the
+ * pieces restores @p text. @p max_bytes below 4 is treated as 4.
+ */
+std::vector<std::string> split_chunks(const std::string& text, size_t max_bytes);
+
+/**
+ * @brief Holds the chunks of recent exports until the client has fetched them.
+ *
+ * Bounded: once @c capacity exports are parked, storing another evicts the
+ * oldest. An export is dropped as soon as its last chunk is fetched.
+ * Thread-safe.
+ */
+class ExportStore {
+  public:
+    explicit ExportStore(size_t capacity = 8);
+
+    /// Park @p chunks and return the export id that fetch() expects.
+    std::string put(std::vector<std::string> chunks);
+
+    /**
+     * @brief Copy chunk @p index of export @p id into @p chunk.
+     * @param chunk_count Receives the export's chunk count on success
+     * @return false if the export is unknown/expired or @p index is out of range
+     */
+    bool fetch(const std::string& id, size_t index, std::string& chunk, size_t& chunk_count);
+
+    size_t size() const;
+
+  private:
+    struct Entry {
+        std::string id;
+        std::vector<std::string> chunks;
+    };
+
+    mutable std::mutex mutex_;
+    std::deque<Entry> entries_;
+    size_t capacity_;
+    unsigned long long next_id_ = 1;
+};
+
+// ============================================================================
+// Fragment import
+// ============================================================================
+
+/**
+ * @brief A box to create, parsed from {"box": {...}} (or a bare box object).
+ */
+struct FragmentBox {
+    std::string id;
+    std::string maxclass;
+    std::string text;
+    std::string varname;  ///< Source varname, "" if none
+    bool has_rect = false;
+    std::array<double, 4> rect{};  ///< patching_rect with the offset applied
+    nlohmann::json attributes = nlohmann::json::object();  ///< All other keys, verbatim
+};
+
+/**
+ * @brief A line to create; source/destination index Fragment::boxes.
+ */
+struct FragmentLine {
+    size_t source = 0;
+    long outlet = 0;
+    size_t destination = 0;
+    long inlet = 0;
+    bool hidden = false;
+    std::vector<double> midpoints;  ///< flat [x1, y1, ...], offset applied
+};
+
+struct Fragment {
+    std::vector<FragmentBox> boxes;
+    std::vector<FragmentLine> lines;
+};
+
+/**
+ * @brief Validate and parse a .maxpat fragment.
+ *
+ * @p boxes must be a non-empty array; @p lines may be null. Every box needs a
+ * unique string "id" and a "maxclass" (newobj boxes also need "text"); every
+ * line must reference ids from @p boxes. patching_rect origins, line
+ * midpoints and the presentation_rect origins of presentation boxes
+ * (presentation = 1) are shifted by (@p dx, @p dy). Derived keys (numinlets,
+ * numoutlets, outlettype, ...) are dropped; embedded "patcher" contents are
+ * not imported.
+ *
+ * @return nullptr on success, otherwise a ToolCommon error object
+ */
+nlohmann::json parse_fragment(const nlohmann::json& boxes, const nlohmann::json& lines, double dx,
+                              double dy, Fragment& out);
+
+/**
+ * @brief Choose a collision-free varname for every fragment box.
+ *
+ * A box keeps its source varname (or, if unnamed, its source id) when that is
+ * free; otherwise "_2", "_3", ... is appended. Chosen names are added to
+ * @p taken, which should start as the varnames already in the patch.
+ *
+ * @return One varname per box, in fragment order
+ */
+std::vector<std::string> assign_fragment_varnames(const Fragment& fragment,
+                                                  std::unordered_set<std::string>& taken);
+
+}  // namespace maxpat
+
+#endif  // MAXPAT_H
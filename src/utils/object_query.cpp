@@ -0,0 +1,290 @@
+/**
+    @file object_query.cpp
+    MaxMCP - Predicate language for query_objects
+
+    @ingroup maxmcp
+*/
+
+#include "object_query.h"
+
+#include "tools/tool_common.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace object_query {
+
+namespace {
+
+// Tolerance for numeric ==, so values that went through float atoms still match
+constexpr double kNumericEps = 1e-9;
+
+json invalid(const std::string& message) {
+    return ToolCommon::make_error(ToolCommon::ErrorCode::INVALID_PARAMS, message);
+}
+
+bool is_non_empty_string(const json& value) {
+    return value.is_string() && !value.get_ref<const std::string&>().empty();
+}
+
+bool equal_values(const json& a, const json& b) {
+    if (a.is_number() && b.is_number()) {
+        return std::fabs(a.get<double>() - b.get<double>()) <= kNumericEps;
+    }
+    if (a.is_array() && b.is_array()) {
+        if (a.size() != b.size()) {
+            return false;
+        }
+        for (size_t i = 0; i < a.size(); ++i) {
+            if (!equal_values(a[i], b[i])) {
+                return false;
+            }
+        }
+        return true;
+    }
+    return a == b;
+}
+
+bool parse_op(const json& value, CompareOp& out) {
+    static const std::pair<const char*, CompareOp> kOps[] = {
+        {"==", CompareOp::Eq}, {"!=", CompareOp::Ne}, {"<", CompareOp::Lt},
+        {"<=", CompareOp::Le}, {">", CompareOp::Gt},  {">=", CompareOp::Ge},
+    };
+    if (!value.is_string()) {
+        return false;
+    }
+    for (const auto& [name, op] : kOps) {
+        if (value == name) {
+            out = op;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool parse_rect(const json& r, geometry::Rect& out) {
+    if (!r.is_array() || r.size() != 4 ||
+        !std::all_of(r.begin(), r.end(), [](const json& v) { return v.is_number(); }) ||
+        r[2].get<double>() < 0 || r[3].get<double>() < 0) {
+        return false;
+    }
+    out = {r[0].get<double>(), r[1].get<double>(), r[2].get<double>(), r[3].get<double>()};
+    return true;
+}
+
+bool contains_rect(const geometry::Rect& outer, const geometry::Rect& inner) {
+    return inner.origin.x >= outer.origin.x && inner.origin.y >= outer.origin.y &&
+           inner.right() <= outer.right() && inner.bottom() <= outer.bottom();
+}
+
+json parse_maxclasses(const json& value, std::vector<std::string>& out) {
+    if (is_non_empty_string(value)) {
+        out.push_back(value.get<std::string>());
+        return nullptr;
+    }
+    if (!value.is_array() || value.empty() ||
+        !std::all_of(value.begin(), value.end(), is_non_empty_string)) {
+        return invalid("where.maxclass must be a class name or a non-empty array of them");
+    }
+    for (const json& name : value) {
+        out.push_back(name.get<std::string>());
+    }
+    return nullptr;
+}
+
+json parse_attribute_predicates(const json& value, std::vector<AttributePredicate>& out) {
+    if (!value.is_array() || value.empty()) {
+        return invalid("where.attributes must be a non-empty array");
+    }
+    for (size_t i = 0; i < value.size(); ++i) {
+        const json& item = value[i];
+        const std::string where = "where.attributes[" + std::to_string(i) + "]";
+        AttributePredicate pred;
+        if (!item.is_object() || !item.contains("name") || !is_non_empty_string(item["name"]) ||
+            !item.contains("value")) {
+            return invalid(where + " needs name and value");
+        }
+        pred.name = item["name"].get<std::string>();
+        if (item.contains("op") && !parse_op(item["op"], pred.op)) {
+            return invalid(where + ".op must be one of ==, !=, <, <=, >, >=");
+        }
+
+        const json& operand = item["value"];
+        const bool ordering = pred.op != CompareOp::Eq && pred.op != CompareOp::Ne;
+        auto scalar = [](const json& v) { return v.is_number() || v.is_string(); };
+        bool valid = ordering ? operand.is_number()
+                              : scalar(operand) ||
+                                    (operand.is_array() && !operand.empty() &&
+                                     std::all_of(operand.begin(), operand.end(), scalar));
+        if (!valid) {
+            return invalid(where + (ordering
+                                        ? ".value must be a number for ordering operators"
+                                        : ".value must be a number, string or array of them"));
+        }
+        pred.value = operand;
+        out.push_back(std::move(pred));
+    }
+    return nullptr;
+}
+
+json parse_region(const json& value, RegionPredicate& out) {
+    if (!value.is_object() || !value.contains("rect") || !parse_rect(value["rect"], out.rect)) {
+        return invalid("where.region.rect must be [x, y, width, height]");
+    }
+    auto option = [&value](const char* key, const char* fallback) {
+        if (!value.contains(key)) {
+            return std::string(fallback);
+        }
+        return value[key].is_string() ? value[key].get<std::string>() : std::string();
+    };
+
+    const std::string mode = option("mode", "intersect");
+    if (mode == "intersect") {
+        out.mode = RegionMode::Intersect;
+    } else if (mode == "contain") {
+        out.mode = RegionMode::Contain;
+    } else {
+        return invalid("where.region.mode must be 'intersect' or 'contain'");
+    }
+    const std::string space = option("space", "patching");
+    if (space != "patching" && space != "presentation") {
+        return invalid("where.region.space must be 'patching' or 'presentation'");
+    }
+    out.presentation = space == "presentation";
+    return nullptr;
+}
+
+}  // namespace
+
+bool compare(const json& actual, CompareOp op, const json& expected) {
+    if (actual.is_null()) {
+        return false;
+    }
+    switch (op) {
+    case CompareOp::Eq:
+        return equal_values(actual, expected);
+    case CompareOp::Ne:
+        return !equal_values(actual, expected);
+    default:
+        break;
+    }
+
+    if (!actual.is_number() || !expected.is_number()) {
+        return false;
+    }
+    const double a = actual.get<double>();
+    const double b = expected.get<double>();
+    switch (op) {
+    case CompareOp::Lt:
+        return a < b;
+    case CompareOp::Le:
+        return a <= b;
+    case CompareOp::Gt:
+        return a > b;
+    case CompareOp::Ge:
+        return a >= b;
+    default:
+        return false;
+    }
+}
+
+bool Query::matches_frame(const BoxView& box) const {
+    if (!maxclasses.empty() &&
+        std::none_of(maxclasses.begin(), maxclasses.end(), [&box](const std::string& name) {
+            return name == box.maxclass || name == box.object_class;
+        })) {
+        return false;
+    }
+    if (hidden && *hidden != box.hidden) {
+        return false;
+    }
+    if (presentation && *presentation != box.presentation) {
+        return false;
+    }
+    if (region) {
+        const geometry::Rect& rect = region->presentation ? box.presentation_rect
+                                                          : box.patching_rect;
+        bool inside = region->mode == RegionMode::Contain
+                          ? contains_rect(region->rect, rect)
+                          : geometry::aabb_overlap(rect, region->rect, 0.0);
+        if (!inside) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Query::matches_text(const std::string& box_text) const {
+    return !text || std::regex_search(box_text, *text);
+}
+
+bool Query::matches_attributes(const BoxView& box) const {
+    if (box.attributes.size() < attributes.size()) {
+        return false;  // Values not read: treat as missing
+    }
+    for (size_t i = 0; i < attributes.size(); ++i) {
+        if (!compare(box.attributes[i], attributes[i].op, attributes[i].value)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+json parse_query(const json& params, Query& out) {
+    out = Query{};
+
+    if (params.contains("limit")) {
+        const json& limit = params["limit"];
+        if (!limit.is_number_integer() || limit.get<long long>() < 1) {
+            return invalid("limit must be a positive integer");
+        }
+        out.limit = limit.get<size_t>();
+    }
+
+    if (!params.contains("where")) {
+        return nullptr;
+    }
+    const json& where = params["where"];
+    if (!where.is_object()) {
+        return invalid("where must be an object");
+    }
+
+    for (const auto& [key, value] : where.items()) {
+        json error;
+        if (key == "maxclass") {
+            error = parse_maxclasses(value, out.maxclasses);
+        } else if (key == "text") {
+            if (!is_non_empty_string(value)) {
+                return invalid("where.text must be a non-empty regular expression");
+            }
+            try {
+                out.text.emplace(value.get<std::string>(), std::regex::ECMAScript);
+            } catch (const std::regex_error& e) {
+                return invalid("where.text is not a valid regular expression: " +
+                               std::string(e.what()));
+            }
+        } else if (key == "attributes") {
+            error = parse_attribute_predicates(value, out.attributes);
+        } else if (key == "region") {
+            RegionPredicate region;
+            error = parse_region(value, region);
+            out.region = region;
+        } else if (key == "hidden" || key == "presentation") {
+            if (!value.is_boolean()) {
+                return invalid("where." + key + " must be a boolean");
+            }
+            (key == "hidden" ? out.hidden : out.presentation) = value.get<bool>();
+        } else {
+            return invalid("Unknown predicate where." + key +
+                           " (expected maxclass, text, attributes, region, hidden, "
+                           "presentation)");
+        }
+        if (!error.is_null()) {
+            return error;
+        }
+    }
+    return nullptr;
+}
+
+}  // namespace object_query
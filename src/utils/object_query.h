@@ -0,0 +1,138 @@
+/**
+    @file object_query.h
+    MaxMCP - Predicate language for query_objects
+
+    query_objects filters a patch's boxes server-side and returns only the
+    matches, in the same "fields" projection as get_objects_in_patch. The
+    filter is a "where" object whose keys are ANDed together:
+
+        {"maxclass": "send~" | ["send~", "receive~"],
+         "text": "^p voice",                       // ECMAScript regex, searched
+         "attributes": [{"name": "fontsize", "op": ">=", "value": 12}],
+         "region": {"rect": [x, y, w, h], "mode": "intersect" | "contain",
+                    "space": "patching" | "presentation"},
+         "hidden": false,
+         "presentation": true}
+
+    Predicates are split by cost. matches_frame() only needs what the jbox
+    getters return directly (class, rects, flags); matches_attributes() needs
+    attribute values, which the caller reads only for boxes that passed the
+    first stage. matches_text() runs the client's regex, whose cost the server
+    does not control, so query_objects copies the candidates' texts out of the
+    patch and searches them on the request thread, off Max's main thread.
+
+    @ingroup maxmcp
+*/
+
+#ifndef OBJECT_QUERY_H
+#define OBJECT_QUERY_H
+
+#include "geometry.h"
+
+#include <cstddef>
+#include <optional>
+#include <regex>
+#include <string>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+namespace object_query {
+
+using json = nlohmann::json;
+
+enum class CompareOp { Eq, Ne, Lt, Le, Gt, Ge };
+
+/**
+ * @brief Compare an attribute value against a predicate operand.
+ *
+ * == and != compare numbers numerically (so 12 == 12.0), strings exactly and
+ * arrays element-wise. The ordering operators need two numbers. A null
+ * @p actual (attribute missing) fails every comparison, including !=.
+ */
+bool compare(const json& actual, CompareOp op, const json& expected);
+
+struct AttributePredicate {
+    std::string name;
+    CompareOp op = CompareOp::Eq;
+    json value;
+};
+
+enum class RegionMode {
+    Intersect,  ///< Box overlaps the rect (marquee selection)
+    Contain,    ///< Box lies entirely inside the rect
+};
+
+struct RegionPredicate {
+    geometry::Rect rect{0, 0, 0, 0};
+    RegionMode mode = RegionMode::Intersect;
+    bool presentation = false;  ///< Test presentation_rect instead of patching_rect
+};
+
+/**
+ * @brief What the predicates look at for one box.
+ *
+ * @c text and @c attributes are only read by matches_content(); the caller
+ * fills them after matches_frame() passed.
+ */
+struct BoxView {
+    std::string maxclass;      ///< Box class ("newobj", "message", "toggle", ...)
+    std::string object_class;  ///< Class of the object inside the box ("send~", ...)
+    geometry::Rect patching_rect{0, 0, 0, 0};
+    geometry::Rect presentation_rect{0, 0, 0, 0};
+    bool hidden = false;
+    bool presentation = false;
+
+    std::string text;
+    std::vector<json> attributes;  ///< Parallel to Query::attributes; null if missing
+};
+
+/**
+ * @brief A parsed query_objects request.
+ */
+struct Query {
+    /// Matches a box whose maxclass or object class is listed; empty matches any.
+    std::vector<std::string> maxclasses;
+    std::optional<std::regex> text;
+    std::vector<AttributePredicate> attributes;
+    std::optional<RegionPredicate> region;
+    std::optional<bool> hidden;
+    std::optional<bool> presentation;
+    std::optional<size_t> limit;
+
+    bool needs_text() const {
+        return text.has_value();
+    }
+
+    /// Class, region and flag predicates.
+    bool matches_frame(const BoxView& box) const;
+
+    /// Attribute predicates.
+    bool matches_attributes(const BoxView& box) const;
+
+    /// Text predicate (true when there is none).
+    bool matches_text(const std::string& text) const;
+
+    /// Text and attribute predicates.
+    bool matches_content(const BoxView& box) const {
+        return matches_text(box.text) && matches_attributes(box);
+    }
+
+    bool matches(const BoxView& box) const {
+        return matches_frame(box) && matches_content(box);
+    }
+};
+
+/**
+ * @brief Parse params["where"] and params["limit"].
+ *
+ * "where" is optional (an absent or empty filter matches every box).
+ *
+ * @return Error JSON naming the first malformed predicate (including a regex
+ *         that does not compile), nullptr otherwise
+ */
+json parse_query(const json& params, Query& out);
+
+}  // namespace object_query
+
+#endif  // OBJECT_QUERY_H
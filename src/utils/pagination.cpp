@@ -0,0 +1,141 @@
+/**
+    @file pagination.cpp
+    MaxMCP - Revision-tied cursor pagination for listing tools
+
+    @ingroup maxmcp
+*/
+
+#include "pagination.h"
+
+#include "tools/tool_common.h"
+
+#include <cctype>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+
+namespace pagination {
+
+namespace {
+
+constexpr uint64_t kFnvOffsetBasis = 14695981039346656037ULL;
+constexpr uint64_t kFnvPrime = 1099511628211ULL;
+
+uint64_t fnv1a_mix(uint64_t hash, uint64_t value) {
+    for (int i = 0; i < 8; ++i) {
+        hash ^= (value >> (i * 8)) & 0xffu;
+        hash *= kFnvPrime;
+    }
+    return hash;
+}
+
+}  // namespace
+
+std::string encode_cursor(const Cursor& cursor) {
+    char buf[48];
+    std::snprintf(buf, sizeof(buf), "%016" PRIx64 ".%zu", cursor.revision, cursor.offset);
+    return buf;
+}
+
+std::optional<Cursor> decode_cursor(const std::string& text) {
+    // Exactly 16 hex digits, a dot, then at least one decimal digit.
+    if (text.size() < 18 || text[16] != '.') {
+        return std::nullopt;
+    }
+    for (size_t i = 0; i < text.size(); ++i) {
+        if (i == 16)
+            continue;
+        char c = text[i];
+        bool ok = i < 16 ? std::isxdigit(static_cast<unsigned char>(c)) != 0
+                         : (c >= '0' && c <= '9');
+        if (!ok) {
+            return std::nullopt;
+        }
+    }
+
+    Cursor cursor;
+    cursor.revision = std::strtoull(text.substr(0, 16).c_str(), nullptr, 16);
+    cursor.offset = static_cast<size_t>(std::strtoull(text.c_str() + 17, nullptr, 10));
+    return cursor;
+}
+
+RevisionHash::RevisionHash(uint64_t structure_edits)
+    : hash_(fnv1a_mix(kFnvOffsetBasis, structure_edits)) {}
+
+void RevisionHash::add(const void* element) {
+    hash_ = fnv1a_mix(hash_, static_cast<uint64_t>(reinterpret_cast<uintptr_t>(element)));
+    ++count_;
+}
+
+uint64_t RevisionHash::value() const {
+    // Fold the count in last so a prefix of a listing never shares its hash.
+    return fnv1a_mix(hash_, count_);
+}
+
+json parse_page_request(const json& params, PageRequest& out) {
+    out = PageRequest{};
+
+    if (params.contains("limit")) {
+        const json& limit = params["limit"];
+        if (!limit.is_number_integer() || limit.get<int64_t>() < 1) {
+            return ToolCommon::make_error(ToolCommon::ErrorCode::INVALID_PARAMS,
+                                          "limit must be a positive integer");
+        }
+        out.limit = static_cast<size_t>(limit.get<int64_t>());
+        out.paginated = true;
+    }
+
+    if (params.contains("cursor")) {
+        const json& cursor = params["cursor"];
+        std::optional<Cursor> decoded;
+        if (cursor.is_string()) {
+            decoded = decode_cursor(cursor.get<std::string>());
+        }
+        if (!decoded) {
+            return ToolCommon::make_error(ToolCommon::ErrorCode::INVALID_PARAMS,
+                                          "Invalid cursor: pass next_cursor from a previous "
+                                          "response unchanged");
+        }
+        out.cursor = decoded;
+        out.paginated = true;
+    }
+
+    return nullptr;
+}
+
+json resolve_page(const PageRequest& request, size_t total, uint64_t revision, PageWindow& out) {
+    size_t begin = 0;
+    if (request.cursor) {
+        if (request.cursor->revision != revision) {
+            return ToolCommon::make_error(
+                ToolCommon::ErrorCode::INVALID_PARAMS,
+                "Patch changed since cursor was issued; restart the listing without 'cursor'");
+        }
+        if (request.cursor->offset > total) {
+            return ToolCommon::make_error(ToolCommon::ErrorCode::INVALID_PARAMS,
+                                          "Cursor points past the end of the listing");
+        }
+        begin = request.cursor->offset;
+    }
+
+    size_t remaining = total - begin;
+    size_t count = (request.limit == 0 || request.limit > remaining) ? remaining : request.limit;
+
+    out.begin = begin;
+    out.end = begin + count;
+    out.has_more = out.end < total;
+    return nullptr;
+}
+
+void add_page_fields(json& result, const PageRequest& request, const PageWindow& window,
+                     size_t total, uint64_t revision) {
+    if (!request.paginated) {
+        return;
+    }
+    result["total"] = total;
+    if (window.has_more) {
+        result["next_cursor"] = encode_cursor(Cursor{revision, window.end});
+    }
+}
+
+}  // namespace pagination
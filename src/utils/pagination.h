@@ -0,0 +1,126 @@
+/**
+    @file pagination.h
+    MaxMCP - Revision-tied cursor pagination for listing tools
+
+    Shared by get_objects_in_patch and get_patchlines. A listing is walked in
+    patcher order; a page is the half-open range [offset, offset + limit). The
+    cursor handed back to the client is an opaque string that carries the
+    offset of the next page plus a revision fingerprint of the listing it was
+    cut from. The fingerprint is an FNV-1a hash over the patch's structure edit
+    counter, the element pointers in iteration order and their count, so
+    adding, removing or re-ordering boxes/lines changes it, while moving or
+    editing attributes does not — the offsets stay meaningful across those
+    edits. The counter catches a box or line freed and re-allocated at the same
+    address by a tool between two pages, which the pointers alone would miss.
+
+    @ingroup maxmcp
+*/
+
+#ifndef PAGINATION_H
+#define PAGINATION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+
+#include <nlohmann/json.hpp>
+
+namespace pagination {
+
+using json = nlohmann::json;
+
+/**
+ * @brief Decoded cursor: the listing revision it was issued for and the
+ *        offset of the first element of the next page.
+ */
+struct Cursor {
+    uint64_t revision = 0;
+    size_t offset = 0;
+};
+
+/**
+ * @brief Encode a cursor as an opaque string ("<16 hex digits>.<offset>").
+ */
+std::string encode_cursor(const Cursor& cursor);
+
+/**
+ * @brief Decode a string produced by encode_cursor().
+ * @return The cursor, or std::nullopt if @p text is malformed.
+ */
+std::optional<Cursor> decode_cursor(const std::string& text);
+
+/**
+ * @brief Incremental revision fingerprint (FNV-1a over an edit counter,
+ *        pointer values and their count).
+ */
+class RevisionHash {
+  public:
+    /**
+     * @param structure_edits Monotonic count of box/line additions and
+     *        removals made to the listed patcher (t_maxmcp::structure_edits)
+     */
+    explicit RevisionHash(uint64_t structure_edits = 0);
+
+    void add(const void* element);
+    uint64_t value() const;
+
+  private:
+    uint64_t hash_;
+    uint64_t count_ = 0;
+};
+
+/**
+ * @brief Pagination parameters of one request.
+ *
+ * @c limit == 0 means "no limit". @c paginated is true when the client passed
+ * either parameter; only then do responses carry total/next_cursor, so
+ * unpaginated calls keep their original shape.
+ */
+struct PageRequest {
+    bool paginated = false;
+    size_t limit = 0;
+    std::optional<Cursor> cursor;
+};
+
+/**
+ * @brief Parse the optional "limit" / "cursor" tool parameters.
+ *
+ * @param params Tool parameters
+ * @param out Receives the parsed request
+ * @return Error JSON for an invalid limit or malformed cursor, nullptr if valid
+ */
+json parse_page_request(const json& params, PageRequest& out);
+
+/**
+ * @brief Half-open element range selected for one page.
+ */
+struct PageWindow {
+    size_t begin = 0;
+    size_t end = 0;
+    bool has_more = false;
+};
+
+/**
+ * @brief Resolve a request against a listing of @p total elements at @p revision.
+ *
+ * @param request Parsed request
+ * @param total Number of elements in the listing
+ * @param revision Current revision fingerprint of the listing
+ * @param out Receives the window to serialize
+ * @return Error JSON if the cursor was issued for another revision or points
+ *         past the end of the listing, nullptr otherwise
+ */
+json resolve_page(const PageRequest& request, size_t total, uint64_t revision, PageWindow& out);
+
+/**
+ * @brief Add total / next_cursor to a listing result for paginated requests.
+ *
+ * No-op when the request was not paginated.
+ */
+void add_page_fields(json& result, const PageRequest& request, const PageWindow& window,
+                     size_t total, uint64_t revision);
+
+}  // namespace pagination
+
+#endif  // PAGINATION_H
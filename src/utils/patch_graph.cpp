@@ -0,0 +1,347 @@
+/**
+    @file patch_graph.cpp
+    MaxMCP - Patchcord graph analysis for analyze_patch_graph
+
+    @ingroup maxmcp
+*/
+
+#include "patch_graph.h"
+
+#include <algorithm>
+#include <functional>
+#include <queue>
+
+namespace patch_graph {
+
+namespace {
+
+// Build one direction of the CSR from (from, to) pairs sorted and deduplicated.
+void build_csr(size_t n, const std::vector<std::pair<int, int>>& pairs,
+               std::vector<size_t>& offsets, std::vector<int>& targets) {
+    offsets.assign(n + 1, 0);
+    for (const auto& [from, to] : pairs) {
+        (void)to;
+        ++offsets[from + 1];
+    }
+    for (size_t i = 0; i < n; ++i) {
+        offsets[i + 1] += offsets[i];
+    }
+    targets.resize(pairs.size());
+    for (size_t i = 0; i < pairs.size(); ++i) {
+        targets[i] = pairs[i].second;
+    }
+}
+
+std::string label_for(const EdgeList& list, int id) {
+    const Node& node = list.nodes[id];
+    if (!node.varname.empty()) {
+        return node.varname;
+    }
+    return node.maxclass + "#" + std::to_string(id);
+}
+
+}  // namespace
+
+Graph::Graph(const EdgeList& list) {
+    const size_t n = list.nodes.size();
+    out_cords_.assign(n, 0);
+    in_cords_.assign(n, 0);
+
+    std::vector<std::pair<int, int>> forward;
+    forward.reserve(list.edges.size());
+    for (const Edge& e : list.edges) {
+        if (e.src < 0 || e.dst < 0 || static_cast<size_t>(e.src) >= n ||
+            static_cast<size_t>(e.dst) >= n) {
+            continue;
+        }
+        ++edge_count_;
+        ++out_cords_[e.src];
+        ++in_cords_[e.dst];
+        forward.emplace_back(e.src, e.dst);
+    }
+    std::sort(forward.begin(), forward.end());
+    forward.erase(std::unique(forward.begin(), forward.end()), forward.end());
+
+    std::vector<std::pair<int, int>> backward;
+    backward.reserve(forward.size());
+    for (const auto& [src, dst] : forward) {
+        backward.emplace_back(dst, src);
+    }
+    std::sort(backward.begin(), backward.end());
+
+    build_csr(n, forward, out_offsets_, out_targets_);
+    build_csr(n, backward, in_offsets_, in_sources_);
+}
+
+bool Graph::has_self_loop(int node) const {
+    auto [begin, end] = successors(node);
+    return std::binary_search(begin, end, node);
+}
+
+std::vector<int> strongly_connected_components(const Graph& graph, int& component_count) {
+    // Iterative Tarjan. Components are emitted sinks first, so they are
+    // renumbered at the end to follow the edges.
+    const int n = static_cast<int>(graph.node_count());
+    std::vector<int> index(n, -1), low(n, 0), component(n, -1);
+    std::vector<bool> on_stack(n, false);
+    std::vector<int> stack;
+    struct Frame {
+        int node;
+        const int* next;
+    };
+    std::vector<Frame> frames;
+    int counter = 0;
+    int emitted = 0;
+
+    for (int root = 0; root < n; ++root) {
+        if (index[root] != -1) {
+            continue;
+        }
+        index[root] = low[root] = counter++;
+        stack.push_back(root);
+        on_stack[root] = true;
+        frames.push_back({root, graph.successors(root).first});
+
+        while (!frames.empty()) {
+            Frame& frame = frames.back();
+            const int v = frame.node;
+            const int* end = graph.successors(v).second;
+            if (frame.next != end) {
+                const int w = *frame.next++;
+                if (index[w] == -1) {
+                    index[w] = low[w] = counter++;
+                    stack.push_back(w);
+                    on_stack[w] = true;
+                    frames.push_back({w, graph.successors(w).first});
+                } else if (on_stack[w]) {
+                    low[v] = std::min(low[v], index[w]);
+                }
+                continue;
+            }
+
+            if (low[v] == index[v]) {
+                int w;
+                do {
+                    w = stack.back();
+                    stack.pop_back();
+                    on_stack[w] = false;
+                    component[w] = emitted;
+                } while (w != v);
+                ++emitted;
+            }
+            frames.pop_back();
+            if (!frames.empty()) {
+                const int parent = frames.back().node;
+                low[parent] = std::min(low[parent], low[v]);
+            }
+        }
+    }
+
+    for (int& c : component) {
+        c = emitted - 1 - c;
+    }
+    component_count = emitted;
+    return component;
+}
+
+std::vector<int> topological_order(const Graph& graph) {
+    const int n = static_cast<int>(graph.node_count());
+    int count = 0;
+    const std::vector<int> component = strongly_connected_components(graph, count);
+
+    // Members of each component, ascending; a component is keyed by its smallest id
+    std::vector<std::vector<int>> members(count);
+    for (int v = 0; v < n; ++v) {
+        members[component[v]].push_back(v);
+    }
+
+    // Kahn's algorithm over the condensation, smallest key first
+    std::vector<int> indegree(count, 0);
+    for (int v = 0; v < n; ++v) {
+        auto [begin, end] = graph.successors(v);
+        for (const int* w = begin; w != end; ++w) {
+            if (component[*w] != component[v]) {
+                ++indegree[component[*w]];
+            }
+        }
+    }
+    using Key = std::pair<int, int>;  // (smallest member, component)
+    std::priority_queue<Key, std::vector<Key>, std::greater<Key>> ready;
+    for (int c = 0; c < count; ++c) {
+        if (indegree[c] == 0) {
+            ready.push({members[c].front(), c});
+        }
+    }
+
+    std::vector<int> order;
+    order.reserve(n);
+    while (!ready.empty()) {
+        const int c = ready.top().second;
+        ready.pop();
+        for (int v : members[c]) {
+            order.push_back(v);
+            auto [begin, end] = graph.successors(v);
+            for (const int* w = begin; w != end; ++w) {
+                const int cw = component[*w];
+                if (cw != c && --indegree[cw] == 0) {
+                    ready.push({members[cw].front(), cw});
+                }
+            }
+        }
+    }
+    return order;
+}
+
+std::vector<std::pair<int, int>> reachable(const Graph& graph, int start, bool downstream,
+                                           int max_depth) {
+    std::vector<std::pair<int, int>> result;
+    const int n = static_cast<int>(graph.node_count());
+    if (start < 0 || start >= n) {
+        return result;
+    }
+
+    std::vector<int> depth(n, -1);
+    depth[start] = 0;
+    std::vector<int> frontier{start};
+    for (int d = 1; !frontier.empty() && (max_depth <= 0 || d <= max_depth); ++d) {
+        std::vector<int> next;
+        for (int v : frontier) {
+            auto [begin, end] = downstream ? graph.successors(v) : graph.predecessors(v);
+            for (const int* w = begin; w != end; ++w) {
+                if (depth[*w] == -1) {
+                    depth[*w] = d;
+                    next.push_back(*w);
+                }
+            }
+        }
+        std::sort(next.begin(), next.end());
+        for (int v : next) {
+            result.emplace_back(v, d);
+        }
+        frontier = std::move(next);
+    }
+    return result;
+}
+
+json analyze_report(const EdgeList& list, const AnalysisOptions& options) {
+    const Graph graph(list);
+    const int n = static_cast<int>(graph.node_count());
+    auto label = [&list](int id) { return label_for(list, id); };
+
+    int component_count = 0;
+    const std::vector<int> component = strongly_connected_components(graph, component_count);
+
+    // Feedback cycles: components with several boxes, or one box feeding itself
+    std::vector<std::vector<int>> members(component_count);
+    for (int v = 0; v < n; ++v) {
+        members[component[v]].push_back(v);
+    }
+    std::vector<std::vector<int>> cycles;
+    for (int c = 0; c < component_count; ++c) {
+        if (members[c].size() > 1 || graph.has_self_loop(members[c].front())) {
+            cycles.push_back(members[c]);
+        }
+    }
+    std::sort(cycles.begin(), cycles.end());
+
+    json report = {{"node_count", n},
+                   {"edge_count", graph.edge_count()},
+                   {"acyclic", cycles.empty()},
+                   {"scc_count", component_count}};
+
+    if (options.order) {
+        json order = json::array();
+        for (int v : topological_order(graph)) {
+            order.push_back(label(v));
+        }
+        report["topological_order"] = std::move(order);
+    }
+
+    if (options.cycles) {
+        std::vector<size_t> cords_within(component_count, 0);
+        for (const Edge& e : list.edges) {
+            if (e.src >= 0 && e.src < n && e.dst >= 0 && e.dst < n &&
+                component[e.src] == component[e.dst]) {
+                ++cords_within[component[e.src]];
+            }
+        }
+        json out = json::array();
+        for (const std::vector<int>& cycle : cycles) {
+            const size_t cords = cords_within[component[cycle.front()]];
+            json objects = json::array();
+            for (int v : cycle) {
+                objects.push_back(label(v));
+            }
+            out.push_back({{"objects", std::move(objects)}, {"cords", cords}});
+        }
+        report["cycles"] = std::move(out);
+    }
+
+    if (options.degrees) {
+        size_t sources = 0, sinks = 0, isolated = 0, max_in = 0, max_out = 0;
+        std::vector<int> by_out, by_in;
+        for (int v = 0; v < n; ++v) {
+            const size_t in = graph.in_degree(v);
+            const size_t out = graph.out_degree(v);
+            sources += (in == 0 && out > 0) ? 1 : 0;
+            sinks += (in > 0 && out == 0) ? 1 : 0;
+            isolated += (in == 0 && out == 0) ? 1 : 0;
+            max_in = std::max(max_in, in);
+            max_out = std::max(max_out, out);
+            if (out > 0) {
+                by_out.push_back(v);
+            }
+            if (in > 0) {
+                by_in.push_back(v);
+            }
+        }
+
+        auto ranking = [&](std::vector<int>& ids, bool fan_out) {
+            auto degree = [&](int v) { return fan_out ? graph.out_degree(v) : graph.in_degree(v); };
+            const size_t k = std::min(options.top, ids.size());
+            std::partial_sort(ids.begin(), ids.begin() + static_cast<long>(k), ids.end(),
+                              [&](int a, int b) {
+                                  return degree(a) != degree(b) ? degree(a) > degree(b) : a < b;
+                              });
+            json out = json::array();
+            for (size_t i = 0; i < k; ++i) {
+                out.push_back({{"object", label(ids[i])}, {"cords", degree(ids[i])}});
+            }
+            return out;
+        };
+
+        report["degrees"] = {{"sources", sources},
+                             {"sinks", sinks},
+                             {"isolated", isolated},
+                             {"max_fan_out", max_out},
+                             {"max_fan_in", max_in},
+                             {"top_fan_out", ranking(by_out, true)},
+                             {"top_fan_in", ranking(by_in, false)}};
+    }
+
+    if (options.from >= 0 && options.from < n) {
+        auto listing = [&](bool downstream) {
+            json out = json::array();
+            for (const auto& [v, depth] :
+                 reachable(graph, options.from, downstream, options.max_depth)) {
+                out.push_back({{"object", label(v)}, {"depth", depth}});
+            }
+            return out;
+        };
+        json reach = {{"from", label(options.from)}};
+        if (options.max_depth > 0) {
+            reach["max_depth"] = options.max_depth;
+        }
+        if (options.downstream) {
+            reach["downstream"] = listing(true);
+        }
+        if (options.upstream) {
+            reach["upstream"] = listing(false);
+        }
+        report["reachability"] = std::move(reach);
+    }
+
+    return report;
+}
+
+}  // namespace patch_graph
@@ -0,0 +1,145 @@
+/**
+    @file patch_graph.h
+    MaxMCP - Patchcord graph analysis for analyze_patch_graph
+
+    The Max side only walks the patcher once and records boxes and patchlines
+    as integer ids (EdgeList). Everything here runs afterwards, off the main
+    thread, on a compressed sparse row (CSR) adjacency built from that list:
+    strongly connected components (iterative Tarjan), a topological order of
+    the condensation, feedback cycles, depth-limited reachability and degree
+    statistics.
+
+    Box ids are patcher indices, the same "index" get_objects_in_patch
+    reports. Parallel cords between the same two boxes (different outlets or
+    inlets) count once for ordering and reachability but individually for
+    degrees.
+
+    @ingroup maxmcp
+*/
+
+#ifndef PATCH_GRAPH_H
+#define PATCH_GRAPH_H
+
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+namespace patch_graph {
+
+using json = nlohmann::json;
+
+struct Node {
+    std::string varname;
+    std::string maxclass;
+};
+
+/// One patchcord, src outlet -> dst inlet, by box id.
+struct Edge {
+    int src;
+    long outlet;
+    int dst;
+    long inlet;
+};
+
+/// What the main thread extracts: every box (in patcher order) and patchline.
+struct EdgeList {
+    std::vector<Node> nodes;
+    std::vector<Edge> edges;
+};
+
+/**
+ * @brief Directed graph in CSR form, in both directions.
+ */
+class Graph {
+  public:
+    explicit Graph(const EdgeList& list);
+
+    size_t node_count() const {
+        return out_offsets_.size() - 1;
+    }
+    size_t edge_count() const {
+        return edge_count_;
+    }
+
+    /// Cord counts, parallel cords included.
+    size_t out_degree(int node) const {
+        return out_cords_[node];
+    }
+    size_t in_degree(int node) const {
+        return in_cords_[node];
+    }
+
+    /// Distinct successor / predecessor ids of @p node, ascending.
+    std::pair<const int*, const int*> successors(int node) const {
+        return {out_targets_.data() + out_offsets_[node],
+                out_targets_.data() + out_offsets_[node + 1]};
+    }
+    std::pair<const int*, const int*> predecessors(int node) const {
+        return {in_sources_.data() + in_offsets_[node],
+                in_sources_.data() + in_offsets_[node + 1]};
+    }
+
+    bool has_self_loop(int node) const;
+
+  private:
+    size_t edge_count_ = 0;
+    std::vector<size_t> out_offsets_, in_offsets_;
+    std::vector<int> out_targets_, in_sources_;
+    std::vector<size_t> out_cords_, in_cords_;
+};
+
+/**
+ * @brief Strongly connected components.
+ *
+ * @return component[i] for every node. Components are numbered in
+ *         topological order of the condensation: every edge goes from a
+ *         component to the same or a higher-numbered one.
+ */
+std::vector<int> strongly_connected_components(const Graph& graph, int& component_count);
+
+/**
+ * @brief A topological order of the boxes.
+ *
+ * Exact when the graph is acyclic. Otherwise the boxes of each feedback
+ * cycle are adjacent and every edge between different cycles/boxes still
+ * points forward. Ties are broken by box id.
+ */
+std::vector<int> topological_order(const Graph& graph);
+
+/**
+ * @brief Boxes reachable from @p start, with their hop distance.
+ *
+ * @param downstream Follow cords forwards (true) or backwards (false)
+ * @param max_depth  Stop after this many hops; 0 for no limit
+ * @return (id, depth) pairs ordered by depth then id, @p start excluded
+ */
+std::vector<std::pair<int, int>> reachable(const Graph& graph, int start, bool downstream,
+                                           int max_depth);
+
+/**
+ * @brief Which analyses analyze_report() includes.
+ */
+struct AnalysisOptions {
+    bool order = true;
+    bool cycles = true;
+    bool degrees = true;
+    int from = -1;  ///< Box id for reachability; -1 to skip
+    bool downstream = true;
+    bool upstream = true;
+    int max_depth = 0;
+    size_t top = 10;  ///< Boxes listed per fan-in / fan-out ranking
+};
+
+/**
+ * @brief The analyze_patch_graph response body (minus patch_id).
+ *
+ * Boxes are reported by label: the varname, or "maxclass#id" when unnamed.
+ */
+json analyze_report(const EdgeList& list, const AnalysisOptions& options);
+
+}  // namespace patch_graph
+
+#endif  // PATCH_GRAPH_H
@@ -7,8 +7,15 @@
 
 #include "patch_helpers.h"
 
+#include "symbols.h"
+
 #ifndef MAXMCP_TEST_MODE
 #include "jpatcher_api.h"
+
+#include <map>
+#include <set>
+#include <tuple>
+#include <utility>
 #endif
 
 using json = nlohmann::json;
@@ -76,6 +83,37 @@ std::vector<t_atom> json_to_atoms(const nlohmann::json& value) {
     return {};
 }
 
+std::unordered_map<std::string, t_object*> index_boxes_by_varname(t_object* patcher) {
+    (void)patcher;
+    return {};
+}
+
+t_object* connect_boxes(t_object* patcher, t_object* src_box, long outlet, t_object* dst_box,
+                        long inlet) {
+    (void)patcher;
+    (void)src_box;
+    (void)outlet;
+    (void)dst_box;
+    (void)inlet;
+    return nullptr;
+}
+
+t_object* set_patchline_midpoints(t_object* patcher, t_object* line,
+                                  const std::vector<double>& coords) {
+    (void)patcher;
+    (void)coords;
+    return line;
+}
+
+json connect_batch(t_object* patcher, const std::vector<batch::ConnectionSpec>& specs,
+                   const std::unordered_map<std::string, t_object*>& boxes, batch::Tally& tally) {
+    (void)patcher;
+    (void)specs;
+    (void)boxes;
+    (void)tally;
+    return json::array();
+}
+
 bool set_box_attribute(t_object* box, const std::string& attr_name, const nlohmann::json& value) {
     (void)box;
     (void)attr_name;
@@ -83,6 +121,13 @@ bool set_box_attribute(t_object* box, const std::string& attr_name, const nlohma
     return false;
 }
 
+bool set_box_attribute(t_object* box, t_symbol* attr, const nlohmann::json& value) {
+    (void)box;
+    (void)attr;
+    (void)value;
+    return false;
+}
+
 bool set_textfield_content(t_object* box, const std::string& text) {
     (void)box;
     (void)text;
@@ -118,6 +163,20 @@ long restore_box_connections(t_object* patcher, t_object* new_box,
     return 0;
 }
 
+std::vector<SavedPatchline> save_patchlines_touching(t_object* patcher,
+                                                     const std::unordered_set<t_object*>& boxes) {
+    (void)patcher;
+    (void)boxes;
+    return {};
+}
+
+std::vector<bool> restore_patchlines(t_object* patcher, const std::vector<SavedPatchline>& lines,
+                                     const std::unordered_map<t_object*, t_object*>& replaced) {
+    (void)patcher;
+    (void)replaced;
+    return std::vector<bool>(lines.size(), false);
+}
+
 #else
 
 t_object* find_box_by_varname(t_object* patcher, const std::string& varname) {
@@ -127,7 +186,7 @@ t_object* find_box_by_varname(t_object* patcher, const std::string& varname) {
 
     for (t_object* box = jpatcher_get_firstobject(patcher); box != nullptr;
          box = jbox_get_nextobject(box)) {
-        t_symbol* box_varname = object_attr_getsym(box, gensym("varname"));
+        t_symbol* box_varname = object_attr_getsym(box, Symbols::varname);
         if (box_varname && box_varname->s_name && varname == box_varname->s_name) {
             return box;
         }
@@ -140,7 +199,7 @@ std::string get_box_varname(t_object* box) {
     if (!box) {
         return "";
     }
-    t_symbol* varname = object_attr_getsym(box, gensym("varname"));
+    t_symbol* varname = object_attr_getsym(box, Symbols::varname);
     return (varname && varname->s_name) ? varname->s_name : "";
 }
 
@@ -157,7 +216,7 @@ long get_inlet_count(t_object* box) {
         return -1;
     }
     // Get inlet count via attribute (jbox_get_numins doesn't exist in current SDK)
-    return object_attr_getlong(box, gensym("numinlets"));
+    return object_attr_getlong(box, Symbols::numinlets);
 }
 
 long get_outlet_count(t_object* box) {
@@ -165,7 +224,7 @@ long get_outlet_count(t_object* box) {
         return -1;
     }
     // Get outlet count via attribute (jbox_get_numouts doesn't exist in current SDK)
-    return object_attr_getlong(box, gensym("numoutlets"));
+    return object_attr_getlong(box, Symbols::numoutlets);
 }
 
 static void json_value_to_atom(t_atom& atom, const nlohmann::json& value) {
@@ -198,6 +257,10 @@ std::vector<t_atom> json_to_atoms(const nlohmann::json& value) {
 }
 
 bool set_box_attribute(t_object* box, const std::string& attr_name, const nlohmann::json& value) {
+    return set_box_attribute(box, gensym(attr_name.c_str()), value);
+}
+
+bool set_box_attribute(t_object* box, t_symbol* attr, const nlohmann::json& value) {
     if (!box) {
         return false;
     }
@@ -207,8 +270,7 @@ bool set_box_attribute(t_object* box, const std::string& attr_name, const nlohma
         return false;
     }
 
-    object_attr_setvalueof(box, gensym(attr_name.c_str()), static_cast<long>(atoms.size()),
-                           atoms.data());
+    object_attr_setvalueof(box, attr, static_cast<long>(atoms.size()), atoms.data());
     return true;
 }
 
@@ -222,7 +284,7 @@ bool set_textfield_content(t_object* box, const std::string& text) {
         return false;
     }
 
-    object_method(textfield, gensym("settext"), text.c_str());
+    object_method(textfield, Symbols::settext, text.c_str());
     return true;
 }
 
@@ -234,7 +296,7 @@ std::string get_box_text(t_object* box) {
     t_object* textfield = jbox_get_textfield(box);
     if (textfield) {
         const char* text = nullptr;
-        object_method(textfield, gensym("gettext"), &text);
+        object_method(textfield, Symbols::gettext, &text);
         if (text)
             return std::string(text);
     }
@@ -242,9 +304,9 @@ std::string get_box_text(t_object* box) {
     // Fallback: serialize box to dictionary and read "text" key
     t_dictionary* d = dictionary_new();
     if (d) {
-        object_method(box, gensym("appendtodictionary"), d);
+        object_method(box, Symbols::appendtodictionary, d);
         const char* text = nullptr;
-        if (dictionary_getstring(d, gensym("text"), &text) == MAX_ERR_NONE && text) {
+        if (dictionary_getstring(d, Symbols::text, &text) == MAX_ERR_NONE && text) {
             std::string result(text);
             object_free((t_object*)d);
             return result;
@@ -255,40 +317,66 @@ std::string get_box_text(t_object* box) {
     return "";
 }
 
-std::vector<SavedAttribute> save_box_attributes(t_object* box) {
-    std::vector<SavedAttribute> saved;
-    if (!box)
-        return saved;
+namespace {
+
+// Saveable attribute lists per class, keyed by (box maxclass, object class).
+// newobj boxes share a maxclass, so the wrapped object's class tells them apart.
+using SaveableKey = std::pair<t_symbol*, t_symbol*>;
+SaveableAttributeCache<SaveableKey, t_symbol*> g_saveable_attributes;
+
+bool is_saveable_attribute(t_object* box, t_symbol* name) {
+    t_object* attr_obj = (t_object*)object_attr_get(box, name);
+    if (!attr_obj)
+        return false;
+
+    // Only save writable attributes
+    if (!object_attr_usercanset(box, name))
+        return false;
+
+    // Save if: has save=1 meta OR is in visual whitelist
+    bool has_save_meta = (object_attr_getlong(attr_obj, Symbols::save) == 1);
+    std::string attr_name = name->s_name ? name->s_name : "";
+    bool is_whitelisted = kBoxAttributeWhitelist.count(attr_name) > 0;
+    return has_save_meta || is_whitelisted;
+}
 
+std::vector<t_symbol*> saveable_attributes(t_object* box) {
     long attr_count = 0;
     t_symbol** attr_names = nullptr;
     if (object_attr_getnames(box, &attr_count, &attr_names) != MAX_ERR_NONE)
-        return saved;
+        return {};
+    std::vector<t_symbol*> names(attr_names, attr_names + attr_count);
+    sysmem_freeptr(attr_names);
 
-    for (long i = 0; i < attr_count; i++) {
-        t_object* attr_obj = (t_object*)object_attr_get(box, attr_names[i]);
-        if (!attr_obj)
-            continue;
+    t_object* obj = jbox_get_object(box);
+    SaveableKey key{jbox_get_maxclass(box), obj ? object_classname(obj) : nullptr};
 
-        // Only save writable attributes
-        if (!object_attr_usercanset(box, attr_names[i]))
-            continue;
+    // Attributes the box or object class declares; anything else was added to
+    // this instance and is not cached
+    auto is_class_attr = [box, obj](t_symbol* name) {
+        return class_attr_get(object_class(box), name) ||
+               (obj && class_attr_get(object_class(obj), name));
+    };
+    return g_saveable_attributes.select(key, names, is_class_attr, [box](t_symbol* name) {
+        return is_saveable_attribute(box, name);
+    });
+}
 
-        // Save if: has save=1 meta OR is in visual whitelist
-        bool has_save_meta = (object_attr_getlong(attr_obj, gensym("save")) == 1);
-        std::string attr_name = attr_names[i]->s_name ? attr_names[i]->s_name : "";
-        bool is_whitelisted = kBoxAttributeWhitelist.count(attr_name) > 0;
-        if (!has_save_meta && !is_whitelisted)
-            continue;
+}  // namespace
 
+std::vector<SavedAttribute> save_box_attributes(t_object* box) {
+    std::vector<SavedAttribute> saved;
+    if (!box)
+        return saved;
+
+    for (t_symbol* name : saveable_attributes(box)) {
         long ac = 0;
         t_atom* av = nullptr;
-        if (object_attr_getvalueof(box, attr_names[i], &ac, &av) == MAX_ERR_NONE && ac > 0) {
-            saved.push_back({attr_names[i], std::vector<t_atom>(av, av + ac)});
+        if (object_attr_getvalueof(box, name, &ac, &av) == MAX_ERR_NONE && ac > 0) {
+            saved.push_back({name, std::vector<t_atom>(av, av + ac)});
             sysmem_freeptr(av);
         }
     }
-    sysmem_freeptr(attr_names);
 
     return saved;
 }
@@ -320,7 +408,7 @@ std::vector<SavedConnection> save_box_connections(t_object* patcher, t_object* b
         if (num_midpoints > 0) {
             long num_values = num_midpoints * 2;
             conn.midpoints.resize(num_values, 0.0);
-            object_attr_getdouble_array(line, gensym("midpoints"), num_values,
+            object_attr_getdouble_array(line, Symbols::midpoints, num_values,
                                         conn.midpoints.data());
         }
 
@@ -368,7 +456,7 @@ long restore_box_connections(t_object* patcher, t_object* new_box,
         atom_setlong(&connect_args[3], conn.inlet);
 
         t_atom rv;
-        object_method_typed(patcher, gensym("connect"), 4, connect_args, &rv);
+        object_method_typed(patcher, Symbols::connect, 4, connect_args, &rv);
 
         // Verify by scanning patchlines (connect return value is unreliable)
         t_object* line = find_patchline(patcher, src_box, conn.outlet, dst_box, conn.inlet);
@@ -378,7 +466,7 @@ long restore_box_connections(t_object* patcher, t_object* new_box,
             jpatchline_set_color(line, &color_copy);
             if (!conn.midpoints.empty()) {
                 std::vector<double> midpts_copy(conn.midpoints);
-                object_attr_setdouble_array(line, gensym("midpoints"), (long)midpts_copy.size(),
+                object_attr_setdouble_array(line, Symbols::midpoints, (long)midpts_copy.size(),
                                             midpts_copy.data());
             }
             reconnected++;
@@ -388,6 +476,285 @@ long restore_box_connections(t_object* patcher, t_object* new_box,
     return reconnected;
 }
 
+std::vector<SavedPatchline> save_patchlines_touching(t_object* patcher,
+                                                     const std::unordered_set<t_object*>& boxes) {
+    std::vector<SavedPatchline> saved;
+    if (!patcher || boxes.empty())
+        return saved;
+
+    for (t_object* line = jpatcher_get_firstline(patcher); line;
+         line = jpatchline_get_nextline(line)) {
+        t_object* box1 = (t_object*)jpatchline_get_box1(line);
+        t_object* box2 = (t_object*)jpatchline_get_box2(line);
+        if (!boxes.count(box1) && !boxes.count(box2))
+            continue;
+
+        SavedPatchline pl;
+        pl.src_box = box1;
+        pl.outlet = jpatchline_get_outletnum(line);
+        pl.dst_box = box2;
+        pl.inlet = jpatchline_get_inletnum(line);
+        pl.hidden = jpatchline_get_hidden(line);
+
+        pl.color = {0.0, 0.0, 0.0, 1.0};
+        jpatchline_get_color(line, &pl.color);
+
+        long num_midpoints = jpatchline_get_nummidpoints(line);
+        if (num_midpoints > 0) {
+            long num_values = num_midpoints * 2;
+            pl.midpoints.resize(num_values, 0.0);
+            object_attr_getdouble_array(line, Symbols::midpoints, num_values, pl.midpoints.data());
+        }
+
+        saved.push_back(std::move(pl));
+    }
+
+    return saved;
+}
+
+std::vector<bool> restore_patchlines(t_object* patcher, const std::vector<SavedPatchline>& lines,
+                                     const std::unordered_map<t_object*, t_object*>& replaced) {
+    std::vector<bool> present(lines.size(), false);
+    if (!patcher)
+        return present;
+
+    auto remap = [&replaced](t_object* box) {
+        auto it = replaced.find(box);
+        return it == replaced.end() ? box : it->second;
+    };
+
+    // Issue every connect first; the lines are matched up in one scan below
+    using Key = std::tuple<t_object*, long, t_object*, long>;
+    std::map<Key, size_t> pending;
+    for (size_t i = 0; i < lines.size(); ++i) {
+        const SavedPatchline& pl = lines[i];
+        if (!replaced.count(pl.src_box) && !replaced.count(pl.dst_box)) {
+            present[i] = true;
+            continue;
+        }
+
+        t_object* src_box = remap(pl.src_box);
+        t_object* dst_box = remap(pl.dst_box);
+
+        t_atom connect_args[4];
+        atom_setobj(&connect_args[0], src_box);
+        atom_setlong(&connect_args[1], pl.outlet);
+        atom_setobj(&connect_args[2], dst_box);
+        atom_setlong(&connect_args[3], pl.inlet);
+
+        t_atom rv;
+        object_method_typed(patcher, Symbols::connect, 4, connect_args, &rv);
+        pending.emplace(Key{src_box, pl.outlet, dst_box, pl.inlet}, i);
+    }
+
+    if (pending.empty())
+        return present;
+
+    // Verify by scanning patchlines (connect return value is unreliable)
+    for (t_object* line = jpatcher_get_firstline(patcher); line;
+         line = jpatchline_get_nextline(line)) {
+        auto it = pending.find(Key{(t_object*)jpatchline_get_box1(line),
+                                   jpatchline_get_outletnum(line),
+                                   (t_object*)jpatchline_get_box2(line),
+                                   jpatchline_get_inletnum(line)});
+        if (it == pending.end())
+            continue;
+
+        const SavedPatchline& pl = lines[it->second];
+        jpatchline_set_hidden(line, pl.hidden);
+        t_jrgba color_copy = pl.color;
+        jpatchline_set_color(line, &color_copy);
+        if (!pl.midpoints.empty()) {
+            std::vector<double> midpts_copy(pl.midpoints);
+            object_attr_setdouble_array(line, Symbols::midpoints, (long)midpts_copy.size(),
+                                        midpts_copy.data());
+        }
+        present[it->second] = true;
+        pending.erase(it);
+    }
+
+    return present;
+}
+
+std::unordered_map<std::string, t_object*> index_boxes_by_varname(t_object* patcher) {
+    std::unordered_map<std::string, t_object*> index;
+    if (!patcher) {
+        return index;
+    }
+
+    for (t_object* box = jpatcher_get_firstobject(patcher); box; box = jbox_get_nextobject(box)) {
+        t_symbol* varname = object_attr_getsym(box, Symbols::varname);
+        if (varname && varname->s_name && varname->s_name[0]) {
+            index.emplace(varname->s_name, box);
+        }
+    }
+    return index;
+}
+
+t_object* connect_boxes(t_object* patcher, t_object* src_box, long outlet, t_object* dst_box,
+                        long inlet) {
+    if (!patcher || !src_box || !dst_box) {
+        return nullptr;
+    }
+
+    t_atom connect_args[4];
+    atom_setobj(&connect_args[0], src_box);
+    atom_setlong(&connect_args[1], outlet);
+    atom_setobj(&connect_args[2], dst_box);
+    atom_setlong(&connect_args[3], inlet);
+
+    t_atom rv;
+    object_method_typed(patcher, Symbols::connect, 4, connect_args, &rv);
+
+    return find_patchline(patcher, src_box, outlet, dst_box, inlet);
+}
+
+t_object* set_patchline_midpoints(t_object* patcher, t_object* line,
+                                  const std::vector<double>& coords) {
+    if (!coords.empty()) {
+        std::vector<double> values(coords);
+        object_attr_setdouble_array(line, Symbols::midpoints, (long)values.size(), values.data());
+        return line;
+    }
+    if (jpatchline_get_nummidpoints(line) == 0) {
+        return line;
+    }
+
+    // No setter API for clearing midpoints; reconnect the patchline
+    t_object* src_box = (t_object*)jpatchline_get_box1(line);
+    t_object* dst_box = (t_object*)jpatchline_get_box2(line);
+    const long outlet = jpatchline_get_outletnum(line);
+    const long inlet = jpatchline_get_inletnum(line);
+    const bool was_hidden = jpatchline_get_hidden(line);
+    t_jrgba saved_color;
+    jpatchline_get_color(line, &saved_color);
+
+    object_free(line);
+
+    line = connect_boxes(patcher, src_box, outlet, dst_box, inlet);
+    if (line) {
+        jpatchline_set_hidden(line, was_hidden);
+        jpatchline_set_color(line, &saved_color);
+    }
+    return line;
+}
+
+json connect_batch(t_object* patcher, const std::vector<batch::ConnectionSpec>& specs,
+                   const std::unordered_map<std::string, t_object*>& boxes, batch::Tally& tally) {
+    using Key = std::tuple<t_object*, long, t_object*, long>;
+    auto line_key = [](t_object* line) {
+        return Key{(t_object*)jpatchline_get_box1(line), jpatchline_get_outletnum(line),
+                   (t_object*)jpatchline_get_box2(line), jpatchline_get_inletnum(line)};
+    };
+
+    // Resolve every endpoint first. Under OnError::Stop nothing after an
+    // unresolved connection is attempted.
+    std::vector<std::string> errors(specs.size());
+    std::vector<Key> keys(specs.size());
+    std::map<Key, t_object*> lines;  // requested cord -> its patchline once verified
+    size_t end = specs.size();
+    for (size_t i = 0; i < specs.size(); ++i) {
+        const batch::ConnectionSpec& spec = specs[i];
+        auto src = boxes.find(spec.src_varname);
+        auto dst = boxes.find(spec.dst_varname);
+
+        if (src == boxes.end() || dst == boxes.end()) {
+            std::string& error = errors[i];
+            error = "Connect failed: ";
+            if (src == boxes.end()) {
+                error += "source '" + spec.src_varname + "' not found";
+            }
+            if (src == boxes.end() && dst == boxes.end()) {
+                error += ", ";
+            }
+            if (dst == boxes.end()) {
+                error += "destination '" + spec.dst_varname + "' not found";
+            }
+            if (tally.stops_on_failure()) {
+                end = i + 1;
+                break;
+            }
+            continue;
+        }
+        keys[i] = Key{src->second, spec.outlet, dst->second, spec.inlet};
+        lines.emplace(keys[i], nullptr);
+    }
+
+    // Cords that already exist are not reconnected, and never removed below
+    std::set<Key> existing;
+    for (t_object* line = jpatcher_get_firstline(patcher); line && !lines.empty();
+         line = jpatchline_get_nextline(line)) {
+        Key key = line_key(line);
+        if (lines.count(key)) {
+            existing.insert(key);
+        }
+    }
+
+    for (const auto& [key, line] : lines) {
+        if (existing.count(key)) {
+            continue;
+        }
+        t_atom connect_args[4];
+        atom_setobj(&connect_args[0], std::get<0>(key));
+        atom_setlong(&connect_args[1], std::get<1>(key));
+        atom_setobj(&connect_args[2], std::get<2>(key));
+        atom_setlong(&connect_args[3], std::get<3>(key));
+
+        t_atom rv;
+        object_method_typed(patcher, Symbols::connect, 4, connect_args, &rv);
+    }
+
+    // Verify by scanning patchlines once (connect return value is unreliable)
+    for (t_object* line = jpatcher_get_firstline(patcher); line && !lines.empty();
+         line = jpatchline_get_nextline(line)) {
+        auto it = lines.find(line_key(line));
+        if (it != lines.end() && !it->second) {
+            it->second = line;
+        }
+    }
+
+    json results = json::array();
+    std::set<Key> reported;  // cords already reported as made
+    for (size_t i = 0; i < end; ++i) {
+        const batch::ConnectionSpec& spec = specs[i];
+        std::string& error = errors[i];
+        if (error.empty() && !lines[keys[i]]) {
+            error = "Connect failed: could not verify connection " + spec.src_varname + "[" +
+                    std::to_string(spec.outlet) + "] -> " + spec.dst_varname + "[" +
+                    std::to_string(spec.inlet) + "]";
+        }
+
+        if (!error.empty()) {
+            results.push_back(batch::item_error(i, error));
+            tally.failed();
+            if (tally.stopped()) {
+                // Undo the cords made for the connections after this one
+                for (size_t j = i + 1; j < end; ++j) {
+                    if (!errors[j].empty() || existing.count(keys[j]) || reported.count(keys[j])) {
+                        continue;
+                    }
+                    t_object*& line = lines[keys[j]];
+                    if (line) {
+                        object_free(line);
+                        line = nullptr;
+                    }
+                }
+                break;
+            }
+            continue;
+        }
+
+        results.push_back(batch::item_success(i, {{"src_varname", spec.src_varname},
+                                                  {"outlet", spec.outlet},
+                                                  {"dst_varname", spec.dst_varname},
+                                                  {"inlet", spec.inlet}}));
+        reported.insert(keys[i]);
+        tally.succeeded();
+    }
+
+    return results;
+}
+
 json atom_to_json(const t_atom& a) {
     switch (atom_gettype(&a)) {
     case A_LONG:
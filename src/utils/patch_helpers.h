@@ -10,8 +10,14 @@
 #ifndef PATCH_HELPERS_H
 #define PATCH_HELPERS_H
 
+#include "batch.h"
+
+#include <map>
+#include <set>
 #include <string>
+#include <unordered_map>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 
 #include <nlohmann/json.hpp>
@@ -157,6 +163,14 @@ std::vector<t_atom> json_to_atoms(const nlohmann::json& value);
  */
 bool set_box_attribute(t_object* box, const std::string& attr_name, const nlohmann::json& value);
 
+/**
+ * @brief set_box_attribute() with an already interned attribute name
+ *
+ * For loops that set the same attribute names on many boxes (see
+ * Symbols::Cache).
+ */
+bool set_box_attribute(t_object* box, t_symbol* attr, const nlohmann::json& value);
+
 /**
  * @brief Build a space-separated text string from a JSON arguments array
  *
@@ -220,6 +234,22 @@ struct SavedConnection {
     std::vector<double> midpoints;  ///< flat [x1, y1, x2, y2, ...]
 };
 
+/**
+ * @brief A saved patchline by its two endpoints, with visual properties
+ *
+ * Unlike SavedConnection (relative to one box), this records both boxes, so a
+ * single snapshot can cover a set of boxes that are all being recreated.
+ */
+struct SavedPatchline {
+    t_object* src_box;
+    long outlet;
+    t_object* dst_box;
+    long inlet;
+    char hidden;
+    t_jrgba color;
+    std::vector<double> midpoints;  ///< flat [x1, y1, x2, y2, ...]
+};
+
 /**
  * @brief Get the text content of a box
  *
@@ -232,11 +262,77 @@ struct SavedConnection {
  */
 std::string get_box_text(t_object* box);
 
+/**
+ * @brief Per-class list of saveable attributes, plus each box's own extras
+ *
+ * The attributes a class declares, and which of them are saveable, depend
+ * only on the class, so the first box of a class resolves that list once and
+ * later boxes reuse it. A class-wide list alone is not enough, though: js/jsui
+ * declareattribute and other dynamic attributes are added per instance and
+ * can differ between boxes of one class. Max has no call that lists only an
+ * instance's attributes, so each box's names are still read (one
+ * object_attr_getnames call), but only the names outside the class list are
+ * checked for saveability.
+ *
+ * Only names are cached, not types: object_attr_getvalueof() returns typed
+ * atoms and object_attr_setvalueof() takes them back, so no caller needs the
+ * declared type.
+ *
+ * Max-API independent: the caller supplies the class key and both checks.
+ */
+template <typename Class, typename Name>
+class SaveableAttributeCache {
+  public:
+    /**
+     * @brief The saveable attributes of a box: the class's, then its own
+     *
+     * @param cls Class key of the box
+     * @param names Every attribute name of the box
+     * @param is_class_attr Whether a name is declared by the class; only
+     *        called for the first box of a class
+     * @param is_saveable The uncached saveable check for one name
+     */
+    template <typename IsClassAttr, typename IsSaveable>
+    std::vector<Name> select(const Class& cls, const std::vector<Name>& names,
+                             IsClassAttr&& is_class_attr, IsSaveable&& is_saveable) {
+        auto it = classes_.find(cls);
+        if (it == classes_.end()) {
+            ClassAttributes attrs;
+            for (const Name& name : names) {
+                if (is_class_attr(name)) {
+                    attrs.declared.insert(name);
+                    if (is_saveable(name)) {
+                        attrs.saveable.push_back(name);
+                    }
+                }
+            }
+            it = classes_.emplace(cls, std::move(attrs)).first;
+        }
+
+        std::vector<Name> saveable = it->second.saveable;
+        for (const Name& name : names) {
+            if (!it->second.declared.count(name) && is_saveable(name)) {
+                saveable.push_back(name);
+            }
+        }
+        return saveable;
+    }
+
+  private:
+    struct ClassAttributes {
+        std::set<Name> declared;     ///< Every attribute the class declares
+        std::vector<Name> saveable;  ///< The saveable ones, in declaration order
+    };
+    std::map<Class, ClassAttributes> classes_;
+};
+
 /**
  * @brief Save all saveable attributes of a box
  *
- * Enumerates all attributes and saves those that are writable AND either have
- * the "save" meta-attribute set to 1 or are in kBoxAttributeWhitelist.
+ * Saves the attributes that are writable AND either have the "save"
+ * meta-attribute set to 1 or are in kBoxAttributeWhitelist. The list of
+ * class-declared ones is cached per class (SaveableAttributeCache); the box's
+ * own instance attributes are checked every time.
  *
  * @param box The box object to save attributes from
  * @return Vector of saved attributes
@@ -274,6 +370,33 @@ void restore_box_attributes(t_object* new_box, const std::vector<SavedAttribute>
 long restore_box_connections(t_object* patcher, t_object* new_box,
                              const std::vector<SavedConnection>& connections);
 
+/**
+ * @brief Save every patchline touching any box in @p boxes
+ *
+ * One patchline scan regardless of how many boxes are given. A line between
+ * two of the boxes is saved once.
+ *
+ * @note This function must be called on the main thread (or via defer)
+ */
+std::vector<SavedPatchline> save_patchlines_touching(t_object* patcher,
+                                                     const std::unordered_set<t_object*>& boxes);
+
+/**
+ * @brief Recreate saved patchlines after some of their boxes were replaced
+ *
+ * Lines with an endpoint in @p replaced (old box → new box) are reconnected
+ * to the new box(es); other endpoints are used as-is. All connects are issued
+ * first, then one patchline scan verifies them and restores hidden, color and
+ * midpoints. Lines touching no replaced box are left alone and count as
+ * present.
+ *
+ * @return Per line, whether it exists after the call
+ *
+ * @note This function must be called on the main thread (or via defer)
+ */
+std::vector<bool> restore_patchlines(t_object* patcher, const std::vector<SavedPatchline>& lines,
+                                     const std::unordered_map<t_object*, t_object*>& replaced);
+
 /**
  * @brief Find a patchline matching the given source/destination
  *
@@ -287,6 +410,67 @@ long restore_box_connections(t_object* patcher, t_object* new_box,
 t_object* find_patchline(t_object* patcher, t_object* src_box, long outlet, t_object* dst_box,
                          long inlet);
 
+/**
+ * @brief Map every named box in a patcher to its box
+ *
+ * One patcher scan, for callers that resolve many varnames. If several boxes
+ * share a varname the first one wins, matching find_box_by_varname().
+ *
+ * @param patcher The patcher to index
+ * @return varname → box
+ *
+ * @note This function must be called on the main thread (or via defer)
+ */
+std::unordered_map<std::string, t_object*> index_boxes_by_varname(t_object* patcher);
+
+/**
+ * @brief Create a patchcord and verify it exists
+ *
+ * Sends "connect" to the patcher, then looks the new patchline up with
+ * find_patchline() (the connect return value is unreliable).
+ *
+ * @return The new patchline, or nullptr if the connection was not made
+ *
+ * @note This function must be called on the main thread (or via defer)
+ */
+t_object* connect_boxes(t_object* patcher, t_object* src_box, long outlet, t_object* dst_box,
+                        long inlet);
+
+/**
+ * @brief Replace a patchline's midpoints
+ *
+ * @p coords holds x, y pairs. There is no setter for clearing midpoints, so
+ * an empty @p coords on a line that has some reconnects the patchline,
+ * keeping its hidden state and color. Does not mark the patcher dirty.
+ *
+ * @return The patchline (a new object when it was reconnected), or nullptr
+ *         if the reconnect failed
+ *
+ * @note This function must be called on the main thread (or via defer)
+ */
+t_object* set_patchline_midpoints(t_object* patcher, t_object* line,
+                                  const std::vector<double>& coords);
+
+/**
+ * @brief Create a list of patchcords in one pass
+ *
+ * Resolves varnames through @p boxes (see index_boxes_by_varname()) and
+ * appends one batch::item_success / item_error entry per attempted
+ * connection, stopping early once @p tally reports stopped(). Sends every
+ * connect first and verifies them all with one patchline scan (plus one
+ * before, to tell existing cords apart), so a batch costs O(E + k) rather
+ * than a scan per cord. When a cord fails verification under
+ * OnError::Stop, the cords this batch made after it are removed again.
+ * Does not mark the patcher dirty; the caller does that once.
+ *
+ * @return JSON array of per-connection results
+ *
+ * @note This function must be called on the main thread (or via defer)
+ */
+nlohmann::json connect_batch(t_object* patcher, const std::vector<batch::ConnectionSpec>& specs,
+                             const std::unordered_map<std::string, t_object*>& boxes,
+                             batch::Tally& tally);
+
 /**
  * @brief Convert a single Max atom to a JSON value
  *
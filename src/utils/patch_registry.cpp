@@ -12,17 +12,95 @@
 #include "tools/tool_common.h"
 
 #include <algorithm>
+#include <mutex>
 
 // Static member initialization
 std::vector<t_maxmcp*> PatchRegistry::patches_;
-std::mutex PatchRegistry::mutex_;
+std::unordered_map<std::string, t_maxmcp*> PatchRegistry::by_id_;
+std::unordered_map<t_maxmcp*, std::string> PatchRegistry::group_of_;
+std::string PatchRegistry::listing_cache_ = R"({"count":0,"patches":[]})";
+std::unordered_map<std::string, std::string> PatchRegistry::group_listing_cache_;
+std::shared_mutex PatchRegistry::mutex_;
+#ifdef MAXMCP_TEST_MODE
+std::unordered_map<t_maxmcp*, std::string> PatchRegistry::test_groups_;
+#endif
+
+std::string PatchRegistry::read_group(t_maxmcp* patch) {
+    // Get group name (may be empty)
+    std::string group_name = "";
+#ifndef MAXMCP_TEST_MODE
+    if (patch->group && patch->group->s_name) {
+        group_name = patch->group->s_name;
+    }
+#else
+    auto it = test_groups_.find(patch);
+    if (it != test_groups_.end()) {
+        group_name = it->second;
+    }
+#endif
+    return group_name;
+}
+
+json PatchRegistry::make_entry(t_maxmcp* patch, const std::string& group_name) {
+    json patch_entry = {{"patch_id", patch->patch_id},
+                        {"display_name", patch->display_name},
+                        {"patcher_name", patch->patcher_name}};
+
+    // Add group field if set
+    if (!group_name.empty()) {
+        patch_entry["group"] = group_name;
+    }
+
+    return patch_entry;
+}
+
+void PatchRegistry::rebuild_listing_cache() {
+    json patches = json::array();
+    std::unordered_map<std::string, json> group_listings;
+
+    for (auto* patch : patches_) {
+        const std::string& group_name = group_of_[patch];
+        json patch_entry = make_entry(patch, group_name);
+
+        if (!group_name.empty()) {
+            json& group_listing = group_listings[group_name];
+            if (group_listing.is_null()) {
+                group_listing = {{"patches", json::array()},
+                                 {"count", 0},
+                                 {"filter", {{"group", group_name}}}};
+            }
+            group_listing["patches"].push_back(patch_entry);
+        }
+
+        patches.push_back(std::move(patch_entry));
+    }
+
+    group_listing_cache_.clear();
+    for (auto& [group_name, group_listing] : group_listings) {
+        group_listing["count"] = group_listing["patches"].size();
+        group_listing_cache_.emplace(group_name, group_listing.dump());
+    }
+
+    // Build result (without wrapping in "result" key - that's handled by MCP server)
+    size_t count = patches.size();
+    listing_cache_ = json{{"patches", std::move(patches)}, {"count", count}}.dump();
+}
 
 void PatchRegistry::register_patch(t_maxmcp* patch) {
     if (!patch)
         return;
 
-    std::lock_guard<std::mutex> lock(mutex_);
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+
+    // Registering the same object twice is a no-op
+    if (group_of_.count(patch))
+        return;
+
     patches_.push_back(patch);
+    // Keep the first registration when two patches share an ID (e.g. same @alias)
+    by_id_.emplace(patch->patch_id, patch);
+    group_of_[patch] = read_group(patch);
+    rebuild_listing_cache();
 
 #ifndef MAXMCP_TEST_MODE
     std::string msg = "Patch registered: " + patch->patch_id;
@@ -34,123 +112,106 @@ void PatchRegistry::unregister_patch(t_maxmcp* patch) {
     if (!patch)
         return;
 
-    std::lock_guard<std::mutex> lock(mutex_);
+    std::unique_lock<std::shared_mutex> lock(mutex_);
 
     auto it = std::find(patches_.begin(), patches_.end(), patch);
-    if (it != patches_.end()) {
+    if (it == patches_.end())
+        return;
+
 #ifndef MAXMCP_TEST_MODE
-        std::string msg = "Patch unregistered: " + patch->patch_id;
-        ConsoleLogger::log(msg.c_str());
+    std::string msg = "Patch unregistered: " + patch->patch_id;
+    ConsoleLogger::log(msg.c_str());
 #endif
-        patches_.erase(it);
+    patches_.erase(it);
+    group_of_.erase(patch);
+
+    // If this patch owned the ID, hand it to the next patch registered with the same ID
+    auto id_it = by_id_.find(patch->patch_id);
+    if (id_it != by_id_.end() && id_it->second == patch) {
+        by_id_.erase(id_it);
+        for (auto* other : patches_) {
+            if (other->patch_id == patch->patch_id) {
+                by_id_.emplace(other->patch_id, other);
+                break;
+            }
+        }
     }
+
+    rebuild_listing_cache();
 }
 
-json PatchRegistry::list_patches(const std::string& group_filter) {
-    std::lock_guard<std::mutex> lock(mutex_);
+void PatchRegistry::update_group(t_maxmcp* patch) {
+    if (!patch)
+        return;
 
-#ifndef MAXMCP_TEST_MODE
-    // Debug: Log registry size
-    std::string debug_msg =
-        "PatchRegistry::list_patches() - Registry size: " + std::to_string(patches_.size());
-    ConsoleLogger::log(debug_msg.c_str());
-#endif
+    std::unique_lock<std::shared_mutex> lock(mutex_);
 
-    json patches = json::array();
+    auto it = group_of_.find(patch);
+    if (it == group_of_.end())
+        return;
 
-    for (auto* patch : patches_) {
-        if (!patch)
-            continue;
+    std::string group_name = read_group(patch);
+    if (it->second == group_name)
+        return;
 
-        // Get group name (may be empty)
-        std::string group_name = "";
-#ifndef MAXMCP_TEST_MODE
-        if (patch->group && patch->group->s_name) {
-            group_name = patch->group->s_name;
-        }
-#endif
+    // The group listings are rebuilt in registration order
+    it->second = group_name;
+    rebuild_listing_cache();
+}
 
-        // Apply group filter if specified
-        if (!group_filter.empty() && group_name != group_filter) {
-            continue;  // Skip patches that don't match the filter
-        }
+json PatchRegistry::list_patches(const std::string& group_filter) {
+    return json::parse(list_patches_text(group_filter));
+}
 
-        // Build patch entry
-        json patch_entry = {{"patch_id", patch->patch_id},
-                            {"display_name", patch->display_name},
-                            {"patcher_name", patch->patcher_name}};
+std::string PatchRegistry::list_patches_text(const std::string& group_filter) {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
 
-        // Add group field if set
-        if (!group_name.empty()) {
-            patch_entry["group"] = group_name;
-        }
+#ifndef MAXMCP_TEST_MODE
+    // Debug: Log registry size
+    std::string debug_msg =
+        "PatchRegistry::list_patches_text() - Registry size: " + std::to_string(patches_.size());
+    ConsoleLogger::log(debug_msg.c_str());
+#endif
 
-        patches.push_back(patch_entry);
+    if (group_filter.empty()) {
+        return listing_cache_;
     }
 
-    // Build result (without wrapping in "result" key - that's handled by MCP server)
-    json result = {{"patches", patches}, {"count", patches.size()}};
-
-    // Add filter info if filter was applied
-    if (!group_filter.empty()) {
-        result["filter"] = {{"group", group_filter}};
+    auto it = group_listing_cache_.find(group_filter);
+    if (it != group_listing_cache_.end()) {
+        return it->second;
     }
 
-    return result;
+    // Unknown group: empty listing, still reporting the filter that was applied
+    return json{{"patches", json::array()}, {"count", 0}, {"filter", {{"group", group_filter}}}}
+        .dump();
 }
 
 t_maxmcp* PatchRegistry::find_patch(const std::string& patch_id) {
-    std::lock_guard<std::mutex> lock(mutex_);
-
-    for (auto* patch : patches_) {
-        if (patch && patch->patch_id == patch_id) {
-            return patch;
-        }
-    }
+    std::shared_lock<std::shared_mutex> lock(mutex_);
 
-    return nullptr;
+    auto it = by_id_.find(patch_id);
+    return it != by_id_.end() ? it->second : nullptr;
 }
 
 json PatchRegistry::get_patch_info(const std::string& patch_id) {
-    std::lock_guard<std::mutex> lock(mutex_);
-
-    // Find patch
-    t_maxmcp* patch = nullptr;
-    for (auto* p : patches_) {
-        if (p && p->patch_id == patch_id) {
-            patch = p;
-            break;
-        }
-    }
+    std::shared_lock<std::shared_mutex> lock(mutex_);
 
-    if (!patch) {
+    auto it = by_id_.find(patch_id);
+    if (it == by_id_.end()) {
         return ToolCommon::patch_not_found_error(patch_id);
     }
 
-    // Get group name (may be empty)
-    std::string group_name = "";
-#ifndef MAXMCP_TEST_MODE
-    if (patch->group && patch->group->s_name) {
-        group_name = patch->group->s_name;
-    }
-#endif
-
-    // Build patch information
-    json patch_info = {{"patch_id", patch->patch_id},
-                       {"display_name", patch->display_name},
-                       {"patcher_name", patch->patcher_name},
-                       {"has_patcher_ref", patch->patcher != nullptr}};
-
-    // Add group field if set
-    if (!group_name.empty()) {
-        patch_info["group"] = group_name;
-    }
+    t_maxmcp* patch = it->second;
+    auto group_it = group_of_.find(patch);
+    json patch_info = make_entry(patch, group_it != group_of_.end() ? group_it->second : "");
+    patch_info["has_patcher_ref"] = patch->patcher != nullptr;
 
     return patch_info;
 }
 
 json PatchRegistry::get_frontmost_patch() {
-    std::lock_guard<std::mutex> lock(mutex_);
+    std::shared_lock<std::shared_mutex> lock(mutex_);
 
     // Check if any patches are registered
     if (patches_.empty()) {
@@ -167,23 +228,18 @@ json PatchRegistry::get_frontmost_patch() {
                                       "Invalid patch reference");
     }
 
-    // Get group name (may be empty)
-    std::string group_name = "";
-#ifndef MAXMCP_TEST_MODE
-    if (patch->group && patch->group->s_name) {
-        group_name = patch->group->s_name;
-    }
-#endif
+    auto group_it = group_of_.find(patch);
+    return make_entry(patch, group_it != group_of_.end() ? group_it->second : "");
+}
 
-    // Build patch information
-    json patch_info = {{"patch_id", patch->patch_id},
-                       {"display_name", patch->display_name},
-                       {"patcher_name", patch->patcher_name}};
+#ifdef MAXMCP_TEST_MODE
+void PatchRegistry::set_group_for_testing(t_maxmcp* patch, const std::string& group_name) {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
 
-    // Add group field if set
-    if (!group_name.empty()) {
-        patch_info["group"] = group_name;
+    if (group_name.empty()) {
+        test_groups_.erase(patch);
+    } else {
+        test_groups_[patch] = group_name;
     }
-
-    return patch_info;
 }
+#endif
@@ -10,8 +10,9 @@
 #ifndef PATCH_REGISTRY_H
 #define PATCH_REGISTRY_H
 
-#include <mutex>
+#include <shared_mutex>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include <nlohmann/json.hpp>
@@ -27,11 +28,29 @@ typedef struct _maxmcp t_maxmcp;
  *
  * Thread-safe singleton registry for tracking all active [maxmcp] instances.
  * Enables list_active_patches MCP tool.
+ *
+ * Patches are indexed by patch_id, and the list_patches() payloads (the full
+ * listing and one per group) are re-serialized on register/unregister and
+ * group changes and served as cached JSON text otherwise. Lookups take a shared lock, so
+ * concurrent readers never block each other; only those writes take the
+ * exclusive lock.
  */
 class PatchRegistry {
   private:
-    static std::vector<t_maxmcp*> patches_;
-    static std::mutex mutex_;
+    static std::vector<t_maxmcp*> patches_;  ///< Registration order
+    static std::unordered_map<std::string, t_maxmcp*> by_id_;
+    static std::unordered_map<t_maxmcp*, std::string> group_of_;
+    static std::string listing_cache_;  ///< Serialized full listing
+    static std::unordered_map<std::string, std::string> group_listing_cache_;
+    static std::shared_mutex mutex_;
+#ifdef MAXMCP_TEST_MODE
+    static std::unordered_map<t_maxmcp*, std::string> test_groups_;
+#endif
+
+    // Helpers below expect mutex_ to be held by the caller
+    static std::string read_group(t_maxmcp* patch);
+    static json make_entry(t_maxmcp* patch, const std::string& group_name);
+    static void rebuild_listing_cache();
 
   public:
     /**
@@ -52,6 +71,16 @@ class PatchRegistry {
      */
     static void unregister_patch(t_maxmcp* patch);
 
+    /**
+     * @brief Re-read a registered patch's group and refresh the indexes
+     *
+     * Thread-safe. Called when the @group attribute changes after
+     * registration. No-op for patches that are not registered.
+     *
+     * @param patch Pointer to maxmcp object
+     */
+    static void update_group(t_maxmcp* patch);
+
     /**
      * @brief List all active patches
      *
@@ -63,6 +92,17 @@ class PatchRegistry {
      */
     static json list_patches(const std::string& group_filter = "");
 
+    /**
+     * @brief List all active patches as serialized JSON
+     *
+     * Thread-safe. Same document as list_patches(), copied out of the cache
+     * as text so the tool path never rebuilds or deep-copies a JSON DOM.
+     *
+     * @param group_filter Optional group name to filter by (empty = all patches)
+     * @return JSON text of the object with patches array and count
+     */
+    static std::string list_patches_text(const std::string& group_filter = "");
+
     /**
      * @brief Find patch by ID
      *
@@ -92,6 +132,16 @@ class PatchRegistry {
      * @return JSON object with frontmost patch info, or error if no patches
      */
     static json get_frontmost_patch();
+
+#ifdef MAXMCP_TEST_MODE
+    /**
+     * @brief Set the group read_group() reports for @p patch (test mode only)
+     *
+     * Test builds have no @group attribute to read. Takes effect on the next
+     * register_patch() or update_group() for the patch; an empty name clears it.
+     */
+    static void set_group_for_testing(t_maxmcp* patch, const std::string& group_name);
+#endif
 };
 
 #endif  // PATCH_REGISTRY_H
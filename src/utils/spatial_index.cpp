@@ -0,0 +1,441 @@
+/**
+    @file spatial_index.cpp
+    MaxMCP - Uniform-grid spatial index over box rects
+
+    @ingroup maxmcp
+*/
+
+#include "spatial_index.h"
+
+#include "geometry_batch.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <iterator>
+#include <numeric>
+#include <unordered_set>
+
+namespace geometry {
+
+namespace {
+
+// A rect covering more cells than this is kept out of the grid and tested on
+// every query (e.g. a huge panel behind the whole patch).
+constexpr int64_t kMaxCellsPerRect = 256;
+
+constexpr double kMinCellSize = 16.0;
+constexpr double kMaxCellSize = 1024.0;
+
+bool contains_rect(const Rect& outer, const Rect& inner) {
+    return inner.origin.x >= outer.origin.x && inner.origin.y >= outer.origin.y &&
+           inner.right() <= outer.right() && inner.bottom() <= outer.bottom();
+}
+
+void sort_unique(std::vector<int>& ids) {
+    std::sort(ids.begin(), ids.end());
+    ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+}
+
+}  // namespace
+
+double point_rect_distance(const Point& p, const Rect& r) {
+    const double dx = std::max({r.origin.x - p.x, 0.0, p.x - r.right()});
+    const double dy = std::max({r.origin.y - p.y, 0.0, p.y - r.bottom()});
+    return std::hypot(dx, dy);
+}
+
+std::vector<std::pair<int, int>> overlapping_pairs(const std::vector<Rect>& rects, double eps) {
+    std::vector<std::pair<int, int>> pairs;
+    const size_t n = rects.size();
+    if (n < 2) {
+        return pairs;
+    }
+
+    // Pick the sweep axis: the expected number of candidates per rect grows
+    // with the mean extent along the axis over the span the rects cover.
+    double min_x = rects[0].origin.x, max_x = min_x, min_y = rects[0].origin.y, max_y = min_y;
+    double sum_w = 0.0, sum_h = 0.0;
+    for (const Rect& r : rects) {
+        min_x = std::min(min_x, r.origin.x);
+        max_x = std::max(max_x, r.origin.x);
+        min_y = std::min(min_y, r.origin.y);
+        max_y = std::max(max_y, r.origin.y);
+        sum_w += std::max(r.width, 0.0);
+        sum_h += std::max(r.height, 0.0);
+    }
+    // Cross-multiplied (sum_w / span_x > sum_h / span_y) to avoid dividing by a zero span
+    const bool sweep_y = sum_w * (max_y - min_y) > sum_h * (max_x - min_x);
+    auto start = [sweep_y](const Rect& r) { return sweep_y ? r.origin.y : r.origin.x; };
+    auto end = [sweep_y](const Rect& r) { return sweep_y ? r.bottom() : r.right(); };
+
+    std::vector<int> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](int a, int b) {
+        const double sa = start(rects[a]), sb = start(rects[b]);
+        return sa != sb ? sa < sb : a < b;
+    });
+
+    // The rects in sweep order, as columns for the batch overlap test
+    RectSoA sorted;
+    sorted.reserve(n);
+    for (int i : order) {
+        sorted.push_back(rects[i]);
+    }
+    const std::vector<double>& starts = sweep_y ? sorted.y0 : sorted.x0;
+
+    BitMask hits;
+    for (size_t p = 0; p < n; ++p) {
+        const Rect& a = rects[order[p]];
+        const double a_end = end(a);
+        // Same comparison as aabb_overlap's separation test on this axis: once a
+        // later rect starts at or past a's end (less eps), so do all after it.
+        size_t q_end = p + 1;
+        while (q_end < n && !(a_end <= starts[q_end] + eps)) {
+            ++q_end;
+        }
+        overlap_mask(a, sorted, p + 1, q_end, eps, hits);
+        for_each_set_bit(hits, [&](size_t k) {
+            const int b = order[p + 1 + k];
+            pairs.emplace_back(std::min(order[p], b), std::max(order[p], b));
+        });
+    }
+    std::sort(pairs.begin(), pairs.end());
+    return pairs;
+}
+
+namespace {
+
+// An axis-aligned segment reduced to its shared coordinate (x for vertical,
+// y for horizontal) and its span along the other axis.
+struct AxisSegment {
+    int64_t bucket;
+    double coord;
+    double lo;
+    double hi;
+    int index;
+};
+
+// Interval sweep over @p items, sorted by lo: the segments of @p bucket and of
+// the bucket after it. Pairs within the next bucket are left to its own sweep.
+void sweep_bucket(const std::vector<Segment>& segments, const std::vector<AxisSegment>& items,
+                  int64_t bucket, double eps, std::vector<AxisSegment>& active,
+                  std::vector<std::pair<int, int>>& pairs) {
+    active.clear();
+    for (const AxisSegment& s : items) {
+        // Items arrive by ascending lo, so an active span ending within eps of
+        // this start can no longer overlap anything that follows.
+        active.erase(std::remove_if(active.begin(), active.end(),
+                                    [&](const AxisSegment& a) { return a.hi - s.lo <= eps; }),
+                     active.end());
+        for (const AxisSegment& a : active) {
+            if ((a.bucket != bucket && s.bucket != bucket) || std::fabs(a.coord - s.coord) > eps) {
+                continue;
+            }
+            if (segments_overlap_collinear(segments[a.index], segments[s.index], eps)) {
+                pairs.emplace_back(std::min(a.index, s.index), std::max(a.index, s.index));
+            }
+        }
+        active.push_back(s);
+    }
+}
+
+}  // namespace
+
+std::vector<std::pair<int, int>> collinear_overlap_pairs(const std::vector<Segment>& segments,
+                                                         double eps) {
+    std::vector<std::pair<int, int>> pairs;
+    if (eps < 0.0) {
+        return pairs;  // nothing is axis-aligned within a negative tolerance
+    }
+
+    // Cells at least eps wide: two segments within eps of each other on the
+    // shared axis are then in the same or adjacent buckets.
+    const double cell = std::max(eps, 1.0);
+    std::vector<AxisSegment> vertical, horizontal;
+    for (size_t i = 0; i < segments.size(); ++i) {
+        const Segment& s = segments[i];
+        const bool is_vertical = std::fabs(s.a.x - s.b.x) <= eps;
+        const bool is_horizontal = std::fabs(s.a.y - s.b.y) <= eps;
+        if (is_vertical == is_horizontal) {
+            continue;  // diagonal, or so short its span cannot exceed eps
+        }
+        const double coord = is_vertical ? s.a.x : s.a.y;
+        const double lo = is_vertical ? std::min(s.a.y, s.b.y) : std::min(s.a.x, s.b.x);
+        const double hi = is_vertical ? std::max(s.a.y, s.b.y) : std::max(s.a.x, s.b.x);
+        if (hi - lo <= eps) {
+            continue;
+        }
+        const auto bucket = static_cast<int64_t>(std::floor(coord / cell));
+        (is_vertical ? vertical : horizontal)
+            .push_back({bucket, coord, lo, hi, static_cast<int>(i)});
+    }
+
+    std::vector<AxisSegment> merged, active;
+    for (std::vector<AxisSegment>* items : {&vertical, &horizontal}) {
+        std::sort(items->begin(), items->end(), [](const AxisSegment& a, const AxisSegment& b) {
+            if (a.bucket != b.bucket) {
+                return a.bucket < b.bucket;
+            }
+            return a.lo != b.lo ? a.lo < b.lo : a.index < b.index;
+        });
+
+        // Sweep each bucket together with the next one when that is adjacent
+        auto at = [items](size_t i) { return items->begin() + static_cast<std::ptrdiff_t>(i); };
+        auto bucket_end = [items](size_t i) {
+            size_t end = i;
+            while (end < items->size() && (*items)[end].bucket == (*items)[i].bucket) {
+                ++end;
+            }
+            return end;
+        };
+        for (size_t begin = 0; begin < items->size();) {
+            const int64_t bucket = (*items)[begin].bucket;
+            const size_t end = bucket_end(begin);
+            const size_t next_end =
+                (end < items->size() && (*items)[end].bucket == bucket + 1) ? bucket_end(end) : end;
+            merged.clear();
+            std::merge(at(begin), at(end), at(end), at(next_end), std::back_inserter(merged),
+                       [](const AxisSegment& a, const AxisSegment& b) { return a.lo < b.lo; });
+            sweep_bucket(segments, merged, bucket, eps, active, pairs);
+            begin = end;
+        }
+    }
+
+    std::sort(pairs.begin(), pairs.end());
+    return pairs;
+}
+
+GridIndex::GridIndex(double cell_size) : cell_(cell_size > 0.0 ? cell_size : kDefaultCellSize) {}
+
+double GridIndex::suggest_cell_size(const std::vector<Rect>& rects) {
+    if (rects.empty()) {
+        return kDefaultCellSize;
+    }
+    double sum = 0.0;
+    for (const Rect& r : rects) {
+        sum += std::max(r.width, r.height);
+    }
+    return std::clamp(sum / static_cast<double>(rects.size()), kMinCellSize, kMaxCellSize);
+}
+
+GridIndex GridIndex::build(const std::vector<Rect>& rects) {
+    GridIndex index(suggest_cell_size(rects));
+    index.entries_.reserve(rects.size());
+    for (size_t i = 0; i < rects.size(); ++i) {
+        index.insert(static_cast<int>(i), rects[i]);
+    }
+    return index;
+}
+
+int64_t GridIndex::cell_of(double v) const {
+    return static_cast<int64_t>(std::floor(v / cell_));
+}
+
+GridIndex::CellRange GridIndex::range_of(const Rect& r, double pad) const {
+    return {cell_of(r.origin.x - pad), cell_of(r.origin.y - pad),
+            cell_of(std::max(r.right(), r.origin.x) + pad),
+            cell_of(std::max(r.bottom(), r.origin.y) + pad)};
+}
+
+uint64_t GridIndex::key(int64_t cx, int64_t cy) {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(cx)) << 32) |
+           static_cast<uint32_t>(cy);
+}
+
+void GridIndex::insert(int id, const Rect& rect) {
+    remove(id);
+
+    Entry entry{rect, range_of(rect, 0.0), false};
+    entry.oversized = entry.cells.count() > kMaxCellsPerRect;
+    if (entry.oversized) {
+        oversized_.push_back(id);
+    } else {
+        for (int64_t cx = entry.cells.x0; cx <= entry.cells.x1; ++cx) {
+            for (int64_t cy = entry.cells.y0; cy <= entry.cells.y1; ++cy) {
+                cells_[key(cx, cy)].push_back(id);
+            }
+        }
+    }
+    entries_.emplace(id, entry);
+}
+
+bool GridIndex::remove(int id) {
+    auto it = entries_.find(id);
+    if (it == entries_.end()) {
+        return false;
+    }
+
+    auto erase_from = [id](std::vector<int>& ids) {
+        auto pos = std::find(ids.begin(), ids.end(), id);
+        if (pos != ids.end()) {
+            *pos = ids.back();
+            ids.pop_back();
+        }
+    };
+
+    const Entry& entry = it->second;
+    if (entry.oversized) {
+        erase_from(oversized_);
+    } else {
+        for (int64_t cx = entry.cells.x0; cx <= entry.cells.x1; ++cx) {
+            for (int64_t cy = entry.cells.y0; cy <= entry.cells.y1; ++cy) {
+                auto cell = cells_.find(key(cx, cy));
+                if (cell == cells_.end()) {
+                    continue;
+                }
+                erase_from(cell->second);
+                if (cell->second.empty()) {
+                    cells_.erase(cell);
+                }
+            }
+        }
+    }
+    entries_.erase(it);
+    return true;
+}
+
+template <typename Fn>
+void GridIndex::for_each_candidate(const CellRange& range, Fn fn) const {
+    // A region covering more cells than there are rects is cheaper to scan flat
+    if (range.count() > static_cast<int64_t>(entries_.size())) {
+        for (const auto& [id, entry] : entries_) {
+            if (!fn(id, entry.rect)) {
+                return;
+            }
+        }
+        return;
+    }
+
+    for (int id : oversized_) {
+        if (!fn(id, entries_.at(id).rect)) {
+            return;
+        }
+    }
+    for (int64_t cx = range.x0; cx <= range.x1; ++cx) {
+        for (int64_t cy = range.y0; cy <= range.y1; ++cy) {
+            auto cell = cells_.find(key(cx, cy));
+            if (cell == cells_.end()) {
+                continue;
+            }
+            for (int id : cell->second) {
+                if (!fn(id, entries_.at(id).rect)) {
+                    return;
+                }
+            }
+        }
+    }
+}
+
+std::vector<int> GridIndex::query(const Rect& region, double eps) const {
+    std::vector<int> ids;
+    for_each_candidate(range_of(region, std::max(0.0, -eps)), [&](int id, const Rect& rect) {
+        if (aabb_overlap(rect, region, eps)) {
+            ids.push_back(id);
+        }
+        return true;
+    });
+    sort_unique(ids);
+    return ids;
+}
+
+std::vector<int> GridIndex::query_contained(const Rect& region) const {
+    std::vector<int> ids;
+    for_each_candidate(range_of(region, 0.0), [&](int id, const Rect& rect) {
+        if (contains_rect(region, rect)) {
+            ids.push_back(id);
+        }
+        return true;
+    });
+    sort_unique(ids);
+    return ids;
+}
+
+bool GridIndex::any(const Rect& region, double eps) const {
+    bool found = false;
+    for_each_candidate(range_of(region, std::max(0.0, -eps)), [&](int, const Rect& rect) {
+        found = aabb_overlap(rect, region, eps);
+        return !found;
+    });
+    return found;
+}
+
+std::vector<std::pair<int, double>> GridIndex::nearest(const Point& p, size_t k) const {
+    std::vector<std::pair<int, double>> result;
+    if (k == 0 || entries_.empty()) {
+        return result;
+    }
+
+    std::unordered_set<int> seen;
+    auto consider = [&](int id) {
+        if (seen.insert(id).second) {
+            result.emplace_back(id, point_rect_distance(p, entries_.at(id).rect));
+        }
+    };
+    auto by_distance = [](const std::pair<int, double>& a, const std::pair<int, double>& b) {
+        return a.second != b.second ? a.second < b.second : a.first < b.first;
+    };
+
+    for (int id : oversized_) {
+        consider(id);
+    }
+
+    // Search square rings of cells outward from p's cell. Everything outside
+    // ring r is at least r cells away, so stop once k candidates are closer
+    // than that. If the rings have covered more cells than are occupied, the
+    // point is far from the patch and a flat scan is cheaper.
+    const int64_t cx = cell_of(p.x);
+    const int64_t cy = cell_of(p.y);
+    size_t visited = 0;
+    bool flat_scan = false;
+    for (int64_t r = 0;; ++r) {
+        auto visit = [&](int64_t x, int64_t y) {
+            ++visited;
+            auto cell = cells_.find(key(x, y));
+            if (cell != cells_.end()) {
+                for (int id : cell->second) {
+                    consider(id);
+                }
+            }
+        };
+        if (r == 0) {
+            visit(cx, cy);
+        } else {
+            for (int64_t x = cx - r; x <= cx + r; ++x) {
+                visit(x, cy - r);
+                visit(x, cy + r);
+            }
+            for (int64_t y = cy - r + 1; y <= cy + r - 1; ++y) {
+                visit(cx - r, y);
+                visit(cx + r, y);
+            }
+        }
+
+        if (result.size() >= k) {
+            std::nth_element(result.begin(), result.begin() + (k - 1), result.end(),
+                             by_distance);
+            if (result[k - 1].second < static_cast<double>(r) * cell_) {
+                break;
+            }
+        }
+        if (visited > cells_.size() + 8) {
+            flat_scan = true;
+            break;
+        }
+    }
+
+    if (flat_scan) {
+        for (const auto& [id, entry] : entries_) {
+            (void)entry;
+            consider(id);
+        }
+    }
+
+    std::sort(result.begin(), result.end(), by_distance);
+    if (result.size() > k) {
+        result.resize(k);
+    }
+    return result;
+}
+
+}  // namespace geometry
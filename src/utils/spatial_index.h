@@ -0,0 +1,158 @@
+/**
+    @file spatial_index.h
+    MaxMCP - Uniform-grid spatial index over box rects
+
+    Region queries, placement searches and "what is near here" questions
+    otherwise test every rect in the patch. GridIndex buckets rects into square
+    cells so a query only looks at the rects sharing a cell with it. Max boxes
+    are roughly uniform in size, which is the case a uniform grid handles
+    best; rects spanning a very large number of cells are kept in a separate
+    list and tested on every query instead of being rasterised.
+
+    Ids are caller-chosen (typically the box's patcher index) and results come
+    back in ascending id order, or by distance then id for nearest(), so
+    output does not depend on hash-table iteration order.
+
+    overlapping_pairs() and collinear_overlap_pairs() are the all-pairs
+    counterparts used by validate_layout's overlap and cord_cord checks.
+
+    The index only pays off when it is queried many times per build;
+    tests/bench/bench_spatial_index.cpp puts the build cost next to the
+    per-query savings.
+
+    @ingroup maxmcp
+*/
+
+#ifndef SPATIAL_INDEX_H
+#define SPATIAL_INDEX_H
+
+#include "geometry.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace geometry {
+
+class GridIndex {
+  public:
+    /// Default cell edge in px: a little larger than a typical object box.
+    static constexpr double kDefaultCellSize = 64.0;
+
+    explicit GridIndex(double cell_size = kDefaultCellSize);
+
+    /**
+     * @brief A cell size suited to @p rects: their mean larger extent,
+     *        clamped to [16, 1024] px. kDefaultCellSize when empty.
+     */
+    static double suggest_cell_size(const std::vector<Rect>& rects);
+
+    /// Build an index over @p rects with ids 0..n-1 (patcher order).
+    static GridIndex build(const std::vector<Rect>& rects);
+
+    /// Add @p rect under @p id, replacing any rect already stored for @p id.
+    void insert(int id, const Rect& rect);
+
+    /// Remove @p id. @return false if it was not present
+    bool remove(int id);
+
+    bool contains(int id) const {
+        return entries_.count(id) > 0;
+    }
+    size_t size() const {
+        return entries_.size();
+    }
+    double cell_size() const {
+        return cell_;
+    }
+
+    /**
+     * @brief Ids of the rects for which aabb_overlap(rect, @p region, @p eps)
+     *        holds, ascending.
+     *
+     * @p eps follows geometry::aabb_overlap: 0 is a strict overlap test (edges
+     * that only touch do not count); a negative value also reports rects
+     * within -eps of @p region (a clearance test, as in rects_conflict).
+     */
+    std::vector<int> query(const Rect& region, double eps = 0.0) const;
+
+    /// Ids of the rects lying entirely inside @p region, ascending.
+    std::vector<int> query_contained(const Rect& region) const;
+
+    /// True if query(@p region, @p eps) would be non-empty, without collecting ids.
+    bool any(const Rect& region, double eps = 0.0) const;
+
+    /**
+     * @brief Up to @p k ids nearest to @p p, by (distance, id).
+     *
+     * Distance is from the point to the rect (0 when @p p is inside it).
+     */
+    std::vector<std::pair<int, double>> nearest(const Point& p, size_t k = 1) const;
+
+  private:
+    struct CellRange {
+        int64_t x0, y0, x1, y1;
+
+        int64_t count() const {
+            return (x1 - x0 + 1) * (y1 - y0 + 1);
+        }
+    };
+
+    struct Entry {
+        Rect rect;
+        CellRange cells;
+        bool oversized;
+    };
+
+    int64_t cell_of(double v) const;
+    CellRange range_of(const Rect& r, double pad) const;
+    static uint64_t key(int64_t cx, int64_t cy);
+
+    // Calls fn(id, rect) for every candidate whose cells meet @p range; a
+    // candidate can be reported more than once.
+    template <typename Fn>
+    void for_each_candidate(const CellRange& range, Fn fn) const;
+
+    double cell_;
+    std::unordered_map<int, Entry> entries_;
+    std::unordered_map<uint64_t, std::vector<int>> cells_;
+    std::vector<int> oversized_;
+};
+
+/// Distance from @p p to the closest point of @p r (0 inside).
+double point_rect_distance(const Point& p, const Rect& r);
+
+/**
+ * @brief Every pair (i, j), i < j, for which aabb_overlap(rects[i], rects[j], @p eps)
+ *        holds, in ascending (i, j) order.
+ *
+ * Sort-and-sweep: rects are sorted along one axis and each one is only tested
+ * against the rects that start before it ends on that axis, so the cost is
+ * O(n log n + candidates) instead of n^2 / 2 tests. A rect's candidates are
+ * contiguous in sweep order, so they are tested in one overlap_mask() call.
+ * The axis is the one along which rects are spread thinner relative to their
+ * size, so a column of boxes sharing an x range is swept along y. The result
+ * is identical to the nested-loop scan it replaces.
+ */
+std::vector<std::pair<int, int>> overlapping_pairs(const std::vector<Rect>& rects, double eps);
+
+/**
+ * @brief Every pair (i, j), i < j, for which
+ *        segments_overlap_collinear(segments[i], segments[j], @p eps) holds, in
+ *        ascending (i, j) order.
+ *
+ * Only axis-aligned segments can overlap collinearly, so vertical and
+ * horizontal segments are bucketed separately by their shared coordinate
+ * (x or y, quantized to cells at least @p eps wide) and an interval sweep
+ * runs over each bucket together with the next one. Segments that are too
+ * short to overlap anything, or not axis-aligned, are dropped up front. Cost
+ * is O(S log S + candidates) instead of S^2 / 2 tests.
+ */
+std::vector<std::pair<int, int>> collinear_overlap_pairs(const std::vector<Segment>& segments,
+                                                         double eps);
+
+}  // namespace geometry
+
+#endif  // SPATIAL_INDEX_H
@@ -0,0 +1,72 @@
+/**
+    @file symbols.cpp
+    MaxMCP - Pre-interned Max symbols
+
+    @ingroup maxmcp
+*/
+
+#include "symbols.h"
+
+namespace Symbols {
+
+t_symbol* varname = nullptr;
+t_symbol* patching_position = nullptr;
+t_symbol* patching_rect = nullptr;
+t_symbol* presentation = nullptr;
+t_symbol* numinlets = nullptr;
+t_symbol* numoutlets = nullptr;
+t_symbol* embed = nullptr;
+t_symbol* text = nullptr;
+
+t_symbol* midpoints = nullptr;
+
+t_symbol* save = nullptr;
+
+t_symbol* connect = nullptr;
+t_symbol* bringtofront = nullptr;
+t_symbol* subpatcher = nullptr;
+t_symbol* gettext = nullptr;
+t_symbol* settext = nullptr;
+t_symbol* appendtodictionary = nullptr;
+
+#ifdef MAXMCP_TEST_MODE
+
+void init() {}
+
+#else
+
+void init() {
+    varname = gensym("varname");
+    patching_position = gensym("patching_position");
+    patching_rect = gensym("patching_rect");
+    presentation = gensym("presentation");
+    numinlets = gensym("numinlets");
+    numoutlets = gensym("numoutlets");
+    embed = gensym("embed");
+    text = gensym("text");
+
+    midpoints = gensym("midpoints");
+
+    save = gensym("save");
+
+    connect = gensym("connect");
+    bringtofront = gensym("bringtofront");
+    subpatcher = gensym("subpatcher");
+    gettext = gensym("gettext");
+    settext = gensym("settext");
+    appendtodictionary = gensym("appendtodictionary");
+}
+
+t_symbol* Cache::get(const std::string& name) {
+    auto it = symbols_.find(name);
+    if (it != symbols_.end()) {
+        return it->second;
+    }
+    t_symbol* sym = gensym(name.c_str());
+    symbols_.emplace(name, sym);
+    return sym;
+}
+
+#endif  // MAXMCP_TEST_MODE
+
+}  // namespace Symbols
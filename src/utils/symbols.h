@@ -0,0 +1,82 @@
+/**
+    @file symbols.h
+    MaxMCP - Pre-interned Max symbols
+
+    gensym() looks its argument up in Max's global symbol table on every call.
+    The attribute and method names used inside per-box and per-patchline loops
+    are interned once from ext_main() and read through the pointers below.
+
+    Names that are only known at run time (attribute names from a request)
+    go through a Symbols::Cache, so each distinct name is interned once per
+    request rather than once per box.
+
+    @ingroup maxmcp
+*/
+
+#ifndef SYMBOLS_H
+#define SYMBOLS_H
+
+#include <string>
+#include <unordered_map>
+
+#ifdef MAXMCP_TEST_MODE
+struct _symbol;
+typedef struct _symbol t_symbol;
+#else
+#include "ext.h"
+#endif
+
+namespace Symbols {
+
+// Box attributes
+extern t_symbol* varname;
+extern t_symbol* patching_position;
+extern t_symbol* patching_rect;
+extern t_symbol* presentation;
+extern t_symbol* numinlets;
+extern t_symbol* numoutlets;
+extern t_symbol* embed;
+extern t_symbol* text;
+
+// Patchline attributes
+extern t_symbol* midpoints;
+
+// Attribute meta-attributes
+extern t_symbol* save;
+
+// Methods
+extern t_symbol* connect;
+extern t_symbol* bringtofront;
+extern t_symbol* subpatcher;
+extern t_symbol* gettext;
+extern t_symbol* settext;
+extern t_symbol* appendtodictionary;
+
+/**
+ * @brief Intern every symbol above.
+ *
+ * Called once from ext_main(), before any tool can run.
+ */
+void init();
+
+#ifndef MAXMCP_TEST_MODE
+
+/**
+ * @brief Request-scoped gensym() memo for names only known at run time.
+ *
+ * Not thread-safe; create one per deferred callback.
+ */
+class Cache {
+  public:
+    /// gensym(@p name), going to Max's symbol table only the first time.
+    t_symbol* get(const std::string& name);
+
+  private:
+    std::unordered_map<std::string, t_symbol*> symbols_;
+};
+
+#endif  // MAXMCP_TEST_MODE
+
+}  // namespace Symbols
+
+#endif  // SYMBOLS_H
@@ -0,0 +1,105 @@
+/**
+    @file wire_codec.cpp
+    MaxMCP - Per-session wire encoding (JSON / CBOR / MessagePack)
+
+    @ingroup maxmcp
+*/
+
+#include "wire_codec.h"
+
+namespace wire {
+
+const char* encoding_name(Encoding encoding) {
+    switch (encoding) {
+    case Encoding::Cbor:
+        return "cbor";
+    case Encoding::MessagePack:
+        return "msgpack";
+    case Encoding::Json:
+    default:
+        return "json";
+    }
+}
+
+std::optional<Encoding> parse_encoding(const std::string& name) {
+    if (name == "json") {
+        return Encoding::Json;
+    }
+    if (name == "cbor") {
+        return Encoding::Cbor;
+    }
+    if (name == "msgpack") {
+        return Encoding::MessagePack;
+    }
+    return std::nullopt;
+}
+
+const char* subprotocol_name(Encoding encoding) {
+    switch (encoding) {
+    case Encoding::Cbor:
+        return "mcp.cbor";
+    case Encoding::MessagePack:
+        return "mcp.msgpack";
+    case Encoding::Json:
+    default:
+        return "mcp";
+    }
+}
+
+std::optional<Encoding> encoding_for_subprotocol(const std::string& subprotocol) {
+    for (Encoding encoding : {Encoding::Json, Encoding::Cbor, Encoding::MessagePack}) {
+        if (subprotocol == subprotocol_name(encoding)) {
+            return encoding;
+        }
+    }
+    return std::nullopt;
+}
+
+std::optional<Encoding> negotiate(const json& params) {
+    const json::json_pointer path("/capabilities/experimental/maxmcp/wireEncodings");
+    if (!params.is_object() || !params.contains(path) || !params[path].is_array()) {
+        return std::nullopt;
+    }
+
+    for (const auto& offered : params[path]) {
+        if (!offered.is_string()) {
+            continue;
+        }
+        if (auto encoding = parse_encoding(offered.get<std::string>())) {
+            return encoding;
+        }
+    }
+    return Encoding::Json;
+}
+
+std::string encode(const json& message, Encoding encoding) {
+    switch (encoding) {
+    case Encoding::Cbor: {
+        std::string out;
+        json::to_cbor(message, out);
+        return out;
+    }
+    case Encoding::MessagePack: {
+        std::string out;
+        json::to_msgpack(message, out);
+        return out;
+    }
+    case Encoding::Json:
+    default:
+        return message.dump();
+    }
+}
+
+json decode(const std::string& payload, Encoding encoding) {
+    switch (encoding) {
+    case Encoding::Cbor:
+        return json::from_cbor(payload);
+    case Encoding::MessagePack:
+        return json::from_msgpack(payload);
+    case Encoding::Json:
+    default:
+        return json::parse(payload);
+    }
+}
+
+}  // namespace wire
@@ -0,0 +1,77 @@
+/**
+    @file wire_codec.h
+    MaxMCP - Per-session wire encoding (JSON / CBOR / MessagePack)
+
+    MCP clients speak textual JSON and that stays the default. Tooling that
+    talks to the agent socket directly can opt into a binary encoding of the
+    same JSON-RPC messages, negotiated either way:
+
+      - WebSocket subprotocol: "mcp.cbor" or "mcp.msgpack" ("mcp" = JSON).
+      - initialize capability: params.capabilities.experimental.maxmcp
+        .wireEncodings = ["cbor", "msgpack", ...] in preference order. The
+        server answers with the chosen name under the same path as
+        "wireEncoding"; the initialize response itself is still JSON.
+
+    Framing rule on the socket: text frames are always JSON; binary frames use
+    the session's negotiated encoding; a response mirrors its request's frame
+    type. Encoding/decoding is nlohmann's to_cbor/from_cbor and
+    to_msgpack/from_msgpack.
+
+    Only the JSON-RPC envelope is binary. A tools/call result keeps MCP's
+    content shape, [{"type": "text", "text": "<JSON>"}], so the tool payload
+    is still a JSON string inside the CBOR/MessagePack message: the binary
+    encodings save the envelope's parse cost, not the payload's. Clients
+    parse content[0].text as JSON exactly as they would over a text frame.
+
+    @ingroup maxmcp
+*/
+
+#ifndef WIRE_CODEC_H
+#define WIRE_CODEC_H
+
+#include <optional>
+#include <string>
+
+#include <nlohmann/json.hpp>
+
+namespace wire {
+
+using json = nlohmann::json;
+
+enum class Encoding { Json, Cbor, MessagePack };
+
+/// Canonical name: "json", "cbor" or "msgpack".
+const char* encoding_name(Encoding encoding);
+
+/// Parse a canonical encoding name; std::nullopt if unknown.
+std::optional<Encoding> parse_encoding(const std::string& name);
+
+/// True for encodings carried in binary WebSocket frames.
+inline bool is_binary(Encoding encoding) {
+    return encoding != Encoding::Json;
+}
+
+/// WebSocket subprotocol name for an encoding ("mcp", "mcp.cbor", "mcp.msgpack").
+const char* subprotocol_name(Encoding encoding);
+
+/// Encoding selected by a WebSocket subprotocol name; std::nullopt if unknown.
+std::optional<Encoding> encoding_for_subprotocol(const std::string& subprotocol);
+
+/**
+ * @brief Pick the session encoding from initialize params.
+ *
+ * @param params initialize request params
+ * @return The first supported entry of wireEncodings, Json if the client
+ *         offered only unsupported names, std::nullopt if it offered nothing
+ */
+std::optional<Encoding> negotiate(const json& params);
+
+/// Serialize a message in @p encoding.
+std::string encode(const json& message, Encoding encoding);
+
+/// Parse a message in @p encoding. Throws nlohmann::json::exception on malformed input.
+json decode(const std::string& payload, Encoding encoding);
+
+}  // namespace wire
+
+#endif  // WIRE_CODEC_H
@@ -0,0 +1,158 @@
+/**
+    @file work_pool.cpp
+    MaxMCP - Small work-stealing thread pool for CPU-bound tool work
+
+    @ingroup maxmcp
+*/
+
+#include "work_pool.h"
+
+#include <algorithm>
+
+namespace parallel {
+
+WorkPool::WorkPool(size_t workers) {
+    for (size_t i = 0; i <= workers; ++i) {
+        queues_.push_back(std::make_unique<Queue>());
+    }
+    for (size_t i = 0; i < workers; ++i) {
+        workers_.emplace_back(&WorkPool::worker_loop, this, i);
+    }
+}
+
+WorkPool::~WorkPool() {
+    {
+        std::lock_guard<std::mutex> lock(state_mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    for (std::thread& worker : workers_) {
+        worker.join();
+    }
+}
+
+WorkPool& WorkPool::shared() {
+    static WorkPool pool([] {
+        const size_t hardware = std::thread::hardware_concurrency();
+        return std::min<size_t>(hardware > 1 ? hardware - 1 : 0, 7);
+    }());
+    return pool;
+}
+
+bool WorkPool::next_task(size_t self, size_t& index) {
+    // Own deque from the front, keeping each thread on its contiguous block
+    {
+        Queue& own = *queues_[self];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            index = own.tasks.front();
+            own.tasks.pop_front();
+            return true;
+        }
+    }
+    // Then steal from the back of the others, starting with the next one
+    for (size_t k = 1; k < queues_.size(); ++k) {
+        Queue& victim = *queues_[(self + k) % queues_.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            index = victim.tasks.back();
+            victim.tasks.pop_back();
+            return true;
+        }
+    }
+    return false;
+}
+
+void WorkPool::drain(size_t self, const std::function<void(size_t)>& task) {
+    size_t index = 0;
+    while (next_task(self, index)) {
+        std::exception_ptr error;
+        try {
+            task(index);
+        } catch (...) {
+            error = std::current_exception();
+        }
+        std::lock_guard<std::mutex> lock(state_mutex_);
+        if (error && !error_) {
+            error_ = error;
+        }
+        if (--pending_ == 0) {
+            done_.notify_all();
+        }
+    }
+}
+
+void WorkPool::worker_loop(size_t self) {
+    uint64_t seen = 0;
+    for (;;) {
+        const std::function<void(size_t)>* task = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(state_mutex_);
+            wake_.wait(lock, [&] { return stopping_ || (generation_ != seen && task_); });
+            if (stopping_) {
+                return;
+            }
+            seen = generation_;
+            task = task_;
+            ++busy_;
+        }
+        drain(self, *task);
+        {
+            std::lock_guard<std::mutex> lock(state_mutex_);
+            if (--busy_ == 0) {
+                done_.notify_all();
+            }
+        }
+    }
+}
+
+void WorkPool::run(size_t count, const std::function<void(size_t)>& task) {
+    if (count == 0) {
+        return;
+    }
+    if (workers_.empty() || count == 1) {
+        for (size_t i = 0; i < count; ++i) {
+            task(i);
+        }
+        return;
+    }
+
+    std::lock_guard<std::mutex> batch(run_mutex_);
+
+    // Deal contiguous blocks, one per participant
+    const size_t participants = queues_.size();
+    for (size_t p = 0; p < participants; ++p) {
+        Queue& queue = *queues_[p];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        for (size_t i = p * count / participants; i < (p + 1) * count / participants; ++i) {
+            queue.tasks.push_back(i);
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(state_mutex_);
+        task_ = &task;
+        pending_ = count;
+        error_ = nullptr;
+        ++generation_;
+    }
+    wake_.notify_all();
+
+    drain(participants - 1, task);
+
+    std::exception_ptr error;
+    {
+        // Wait for the last task and for every worker to leave the batch, so
+        // none still holds `task` once this returns.
+        std::unique_lock<std::mutex> lock(state_mutex_);
+        done_.wait(lock, [this] { return pending_ == 0 && busy_ == 0; });
+        task_ = nullptr;
+        error = error_;
+        error_ = nullptr;
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+}  // namespace parallel
@@ -0,0 +1,94 @@
+/**
+    @file work_pool.h
+    MaxMCP - Small work-stealing thread pool for CPU-bound tool work
+
+    Pure analyses (layout checks, graph analysis) run on the request thread
+    once the main-thread extraction is done. WorkPool spreads one batch of
+    independent tasks over a few worker threads: every participant starts
+    with a contiguous block of task indices in its own deque, pops from the
+    front, and steals from the back of the other deques when its own runs
+    dry, so uneven task costs still balance out.
+
+    The calling thread takes part in the batch, so a pool with no workers
+    simply runs the tasks inline, in order. Batches are serialized; a task
+    must not start another batch on the same pool.
+
+    Workers never touch Max objects, and neither may tasks: everything a task
+    reads has been copied out of the patcher on the main thread beforehand.
+
+    @ingroup maxmcp
+*/
+
+#ifndef WORK_POOL_H
+#define WORK_POOL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace parallel {
+
+class WorkPool {
+  public:
+    /// @param workers Threads besides the caller; 0 runs every batch inline.
+    explicit WorkPool(size_t workers);
+    ~WorkPool();
+
+    WorkPool(const WorkPool&) = delete;
+    WorkPool& operator=(const WorkPool&) = delete;
+
+    /// Threads a batch runs on, the caller included.
+    size_t concurrency() const {
+        return workers_.size() + 1;
+    }
+
+    /**
+     * @brief Run task(i) for every i in [0, @p count) and wait for all of them.
+     *
+     * Tasks may run in any order and on any participating thread. If tasks
+     * throw, the remaining tasks still run and the first exception is
+     * rethrown here.
+     */
+    void run(size_t count, const std::function<void(size_t)>& task);
+
+    /**
+     * @brief The process-wide pool: one worker per hardware thread beyond the
+     *        caller, at most 7, created on first use.
+     */
+    static WorkPool& shared();
+
+  private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<size_t> tasks;
+    };
+
+    bool next_task(size_t self, size_t& index);
+    void drain(size_t self, const std::function<void(size_t)>& task);
+    void worker_loop(size_t self);
+
+    std::vector<std::thread> workers_;
+    std::vector<std::unique_ptr<Queue>> queues_;  // one per worker, then the caller's
+
+    std::mutex run_mutex_;  // one batch at a time
+    std::mutex state_mutex_;
+    std::condition_variable wake_;
+    std::condition_variable done_;
+    const std::function<void(size_t)>* task_ = nullptr;
+    uint64_t generation_ = 0;
+    size_t pending_ = 0;  // tasks of the current batch not yet finished
+    size_t busy_ = 0;     // workers still inside the current batch
+    bool stopping_ = false;
+    std::exception_ptr error_;
+};
+
+}  // namespace parallel
+
+#endif  // WORK_POOL_H
@@ -16,7 +16,9 @@
 
 using json = nlohmann::json;
 
-// libwebsockets protocol definition
+// libwebsockets protocol definition. "mcp" (JSON) comes first so it is used
+// when the client requests no subprotocol; the others select a binary wire
+// encoding for the session (see utils/wire_codec.h).
 static const struct lws_protocols protocols[] = {
     {
         "mcp",  // Protocol name
@@ -24,6 +26,8 @@ static const struct lws_protocols protocols[] = {
         0,     // per_session_data_size
         4096,  // rx_buffer_size
     },
+    {"mcp.cbor", WebSocketServer::lws_callback, 0, 4096},
+    {"mcp.msgpack", WebSocketServer::lws_callback, 0, 4096},
     {nullptr, nullptr, 0, 0}  // Terminator
 };
 
@@ -221,7 +225,7 @@ bool WebSocketServer::send_to_client(const std::string& client_id, const std::st
     // Add message to client's send queue
     {
         std::lock_guard<std::mutex> send_lock(it->second->send_mutex);
-        it->second->send_queue.push(message);
+        it->second->send_queue.push(OutgoingMessage{message, false});
     }
 
     // Request callback on writable (triggers LWS_CALLBACK_SERVER_WRITEABLE)
@@ -371,6 +375,21 @@ int WebSocketServer::lws_callback(struct lws* wsi, enum lws_callback_reasons rea
         char ip[128];
         lws_get_peer_simple(wsi, ip, sizeof(ip));
         server->add_client(wsi, ip);
+
+        // The negotiated subprotocol selects the session's binary encoding
+        const struct lws_protocols* protocol = lws_get_protocol(wsi);
+        if (protocol && protocol->name) {
+            auto encoding = wire::encoding_for_subprotocol(protocol->name);
+            auto client = server->find_client_by_wsi(wsi);
+            if (encoding && client) {
+                client->encoding = *encoding;
+                if (wire::is_binary(*encoding)) {
+                    ConsoleLogger::log(("Client " + client->client_id + " wire encoding: " +
+                                        wire::encoding_name(*encoding))
+                                           .c_str());
+                }
+            }
+        }
         break;
     }
 
@@ -387,15 +406,22 @@ int WebSocketServer::lws_callback(struct lws* wsi, enum lws_callback_reasons rea
         }
 
         std::string message(static_cast<const char*>(in), len);
+        const bool binary = lws_frame_is_binary(wsi) != 0;
 
         // If sync callback is set, use synchronous response
         if (server->sync_message_callback_) {
             ConsoleLogger::log(("RECEIVE: Processing message from " + client->client_id + " (" +
                                 std::to_string(message.length()) + " bytes)")
                                    .c_str());
-            ConsoleLogger::log(("REQUEST: " + message.substr(0, 200)).c_str());
+            if (!binary) {
+                ConsoleLogger::log(("REQUEST: " + message.substr(0, 200)).c_str());
+            }
 
-            std::string response = server->sync_message_callback_(client->client_id, message);
+            // Responses mirror the request frame type, decided before the callback
+            // can switch the session encoding (initialize negotiation).
+            const bool binary_response = binary && wire::is_binary(client->encoding);
+            std::string response = server->sync_message_callback_(client->client_id, message,
+                                                                  binary, client->encoding);
 
             // Check if response is empty (for notifications, which should not receive a response)
             if (response.empty()) {
@@ -404,12 +430,14 @@ int WebSocketServer::lws_callback(struct lws* wsi, enum lws_callback_reasons rea
                 ConsoleLogger::log(("RECEIVE: Got response (" + std::to_string(response.length()) +
                                     " bytes), adding to send queue")
                                        .c_str());
-                ConsoleLogger::log(("RESPONSE PREVIEW: " + response.substr(0, 300)).c_str());
+                if (!binary_response) {
+                    ConsoleLogger::log(("RESPONSE PREVIEW: " + response.substr(0, 300)).c_str());
+                }
 
                 // Add response to client's send queue (direct access to avoid mutex nesting)
                 {
                     std::lock_guard<std::mutex> send_lock(client->send_mutex);
-                    client->send_queue.push(response);
+                    client->send_queue.push(OutgoingMessage{std::move(response), binary_response});
                     ConsoleLogger::log(
                         ("RECEIVE: Queue size now: " + std::to_string(client->send_queue.size()))
                             .c_str());
@@ -458,16 +486,16 @@ int WebSocketServer::lws_callback(struct lws* wsi, enum lws_callback_reasons rea
         }
 
         // Check if there are messages to send
-        std::string message;
+        OutgoingMessage message;
         bool has_message = false;
         {
             std::lock_guard<std::mutex> send_lock(client->send_mutex);
             if (!client->send_queue.empty()) {
-                message = client->send_queue.front();
+                message = std::move(client->send_queue.front());
                 client->send_queue.pop();
                 has_message = true;
                 ConsoleLogger::log(("WRITEABLE: Dequeued message for " + client->client_id + " (" +
-                                    std::to_string(message.length()) + " bytes)")
+                                    std::to_string(message.data.length()) + " bytes)")
                                        .c_str());
             }
         }
@@ -478,13 +506,14 @@ int WebSocketServer::lws_callback(struct lws* wsi, enum lws_callback_reasons rea
         }
 
         // Allocate buffer with LWS_PRE padding
-        size_t msg_len = message.length();
+        size_t msg_len = message.data.length();
         unsigned char* buf = new unsigned char[LWS_PRE + msg_len];
-        memcpy(buf + LWS_PRE, message.c_str(), msg_len);
+        memcpy(buf + LWS_PRE, message.data.data(), msg_len);
 
         // Write message
         ConsoleLogger::log(("WRITEABLE: Calling lws_write for " + client->client_id).c_str());
-        int written = lws_write(wsi, buf + LWS_PRE, msg_len, LWS_WRITE_TEXT);
+        int written = lws_write(wsi, buf + LWS_PRE, msg_len,
+                                message.binary ? LWS_WRITE_BINARY : LWS_WRITE_TEXT);
         delete[] buf;
 
         if (written < 0) {
@@ -9,6 +9,8 @@
 #ifndef WEBSOCKET_SERVER_H
 #define WEBSOCKET_SERVER_H
 
+#include "utils/wire_codec.h"
+
 #include <atomic>
 #include <functional>
 #include <libwebsockets.h>
@@ -19,6 +21,14 @@
 #include <thread>
 #include <vector>
 
+/**
+ * Outgoing message and its frame type
+ */
+struct OutgoingMessage {
+    std::string data;
+    bool binary;
+};
+
 /**
  * Client connection information
  */
@@ -27,8 +37,9 @@ struct ClientInfo {
     struct lws* wsi;
     std::string ip_address;
     bool authenticated;
-    std::queue<std::string> send_queue;  // Queue for outgoing messages
-    std::mutex send_mutex;               // Mutex for send_queue
+    wire::Encoding encoding = wire::Encoding::Json;  // Binary-frame encoding for this session
+    std::queue<OutgoingMessage> send_queue;          // Queue for outgoing messages
+    std::mutex send_mutex;                           // Mutex for send_queue
 };
 
 /**
@@ -123,12 +134,21 @@ class WebSocketServer {
         error_callback_ = callback;
     }
 
+    /**
+     * Synchronous message callback
+     * Arguments: client ID, frame payload, whether the frame was binary, and the
+     * session's wire encoding (which the callback may update on negotiation).
+     */
+    using SyncMessageCallback =
+        std::function<std::string(const std::string&, const std::string&, bool, wire::Encoding&)>;
+
     /**
      * Set synchronous message callback
-     * Called from LWS_CALLBACK_RECEIVE, should return response immediately
+     * Called from LWS_CALLBACK_RECEIVE, should return response immediately.
+     * The response is sent as a binary frame when the request was a binary
+     * frame in a binary session encoding, as a text frame otherwise.
      */
-    void set_sync_message_callback(
-        std::function<std::string(const std::string&, const std::string&)> callback) {
+    void set_sync_message_callback(SyncMessageCallback callback) {
         sync_message_callback_ = callback;
     }
 
@@ -162,7 +182,7 @@ class WebSocketServer {
     // Callbacks
     std::function<void(const std::string&, const std::string&)> message_callback_;
     std::function<void(const std::string&, const std::string&)> error_callback_;
-    std::function<std::string(const std::string&, const std::string&)> sync_message_callback_;
+    SyncMessageCallback sync_message_callback_;
 
     // Internal methods
     void service_loop();
@@ -0,0 +1,69 @@
+/**
+    @file bench_auto_layout.cpp
+    Microbenchmark: layered_layout (src/utils/auto_layout.h)
+
+    For seeded patch-like graphs of 500, 2000 and 5000 boxes (signal chains
+    that mostly feed boxes created shortly after them, with some fan-out,
+    long cords and a few feedback loops), times one whole layout and prints
+    its shape: layers, dummy nodes, reversed cords, and the crossings before
+    and after ordering.
+*/
+
+#include "auto_layout.h"
+#include "bench_common.h"
+
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using geometry::LayeredEdge;
+using geometry::LayeredNode;
+
+namespace {
+
+void patch_like(size_t n, std::mt19937& rng, std::vector<LayeredNode>& nodes,
+                std::vector<LayeredEdge>& edges) {
+    std::uniform_real_distribution<double> pos(0.0, 3000.0);
+    std::uniform_real_distribution<double> width(30.0, 160.0);
+    std::uniform_int_distribution<int> nubs(1, 4);
+    std::uniform_int_distribution<int> ahead(1, 12);
+    std::uniform_int_distribution<int> percent(0, 99);
+    for (size_t i = 0; i < n; ++i) {
+        nodes.push_back({{pos(rng), pos(rng), width(rng), 22.0}, nubs(rng), nubs(rng), true,
+                         "newobj"});
+    }
+    for (size_t i = 0; i + 1 < n; ++i) {
+        const int fan = percent(rng) < 30 ? 2 : 1;
+        for (int k = 0; k < fan; ++k) {
+            const size_t dst = std::min(n - 1, i + static_cast<size_t>(ahead(rng)));
+            edges.push_back({static_cast<int>(i), k, static_cast<int>(dst), 0});
+        }
+        if (percent(rng) < 3 && i > 20) {
+            edges.push_back({static_cast<int>(i), 0, static_cast<int>(i - 20), 1});
+        }
+    }
+}
+
+}  // namespace
+
+int main() {
+    for (size_t n : {500u, 2000u, 5000u}) {
+        std::mt19937 rng(static_cast<unsigned>(n));
+        std::vector<LayeredNode> nodes;
+        std::vector<LayeredEdge> edges;
+        patch_like(n, rng, nodes, edges);
+
+        geometry::LayeredLayoutResult result;
+        const double ns = bench::best_of(3, [&] {
+            result = geometry::layered_layout(nodes, edges);
+            bench::keep(result.crossings);
+        });
+        std::printf("== %zu boxes, %zu cords: %d layers, %zu dummies, %d reversed, "
+                    "crossings %zu -> %zu ==\n",
+                    n, edges.size(), result.layer_count, result.dummy_nodes,
+                    result.reversed_edges, result.initial_crossings, result.crossings);
+        std::printf("%-40s n=%-8zu %10.2f ms\n", "layered_layout (whole patch)", n, ns / 1e6);
+        bench::report("layered_layout (per box)", n, ns);
+    }
+    return 0;
+}
@@ -0,0 +1,48 @@
+/**
+    @file bench_common.h
+    Minimal timing helpers shared by the microbenchmarks in tests/bench.
+
+    Each benchmark is a plain executable that prints one line per case:
+    best-of-N wall time per iteration, so results are comparable between a
+    "before" and "after" variant of the same loop run back to back.
+*/
+
+#ifndef BENCH_COMMON_H
+#define BENCH_COMMON_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <limits>
+
+namespace bench {
+
+/// Defeat dead-code elimination of a benchmark result.
+template <typename T>
+inline void keep(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+/**
+ * @brief Run @p fn @p repeats times and return the fastest run in nanoseconds.
+ */
+template <typename Fn>
+double best_of(int repeats, Fn&& fn) {
+    double best = std::numeric_limits<double>::max();
+    for (int r = 0; r < repeats; ++r) {
+        auto start = std::chrono::steady_clock::now();
+        fn();
+        auto end = std::chrono::steady_clock::now();
+        best = std::min(best, std::chrono::duration<double, std::nano>(end - start).count());
+    }
+    return best;
+}
+
+/// Print "<name>  <n>  <per-item ns>" for a run over @p n items.
+inline void report(const char* name, size_t n, double total_ns) {
+    std::printf("%-40s n=%-8zu %10.2f ns/item\n", name, n, total_ns / static_cast<double>(n));
+}
+
+}  // namespace bench
+
+#endif  // BENCH_COMMON_H
@@ -0,0 +1,79 @@
+/**
+    @file bench_cord_router.cpp
+    Microbenchmark: CordRouter (src/utils/cord_router.h)
+
+    For seeded patch-like layouts of 500, 2000 and 5000 boxes (rows of boxes
+    with jitter, about 80 px apart vertically), routes one cord per box to a
+    box a few rows below it, or now and then back up, and prints the time per
+    cord, how many could be routed and their average number of bends.
+*/
+
+#include "bench_common.h"
+#include "cord_router.h"
+
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using geometry::CordRoute;
+using geometry::CordRouter;
+using geometry::Point;
+using geometry::Rect;
+
+namespace {
+
+std::vector<Rect> patch_like(size_t n, std::mt19937& rng) {
+    const size_t per_row = static_cast<size_t>(std::sqrt(static_cast<double>(n)));
+    std::uniform_real_distribution<double> jitter(0.0, 40.0);
+    std::uniform_real_distribution<double> width(30.0, 120.0);
+    std::vector<Rect> boxes;
+    for (size_t i = 0; i < n; ++i) {
+        const double x = static_cast<double>(i % per_row) * 180.0 + jitter(rng);
+        const double y = static_cast<double>(i / per_row) * 80.0 + jitter(rng);
+        boxes.push_back({x, y, width(rng), 22.0});
+    }
+    return boxes;
+}
+
+}  // namespace
+
+int main() {
+    for (size_t n : {500u, 2000u, 5000u}) {
+        std::mt19937 rng(static_cast<unsigned>(n));
+        const std::vector<Rect> boxes = patch_like(n, rng);
+        const size_t per_row = static_cast<size_t>(std::sqrt(static_cast<double>(n)));
+
+        // One cord per box, mostly 1-3 rows down and a little sideways
+        std::uniform_int_distribution<int> rows(-1, 3);
+        std::uniform_int_distribution<int> cols(-2, 2);
+        std::vector<std::pair<int, int>> cords;
+        for (size_t i = 0; i < n; ++i) {
+            const long col = static_cast<long>(i % per_row) + cols(rng);
+            const long row = static_cast<long>(i / per_row) + rows(rng);
+            const long dst = row * static_cast<long>(per_row) + col;
+            if (col >= 0 && col < static_cast<long>(per_row) && row >= 0 &&
+                dst < static_cast<long>(n) && dst != static_cast<long>(i)) {
+                cords.emplace_back(static_cast<int>(i), static_cast<int>(dst));
+            }
+        }
+
+        const CordRouter router(boxes);
+        size_t routed = 0, bends = 0;
+        const double ns = bench::best_of(3, [&] {
+            routed = bends = 0;
+            for (const auto& [src, dst] : cords) {
+                const Point start{boxes[src].origin.x + 9.5, boxes[src].bottom()};
+                const Point end{boxes[dst].origin.x + 9.5, boxes[dst].origin.y};
+                const CordRoute route = router.route(start, end, src, dst);
+                routed += route.ok;
+                bends += route.midpoints.size();
+                bench::keep(route.length);
+            }
+        });
+        std::printf("== %zu boxes: %zu of %zu cords routed, %.2f bends on average ==\n", n,
+                    routed, cords.size(), static_cast<double>(bends) / std::max<size_t>(routed, 1));
+        bench::report("CordRouter::route (per cord)", cords.size(), ns);
+    }
+    return 0;
+}
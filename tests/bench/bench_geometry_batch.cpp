@@ -0,0 +1,139 @@
+/**
+    @file bench_geometry_batch.cpp
+    Microbenchmark: batch geometry predicates (src/utils/geometry_batch.h)
+
+    One rect or segment against 16 to 4096 seeded rects, per kernel level the
+    CPU supports, next to the one-at-a-time predicates of geometry.h over the
+    same rects stored as a std::vector<Rect>. The small sizes are the length
+    of a typical sweep-and-prune candidate run; the large ones show the
+    kernels' throughput.
+*/
+
+#include "bench_common.h"
+#include "geometry_batch.h"
+
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using geometry::BitMask;
+using geometry::Rect;
+using geometry::RectSoA;
+using geometry::Segment;
+using geometry::SegmentSoA;
+using geometry::SimdLevel;
+
+namespace {
+
+constexpr int kQueries = 256;
+
+std::vector<SimdLevel> levels() {
+    std::vector<SimdLevel> all{SimdLevel::Scalar};
+    for (SimdLevel level : {SimdLevel::Sse2, SimdLevel::Avx2}) {
+        if (geometry::simd_level() >= level) {
+            all.push_back(level);
+        }
+    }
+    return all;
+}
+
+void run(size_t n, std::mt19937& rng) {
+    std::uniform_real_distribution<double> pos(0.0, 2000.0);
+    std::uniform_real_distribution<double> size(20.0, 160.0);
+    std::vector<Rect> rects;
+    std::vector<Segment> segments;
+    for (size_t i = 0; i < n; ++i) {
+        rects.push_back({pos(rng), pos(rng), size(rng), size(rng) / 4.0});
+        segments.push_back({{pos(rng), pos(rng)}, {pos(rng), pos(rng)}});
+    }
+    std::vector<Rect> queries;
+    std::vector<Segment> query_segments;
+    for (int q = 0; q < kQueries; ++q) {
+        queries.push_back({pos(rng), pos(rng), 400.0, 300.0});
+        query_segments.push_back({{pos(rng), pos(rng)}, {pos(rng), pos(rng)}});
+    }
+    const RectSoA soa = RectSoA::from(rects);
+    SegmentSoA segment_soa;
+    for (const Segment& s : segments) {
+        segment_soa.push_back(s);
+    }
+    const size_t tests = n * kQueries;
+    const int repeats = 5;
+
+    std::printf("== %zu rects ==\n", n);
+    double ns = bench::best_of(repeats, [&] {
+        long hits = 0;
+        for (const Rect& q : queries) {
+            for (const Rect& r : rects) {
+                hits += geometry::aabb_overlap(q, r, 2.0) ? 1 : 0;
+            }
+        }
+        bench::keep(hits);
+    });
+    bench::report("aabb_overlap, one at a time (per test)", tests, ns);
+    BitMask mask;
+    for (SimdLevel level : levels()) {
+        ns = bench::best_of(repeats, [&] {
+            for (const Rect& q : queries) {
+                geometry::overlap_mask(q, soa, 0, n, 2.0, mask, level);
+                bench::keep(mask[0]);
+            }
+        });
+        char name[64];
+        std::snprintf(name, sizeof(name), "overlap_mask, %s (per test)",
+                      geometry::simd_level_name(level));
+        bench::report(name, tests, ns);
+    }
+
+    ns = bench::best_of(repeats, [&] {
+        long hits = 0;
+        for (const Segment& s : query_segments) {
+            for (const Rect& r : rects) {
+                hits += geometry::segment_intersects_rect(s, r, 2.0, nullptr) ? 1 : 0;
+            }
+        }
+        bench::keep(hits);
+    });
+    bench::report("segment_intersects_rect, one at a time", tests, ns);
+    for (SimdLevel level : levels()) {
+        ns = bench::best_of(repeats, [&] {
+            for (const Segment& s : query_segments) {
+                geometry::segment_rect_mask(s, soa, 0, n, 2.0, mask, level);
+                bench::keep(mask[0]);
+            }
+        });
+        char name[64];
+        std::snprintf(name, sizeof(name), "segment_rect_mask, %s",
+                      geometry::simd_level_name(level));
+        bench::report(name, tests, ns);
+    }
+
+    ns = bench::best_of(repeats, [&] {
+        long hits = 0;
+        for (const Segment& s : segments) {
+            hits += geometry::segment_is_upward(s, 2.0) ? 1 : 0;
+        }
+        bench::keep(hits);
+    });
+    bench::report("segment_is_upward, one at a time", n, ns);
+    for (SimdLevel level : levels()) {
+        ns = bench::best_of(repeats, [&] {
+            geometry::upward_mask(segment_soa, 0, n, 2.0, mask, level);
+            bench::keep(mask[0]);
+        });
+        char name[64];
+        std::snprintf(name, sizeof(name), "upward_mask, %s", geometry::simd_level_name(level));
+        bench::report(name, n, ns);
+    }
+    std::printf("\n");
+}
+
+}  // namespace
+
+int main() {
+    std::mt19937 rng(99);
+    for (size_t n : {16, 256, 4096}) {
+        run(n, rng);
+    }
+    return 0;
+}
@@ -0,0 +1,274 @@
+/**
+    @file bench_layout_checks.cpp
+    Microbenchmark: validate_layout checks (src/tools/layout_checks.cpp) at scale
+
+    Seeded patches of 1k to 20k objects at constant density, laid out either
+    scattered or in tidy columns (the shape real patches tend to have). For
+    the overlap check, times the nested all-pairs scan the check used to run
+    against geometry::overlapping_pairs, and run_layout_checks end to end
+    with only the overlap check enabled. The cord_object check gets one local
+    cord per object (a third of them folded) and is timed against the full
+    segment x object scan it used to run, and the cord_cord check on the same
+    cords against its all-segment-pairs scan. Per-item time should stay roughly
+    flat for the accelerated versions while the full scans grow linearly
+    with n.
+
+    Every check then runs together on pools of 1 to 8 threads; the speedup
+    column is relative to the single-thread run and is bounded by the cores
+    the machine actually has.
+
+    Finally, LayoutCheckCache: a full run_layout_checks against the cache's
+    first update and against an update after one box moved and one cord was
+    rerouted, the common case of an agent re-validating after a small edit.
+    Both include serializing the report, as validate_layout does.
+*/
+
+#include "bench_common.h"
+#include "json_writer.h"
+#include "spatial_index.h"
+#include "tools/layout_checks.h"
+#include "work_pool.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <set>
+#include <utility>
+#include <vector>
+
+using geometry::Rect;
+using LayoutTools::LayoutCheckOptions;
+using LayoutTools::LayoutCord;
+using LayoutTools::LayoutObject;
+
+namespace {
+
+std::vector<Rect> scattered_patch(size_t n, std::mt19937& rng) {
+    const double side = 4000.0 * std::sqrt(static_cast<double>(n) / 1000.0);
+    std::uniform_real_distribution<double> pos(0.0, side);
+    std::uniform_real_distribution<double> width(30.0, 160.0);
+    std::uniform_real_distribution<double> height(20.0, 40.0);
+    std::vector<Rect> rects;
+    rects.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        rects.push_back({pos(rng), pos(rng), width(rng), height(rng)});
+    }
+    return rects;
+}
+
+// Columns of 40 boxes, 24 px apart vertically, with enough jitter that some
+// neighbours overlap.
+std::vector<Rect> column_patch(size_t n, std::mt19937& rng) {
+    std::uniform_real_distribution<double> jitter(0.0, 10.0);
+    std::vector<Rect> rects;
+    rects.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        const double column = static_cast<double>(i / 40);
+        const double row = static_cast<double>(i % 40);
+        rects.push_back({column * 200.0 + jitter(rng), row * 24.0 + jitter(rng), 120.0, 22.0});
+    }
+    return rects;
+}
+
+long nested_overlaps(const std::vector<Rect>& rects, double eps) {
+    long hits = 0;
+    for (size_t i = 0; i < rects.size(); ++i) {
+        for (size_t j = i + 1; j < rects.size(); ++j) {
+            hits += geometry::aabb_overlap(rects[i], rects[j], eps) ? 1 : 0;
+        }
+    }
+    return hits;
+}
+
+// One cord per object, from its bottom edge to a point a little below it.
+std::vector<LayoutCord> local_cords(const std::vector<Rect>& rects, std::mt19937& rng) {
+    std::uniform_real_distribution<double> dx(-150.0, 150.0);
+    std::uniform_real_distribution<double> dy(40.0, 300.0);
+    std::vector<LayoutCord> cords;
+    cords.reserve(rects.size());
+    for (size_t i = 0; i < rects.size(); ++i) {
+        LayoutCord cord{static_cast<int>(i), "", 0, -1, "", 0, {}, {}, {}};
+        cord.start = {rects[i].origin.x + 5.0, rects[i].bottom()};
+        cord.end = {cord.start.x + dx(rng), cord.start.y + dy(rng)};
+        if (i % 3 == 0) {
+            const double fold_y = cord.start.y + 15.0;
+            cord.midpoints = {{cord.start.x, fold_y}, {cord.end.x, fold_y}};
+        }
+        cords.push_back(std::move(cord));
+    }
+    return cords;
+}
+
+long full_scan_cord_object(const std::vector<LayoutObject>& objects,
+                           const std::vector<LayoutCord>& cords, double eps) {
+    long hits = 0;
+    for (const LayoutCord& cord : cords) {
+        std::set<int> flagged;
+        for (const geometry::Segment& seg : cord.segments()) {
+            for (const LayoutObject& obj : objects) {
+                if (obj.id == cord.src_id || obj.id == cord.dst_id || flagged.count(obj.id)) {
+                    continue;
+                }
+                geometry::Point entry{0.0, 0.0};
+                if (geometry::segment_intersects_rect(seg, obj.rect, eps, &entry)) {
+                    flagged.insert(obj.id);
+                    ++hits;
+                }
+            }
+        }
+    }
+    return hits;
+}
+
+long full_scan_cord_cord(const std::vector<LayoutCord>& cords, double eps) {
+    std::vector<std::pair<size_t, geometry::Segment>> segs;
+    for (size_t c = 0; c < cords.size(); ++c) {
+        for (const geometry::Segment& seg : cords[c].segments()) {
+            segs.emplace_back(c, seg);
+        }
+    }
+    std::set<std::pair<size_t, size_t>> flagged;
+    for (size_t a = 0; a < segs.size(); ++a) {
+        for (size_t b = a + 1; b < segs.size(); ++b) {
+            if (segs[a].first != segs[b].first &&
+                geometry::segments_overlap_collinear(segs[a].second, segs[b].second, eps)) {
+                flagged.insert(std::minmax(segs[a].first, segs[b].first));
+            }
+        }
+    }
+    return static_cast<long>(flagged.size());
+}
+
+std::vector<LayoutObject> to_objects(const std::vector<Rect>& rects) {
+    std::vector<LayoutObject> objects;
+    objects.reserve(rects.size());
+    for (size_t i = 0; i < rects.size(); ++i) {
+        objects.push_back({static_cast<int>(i), "", "newobj", rects[i], false});
+    }
+    return objects;
+}
+
+void run_cord_object(const std::vector<Rect>& rects, std::mt19937& rng) {
+    const size_t n = rects.size();
+    std::vector<LayoutObject> objects = to_objects(rects);
+    std::vector<LayoutCord> cords = local_cords(rects, rng);
+    LayoutCheckOptions options;
+    options.check_upward = options.check_overlap = options.check_cord_cord = false;
+
+    const int repeats = n > 5000 ? 1 : 3;
+    double full = bench::best_of(
+        repeats, [&] { bench::keep(full_scan_cord_object(objects, cords, options.epsilon)); });
+    double check = bench::best_of(
+        3, [&] { bench::keep(LayoutTools::run_layout_checks(objects, cords, options).size()); });
+    bench::report("cord_object, full scan (per cord)", n, full);
+    bench::report("cord_object, run_layout_checks (per cord)", n, check);
+
+    options.check_cord_object = false;
+    options.check_cord_cord = true;
+    full = bench::best_of(repeats,
+                          [&] { bench::keep(full_scan_cord_cord(cords, options.epsilon)); });
+    check = bench::best_of(
+        3, [&] { bench::keep(LayoutTools::run_layout_checks(objects, cords, options).size()); });
+    bench::report("cord_cord, full scan (per cord)", n, full);
+    bench::report("cord_cord, run_layout_checks (per cord)", n, check);
+}
+
+void run_overlap(const char* layout, const std::vector<Rect>& rects) {
+    const size_t n = rects.size();
+    std::vector<LayoutObject> objects = to_objects(rects);
+    LayoutCheckOptions options;
+    options.check_upward = options.check_cord_object = options.check_cord_cord = false;
+
+    std::printf("== %s, %zu objects (%zu overlapping pairs) ==\n", layout, n,
+                geometry::overlapping_pairs(rects, options.epsilon).size());
+    const int repeats = n > 5000 ? 1 : 3;
+    double nested = bench::best_of(repeats, [&] { bench::keep(nested_overlaps(rects, 2.0)); });
+    double sweep = bench::best_of(
+        5, [&] { bench::keep(geometry::overlapping_pairs(rects, options.epsilon).size()); });
+    double check = bench::best_of(
+        5, [&] { bench::keep(LayoutTools::run_layout_checks(objects, {}, options).size()); });
+    bench::report("overlap pairs, nested scan (per object)", n, nested);
+    bench::report("overlap pairs, sweep (per object)", n, sweep);
+    bench::report("run_layout_checks overlap (per object)", n, check);
+}
+
+void run_scaling(const std::vector<Rect>& rects, std::mt19937& rng) {
+    const size_t n = rects.size();
+    std::vector<LayoutObject> objects = to_objects(rects);
+    std::vector<LayoutCord> cords = local_cords(rects, rng);
+
+    double single = 0.0;
+    for (size_t workers : {0, 1, 3, 7}) {
+        parallel::WorkPool pool(workers);
+        const double ns = bench::best_of(5, [&] {
+            bench::keep(
+                LayoutTools::run_layout_checks(objects, cords, LayoutCheckOptions{}, pool).size());
+        });
+        single = workers == 0 ? ns : single;
+        char name[64];
+        std::snprintf(name, sizeof(name), "all checks, %zu thread(s) (per object)", workers + 1);
+        bench::report(name, n, ns);
+        std::printf("%40s speedup %.2fx\n", "", single / ns);
+    }
+}
+
+void run_incremental(const std::vector<Rect>& rects, std::mt19937& rng) {
+    const size_t n = rects.size();
+    LayoutTools::LayoutSnapshot snapshot;
+    snapshot.objects = to_objects(rects);
+    snapshot.cords = local_cords(rects, rng);
+    for (size_t i = 0; i < n; ++i) {
+        snapshot.object_keys.push_back(i);
+        snapshot.cord_keys.push_back(n + i);
+    }
+    const LayoutCheckOptions options;
+
+    // Both as validate_layout sends them: serialized
+    auto update = [&](LayoutTools::LayoutCheckCache& cache) {
+        jsonwriter::JsonWriter writer;
+        writer.begin_object();
+        cache.update(snapshot, options, false, writer);
+        writer.end_object();
+        return writer.str().size();
+    };
+    const double full = bench::best_of(3, [&] {
+        bench::keep(LayoutTools::run_layout_checks(snapshot.objects, snapshot.cords, options)
+                        .dump()
+                        .size());
+    });
+    const double cold = bench::best_of(3, [&] {
+        LayoutTools::LayoutCheckCache cache;
+        bench::keep(update(cache));
+    });
+    LayoutTools::LayoutCheckCache cache;
+    update(cache);
+    size_t edit = 0;
+    const double warm = bench::best_of(5, [&] {
+        snapshot.objects[edit % n].rect.origin.x += 7.0;
+        snapshot.cords[(edit * 7) % n].end.y += 5.0;
+        ++edit;
+        bench::keep(update(cache));
+    });
+    bench::report("all checks, run_layout_checks (per object)", n, full);
+    bench::report("all checks, cache first update (per object)", n, cold);
+    bench::report("all checks, cache after one edit (per object)", n, warm);
+}
+
+}  // namespace
+
+int main() {
+    for (size_t n : {1000, 5000, 20000}) {
+        std::mt19937 rng(1234);
+        std::vector<Rect> scattered = scattered_patch(n, rng);
+        std::vector<Rect> columns = column_patch(n, rng);
+        run_overlap("scattered", scattered);
+        run_cord_object(scattered, rng);
+        run_overlap("columns", columns);
+        run_cord_object(columns, rng);
+        run_scaling(scattered, rng);
+        run_incremental(scattered, rng);
+        std::printf("\n");
+    }
+    return 0;
+}
@@ -0,0 +1,149 @@
+/**
+    @file bench_spatial_index.cpp
+    Microbenchmark: GridIndex (src/utils/spatial_index.h) vs a linear scan
+
+    For a seeded patch of 1k, 10k and 50k object-sized rects (constant
+    density, so a query region holds about the same number of boxes), times:
+      - building the index (per rect);
+      - region queries of roughly screen size (per query);
+      - clearance tests as made by the placement search (per candidate);
+      - 5-nearest-neighbour queries (per query).
+    The linear scan is what the callers did before the index existed.
+*/
+
+#include "bench_common.h"
+#include "spatial_index.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <utility>
+#include <vector>
+
+using geometry::GridIndex;
+using geometry::Point;
+using geometry::Rect;
+
+namespace {
+
+constexpr size_t kQueries = 1000;
+
+std::vector<Rect> random_patch(size_t n, std::mt19937& rng) {
+    // Keep density roughly constant: a 1k patch spans ~4000 px square
+    const double side = 4000.0 * std::sqrt(static_cast<double>(n) / 1000.0);
+    std::uniform_real_distribution<double> pos(0.0, side);
+    std::uniform_real_distribution<double> width(30.0, 160.0);
+    std::uniform_real_distribution<double> height(20.0, 40.0);
+    std::vector<Rect> rects;
+    rects.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        rects.push_back({pos(rng), pos(rng), width(rng), height(rng)});
+    }
+    return rects;
+}
+
+long linear_query(const std::vector<Rect>& rects, const Rect& region, double eps) {
+    long hits = 0;
+    for (const Rect& r : rects) {
+        hits += geometry::aabb_overlap(r, region, eps) ? 1 : 0;
+    }
+    return hits;
+}
+
+bool linear_any(const std::vector<Rect>& rects, const Rect& region, double eps) {
+    for (const Rect& r : rects) {
+        if (geometry::aabb_overlap(r, region, eps)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+long linear_nearest(const std::vector<Rect>& rects, const Point& p, size_t k) {
+    std::vector<std::pair<double, int>> all;
+    all.reserve(rects.size());
+    for (size_t i = 0; i < rects.size(); ++i) {
+        all.emplace_back(geometry::point_rect_distance(p, rects[i]), static_cast<int>(i));
+    }
+    std::partial_sort(all.begin(), all.begin() + static_cast<long>(k), all.end());
+    return all[0].second;
+}
+
+}  // namespace
+
+int main() {
+    for (size_t n : {1000, 10000, 50000}) {
+        std::mt19937 rng(1234);
+        std::vector<Rect> rects = random_patch(n, rng);
+        const double side = 4000.0 * std::sqrt(static_cast<double>(n) / 1000.0);
+
+        std::uniform_real_distribution<double> pos(0.0, side);
+        std::vector<Rect> regions;
+        std::vector<Rect> candidates;
+        std::vector<Point> points;
+        for (size_t q = 0; q < kQueries; ++q) {
+            regions.push_back({pos(rng), pos(rng), 600.0, 400.0});
+            candidates.push_back({pos(rng), pos(rng), 50.0, 20.0});
+            points.push_back({pos(rng), pos(rng)});
+        }
+
+        std::printf("== %zu rects ==\n", n);
+        double build = bench::best_of(5, [&] { bench::keep(GridIndex::build(rects).size()); });
+        bench::report("build index (per rect)", n, build);
+
+        GridIndex index = GridIndex::build(rects);
+
+        double scan = bench::best_of(5, [&] {
+            long hits = 0;
+            for (const Rect& r : regions) {
+                hits += linear_query(rects, r, 0.0);
+            }
+            bench::keep(hits);
+        });
+        double grid = bench::best_of(5, [&] {
+            long hits = 0;
+            for (const Rect& r : regions) {
+                hits += static_cast<long>(index.query(r).size());
+            }
+            bench::keep(hits);
+        });
+        bench::report("region query, linear (per query)", kQueries, scan);
+        bench::report("region query, grid (per query)", kQueries, grid);
+
+        scan = bench::best_of(5, [&] {
+            long free = 0;
+            for (const Rect& c : candidates) {
+                free += linear_any(rects, c, -8.0) ? 0 : 1;
+            }
+            bench::keep(free);
+        });
+        grid = bench::best_of(5, [&] {
+            long free = 0;
+            for (const Rect& c : candidates) {
+                free += index.any(c, -8.0) ? 0 : 1;
+            }
+            bench::keep(free);
+        });
+        bench::report("clearance test, linear (per candidate)", kQueries, scan);
+        bench::report("clearance test, grid (per candidate)", kQueries, grid);
+
+        scan = bench::best_of(3, [&] {
+            long sum = 0;
+            for (const Point& p : points) {
+                sum += linear_nearest(rects, p, 5);
+            }
+            bench::keep(sum);
+        });
+        grid = bench::best_of(3, [&] {
+            long sum = 0;
+            for (const Point& p : points) {
+                sum += index.nearest(p, 5)[0].first;
+            }
+            bench::keep(sum);
+        });
+        bench::report("5-nearest, linear (per query)", kQueries, scan);
+        bench::report("5-nearest, grid (per query)", kQueries, grid);
+        std::printf("\n");
+    }
+    return 0;
+}
@@ -0,0 +1,117 @@
+/**
+    @file bench_symbol_lookup.cpp
+    Microbenchmark: per-box gensym() vs pre-interned symbols (src/utils/symbols.h)
+
+    Models the get_objects_in_patch / layout listing loop: for every box, read
+    the attributes a listing needs by symbol. "before" resolves each name with
+    gensym() inside the loop, as the tools did; "after" uses symbols interned
+    once up front, as Symbols::init() does.
+
+    The Max SDK is not available here, so gensym() is a stand-in with the same
+    shape as Max's: a thread-safe, string-keyed global table that hashes the
+    name and compares it on every call. Attribute storage is keyed by symbol
+    pointer, like object_attr_get*. Absolute numbers will differ inside Max;
+    the ratio is what the loop change buys.
+*/
+
+#include "bench_common.h"
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+struct Symbol {
+    std::string name;
+};
+
+// Stand-in for Max's global symbol table
+class SymbolTable {
+  public:
+    Symbol* gensym(const char* name) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto& slot = table_[name];
+        if (!slot) {
+            slot = std::make_unique<Symbol>(Symbol{name});
+        }
+        return slot.get();
+    }
+
+  private:
+    std::mutex mutex_;
+    std::unordered_map<std::string, std::unique_ptr<Symbol>> table_;
+};
+
+SymbolTable g_symbols;
+
+struct Box {
+    std::unordered_map<const Symbol*, long> attributes;
+
+    long get(const Symbol* attr) const {
+        auto it = attributes.find(attr);
+        return it == attributes.end() ? 0 : it->second;
+    }
+};
+
+const char* const kListingAttributes[] = {"varname",   "patching_rect", "presentation",
+                                          "numinlets", "numoutlets",    "hidden"};
+
+std::vector<Box> make_patch(size_t boxes) {
+    // A realistic symbol table is not empty: pad it with other names first
+    for (int i = 0; i < 20000; ++i) {
+        g_symbols.gensym(("sym_" + std::to_string(i)).c_str());
+    }
+
+    std::vector<Box> patch(boxes);
+    for (size_t i = 0; i < boxes; ++i) {
+        long v = static_cast<long>(i);
+        for (const char* name : kListingAttributes) {
+            patch[i].attributes[g_symbols.gensym(name)] = v++;
+        }
+    }
+    return patch;
+}
+
+long listing_before(const std::vector<Box>& patch) {
+    long sum = 0;
+    for (const Box& box : patch) {
+        for (const char* name : kListingAttributes) {
+            sum += box.get(g_symbols.gensym(name));
+        }
+    }
+    return sum;
+}
+
+long listing_after(const std::vector<Box>& patch, const std::vector<Symbol*>& interned) {
+    long sum = 0;
+    for (const Box& box : patch) {
+        for (const Symbol* sym : interned) {
+            sum += box.get(sym);
+        }
+    }
+    return sum;
+}
+
+}  // namespace
+
+int main() {
+    for (size_t n : {100, 1000, 10000}) {
+        std::vector<Box> patch = make_patch(n);
+
+        std::vector<Symbol*> interned;
+        for (const char* name : kListingAttributes) {
+            interned.push_back(g_symbols.gensym(name));
+        }
+
+        double before = bench::best_of(50, [&] { bench::keep(listing_before(patch)); });
+        double after = bench::best_of(50, [&] { bench::keep(listing_after(patch, interned)); });
+
+        bench::report("listing, gensym per box (before)", n, before);
+        bench::report("listing, pre-interned (after)", n, after);
+        std::printf("%-40s %.2fx\n\n", "speedup", before / after);
+    }
+    return 0;
+}
@@ -0,0 +1,79 @@
+/**
+    @file bench_wire_codec.cpp
+    Microbenchmark: JSON vs CBOR vs MessagePack wire encoding (src/utils/wire_codec.h)
+
+    Encodes and decodes the tools/call response for a get_objects_in_patch
+    listing of 500 and 5000 objects, in the shape MCPServer sends it: the tool
+    result is serialized to a JSON string and carried in
+    result.content[0].text, so a binary encoding only changes the envelope
+    around that string. Prints the frame size per encoding and the time per
+    encode and decode.
+*/
+
+#include "bench_common.h"
+#include "wire_codec.h"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+using json = nlohmann::json;
+using wire::Encoding;
+
+namespace {
+
+// The tool result of get_objects_in_patch for n boxes
+json listing(int n) {
+    const std::vector<std::string> classes = {"newobj", "message", "number", "flonum", "toggle"};
+    json objects = json::array();
+    for (int i = 0; i < n; ++i) {
+        objects.push_back({{"index", i},
+                           {"varname", "obj_" + std::to_string(i)},
+                           {"maxclass", classes[i % classes.size()]},
+                           {"text", "pack 0 0"},
+                           {"position", {30.0 + 15.0 * (i % 40), 30.0 + 45.0 * (i / 40)}},
+                           {"size", {50.0, 22.0}}});
+    }
+    return {{"patch_id", "bench"}, {"objects", objects}, {"count", n}};
+}
+
+// The JSON-RPC response to tools/call, as MCPServer::handle_request builds it
+json tools_call_response(const json& tool_result) {
+    return {{"jsonrpc", "2.0"},
+            {"id", 1},
+            {"result",
+             {{"content", json::array({{{"type", "text"}, {"text", tool_result.dump()}}})},
+              {"isError", false}}}};
+}
+
+}  // namespace
+
+int main() {
+    for (int n : {500, 5000}) {
+        const json message = tools_call_response(listing(n));
+        std::printf("== tools/call response, %d-object listing ==\n", n);
+
+        for (Encoding e : {Encoding::Json, Encoding::Cbor, Encoding::MessagePack}) {
+            std::string bytes;
+            const double encode_ns = bench::best_of(5, [&] {
+                bytes = wire::encode(message, e);
+                bench::keep(bytes.size());
+            });
+            json decoded;
+            const double decode_ns = bench::best_of(5, [&] {
+                decoded = wire::decode(bytes, e);
+                bench::keep(decoded.size());
+            });
+            if (decoded != message) {
+                std::fprintf(stderr, "%s round trip mismatch\n", wire::encoding_name(e));
+                return 1;
+            }
+            std::printf("%-8s %9zu B  encode %8.1f us  decode %8.1f us\n",
+                        wire::encoding_name(e), bytes.size(), encode_ns / 1000.0,
+                        decode_ns / 1000.0);
+        }
+    }
+    return 0;
+}
@@ -14,6 +14,7 @@
 #define MAXMCP_H
 
 #include <atomic>
+#include <cstdint>
 #include <string>
 
 // Minimal Max SDK type stubs
@@ -50,6 +51,7 @@ typedef struct _maxmcp {
     t_object* patcher;
     t_symbol* alias;
     t_symbol* group;
+    uint64_t structure_edits;
 } t_maxmcp;
 
 #endif  // MAXMCP_H
@@ -0,0 +1,216 @@
+/**
+    @file test_auto_layout.cpp
+    Unit tests for the layered layout (src/utils/auto_layout.cpp).
+
+    Small hand-built patches pin the layering, cycle breaking, crossing
+    removal and nub-aligned placement; seeded random patches check the
+    invariants every layout must keep: no two boxes overlap, sizes never
+    change, and every cord that was not reversed runs downward.
+*/
+
+#include "utils/auto_layout.h"
+
+#include "utils/io_geometry.h"
+
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using geometry::LayeredEdge;
+using geometry::LayeredLayoutOptions;
+using geometry::LayeredLayoutResult;
+using geometry::LayeredNode;
+using geometry::Rect;
+
+namespace {
+
+LayeredNode box(double x, double y, double width = 60.0, int inlets = 1, int outlets = 1) {
+    return {{x, y, width, 22.0}, inlets, outlets, true, "newobj"};
+}
+
+double outlet_x(const LayeredNode& node, const Rect& rect, int index) {
+    return geometry::io_positions(rect, node.outlets, geometry::IoSide::Outlet, true, "newobj")
+        .at(index)
+        .center.x;
+}
+
+double inlet_x(const LayeredNode& node, const Rect& rect, int index) {
+    return geometry::io_positions(rect, node.inlets, geometry::IoSide::Inlet, true, "newobj")
+        .at(index)
+        .center.x;
+}
+
+void expect_no_overlaps(const LayeredLayoutResult& result) {
+    for (size_t a = 0; a < result.rects.size(); ++a) {
+        for (size_t b = a + 1; b < result.rects.size(); ++b) {
+            ASSERT_FALSE(geometry::aabb_overlap(result.rects[a], result.rects[b], 0.0))
+                << "boxes " << a << " and " << b << " overlap";
+        }
+    }
+}
+
+}  // namespace
+
+TEST(AutoLayoutTest, ChainIsStackedWithStraightCords) {
+    // Scattered in reverse order on purpose
+    const std::vector<LayeredNode> nodes{box(300, 200), box(50, 400), box(10, 20)};
+    const std::vector<LayeredEdge> edges{{2, 0, 0, 0}, {0, 0, 1, 0}};
+    const LayeredLayoutResult result = geometry::layered_layout(nodes, edges);
+
+    EXPECT_EQ(result.layer, (std::vector<int>{1, 2, 0}));
+    EXPECT_EQ(result.layer_count, 3);
+    EXPECT_EQ(result.reversed_edges, 0);
+    // Same width and one nub each: the chain is one column
+    EXPECT_DOUBLE_EQ(result.rects[0].origin.x, result.rects[2].origin.x);
+    EXPECT_DOUBLE_EQ(result.rects[1].origin.x, result.rects[2].origin.x);
+    // Keeps the bounding box's top-left corner, one layer gap apart
+    EXPECT_DOUBLE_EQ(result.rects[2].origin.x, 10.0);
+    EXPECT_DOUBLE_EQ(result.rects[2].origin.y, 20.0);
+    EXPECT_DOUBLE_EQ(result.rects[0].origin.y, 20.0 + 22.0 + 30.0);
+    EXPECT_DOUBLE_EQ(result.rects[1].origin.y, 20.0 + 2 * (22.0 + 30.0));
+}
+
+TEST(AutoLayoutTest, FeedbackCordIsReversed) {
+    // source -> a -> b -> c -> a
+    const std::vector<LayeredNode> nodes{box(0, 0), box(0, 50), box(0, 100), box(0, 150)};
+    const std::vector<LayeredEdge> edges{
+        {0, 0, 1, 0}, {1, 0, 2, 0}, {2, 0, 3, 0}, {3, 0, 1, 0}};
+    const LayeredLayoutResult result = geometry::layered_layout(nodes, edges);
+
+    EXPECT_EQ(result.reversed_edges, 1);
+    EXPECT_EQ(result.layer, (std::vector<int>{0, 1, 2, 3}));
+}
+
+TEST(AutoLayoutTest, OrderingRemovesCrossings) {
+    // Top: a (left), b (right); bottom: c (left), d (right); a -> d, b -> c
+    const std::vector<LayeredNode> nodes{box(0, 0), box(100, 0), box(0, 100), box(100, 100)};
+    const std::vector<LayeredEdge> edges{{0, 0, 3, 0}, {1, 0, 2, 0}};
+    const LayeredLayoutResult result = geometry::layered_layout(nodes, edges);
+
+    EXPECT_EQ(result.initial_crossings, 1u);
+    EXPECT_EQ(result.crossings, 0u);
+    expect_no_overlaps(result);
+    // Each cord is vertical again
+    EXPECT_DOUBLE_EQ(result.rects[0].origin.x, result.rects[3].origin.x);
+    EXPECT_DOUBLE_EQ(result.rects[1].origin.x, result.rects[2].origin.x);
+}
+
+TEST(AutoLayoutTest, ChildrenLineUpUnderTheirOutlets) {
+    // A wide box with two outlets; the child of outlet 0 starts on the right
+    const std::vector<LayeredNode> nodes{box(0, 0, 120, 1, 2), box(200, 80, 50), box(0, 80, 50)};
+    const std::vector<LayeredEdge> edges{{0, 0, 1, 0}, {0, 1, 2, 0}};
+    const LayeredLayoutResult result = geometry::layered_layout(nodes, edges);
+
+    EXPECT_EQ(result.crossings, 0u);
+    EXPECT_LT(result.rects[1].origin.x, result.rects[2].origin.x);
+    EXPECT_NEAR(inlet_x(nodes[1], result.rects[1], 0), outlet_x(nodes[0], result.rects[0], 0),
+                1e-9);
+    EXPECT_NEAR(inlet_x(nodes[2], result.rects[2], 0), outlet_x(nodes[0], result.rects[0], 1),
+                1e-9);
+}
+
+TEST(AutoLayoutTest, LongCordsGoThroughDummyNodes) {
+    // a -> b -> c -> d, and a -> d skipping two layers
+    const std::vector<LayeredNode> nodes{box(0, 0), box(0, 50), box(0, 100), box(0, 150)};
+    const std::vector<LayeredEdge> edges{{0, 0, 1, 0}, {1, 0, 2, 0}, {2, 0, 3, 0}, {0, 0, 3, 0}};
+    const LayeredLayoutResult result = geometry::layered_layout(nodes, edges);
+
+    EXPECT_EQ(result.dummy_nodes, 2u);
+    EXPECT_EQ(result.layer_count, 4);
+    expect_no_overlaps(result);
+}
+
+TEST(AutoLayoutTest, SourcesSitJustAboveTheirSuccessor) {
+    // a -> b -> c, and a second source s feeding only c
+    const std::vector<LayeredNode> nodes{box(0, 0), box(0, 50), box(0, 100), box(100, 0)};
+    const std::vector<LayeredEdge> edges{{0, 0, 1, 0}, {1, 0, 2, 0}, {3, 0, 2, 0}};
+    const LayeredLayoutResult result = geometry::layered_layout(nodes, edges);
+
+    EXPECT_EQ(result.layer, (std::vector<int>{0, 1, 2, 1}));
+    EXPECT_EQ(result.dummy_nodes, 0u);
+}
+
+TEST(AutoLayoutTest, UnconnectedBoxesArePackedBelow) {
+    std::vector<LayeredNode> nodes{box(0, 0), box(0, 50)};
+    for (int i = 0; i < 30; ++i) {
+        nodes.push_back(box(500.0 - i * 10.0, 10.0 * i, 40.0 + i));
+    }
+    const std::vector<LayeredEdge> edges{{0, 0, 1, 0}, {1, 0, 1, 0}, {0, 0, 99, 0}};
+    const LayeredLayoutResult result = geometry::layered_layout(nodes, edges);
+
+    const double drawing_bottom = result.rects[1].bottom();
+    for (size_t v = 2; v < nodes.size(); ++v) {
+        EXPECT_EQ(result.layer[v], -1);
+        EXPECT_GE(result.rects[v].origin.y, drawing_bottom);
+        EXPECT_DOUBLE_EQ(result.rects[v].width, nodes[v].rect.width);
+    }
+    expect_no_overlaps(result);
+}
+
+TEST(AutoLayoutTest, RandomPatchesKeepTheInvariants) {
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<double> coord(0.0, 2000.0);
+    std::uniform_real_distribution<double> width(20.0, 160.0);
+    std::uniform_int_distribution<int> nubs(0, 4);
+
+    for (int round = 0; round < 6; ++round) {
+        const int n = 60 + 80 * round;
+        std::vector<LayeredNode> nodes;
+        for (int i = 0; i < n; ++i) {
+            nodes.push_back({{coord(rng), coord(rng), width(rng), 22.0},
+                             nubs(rng),
+                             nubs(rng),
+                             round % 2 == 0 || i % 3 != 0,
+                             "newobj"});
+        }
+        // Mostly forward cords with some feedback, parallel and bad ones
+        std::vector<LayeredEdge> edges;
+        std::uniform_int_distribution<int> pick(0, n - 1);
+        for (int e = 0; e < 2 * n; ++e) {
+            int a = pick(rng), b = pick(rng);
+            if (e % 7 != 0 && a > b) {
+                std::swap(a, b);
+            }
+            edges.push_back({a, e % 3, b, e % 2});
+        }
+        edges.push_back({-1, 0, 0, 0});
+        edges.push_back({0, 0, n, 0});
+
+        LayeredLayoutOptions options;
+        options.layer_gap = 25.0 + round;
+        const LayeredLayoutResult result = geometry::layered_layout(nodes, edges, options);
+
+        SCOPED_TRACE("round " + std::to_string(round));
+        ASSERT_EQ(result.rects.size(), nodes.size());
+        expect_no_overlaps(result);
+        EXPECT_LE(result.crossings, result.initial_crossings);
+        size_t upward = 0;
+        for (size_t v = 0; v < nodes.size(); ++v) {
+            EXPECT_DOUBLE_EQ(result.rects[v].width, nodes[v].rect.width);
+            EXPECT_DOUBLE_EQ(result.rects[v].height, nodes[v].rect.height);
+        }
+        for (const LayeredEdge& e : edges) {
+            if (e.src < 0 || e.dst >= n || e.src == e.dst) {
+                continue;
+            }
+            if (result.layer[e.src] >= result.layer[e.dst]) {
+                ++upward;
+            } else {
+                EXPECT_LE(result.rects[e.src].bottom() + options.layer_gap,
+                          result.rects[e.dst].origin.y + 1e-9);
+            }
+        }
+        // Only the reversed cords run upward
+        EXPECT_EQ(upward, static_cast<size_t>(result.reversed_edges));
+    }
+}
+
+TEST(AutoLayoutTest, EmptyAndEdgelessInputs) {
+    EXPECT_TRUE(geometry::layered_layout({}, {}).rects.empty());
+
+    const LayeredLayoutResult single = geometry::layered_layout({box(40, 30)}, {});
+    EXPECT_DOUBLE_EQ(single.rects[0].origin.x, 40.0);
+    EXPECT_DOUBLE_EQ(single.rects[0].origin.y, 30.0);
+    EXPECT_EQ(single.layer_count, 0);
+}
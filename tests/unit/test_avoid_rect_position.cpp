@@ -1,25 +1,38 @@
 /**
     @file test_avoid_rect_position.cpp
-    Unit tests for UtilityTools::find_avoid_rect_position (pure geometry).
+    Unit tests for UtilityTools::find_avoid_rect_position, place_rects,
+    settle_rects and clear_block_offset (pure geometry).
 
     These tests exercise the Max-API independent placement logic behind the
     get_avoid_rect_position MCP tool: the non-overlap (gap) guarantee, the
     near-point search, nearest-spot selection, size sensitivity, bounds, the
-    rationale strings, and the legacy "place to the right" fallback.
+    rationale strings, and the legacy "place to the right" fallback. The
+    batch placement behind place_objects is checked for clearance between
+    everything it places, group packing and anchor priority; re-placing
+    created boxes that came out larger than reserved; and the block
+    move behind auto_layout's varnames subset for clearing the boxes it
+    leaves alone.
 */
 
 #include "tools/utility_tools.h"
+#include "utils/auto_layout.h"
 
+#include <algorithm>
 #include <cmath>
+#include <random>
 #include <string>
 #include <vector>
 
 #include <gtest/gtest.h>
 
+using UtilityTools::clear_block_offset;
 using UtilityTools::find_avoid_rect_position;
+using UtilityTools::place_rects;
 using UtilityTools::PlacedPosition;
+using UtilityTools::PlaceRequest;
 using UtilityTools::Rect;
 using UtilityTools::rects_conflict;
+using UtilityTools::settle_rects;
 
 namespace {
 
@@ -27,6 +40,10 @@ namespace {
 // must keep between the placed object and every existing object.
 constexpr double kGap = 8.0;
 
+// Mirror PLACE_GRID and PLACE_MAX_RADIUS for the reference search below.
+constexpr double kGrid = 15.0;
+constexpr double kMaxRadius = 4000.0;
+
 // Assert the placed rect clears every existing object by at least kGap, reusing
 // the production predicate (see the RectsConflict tests below for its own
 // boundary coverage).
@@ -41,6 +58,45 @@ void expect_cleared(const PlacedPosition& placed, double width, double height,
     }
 }
 
+// The ring search as a plain scan: every grid point of every ring, in order,
+// tested against every existing rect. Returns false past kMaxRadius.
+bool reference_search(const std::vector<Rect>& existing, double width, double height,
+                      geometry::Point anchor, geometry::Point& out) {
+    auto is_free = [&](double x, double y) {
+        if (x < 0.0 || y < 0.0) {
+            return false;
+        }
+        return std::none_of(existing.begin(), existing.end(), [&](const Rect& e) {
+            return rects_conflict(Rect{x, y, width, height}, e, kGap);
+        });
+    };
+    if (is_free(anchor.x, anchor.y)) {
+        out = anchor;
+        return true;
+    }
+    for (double radius = kGrid; radius <= kMaxRadius; radius += kGrid) {
+        bool found = false;
+        double best = 0.0;
+        for (double dx = -radius; dx <= radius; dx += kGrid) {
+            for (double dy = -radius; dy <= radius; dy += kGrid) {
+                if (std::max(std::fabs(dx), std::fabs(dy)) < radius ||
+                    !is_free(anchor.x + dx, anchor.y + dy)) {
+                    continue;
+                }
+                if (!found || dx * dx + dy * dy < best) {
+                    found = true;
+                    best = dx * dx + dy * dy;
+                    out = {anchor.x + dx, anchor.y + dy};
+                }
+            }
+        }
+        if (found) {
+            return true;
+        }
+    }
+    return false;
+}
+
 bool contains(const std::string& haystack, const std::string& needle) {
     return haystack.find(needle) != std::string::npos;
 }
@@ -180,3 +236,256 @@ TEST(AvoidRectPosition, IsDeterministic) {
     EXPECT_DOUBLE_EQ(a.position.x, b.position.x);
     EXPECT_DOUBLE_EQ(a.position.y, b.position.y);
 }
+
+// The free-space grid picks exactly the spot the plain scan does, ties
+// included, on crowded random layouts with odd-sized objects.
+TEST(AvoidRectPosition, MatchesCandidateByCandidateScan) {
+    std::mt19937 rng(17);
+    std::uniform_real_distribution<double> pos(0.0, 600.0);
+    std::uniform_real_distribution<double> size(10.0, 90.0);
+    for (int layout = 0; layout < 40; ++layout) {
+        std::vector<Rect> existing;
+        for (int i = 0; i < 120; ++i) {
+            existing.push_back({pos(rng), pos(rng), size(rng), size(rng) / 3.0});
+        }
+        for (int t = 0; t < 5; ++t) {
+            const double width = size(rng), height = size(rng) / 2.0;
+            const geometry::Point near{pos(rng) - 50.0, pos(rng) - 50.0};
+            PlacedPosition placed =
+                find_avoid_rect_position(existing, width, height, true, near.x, near.y);
+
+            geometry::Point expected{};
+            ASSERT_TRUE(reference_search(existing, width, height,
+                                         {std::max(0.0, near.x), std::max(0.0, near.y)},
+                                         expected));
+            EXPECT_EQ(placed.position.x, expected.x) << "layout " << layout << " query " << t;
+            EXPECT_EQ(placed.position.y, expected.y) << "layout " << layout << " query " << t;
+        }
+    }
+}
+
+// Whole-pixel layouts put rect edges exactly on the search grid, where the
+// gap test is decided by equality; the result must still match the scan.
+TEST(AvoidRectPosition, MatchesScanOnGridAlignedEdges) {
+    std::mt19937 rng(99);
+    std::uniform_int_distribution<int> pos(0, 300);
+    std::uniform_int_distribution<int> size(1, 18);
+    for (int layout = 0; layout < 40; ++layout) {
+        std::vector<Rect> existing;
+        for (int i = 0; i < 60 + 4 * layout; ++i) {
+            existing.push_back({static_cast<double>(pos(rng)), static_cast<double>(pos(rng)),
+                                size(rng) * 5.0, size(rng) * 2.0});
+        }
+        for (int t = 0; t < 5; ++t) {
+            const double width = size(rng) * 5.0, height = size(rng) * 2.5;
+            const geometry::Point near{pos(rng) - 30.0, pos(rng) - 30.0};
+            PlacedPosition placed =
+                find_avoid_rect_position(existing, width, height, true, near.x, near.y);
+
+            geometry::Point expected{};
+            ASSERT_TRUE(reference_search(existing, width, height,
+                                         {std::max(0.0, near.x), std::max(0.0, near.y)},
+                                         expected));
+            EXPECT_EQ(placed.position.x, expected.x) << "layout " << layout << " query " << t;
+            EXPECT_EQ(placed.position.y, expected.y) << "layout " << layout << " query " << t;
+        }
+    }
+}
+
+// Deep inside a packed block the nearest free spot is many grid steps away,
+// past the first search window, which then has to be widened.
+TEST(AvoidRectPosition, FindsFarSpotOutsideAPackedBlock) {
+    std::vector<Rect> existing;
+    for (int row = 0; row < 20; ++row) {
+        for (int col = 0; col < 20; ++col) {
+            existing.push_back({100.0 + col * 62.0, 100.0 + row * 32.0, 60.0, 30.0});
+        }
+    }
+    const geometry::Point near{720.0, 420.0};
+    PlacedPosition placed = find_avoid_rect_position(existing, 80.0, 22.0, true, near.x, near.y);
+
+    geometry::Point expected{};
+    ASSERT_TRUE(reference_search(existing, 80.0, 22.0, near, expected));
+    EXPECT_EQ(placed.position.x, expected.x);
+    EXPECT_EQ(placed.position.y, expected.y);
+    EXPECT_GT(std::max(std::fabs(expected.x - near.x), std::fabs(expected.y - near.y)),
+              16 * kGrid);
+    expect_cleared(placed, 80.0, 22.0, existing);
+}
+
+// ---------------------------------------------------------------------------
+// place_rects: many objects at once
+// ---------------------------------------------------------------------------
+
+// A lone request lands where find_avoid_rect_position puts it.
+TEST(PlaceRects, SingleRequestMatchesAvoidRect) {
+    std::vector<Rect> existing{{100.0, 100.0, 100.0, 40.0}};
+    PlaceRequest r;
+    r.has_near = true;
+    r.near_x = 150.0;
+    r.near_y = 120.0;
+    std::vector<PlacedPosition> placed = place_rects(existing, {r});
+    PlacedPosition single = find_avoid_rect_position(existing, 50.0, 20.0, true, 150.0, 120.0);
+    ASSERT_EQ(placed.size(), 1u);
+    EXPECT_EQ(placed[0].position.x, single.position.x);
+    EXPECT_EQ(placed[0].position.y, single.position.y);
+}
+
+// Every placed object clears the existing ones and every other placed one.
+TEST(PlaceRects, ClearsExistingAndEachOther) {
+    std::mt19937 rng(23);
+    std::uniform_real_distribution<double> pos(0.0, 500.0);
+    std::uniform_real_distribution<double> size(20.0, 120.0);
+    std::vector<Rect> existing;
+    for (int i = 0; i < 80; ++i) {
+        existing.push_back({pos(rng), pos(rng), size(rng), 22.0});
+    }
+    std::vector<PlaceRequest> requests(40);
+    for (size_t i = 0; i < requests.size(); ++i) {
+        PlaceRequest& r = requests[i];
+        r.width = size(rng);
+        r.height = size(rng) / 3.0;
+        r.has_near = i % 3 == 0;
+        r.near_x = pos(rng);
+        r.near_y = pos(rng);
+        r.group = i % 4 == 1 ? "g" + std::to_string(i % 3) : "";
+    }
+
+    std::vector<PlacedPosition> placed = place_rects(existing, requests);
+    ASSERT_EQ(placed.size(), requests.size());
+    std::vector<Rect> rects;
+    for (size_t i = 0; i < placed.size(); ++i) {
+        expect_cleared(placed[i], requests[i].width, requests[i].height, existing);
+        EXPECT_GE(placed[i].position.x, 0.0);
+        EXPECT_GE(placed[i].position.y, 0.0);
+        rects.push_back({placed[i].position.x, placed[i].position.y, requests[i].width,
+                         requests[i].height});
+    }
+    for (size_t a = 0; a < rects.size(); ++a) {
+        for (size_t b = a + 1; b < rects.size(); ++b) {
+            EXPECT_FALSE(rects_conflict(rects[a], rects[b], kGap)) << a << " and " << b;
+        }
+    }
+}
+
+// A group is packed in request order into rows, starting at its anchor.
+TEST(PlaceRects, PacksAGroupIntoRows) {
+    std::vector<PlaceRequest> requests(6);
+    for (PlaceRequest& r : requests) {
+        r.group = "osc";
+        r.width = 60.0;
+        r.height = 20.0;
+    }
+    requests[0].has_near = true;
+    requests[0].near_x = 100.0;
+    requests[0].near_y = 100.0;
+
+    std::vector<PlacedPosition> placed = place_rects({}, requests);
+    EXPECT_EQ(placed[0].position.x, 100.0);
+    EXPECT_EQ(placed[0].position.y, 100.0);
+    EXPECT_EQ(placed[1].position.x, 100.0 + 60.0 + kGrid);  // same row, one gap apart
+    EXPECT_EQ(placed[1].position.y, 100.0);
+    double bottom = 0.0, right = 0.0;
+    for (size_t i = 0; i < placed.size(); ++i) {
+        right = std::max(right, placed[i].position.x + 60.0);
+        bottom = std::max(bottom, placed[i].position.y + 20.0);
+        EXPECT_TRUE(contains(placed[i].rationale, "group 'osc'"));
+    }
+    // Wrapped into more than one row, so the block is not one long strip
+    EXPECT_GT(bottom - 100.0, 20.0);
+    EXPECT_LT(right - 100.0, 6 * (60.0 + kGrid));
+}
+
+// Anchored objects are placed before the others, whatever the request order.
+TEST(PlaceRects, AnchoredRequestsGoFirst) {
+    PlaceRequest loose;  // no anchor: the default origin of an empty patch
+    PlaceRequest anchored;
+    anchored.has_near = true;
+    anchored.near_x = 50.0;
+    anchored.near_y = 50.0;
+
+    std::vector<PlacedPosition> placed = place_rects({}, {loose, anchored});
+    EXPECT_EQ(placed[1].position.x, 50.0);
+    EXPECT_EQ(placed[1].position.y, 50.0);
+    EXPECT_FALSE(rects_conflict({placed[0].position.x, placed[0].position.y, 50.0, 20.0},
+                                {50.0, 50.0, 50.0, 20.0}, kGap));
+}
+
+TEST(SettleRects, OnlyOverlappingBoxesMove) {
+    // Three objects reserved 50x20 each in a row; the middle one came out
+    // 140 px wide and now runs into the third
+    const std::vector<Rect> existing{{100, 200, 60, 22}};
+    std::vector<Rect> created{{300, 50, 50, 20}, {365, 50, 50, 20}, {430, 50, 50, 20}};
+    created[1].width = 140;
+    created[1].height = 22;
+
+    const std::vector<geometry::Point> settled = settle_rects(existing, created);
+    ASSERT_EQ(settled.size(), 3u);
+    EXPECT_EQ(settled[0].x, created[0].origin.x);
+    EXPECT_EQ(settled[0].y, created[0].origin.y);
+    EXPECT_EQ(settled[1].x, created[1].origin.x);  // clear of the first one
+    EXPECT_EQ(settled[1].y, created[1].origin.y);
+    EXPECT_TRUE(settled[2].x != created[2].origin.x || settled[2].y != created[2].origin.y);
+
+    std::vector<Rect> all(existing);
+    for (size_t i = 0; i < created.size(); ++i) {
+        all.push_back({settled[i].x, settled[i].y, created[i].width, created[i].height});
+    }
+    for (size_t i = 0; i < all.size(); ++i) {
+        for (size_t j = i + 1; j < all.size(); ++j) {
+            EXPECT_FALSE(rects_conflict(all[i], all[j], kGap)) << i << " vs " << j;
+        }
+    }
+}
+
+TEST(SettleRects, BoxLargerThanReservedClearsExisting) {
+    const std::vector<Rect> existing{{0, 0, 60, 22}, {120, 0, 60, 22}};
+    // Reserved 50x20 at (68, 0), which fits the gap; the real box is 90 wide
+    const std::vector<Rect> created{{68, 0, 90, 22}};
+    const std::vector<geometry::Point> settled = settle_rects(existing, created);
+    ASSERT_EQ(settled.size(), 1u);
+    const Rect moved{settled[0].x, settled[0].y, 90, 22};
+    for (const Rect& e : existing) {
+        EXPECT_FALSE(rects_conflict(moved, e, kGap));
+    }
+}
+
+TEST(ClearBlockOffset, ClearBlockStaysPut) {
+    // An obstacle in a hole of the block, touching none of its rects
+    const std::vector<Rect> block{{0, 0, 40, 20}, {200, 0, 40, 20}};
+    const std::vector<Rect> existing{{100, 0, 40, 20}};
+    const geometry::Point shift = clear_block_offset(existing, block);
+    EXPECT_EQ(shift.x, 0.0);
+    EXPECT_EQ(shift.y, 0.0);
+    EXPECT_EQ(clear_block_offset({}, block).x, 0.0);
+}
+
+TEST(ClearBlockOffset, LaidOutSubsetMovesOffTheOtherBoxes) {
+    // auto_layout with varnames: a three-box chain is laid out from the
+    // top-left corner of its own rects, onto boxes that were not selected
+    std::vector<geometry::LayeredNode> nodes;
+    for (double y : {100.0, 130.0, 160.0}) {
+        nodes.push_back({{100.0, y, 60.0, 22.0}, 1, 1, true, "newobj"});
+    }
+    const std::vector<geometry::LayeredEdge> edges{{0, 0, 1, 0}, {1, 0, 2, 0}};
+    const geometry::LayeredLayoutResult layout = geometry::layered_layout(nodes, edges);
+    const std::vector<Rect> others{{90, 150, 80, 22}, {300, 100, 60, 22}, {90, 300, 60, 22}};
+
+    bool overlapped = false;
+    for (const Rect& r : layout.rects) {
+        for (const Rect& o : others) {
+            overlapped = overlapped || rects_conflict(r, o, kGap);
+        }
+    }
+    ASSERT_TRUE(overlapped) << "the test layout should land on an unselected box";
+
+    const geometry::Point shift = clear_block_offset(others, layout.rects);
+    EXPECT_TRUE(shift.x != 0.0 || shift.y != 0.0);
+    for (size_t i = 0; i < layout.rects.size(); ++i) {
+        const Rect moved{layout.rects[i].origin.x + shift.x, layout.rects[i].origin.y + shift.y,
+                         layout.rects[i].width, layout.rects[i].height};
+        for (const Rect& o : others) {
+            EXPECT_FALSE(rects_conflict(moved, o, kGap)) << "box " << i;
+        }
+    }
+}
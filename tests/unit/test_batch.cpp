@@ -0,0 +1,261 @@
+/**
+    @file test_batch.cpp
+    Unit tests for bulk tool helpers (src/utils/batch.cpp).
+
+    Covers on_error parsing, connection item validation (the errors must name
+    the offending index) and the Tally bookkeeping that decides when a
+    "stop" pass ends and which overall status is reported.
+*/
+
+#include "utils/batch.h"
+
+#include "tools/tool_common.h"
+
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using batch::ConnectionSpec;
+using batch::OnError;
+using batch::Tally;
+using json = nlohmann::json;
+
+// ============================================================================
+// parse_on_error
+// ============================================================================
+
+TEST(BatchOnErrorTest, DefaultsToStop) {
+    OnError mode = OnError::Continue;
+    EXPECT_TRUE(batch::parse_on_error(json::object(), mode).is_null());
+    EXPECT_EQ(mode, OnError::Stop);
+}
+
+TEST(BatchOnErrorTest, AcceptsStopAndContinue) {
+    OnError mode;
+    EXPECT_TRUE(batch::parse_on_error({{"on_error", "continue"}}, mode).is_null());
+    EXPECT_EQ(mode, OnError::Continue);
+    EXPECT_TRUE(batch::parse_on_error({{"on_error", "stop"}}, mode).is_null());
+    EXPECT_EQ(mode, OnError::Stop);
+}
+
+TEST(BatchOnErrorTest, RejectsOtherValues) {
+    OnError mode;
+    for (const json& value : {json("skip"), json(true), json(1)}) {
+        json error = batch::parse_on_error({{"on_error", value}}, mode);
+        ASSERT_TRUE(error.contains("error")) << value.dump();
+        EXPECT_EQ(error["error"]["code"], ToolCommon::ErrorCode::INVALID_PARAMS);
+    }
+}
+
+// ============================================================================
+// parse_connection_specs
+// ============================================================================
+
+TEST(BatchConnectionSpecsTest, ParsesItemsInOrder) {
+    json first = {{"src_varname", "osc"}, {"outlet", 0}, {"dst_varname", "gain"}, {"inlet", 0}};
+    json second = {{"src_varname", "gain"}, {"outlet", 0}, {"dst_varname", "dac"}, {"inlet", 1}};
+    json params = {{"connections", json::array({first, second})}};
+
+    std::vector<ConnectionSpec> specs;
+    ASSERT_TRUE(batch::parse_connection_specs(params, "connections", true, specs).is_null());
+    ASSERT_EQ(specs.size(), 2u);
+    EXPECT_EQ(specs[0].src_varname, "osc");
+    EXPECT_EQ(specs[0].dst_varname, "gain");
+    EXPECT_EQ(specs[1].src_varname, "gain");
+    EXPECT_EQ(specs[1].dst_varname, "dac");
+    EXPECT_EQ(specs[1].inlet, 1);
+}
+
+TEST(BatchConnectionSpecsTest, MissingKeyIsOptionalUnlessRequired) {
+    std::vector<ConnectionSpec> specs = {{"a", 0, "b", 0}};
+    json params = json::object();
+    EXPECT_TRUE(batch::parse_connection_specs(params, "connections", false, specs).is_null());
+    EXPECT_TRUE(specs.empty());
+
+    json error = batch::parse_connection_specs(params, "connections", true, specs);
+    ASSERT_TRUE(error.contains("error"));
+    EXPECT_EQ(error["error"]["code"], ToolCommon::ErrorCode::INVALID_PARAMS);
+}
+
+TEST(BatchConnectionSpecsTest, EmptyArrayOnlyRejectedWhenRequired) {
+    json params = {{"connections", json::array()}};
+    std::vector<ConnectionSpec> specs;
+    EXPECT_TRUE(batch::parse_connection_specs(params, "connections", false, specs).is_null());
+    json error = batch::parse_connection_specs(params, "connections", true, specs);
+    EXPECT_TRUE(error.contains("error"));
+}
+
+TEST(BatchConnectionSpecsTest, ErrorNamesTheBadItem) {
+    json good = {{"src_varname", "a"}, {"outlet", 0}, {"dst_varname", "b"}, {"inlet", 0}};
+    std::vector<json> bad_items = {
+        {{"src_varname", "a"}, {"outlet", -1}, {"dst_varname", "b"}, {"inlet", 0}},
+        {{"src_varname", ""}, {"outlet", 0}, {"dst_varname", "b"}, {"inlet", 0}},
+        {{"src_varname", "a"}, {"outlet", 0}, {"dst_varname", "b"}, {"inlet", 0.5}},
+        {{"src_varname", "a"}, {"outlet", 0}, {"inlet", 0}},
+        json("a -> b"),
+    };
+
+    for (const json& bad : bad_items) {
+        json params = {{"connections", json::array({good, bad})}};
+        std::vector<ConnectionSpec> specs;
+        json error = batch::parse_connection_specs(params, "connections", true, specs);
+        ASSERT_TRUE(error.contains("error")) << bad.dump();
+        EXPECT_NE(error["error"]["message"].get<std::string>().find("connections[1]"),
+                  std::string::npos)
+            << error.dump();
+    }
+}
+
+// ============================================================================
+// Result entries and Tally
+// ============================================================================
+
+TEST(BatchResultTest, ItemEntries) {
+    json ok = batch::item_success(2, {{"varname", "osc"}});
+    EXPECT_EQ(ok["index"], 2);
+    EXPECT_EQ(ok["status"], "success");
+    EXPECT_EQ(ok["varname"], "osc");
+
+    json err = batch::item_error(3, "boom");
+    EXPECT_EQ(err["index"], 3);
+    EXPECT_EQ(err["status"], "error");
+    EXPECT_EQ(err["error"], "boom");
+}
+
+TEST(BatchTallyTest, StopModeStopsAtFirstFailure) {
+    Tally tally(OnError::Stop);
+    tally.succeeded();
+    EXPECT_FALSE(tally.stopped());
+    tally.failed();
+    EXPECT_TRUE(tally.stopped());
+    EXPECT_EQ(tally.status(), "partial");
+}
+
+TEST(BatchTallyTest, ContinueModeNeverStops) {
+    Tally tally(OnError::Continue);
+    tally.failed();
+    tally.failed();
+    EXPECT_FALSE(tally.stopped());
+    EXPECT_EQ(tally.failed_count(), 2u);
+    EXPECT_EQ(tally.status(), "failed");
+}
+
+TEST(BatchTallyTest, StatusWithoutFailuresIsSuccess) {
+    Tally tally(OnError::Stop);
+    EXPECT_EQ(tally.status(), "success");
+    tally.succeeded();
+    tally.succeeded();
+    EXPECT_EQ(tally.succeeded_count(), 2u);
+    EXPECT_EQ(tally.status(), "success");
+}
+
+// ============================================================================
+// Bulk attribute requests
+// ============================================================================
+
+TEST(BatchSelectorTest, ParsesMaxclassAndRegion) {
+    batch::BoxSelector selector;
+    json value = {{"maxclass", "comment"}, {"region", {0, 0, 100, 100}}};
+    ASSERT_TRUE(batch::parse_selector(value, selector).is_null());
+    EXPECT_EQ(selector.maxclass, "comment");
+    ASSERT_TRUE(selector.region.has_value());
+
+    EXPECT_TRUE(selector.matches("comment", {50, 50, 80, 20}));
+    EXPECT_FALSE(selector.matches("message", {50, 50, 80, 20}));
+    EXPECT_FALSE(selector.matches("comment", {200, 50, 80, 20}));
+    // Merely touching the region edge does not count
+    EXPECT_FALSE(selector.matches("comment", {100, 0, 80, 20}));
+}
+
+TEST(BatchSelectorTest, EitherCriterionAlone) {
+    batch::BoxSelector selector;
+    ASSERT_TRUE(batch::parse_selector({{"maxclass", "number"}}, selector).is_null());
+    EXPECT_TRUE(selector.matches("number", {1000, 1000, 50, 22}));
+
+    ASSERT_TRUE(batch::parse_selector({{"region", {0, 0, 10, 10}}}, selector).is_null());
+    EXPECT_EQ(selector.maxclass, "");
+    EXPECT_TRUE(selector.matches("anything", {5, 5, 50, 22}));
+}
+
+TEST(BatchSelectorTest, RejectsEmptyOrMalformed) {
+    batch::BoxSelector selector;
+    EXPECT_TRUE(batch::parse_selector(json::object(), selector).contains("error"));
+    EXPECT_TRUE(batch::parse_selector({{"maxclass", ""}}, selector).contains("error"));
+    EXPECT_TRUE(batch::parse_selector({{"region", {0, 0, 10}}}, selector).contains("error"));
+    EXPECT_TRUE(batch::parse_selector({{"region", {0, 0, -1, 10}}}, selector).contains("error"));
+    EXPECT_TRUE(batch::parse_selector("comment", selector).contains("error"));
+}
+
+TEST(BatchValuePoolTest, DeduplicatesEqualValues) {
+    batch::ValuePool pool;
+    EXPECT_EQ(pool.add(json::array({1, 0, 0, 1})), 0u);
+    EXPECT_EQ(pool.add(14), 1u);
+    EXPECT_EQ(pool.add(json::array({1, 0, 0, 1})), 0u);
+    EXPECT_EQ(pool.add("Arial"), 2u);
+    EXPECT_EQ(pool.add(14), 1u);
+    EXPECT_EQ(pool.size(), 3u);
+    EXPECT_EQ(pool.values()[2], "Arial");
+}
+
+TEST(BatchAttributeRequestTest, ItemsPoolNamesAndValues) {
+    json params = {{"items",
+                    {{{"varname", "c1"}, {"attribute", "fontsize"}, {"value", 14}},
+                     {{"varname", "c2"}, {"attribute", "fontsize"}, {"value", 14}},
+                     {{"varname", "c3"}, {"attribute", "textcolor"}, {"value", {1, 0, 0, 1}}}}}};
+
+    batch::AttributeRequest request;
+    ASSERT_TRUE(batch::parse_attribute_request(params, true, request).is_null());
+    ASSERT_EQ(request.items.size(), 3u);
+    EXPECT_FALSE(request.selector.has_value());
+    EXPECT_EQ(request.names.size(), 2u);
+    EXPECT_EQ(request.values.size(), 2u);
+    EXPECT_EQ(request.items[0].value, request.items[1].value);
+    EXPECT_EQ(request.items[2].varname, "c3");
+    EXPECT_EQ(request.names.values()[request.items[2].attribute], "textcolor");
+}
+
+TEST(BatchAttributeRequestTest, SelectorWithAttributeMap) {
+    json params = {{"selector", {{"maxclass", "comment"}}},
+                   {"attributes", {{"fontsize", 14}, {"fontname", "Arial"}}}};
+
+    batch::AttributeRequest request;
+    ASSERT_TRUE(batch::parse_attribute_request(params, true, request).is_null());
+    ASSERT_TRUE(request.selector.has_value());
+    EXPECT_TRUE(request.items.empty());
+    EXPECT_EQ(request.attributes.size(), 2u);
+    EXPECT_EQ(request.values.size(), 2u);
+}
+
+TEST(BatchAttributeRequestTest, ReadsTakeNamesOnly) {
+    batch::AttributeRequest request;
+    json items = {{"items", {{{"varname", "c1"}, {"attribute", "fontsize"}}}}};
+    ASSERT_TRUE(batch::parse_attribute_request(items, false, request).is_null());
+    EXPECT_EQ(request.values.size(), 0u);
+
+    json selector = {{"selector", {{"maxclass", "comment"}}},
+                     {"attributes", {"fontsize", "patching_rect"}}};
+    ASSERT_TRUE(batch::parse_attribute_request(selector, false, request).is_null());
+    EXPECT_EQ(request.attributes.size(), 2u);
+
+    // A write-style map is not a list of names
+    json map = {{"selector", {{"maxclass", "comment"}}}, {"attributes", {{"fontsize", 14}}}};
+    EXPECT_TRUE(batch::parse_attribute_request(map, false, request).contains("error"));
+}
+
+TEST(BatchAttributeRequestTest, RejectsAmbiguousOrBadInput) {
+    batch::AttributeRequest request;
+    EXPECT_TRUE(batch::parse_attribute_request(json::object(), true, request).contains("error"));
+
+    json both = {{"items", json::array()}, {"selector", {{"maxclass", "comment"}}}};
+    EXPECT_TRUE(batch::parse_attribute_request(both, true, request).contains("error"));
+
+    json no_map = {{"selector", {{"maxclass", "comment"}}}};
+    EXPECT_TRUE(batch::parse_attribute_request(no_map, true, request).contains("error"));
+
+    json bad_value = {{"items",
+                       {{{"varname", "a"}, {"attribute", "x"}, {"value", 1}},
+                        {{"varname", "b"}, {"attribute", "x"}, {"value", {{"k", 1}}}}}}};
+    json error = batch::parse_attribute_request(bad_value, true, request);
+    ASSERT_TRUE(error.contains("error"));
+    EXPECT_NE(error["error"]["message"].get<std::string>().find("items[1]"), std::string::npos);
+}
@@ -0,0 +1,208 @@
+/**
+    @file test_columnar.cpp
+    Unit tests for the streaming JSON writer and the columnar listing encoding
+    (src/utils/json_writer.cpp, src/utils/columnar.cpp).
+
+    Output is parsed back with nlohmann to check it is valid JSON with the
+    documented shape; the size test compares a synthetic listing against the
+    row-wise get_objects_in_patch form.
+*/
+
+#include "utils/columnar.h"
+#include "utils/json_writer.h"
+
+#include <clocale>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <nlohmann/json.hpp>
+
+using columnar::ColumnBuilder;
+using columnar::Kind;
+using json = nlohmann::json;
+using jsonwriter::JsonWriter;
+
+TEST(JsonWriterTest, NestedStructureRoundTrips) {
+    JsonWriter w;
+    w.begin_object();
+    w.key("a");
+    w.integer(1);
+    w.key("b");
+    w.begin_array();
+    w.number(0.5);
+    w.boolean(true);
+    w.null();
+    w.begin_object();
+    w.end_object();
+    w.end_array();
+    w.key("c");
+    w.value(json{{"k", {1, 2}}});
+    w.end_object();
+
+    json parsed = json::parse(w.str());
+    EXPECT_EQ(parsed, (json{{"a", 1},
+                            {"b", json::array({0.5, true, nullptr, json::object()})},
+                            {"c", {{"k", {1, 2}}}}}));
+}
+
+TEST(JsonWriterTest, StringsAreEscaped) {
+    std::string tricky = "quote\" back\\ nl\n tab\t ctl\x01 utf8 \xc3\xa9";
+    JsonWriter w;
+    w.string(tricky);
+    EXPECT_EQ(json::parse(w.str()).get<std::string>(), tricky);
+}
+
+TEST(JsonWriterTest, NumbersAreShortestRoundTrip) {
+    auto render = [](double v) {
+        std::string out;
+        jsonwriter::append_number(out, v);
+        return out;
+    };
+    EXPECT_EQ(render(100.0), "100");
+    EXPECT_EQ(render(-22.0), "-22");
+    EXPECT_EQ(render(100.5), "100.5");
+    EXPECT_EQ(render(0.1), "0.1");
+    EXPECT_EQ(json::parse(render(1.0 / 3.0)).get<double>(), 1.0 / 3.0);
+    EXPECT_EQ(render(std::numeric_limits<double>::quiet_NaN()), "null");
+    EXPECT_EQ(render(std::numeric_limits<double>::infinity()), "null");
+}
+
+TEST(JsonWriterTest, NumbersIgnoreCommaDecimalLocale) {
+    std::string previous = std::setlocale(LC_NUMERIC, nullptr);
+    const char* comma_locale = nullptr;
+    for (const char* name : {"de_DE.UTF-8", "de_DE.utf8", "fr_FR.UTF-8", "fr_FR.utf8", "de_DE"}) {
+        if (std::setlocale(LC_NUMERIC, name)) {
+            comma_locale = name;
+            break;
+        }
+    }
+    if (!comma_locale) {
+        GTEST_SKIP() << "No locale with a ',' decimal separator installed";
+    }
+
+    std::string out;
+    jsonwriter::append_number(out, 100.5);
+    out += ' ';
+    jsonwriter::append_number(out, 1.0 / 3.0);
+    std::setlocale(LC_NUMERIC, previous.c_str());
+
+    EXPECT_EQ(out.substr(0, 6), "100.5 ");
+    EXPECT_EQ(std::stod(out.substr(6)), 1.0 / 3.0);
+}
+
+TEST(ColumnarTest, WritesParallelColumnsAndTables) {
+    ColumnBuilder columns;
+    auto varname = columns.add_column("varname", Kind::String);
+    auto maxclass = columns.add_column("maxclass", Kind::Interned);
+    auto x = columns.add_column("x", Kind::Number);
+    auto hidden = columns.add_column("hidden", Kind::Flag);
+    auto bgcolor = columns.add_column("bgcolor", Kind::Value);
+
+    columns.push_string(varname, "osc1");
+    columns.push_interned(maxclass, "cycle~");
+    columns.push_number(x, 100.0);
+    columns.push_flag(hidden, false);
+    columns.push_value(bgcolor, json::array({0.2, 0.2, 0.2, 1.0}));
+
+    columns.push_null(varname);
+    columns.push_interned(maxclass, "dac~");
+    columns.push_number(x, 40.5);
+    columns.push_flag(hidden, true);
+    columns.push_null(bgcolor);
+
+    columns.push_string(varname, "osc2");
+    columns.push_interned(maxclass, "cycle~");
+    columns.push_number(x, 220.0);
+    columns.push_flag(hidden, false);
+    columns.push_null(bgcolor);
+
+    JsonWriter w;
+    w.begin_object();
+    w.key("count");
+    w.integer(3);
+    columns.write(w);
+    w.end_object();
+
+    json parsed = json::parse(w.str());
+    EXPECT_EQ(parsed["count"], 3);
+    EXPECT_EQ(parsed["columns"]["varname"], json::array({"osc1", nullptr, "osc2"}));
+    EXPECT_EQ(parsed["columns"]["maxclass"], json::array({0, 1, 0}));
+    EXPECT_EQ(parsed["columns"]["x"], json::array({100, 40.5, 220}));
+    EXPECT_EQ(parsed["columns"]["hidden"], json::array({0, 1, 0}));
+    EXPECT_FALSE(parsed["columns"].contains("bgcolor"));
+    EXPECT_EQ(parsed["attributes"]["bgcolor"],
+              json::array({json::array({0.2, 0.2, 0.2, 1.0}), nullptr, nullptr}));
+    EXPECT_EQ(parsed["tables"]["maxclass"], json::array({"cycle~", "dac~"}));
+}
+
+TEST(ColumnarTest, EmptyListingOmitsOptionalSections) {
+    ColumnBuilder columns;
+    columns.add_column("x", Kind::Number);
+
+    JsonWriter w;
+    w.begin_object();
+    columns.write(w);
+    w.end_object();
+
+    json parsed = json::parse(w.str());
+    EXPECT_EQ(parsed["columns"]["x"], json::array());
+    EXPECT_FALSE(parsed.contains("attributes"));
+    EXPECT_FALSE(parsed.contains("tables"));
+}
+
+TEST(ColumnarTest, SmallerThanRowListing) {
+    // Synthetic 2000-box patch with a realistic class mix, encoded both ways in
+    // the default get_objects_in_patch field set.
+    const std::vector<std::string> classes = {"newobj", "message", "number", "flonum",
+                                              "toggle", "comment", "button", "live.dial"};
+    const size_t n = 2000;
+
+    json rows = json::array();
+    ColumnBuilder columns(n);
+    auto c_varname = columns.add_column("varname", Kind::String);
+    auto c_maxclass = columns.add_column("maxclass", Kind::Interned);
+    auto c_text = columns.add_column("text", Kind::String);
+    auto c_x = columns.add_column("x", Kind::Number);
+    auto c_y = columns.add_column("y", Kind::Number);
+    auto c_w = columns.add_column("width", Kind::Number);
+    auto c_h = columns.add_column("height", Kind::Number);
+
+    for (size_t i = 0; i < n; ++i) {
+        const std::string& cls = classes[i % classes.size()];
+        std::string varname = "obj_" + std::to_string(i);
+        std::string text = cls == "newobj" ? "pack 0 0" : "";
+        double x = 30.0 + 15.0 * (i % 40), y = 30.0 + 45.0 * (i / 40), w = 50.0, h = 22.0;
+
+        rows.push_back({{"index", i},
+                        {"varname", varname},
+                        {"maxclass", cls},
+                        {"text", text},
+                        {"position", {x, y}},
+                        {"size", {w, h}}});
+
+        columns.push_string(c_varname, varname);
+        columns.push_interned(c_maxclass, cls);
+        columns.push_string(c_text, text);
+        columns.push_number(c_x, x);
+        columns.push_number(c_y, y);
+        columns.push_number(c_w, w);
+        columns.push_number(c_h, h);
+    }
+
+    std::string row_text = json{{"objects", rows}, {"count", n}}.dump();
+
+    JsonWriter writer;
+    writer.begin_object();
+    writer.key("count");
+    writer.integer(static_cast<long long>(n));
+    writer.key("index_start");
+    writer.integer(0);
+    columns.write(writer);
+    writer.end_object();
+
+    double ratio = static_cast<double>(row_text.size()) / writer.str().size();
+    EXPECT_GT(ratio, 3.0) << "rows=" << row_text.size() << " B, columnar=" << writer.str().size()
+                          << " B";
+}
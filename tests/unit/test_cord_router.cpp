@@ -0,0 +1,191 @@
+/**
+    @file test_cord_router.cpp
+    Unit tests for the orthogonal cord router (src/utils/cord_router.cpp).
+
+    Hand-built layouts pin the shape of a route (straight, one jog, around a
+    blocker, a feedback loop); seeded random layouts check what every route
+    must satisfy: it starts at the outlet going down, ends at the inlet
+    coming down, only runs horizontally or vertically, and never passes
+    through a box other than its own two.
+*/
+
+#include "utils/cord_router.h"
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using geometry::CordRoute;
+using geometry::CordRouter;
+using geometry::CordRouterOptions;
+using geometry::Point;
+using geometry::Rect;
+
+namespace {
+
+// The full polyline of a route, outlet to inlet
+std::vector<Point> polyline(const Point& start, const CordRoute& route, const Point& end) {
+    std::vector<Point> points{start};
+    points.insert(points.end(), route.midpoints.begin(), route.midpoints.end());
+    points.push_back(end);
+    return points;
+}
+
+void expect_orthogonal(const std::vector<Point>& points) {
+    for (size_t k = 1; k < points.size(); ++k) {
+        EXPECT_TRUE(points[k].x == points[k - 1].x || points[k].y == points[k - 1].y)
+            << "segment " << k << " is diagonal";
+    }
+}
+
+// Whether any segment runs through the interior of a box other than src/dst
+bool crosses_other_box(const std::vector<Point>& points, const std::vector<Rect>& boxes, int src,
+                       int dst) {
+    for (size_t k = 1; k < points.size(); ++k) {
+        const geometry::Segment seg{points[k - 1], points[k]};
+        for (size_t b = 0; b < boxes.size(); ++b) {
+            if (static_cast<int>(b) != src && static_cast<int>(b) != dst &&
+                geometry::segment_intersects_rect(seg, boxes[b], 0.5, nullptr)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+}  // namespace
+
+TEST(CordRouterTest, ClearVerticalCordStaysStraight) {
+    const std::vector<Rect> boxes{{100, 100, 60, 22}, {100, 200, 60, 22}};
+    const CordRouter router(boxes);
+    const CordRoute route = router.route({109.5, 122}, {109.5, 200}, 0, 1);
+
+    ASSERT_TRUE(route.ok);
+    EXPECT_TRUE(route.midpoints.empty());
+    EXPECT_DOUBLE_EQ(route.length, 78.0);
+}
+
+TEST(CordRouterTest, OffsetInletGetsOneJog) {
+    const std::vector<Rect> boxes{{100, 100, 60, 22}, {300, 200, 60, 22}};
+    const CordRouter router(boxes);
+    const Point start{109.5, 122}, end{309.5, 200};
+    const CordRoute route = router.route(start, end, 0, 1);
+
+    ASSERT_TRUE(route.ok);
+    // Down, across, down: two bends
+    ASSERT_EQ(route.midpoints.size(), 2u);
+    EXPECT_DOUBLE_EQ(route.midpoints[0].x, start.x);
+    EXPECT_DOUBLE_EQ(route.midpoints[1].x, end.x);
+    EXPECT_DOUBLE_EQ(route.midpoints[0].y, route.midpoints[1].y);
+    EXPECT_GT(route.midpoints[0].y, start.y);
+    EXPECT_LT(route.midpoints[0].y, end.y);
+}
+
+TEST(CordRouterTest, GoesAroundABlocker) {
+    // A wide box straight between the outlet and the inlet
+    const std::vector<Rect> boxes{{100, 100, 60, 22}, {60, 180, 200, 22}, {100, 300, 60, 22}};
+    CordRouterOptions options;
+    options.margin = 10.0;
+    const CordRouter router(boxes, options);
+    const Point start{109.5, 122}, end{109.5, 300};
+    const CordRoute route = router.route(start, end, 0, 2);
+
+    ASSERT_TRUE(route.ok);
+    const std::vector<Point> points = polyline(start, route, end);
+    expect_orthogonal(points);
+    EXPECT_FALSE(crosses_other_box(points, boxes, 0, 2));
+    // Around the nearer (left) end of the blocker, keeping the margin
+    EXPECT_EQ(route.midpoints.size(), 4u);
+    EXPECT_DOUBLE_EQ(route.midpoints[1].x, 60.0 - 10.0);
+}
+
+TEST(CordRouterTest, FeedbackCordLeavesDownAndEntersFromAbove) {
+    // The inlet is above the outlet: the cord loops around the side
+    const std::vector<Rect> boxes{{100, 100, 60, 22}, {100, 200, 60, 22}};
+    const CordRouter router(boxes);
+    const Point start{109.5, 222}, end{109.5, 100};
+    const CordRoute route = router.route(start, end, 1, 0);
+
+    ASSERT_TRUE(route.ok);
+    const std::vector<Point> points = polyline(start, route, end);
+    expect_orthogonal(points);
+    EXPECT_FALSE(crosses_other_box(points, boxes, -1, -1));
+    EXPECT_GT(points[1].y, start.y);                // leaves going down
+    EXPECT_LT(points[points.size() - 2].y, end.y);  // enters coming down
+}
+
+TEST(CordRouterTest, GapNarrowerThanTwoMarginsStaysOpen) {
+    // Inside a closed frame, a barrier with a 6 px gap separates the two
+    // boxes: the 10 px margin would close it, so its sides keep 3 px each.
+    const std::vector<Rect> boxes{{20, -60, 60, 22},      {38, 60, 30, 22},  // source, destination
+                                  {-90, 0, 130, 22},      {46, 0, 144, 22},  // barrier
+                                  {-100, -100, 300, 10},  {-100, 150, 300, 10},
+                                  {-100, -100, 10, 260},  {190, -100, 10, 260}};  // frame
+    CordRouterOptions options;
+    options.margin = 10.0;
+    const CordRouter router(boxes, options);
+    const Point start{43, -38}, end{43, 60};
+    const CordRoute route = router.route(start, end, 0, 1);
+
+    ASSERT_TRUE(route.ok);
+    EXPECT_TRUE(route.midpoints.empty());
+    EXPECT_FALSE(crosses_other_box(polyline(start, route, end), boxes, 0, 1));
+}
+
+TEST(CordRouterTest, EnclosedInletHasNoRoute) {
+    // The inlet sits inside a box that is not the cord's own
+    const std::vector<Rect> boxes{{0, 0, 40, 22}, {0, 100, 40, 22}, {-50, 60, 140, 100}};
+    const CordRouter router(boxes);
+    EXPECT_FALSE(router.route({9.5, 22}, {9.5, 100}, 0, 1).ok);
+}
+
+TEST(CordRouterTest, RandomLayoutsKeepTheInvariants) {
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<double> coord(0.0, 1200.0);
+    std::uniform_real_distribution<double> width(30.0, 140.0);
+
+    for (int round = 0; round < 4; ++round) {
+        // Non-overlapping boxes on a loose grid with jitter
+        std::vector<Rect> boxes;
+        for (int i = 0; i < 150; ++i) {
+            const Rect r{coord(rng), coord(rng), width(rng), 22.0};
+            bool clear = true;
+            for (const Rect& other : boxes) {
+                clear = clear && !geometry::aabb_overlap(r, other, -4.0);
+            }
+            if (clear) {
+                boxes.push_back(r);
+            }
+        }
+        const CordRouter router(boxes);
+        std::uniform_int_distribution<int> pick(0, static_cast<int>(boxes.size()) - 1);
+
+        SCOPED_TRACE("round " + std::to_string(round));
+        int routed = 0;
+        for (int c = 0; c < 60; ++c) {
+            // Cords are mostly local in a patch: a box within 500 px
+            int src = pick(rng), dst = pick(rng);
+            while (src == dst || std::abs(boxes[src].origin.x - boxes[dst].origin.x) +
+                                         std::abs(boxes[src].origin.y - boxes[dst].origin.y) >
+                                     500.0) {
+                src = pick(rng);
+                dst = pick(rng);
+            }
+            const Point start{boxes[src].origin.x + 9.5, boxes[src].bottom()};
+            const Point end{boxes[dst].origin.x + 9.5, boxes[dst].origin.y};
+            const CordRoute route = router.route(start, end, src, dst);
+            if (!route.ok) {
+                continue;
+            }
+            ++routed;
+            const std::vector<Point> points = polyline(start, route, end);
+            expect_orthogonal(points);
+            EXPECT_FALSE(crosses_other_box(points, boxes, src, dst)) << "cord " << c;
+            EXPECT_GT(points[1].y, start.y);
+            EXPECT_LT(points[points.size() - 2].y, end.y);
+        }
+        EXPECT_GT(routed, 55);
+    }
+}
@@ -0,0 +1,66 @@
+/**
+    @file test_field_selection.cpp
+    Unit tests for the "fields" projection parser (src/utils/field_selection.cpp).
+*/
+
+#include "utils/field_selection.h"
+
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <nlohmann/json.hpp>
+
+using field_selection::FieldSelection;
+using field_selection::parse_fields;
+using json = nlohmann::json;
+
+namespace {
+
+const std::vector<std::string> kBuiltins = {"index", "varname", "maxclass", "position"};
+
+}  // namespace
+
+TEST(FieldSelectionTest, AbsentFieldsLeavesSelectionEmpty) {
+    std::optional<FieldSelection> out = FieldSelection{};
+    EXPECT_TRUE(parse_fields({{"patch_id", "p"}}, kBuiltins, out).is_null());
+    EXPECT_FALSE(out.has_value());
+}
+
+TEST(FieldSelectionTest, SplitsBuiltinsFromAttributesInRequestOrder) {
+    std::optional<FieldSelection> out;
+    json params = {{"fields", {"position", "bgcolor", "varname", "fontsize"}}};
+    ASSERT_TRUE(parse_fields(params, kBuiltins, out).is_null());
+    ASSERT_TRUE(out.has_value());
+
+    EXPECT_EQ(out->builtins, (std::vector<size_t>{3, 1}));
+    EXPECT_EQ(out->attributes, (std::vector<std::string>{"bgcolor", "fontsize"}));
+    EXPECT_TRUE(out->has(1));
+    EXPECT_FALSE(out->has(0));
+}
+
+TEST(FieldSelectionTest, DuplicatesAreDropped) {
+    std::optional<FieldSelection> out;
+    json params = {{"fields", {"varname", "bgcolor", "varname", "bgcolor"}}};
+    ASSERT_TRUE(parse_fields(params, kBuiltins, out).is_null());
+    EXPECT_EQ(out->builtins.size(), 1u);
+    EXPECT_EQ(out->attributes.size(), 1u);
+}
+
+TEST(FieldSelectionTest, RejectsMalformedFields) {
+    std::optional<FieldSelection> out;
+    EXPECT_TRUE(parse_fields({{"fields", "varname"}}, kBuiltins, out).contains("error"));
+    EXPECT_TRUE(parse_fields({{"fields", json::array()}}, kBuiltins, out).contains("error"));
+    EXPECT_TRUE(parse_fields({{"fields", {"varname", 3}}}, kBuiltins, out).contains("error"));
+    EXPECT_TRUE(parse_fields({{"fields", {""}}}, kBuiltins, out).contains("error"));
+    EXPECT_FALSE(out.has_value());
+}
+
+TEST(FieldSelectionTest, RejectsFieldsCombinedWithMode) {
+    std::optional<FieldSelection> out;
+    json params = {{"fields", {"varname"}}, {"mode", "layout"}};
+    auto error = parse_fields(params, kBuiltins, out);
+    ASSERT_TRUE(error.contains("error"));
+    EXPECT_NE(error["error"]["message"].get<std::string>().find("mode"), std::string::npos);
+}
@@ -0,0 +1,217 @@
+/**
+    @file test_geometry_batch.cpp
+    Unit tests for the batch geometry predicates (src/utils/geometry_batch.cpp).
+
+    Every kernel this CPU can run (scalar, SSE2, AVX2) is compared bit for bit
+    with the one-at-a-time predicates in geometry.cpp, over seeded rects and
+    segments on a coarse lattice (so touching edges, shared corners and
+    zero-length segments come up often), with NaN, infinities and negative
+    zeros mixed in, and over ranges that start and end off the vector width
+    and across 64-bit mask words.
+*/
+
+#include "utils/geometry_batch.h"
+
+#include <cmath>
+#include <limits>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using geometry::BitMask;
+using geometry::Rect;
+using geometry::RectSoA;
+using geometry::Segment;
+using geometry::SegmentSoA;
+using geometry::SimdLevel;
+
+namespace {
+
+std::vector<SimdLevel> levels() {
+    std::vector<SimdLevel> all{SimdLevel::Scalar};
+    if (geometry::simd_level() >= SimdLevel::Sse2) {
+        all.push_back(SimdLevel::Sse2);
+    }
+    if (geometry::simd_level() >= SimdLevel::Avx2) {
+        all.push_back(SimdLevel::Avx2);
+    }
+    return all;
+}
+
+// Coordinates on a 4 px lattice, with an occasional non-finite or signed zero.
+class Lattice {
+  public:
+    explicit Lattice(unsigned seed) : rng_(seed) {}
+
+    double coord() {
+        if (special_(rng_) == 0) {
+            const double values[] = {std::numeric_limits<double>::quiet_NaN(),
+                                     std::numeric_limits<double>::infinity(),
+                                     -std::numeric_limits<double>::infinity(), -0.0, 0.0};
+            return values[pick_(rng_) % 5];
+        }
+        return 4.0 * static_cast<double>(pick_(rng_) % 40);
+    }
+
+    Rect rect() {
+        return {coord(), coord(), 4.0 * static_cast<double>(pick_(rng_) % 12),
+                4.0 * static_cast<double>(pick_(rng_) % 12)};
+    }
+
+    Segment segment() {
+        Segment s{{coord(), coord()}, {coord(), coord()}};
+        switch (pick_(rng_) % 4) {
+        case 0:
+            s.b.x = s.a.x;  // vertical (or a point)
+            break;
+        case 1:
+            s.b.y = s.a.y;  // horizontal
+            break;
+        default:
+            break;
+        }
+        return s;
+    }
+
+  private:
+    std::mt19937 rng_;
+    std::uniform_int_distribution<int> special_{0, 30};
+    std::uniform_int_distribution<int> pick_{0, 1 << 20};
+};
+
+bool bit(const BitMask& mask, size_t k) {
+    return (mask[k / 64] >> (k % 64)) & 1u;
+}
+
+// [begin, end) ranges over n items: whole, off the vector width, a single
+// item, empty, and across a mask word boundary.
+std::vector<std::pair<size_t, size_t>> ranges(size_t n) {
+    return {{0, n}, {3, n - 5}, {7, 8}, {9, 9}, {61, 130}};
+}
+
+constexpr double kEpsilons[] = {-8.0, -0.0, 0.0, 2.0};
+
+}  // namespace
+
+TEST(GeometryBatchTest, OverlapMaskMatchesAabbOverlap) {
+    Lattice lattice(3);
+    std::vector<Rect> rects;
+    for (int i = 0; i < 300; ++i) {
+        rects.push_back(lattice.rect());
+    }
+    const RectSoA soa = RectSoA::from(rects);
+
+    BitMask mask;
+    for (SimdLevel level : levels()) {
+        for (int t = 0; t < 60; ++t) {
+            const Rect query = lattice.rect();
+            for (double eps : kEpsilons) {
+                for (const auto& [begin, end] : ranges(rects.size())) {
+                    geometry::overlap_mask(query, soa, begin, end, eps, mask, level);
+                    ASSERT_EQ(mask.size(), geometry::mask_words(end - begin));
+                    for (size_t k = 0; k < mask.size() * 64; ++k) {
+                        const bool expected =
+                            begin + k < end && geometry::aabb_overlap(query, rects[begin + k], eps);
+                        ASSERT_EQ(bit(mask, k), expected)
+                            << geometry::simd_level_name(level) << " query " << t << " eps " << eps
+                            << " item " << begin + k;
+                    }
+                }
+            }
+        }
+    }
+}
+
+TEST(GeometryBatchTest, SegmentRectMaskMatchesSegmentIntersectsRect) {
+    Lattice lattice(5);
+    std::vector<Rect> rects;
+    for (int i = 0; i < 300; ++i) {
+        rects.push_back(lattice.rect());
+    }
+    const RectSoA soa = RectSoA::from(rects);
+
+    BitMask mask;
+    for (SimdLevel level : levels()) {
+        for (int t = 0; t < 200; ++t) {
+            const Segment seg = lattice.segment();
+            for (double eps : kEpsilons) {
+                for (const auto& [begin, end] : ranges(rects.size())) {
+                    geometry::segment_rect_mask(seg, soa, begin, end, eps, mask, level);
+                    for (size_t k = 0; k < mask.size() * 64; ++k) {
+                        const bool expected =
+                            begin + k < end && geometry::segment_intersects_rect(
+                                                   seg, rects[begin + k], eps, nullptr);
+                        ASSERT_EQ(bit(mask, k), expected)
+                            << geometry::simd_level_name(level) << " segment " << t << " eps "
+                            << eps << " item " << begin + k;
+                    }
+                }
+            }
+        }
+    }
+}
+
+TEST(GeometryBatchTest, UpwardMaskMatchesSegmentIsUpward) {
+    Lattice lattice(7);
+    std::vector<Segment> segments;
+    SegmentSoA soa;
+    for (int i = 0; i < 300; ++i) {
+        segments.push_back(lattice.segment());
+        soa.push_back(segments.back());
+    }
+
+    BitMask mask;
+    for (SimdLevel level : levels()) {
+        for (double eps : kEpsilons) {
+            for (const auto& [begin, end] : ranges(segments.size())) {
+                geometry::upward_mask(soa, begin, end, eps, mask, level);
+                for (size_t k = 0; k < mask.size() * 64; ++k) {
+                    const bool expected =
+                        begin + k < end && geometry::segment_is_upward(segments[begin + k], eps);
+                    ASSERT_EQ(bit(mask, k), expected)
+                        << geometry::simd_level_name(level) << " eps " << eps << " item "
+                        << begin + k;
+                }
+            }
+        }
+    }
+}
+
+TEST(GeometryBatchTest, SegmentRectMaskTreatsRectsAsClosed) {
+    // Crosses the first rect, runs along the second's top edge, misses the third
+    const std::vector<Rect> rects{{10.0, 0.0, 20.0, 20.0}, {40.0, 10.0, 20.0, 20.0},
+                                  {0.0, 50.0, 10.0, 10.0}};
+    const Segment seg{{0.0, 10.0}, {100.0, 10.0}};
+    BitMask mask;
+    for (SimdLevel level : levels()) {
+        geometry::segment_rect_mask(seg, RectSoA::from(rects), 0, rects.size(), 2.0, mask, level);
+        EXPECT_EQ(mask, (BitMask{0b011})) << geometry::simd_level_name(level);
+    }
+}
+
+TEST(GeometryBatchTest, ForEachSetBitVisitsAscending) {
+    const BitMask mask{(uint64_t{1} << 63) | 0b101, 0, 0b10};
+    std::vector<size_t> seen;
+    geometry::for_each_set_bit(mask, [&](size_t k) { seen.push_back(k); });
+    EXPECT_EQ(seen, (std::vector<size_t>{0, 2, 63, 129}));
+}
+
+TEST(GeometryBatchTest, SwapRemoveMovesTheLastRect) {
+    RectSoA soa = RectSoA::from({{0.0, 0.0, 1.0, 1.0}, {5.0, 5.0, 1.0, 1.0}, {9.0, 9.0, 2.0, 2.0}});
+    soa.swap_remove(0);
+    ASSERT_EQ(soa.size(), 2u);
+    EXPECT_EQ(soa.x0, (std::vector<double>{9.0, 5.0}));
+    EXPECT_EQ(soa.x1, (std::vector<double>{11.0, 6.0}));
+}
+
+TEST(GeometryBatchTest, LevelIsCappedAtWhatTheCpuSupports) {
+    // Asking for AVX2 is always safe; it runs the best kernel available.
+    const std::vector<Rect> rects{{0.0, 0.0, 10.0, 10.0}, {20.0, 0.0, 10.0, 10.0}};
+    BitMask mask;
+    geometry::overlap_mask({5.0, 5.0, 10.0, 10.0}, RectSoA::from(rects), 0, 2, 0.0, mask,
+                           SimdLevel::Avx2);
+    EXPECT_EQ(mask, (BitMask{0b01}));
+    EXPECT_STRNE(geometry::simd_level_name(geometry::simd_level()), "");
+}
@@ -5,12 +5,22 @@
     These exercise the validate_layout decision logic without the Max SDK: the
     five checks (overlap, upward, cord_object, cord_cord, presentation_overlap),
     severity assignment, endpoint exclusion for cord-vs-object, and the summary
-    counters. The underlying geometry is covered separately in test_geometry.cpp.
+    counters, and that the parallel run reports exactly what a single thread does.
+    LayoutCheckCache is checked against run_layout_checks over randomized edit
+    sequences (moves, resizes, renames, added/removed/reordered boxes and cords).
+    The underlying geometry is covered separately in test_geometry.cpp.
 */
 
 #include "tools/layout_checks.h"
+#include "utils/work_pool.h"
 
+#include <algorithm>
+#include <map>
+#include <random>
+#include <set>
 #include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include <gtest/gtest.h>
@@ -39,6 +49,71 @@ int summary_of(const json& result, const std::string& key) {
     return result.at("summary").at(key).get<int>();
 }
 
+// Options running only the cord_object check.
+LayoutCheckOptions cord_object_only() {
+    LayoutCheckOptions opt;
+    opt.check_overlap = false;
+    opt.check_upward = false;
+    opt.check_cord_cord = false;
+    return opt;
+}
+
+// Options running only the cord_cord check.
+LayoutCheckOptions cord_cord_only() {
+    LayoutCheckOptions opt;
+    opt.check_overlap = false;
+    opt.check_upward = false;
+    opt.check_cord_object = false;
+    return opt;
+}
+
+// A seeded patch of objects and cords (some folded) between random objects.
+void random_patch(size_t n_objects, size_t n_cords, unsigned seed,
+                  std::vector<LayoutObject>& objects, std::vector<LayoutCord>& cords) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> pos(0.0, 1500.0);
+    std::uniform_real_distribution<double> width(30.0, 150.0);
+    std::uniform_int_distribution<int> pick(0, static_cast<int>(n_objects) - 1);
+    for (size_t i = 0; i < n_objects; ++i) {
+        objects.push_back(obj(static_cast<int>(i), "o" + std::to_string(i), pos(rng), pos(rng),
+                              width(rng), 22.0));
+    }
+    for (size_t c = 0; c < n_cords; ++c) {
+        const LayoutObject& src = objects[pick(rng)];
+        const LayoutObject& dst = objects[pick(rng)];
+        LayoutCord lc = cord(src.id, src.varname, dst.id, dst.varname, src.rect.origin.x,
+                             src.rect.bottom(), dst.rect.origin.x, dst.rect.origin.y);
+        if (c % 3 == 0) {
+            // Fold through an axis-aligned detour
+            lc.midpoints = {{lc.start.x, lc.start.y + 15.0}, {lc.end.x, lc.start.y + 15.0}};
+        }
+        cords.push_back(lc);
+    }
+}
+
+// The original full segment x object scan, as (cord index, object label) in
+// reporting order.
+std::vector<std::pair<size_t, std::string>> brute_cord_object(
+    const std::vector<LayoutObject>& objects, const std::vector<LayoutCord>& cords, double eps) {
+    std::vector<std::pair<size_t, std::string>> hits;
+    for (size_t c = 0; c < cords.size(); ++c) {
+        std::set<int> flagged;
+        for (const geometry::Segment& seg : cords[c].segments()) {
+            for (const LayoutObject& o : objects) {
+                if (o.id == cords[c].src_id || o.id == cords[c].dst_id || flagged.count(o.id)) {
+                    continue;
+                }
+                geometry::Point entry{0.0, 0.0};
+                if (geometry::segment_intersects_rect(seg, o.rect, eps, &entry)) {
+                    flagged.insert(o.id);
+                    hits.emplace_back(c, o.varname);
+                }
+            }
+        }
+    }
+    return hits;
+}
+
 }  // namespace
 
 // ---------------------------------------------------------------------------
@@ -64,6 +139,21 @@ TEST(RunLayoutChecks, DetectsObjectOverlap) {
     EXPECT_EQ(f.at("severity"), "error");
 }
 
+TEST(RunLayoutChecks, OverlapFindingsFollowObjectOrder) {
+    // Listed right-to-left, so x order is the reverse of patcher order; findings
+    // must still come out as (0,1), (0,2), (1,2).
+    std::vector<LayoutObject> objects{obj(0, "c", 80.0, 0.0, 60.0, 20.0),
+                                      obj(1, "b", 40.0, 5.0, 60.0, 20.0),
+                                      obj(2, "a", 0.0, 10.0, 100.0, 20.0)};
+    json result = run_layout_checks(objects, {}, LayoutCheckOptions{});
+    ASSERT_EQ(summary_of(result, "overlap"), 3);
+    const json& findings = result.at("findings");
+    EXPECT_EQ(findings.at(0).at("objects"), json::array({"c", "b"}));
+    EXPECT_EQ(findings.at(1).at("objects"), json::array({"c", "a"}));
+    EXPECT_EQ(findings.at(2).at("objects"), json::array({"b", "a"}));
+    EXPECT_EQ(findings.at(0).at("detail"), "patching_rect overlap area 300 px^2 (x:80-100 y:5-20)");
+}
+
 // ---------------------------------------------------------------------------
 // upward
 // ---------------------------------------------------------------------------
@@ -124,6 +214,50 @@ TEST(RunLayoutChecks, CordDoesNotFlagItsOwnEndpoints) {
     EXPECT_TRUE(result.at("clean").get<bool>());
 }
 
+TEST(RunLayoutChecks, CordObjectReportsEachObjectOncePerCordInSegmentOrder) {
+    // A folded cord from a(0) down, right along y=200 and up again to b(1). The
+    // first segment crosses d(3); the second runs through d again, then c(2).
+    std::vector<LayoutObject> objects{
+        obj(0, "a", 0.0, 0.0, 40.0, 20.0), obj(1, "b", 400.0, 0.0, 40.0, 20.0),
+        obj(2, "c", 300.0, 190.0, 40.0, 20.0), obj(3, "d", 0.0, 100.0, 200.0, 120.0)};
+    LayoutCord c{0, "a", 0, 1, "b", 0, {20.0, 20.0}, {420.0, 20.0},
+                 {{20.0, 200.0}, {420.0, 200.0}}};
+    json result = run_layout_checks(objects, {c}, cord_object_only());
+    ASSERT_EQ(summary_of(result, "cord_object"), 2);
+    EXPECT_EQ(result.at("findings").at(0).at("object"), "d");
+    EXPECT_EQ(result.at("findings").at(1).at("object"), "c");
+}
+
+TEST(RunLayoutChecks, CordAlongAnObjectEdgeIsStillTested) {
+    // Runs exactly along c's top edge: its bounding box only touches the rect
+    std::vector<LayoutObject> objects{obj(0, "a", 0.0, 80.0, 40.0, 20.0),
+                                      obj(1, "b", 400.0, 80.0, 40.0, 20.0),
+                                      obj(2, "c", 200.0, 100.0, 60.0, 30.0)};
+    std::vector<LayoutCord> cords{cord(0, "a", 1, "b", 20.0, 100.0, 420.0, 100.0)};
+    json result = run_layout_checks(objects, cords, cord_object_only());
+    ASSERT_EQ(summary_of(result, "cord_object"), 1);
+    EXPECT_EQ(result.at("findings").at(0).at("object"), "c");
+}
+
+TEST(RunLayoutChecks, CordObjectMatchesFullScanOnRandomPatch) {
+    std::vector<LayoutObject> objects;
+    std::vector<LayoutCord> cords;
+    random_patch(400, 300, 21, objects, cords);
+
+    json result = run_layout_checks(objects, cords, cord_object_only());
+    std::vector<std::pair<size_t, std::string>> expected = brute_cord_object(objects, cords, 2.0);
+    ASSERT_GT(expected.size(), 10u);
+    ASSERT_EQ(result.at("findings").size(), expected.size());
+
+    for (size_t k = 0; k < expected.size(); ++k) {
+        const json& f = result.at("findings").at(k);
+        const size_t c = expected[k].first;
+        EXPECT_EQ(f.at("cord").at("src_varname"), cords[c].src_varname) << k;
+        EXPECT_EQ(f.at("cord").at("dst_varname"), cords[c].dst_varname) << k;
+        EXPECT_EQ(f.at("object"), expected[k].second) << k;
+    }
+}
+
 // ---------------------------------------------------------------------------
 // cord_cord
 // ---------------------------------------------------------------------------
@@ -143,6 +277,64 @@ TEST(RunLayoutChecks, CollinearCordsOverlap) {
     EXPECT_EQ(summary_of(result, "cord_cord"), 1);
 }
 
+TEST(RunLayoutChecks, CordCordReportsEachPairOnceInScanOrder) {
+    std::vector<LayoutObject> objects{obj(0, "a", 0.0, 0.0, 50.0, 20.0),
+                                      obj(1, "b", 0.0, 300.0, 50.0, 20.0)};
+    // Cord 0 is folded: its last two segments also run along cord 1 (x=25 and
+    // y=200). Cord 2 only overlaps cord 1, but on cord 1's first segment, so
+    // the (1, 2) pair comes first.
+    LayoutCord c0{0, "a", 0, 1, "b", 0, {300.0, 20.0}, {25.0, 300.0},
+                  {{300.0, 200.0}, {100.0, 200.0}, {25.0, 200.0}, {25.0, 250.0}}};
+    LayoutCord c1{0, "a", 1, 1, "b", 1, {25.0, 20.0}, {25.0, 300.0}, {{25.0, 200.0}}};
+    LayoutCord c2{0, "a", 2, 1, "b", 2, {25.0, 100.0}, {25.0, 150.0}, {}};
+    json result = run_layout_checks(objects, {c0, c1, c2}, cord_cord_only());
+    ASSERT_EQ(summary_of(result, "cord_cord"), 2);
+    const json& findings = result.at("findings");
+    EXPECT_EQ(findings.at(0).at("cords").at(0).at("outlet"), 0);
+    EXPECT_EQ(findings.at(0).at("cords").at(1).at("outlet"), 1);
+    EXPECT_EQ(findings.at(1).at("cords").at(0).at("outlet"), 1);
+    EXPECT_EQ(findings.at(1).at("cords").at(1).at("outlet"), 2);
+}
+
+TEST(RunLayoutChecks, CordCordMatchesFullScanOnRandomPatch) {
+    std::vector<LayoutObject> objects;
+    std::vector<LayoutCord> cords;
+    random_patch(60, 400, 8, objects, cords);
+    for (LayoutCord& c : cords) {
+        c.outlet = static_cast<long>(&c - cords.data());  // make every cord identifiable
+    }
+
+    // The original all-segment-pairs scan with a set of reported cord pairs
+    std::vector<std::pair<size_t, size_t>> expected;
+    std::set<std::pair<size_t, size_t>> seen;
+    std::vector<std::pair<size_t, geometry::Segment>> segs;
+    for (size_t c = 0; c < cords.size(); ++c) {
+        for (const geometry::Segment& seg : cords[c].segments()) {
+            segs.emplace_back(c, seg);
+        }
+    }
+    for (size_t a = 0; a < segs.size(); ++a) {
+        for (size_t b = a + 1; b < segs.size(); ++b) {
+            if (segs[a].first != segs[b].first &&
+                geometry::segments_overlap_collinear(segs[a].second, segs[b].second, 2.0)) {
+                std::pair<size_t, size_t> pair = std::minmax(segs[a].first, segs[b].first);
+                if (seen.insert(pair).second) {
+                    expected.push_back(pair);
+                }
+            }
+        }
+    }
+
+    json result = run_layout_checks(objects, cords, cord_cord_only());
+    ASSERT_GT(expected.size(), 10u);
+    ASSERT_EQ(result.at("findings").size(), expected.size());
+    for (size_t k = 0; k < expected.size(); ++k) {
+        const json& pair = result.at("findings").at(k).at("cords");
+        EXPECT_EQ(pair.at(0).at("outlet"), expected[k].first) << k;
+        EXPECT_EQ(pair.at(1).at("outlet"), expected[k].second) << k;
+    }
+}
+
 // ---------------------------------------------------------------------------
 // presentation mode
 // ---------------------------------------------------------------------------
@@ -173,3 +365,360 @@ TEST(RunLayoutChecks, DisabledChecksProduceNoFindings) {
     EXPECT_TRUE(result.at("clean").get<bool>());
     EXPECT_EQ(summary_of(result, "overlap"), 0);
 }
+
+// ---------------------------------------------------------------------------
+// parallel execution
+// ---------------------------------------------------------------------------
+
+TEST(RunLayoutChecks, ParallelRunMatchesSingleThread) {
+    // Large enough for every check to be split into several tasks
+    std::vector<LayoutObject> objects;
+    std::vector<LayoutCord> cords;
+    random_patch(1500, 1200, 5, objects, cords);
+
+    parallel::WorkPool inline_pool(0);
+    parallel::WorkPool pool(3);
+    const json expected = run_layout_checks(objects, cords, LayoutCheckOptions{}, inline_pool);
+    ASSERT_GT(summary_of(expected, "overlap"), 1000);
+    ASSERT_GT(summary_of(expected, "cord_object"), 300);
+
+    for (int round = 0; round < 3; ++round) {
+        EXPECT_EQ(run_layout_checks(objects, cords, LayoutCheckOptions{}, pool), expected);
+    }
+
+    // Findings are grouped by check in a fixed order
+    const std::vector<std::string> order{"overlap", "upward", "cord_object", "cord_cord"};
+    size_t rank = 0;
+    for (const json& f : expected.at("findings")) {
+        const auto it = std::find(order.begin(), order.end(), f.at("type").get<std::string>());
+        ASSERT_NE(it, order.end());
+        EXPECT_GE(static_cast<size_t>(it - order.begin()), rank);
+        rank = it - order.begin();
+    }
+}
+
+// ---------------------------------------------------------------------------
+// cords_needing_route
+// ---------------------------------------------------------------------------
+
+TEST(CordsNeedingRoute, MatchesTheUpwardAndCordObjectFindings) {
+    std::vector<LayoutObject> objects;
+    std::vector<LayoutCord> cords;
+    random_patch(300, 200, 9, objects, cords);
+
+    LayoutCheckOptions opt;
+    opt.check_overlap = false;
+    opt.check_cord_cord = false;
+    std::vector<size_t> expected;
+    for (size_t c = 0; c < cords.size(); ++c) {
+        if (!run_layout_checks(objects, {cords[c]}, opt).at("clean").get<bool>()) {
+            expected.push_back(c);
+        }
+    }
+    ASSERT_GT(expected.size(), 20u);
+    ASSERT_LT(expected.size(), cords.size());
+    EXPECT_EQ(cords_needing_route(objects, cords, opt.epsilon), expected);
+}
+
+// ---------------------------------------------------------------------------
+// LayoutCheckCache (incremental re-checks)
+// ---------------------------------------------------------------------------
+
+namespace {
+
+using LayoutTools::LayoutCheckCache;
+using LayoutTools::LayoutKey;
+using LayoutTools::LayoutSnapshot;
+
+// A patch that goes through random edits between validate_layout calls. Boxes
+// and lines keep their key; ids are renumbered by patcher order and cord ends
+// follow their boxes, as when reading a real patcher. Coordinates sit on a
+// 20 px lattice in a small area, so every kind of finding comes up.
+class EditedPatch {
+  public:
+    explicit EditedPatch(unsigned seed) : rng_(seed) {
+        for (int i = 0; i < 60; ++i) {
+            boxes_.push_back(new_box());
+        }
+        for (int c = 0; c < 70; ++c) {
+            add_line();
+        }
+    }
+
+    LayoutSnapshot snapshot() const {
+        LayoutSnapshot s;
+        std::unordered_map<LayoutKey, size_t> pos;
+        for (size_t i = 0; i < boxes_.size(); ++i) {
+            const Box& b = boxes_[i];
+            pos[b.key] = i;
+            s.objects.push_back({static_cast<int>(i), b.varname, "newobj", b.rect, true});
+            s.object_keys.push_back(b.key);
+        }
+        for (const Line& l : lines_) {
+            const Box& src = boxes_[pos.at(l.src)];
+            const Box& dst = boxes_[pos.at(l.dst)];
+            LayoutCord c = cord(static_cast<int>(pos.at(l.src)), src.varname,
+                                static_cast<int>(pos.at(l.dst)), dst.varname,
+                                src.rect.origin.x + 5.0, src.rect.bottom(), dst.rect.origin.x + 5.0,
+                                dst.rect.origin.y);
+            if (l.folded) {
+                c.midpoints = {{c.start.x, l.fold_y}, {c.end.x, l.fold_y}};
+            }
+            s.cords.push_back(c);
+            s.cord_keys.push_back(l.key);
+        }
+        return s;
+    }
+
+    // One random edit: move, resize, rename, add or remove a box or a line,
+    // refold a line, or reorder two boxes.
+    void edit() {
+        switch (pick(10)) {
+        case 0:
+        case 1:
+            box().rect.origin = {lattice(30), lattice(30)};
+            break;
+        case 2:
+            box().rect.width = 20.0 + lattice(5);
+            break;
+        case 3:
+            box().varname = pick(3) == 0 ? "" : "n" + std::to_string(next_key_++);
+            break;
+        case 4:
+            boxes_.insert(boxes_.begin() + pick(boxes_.size() + 1), new_box());
+            break;
+        case 5:
+            if (boxes_.size() > 2) {
+                const size_t i = pick(boxes_.size());
+                const LayoutKey key = boxes_[i].key;
+                boxes_.erase(boxes_.begin() + i);
+                lines_.erase(std::remove_if(lines_.begin(), lines_.end(),
+                                            [&](const Line& l) {
+                                                return l.src == key || l.dst == key;
+                                            }),
+                             lines_.end());
+            }
+            break;
+        case 6:
+            add_line();
+            break;
+        case 7:
+            if (!lines_.empty()) {
+                lines_.erase(lines_.begin() + pick(lines_.size()));
+            }
+            break;
+        case 8:
+            if (!lines_.empty()) {
+                Line& l = lines_[pick(lines_.size())];
+                l.folded = !l.folded;
+                l.fold_y = lattice(30);
+            }
+            break;
+        default:
+            std::swap(box(), box());
+            break;
+        }
+    }
+
+  private:
+    struct Box {
+        LayoutKey key;
+        std::string varname;
+        geometry::Rect rect;
+    };
+    struct Line {
+        LayoutKey key;
+        LayoutKey src, dst;
+        bool folded;
+        double fold_y;
+    };
+
+    size_t pick(size_t n) {
+        return std::uniform_int_distribution<size_t>(0, n - 1)(rng_);
+    }
+    double lattice(size_t cells) {
+        return 20.0 * static_cast<double>(pick(cells));
+    }
+    Box& box() {
+        return boxes_[pick(boxes_.size())];
+    }
+    Box new_box() {
+        const LayoutKey key = next_key_++;
+        return {key, "b" + std::to_string(key),
+                {lattice(30), lattice(30), 20.0 + lattice(5), 22.0}};
+    }
+    void add_line() {
+        const LayoutKey key = next_key_++;
+        lines_.push_back({key, box().key, box().key, pick(2) == 0, lattice(30)});
+    }
+
+    std::mt19937 rng_;
+    LayoutKey next_key_ = 1;
+    std::vector<Box> boxes_;
+    std::vector<Line> lines_;
+};
+
+// The cached run reports what a run from scratch does; returns the latter.
+json expect_same_as_full_run(LayoutCheckCache& cache, const LayoutSnapshot& s,
+                             const LayoutCheckOptions& options, parallel::WorkPool& pool,
+                             const std::string& where) {
+    const json expected = run_layout_checks(s.objects, s.cords, options, pool);
+    const json result = cache.update(s, options, false, pool);
+    EXPECT_EQ(result.at("findings"), expected.at("findings")) << where;
+    EXPECT_EQ(result.at("summary"), expected.at("summary")) << where;
+    EXPECT_EQ(result.at("clean"), expected.at("clean")) << where;
+    return expected;
+}
+
+}  // namespace
+
+TEST(LayoutCheckCache, MatchesFullRunUnderRandomEdits) {
+    LayoutCheckOptions exact;
+    exact.epsilon = 0.0;
+    LayoutCheckOptions presentation;
+    presentation.presentation_mode = true;
+    LayoutCheckOptions cords_only;
+    cords_only.check_overlap = false;
+
+    parallel::WorkPool pool(2);
+    std::map<std::string, int> seen;
+    const std::vector<LayoutCheckOptions> option_sets{LayoutCheckOptions{}, exact, presentation,
+                                                      cords_only};
+    for (size_t set = 0; set < option_sets.size(); ++set) {
+        EditedPatch patch(100 + static_cast<unsigned>(set));
+        LayoutCheckCache cache;
+        for (int round = 0; round < 150; ++round) {
+            // Mostly a few edits, sometimes a large batch
+            const int edits = round % 25 == 24 ? 40 : round % 3;
+            for (int e = 0; e < edits; ++e) {
+                patch.edit();
+            }
+            const json expected = expect_same_as_full_run(
+                cache, patch.snapshot(), option_sets[set], pool,
+                "options " + std::to_string(set) + " round " + std::to_string(round));
+            for (const json& f : expected.at("findings")) {
+                ++seen[f.at("type").get<std::string>()];
+            }
+        }
+    }
+    for (const char* type :
+         {"overlap", "upward", "cord_object", "cord_cord", "presentation_overlap"}) {
+        EXPECT_GT(seen[type], 50) << type;
+    }
+}
+
+TEST(LayoutCheckCache, MatchesFullRunWhenOptionsChange) {
+    EditedPatch patch(7);
+    LayoutCheckCache cache;
+    parallel::WorkPool pool(0);
+    for (int round = 0; round < 40; ++round) {
+        patch.edit();
+        LayoutCheckOptions options;
+        options.epsilon = round % 4 == 0 ? 0.0 : 2.0;
+        options.check_cord_cord = round % 3 != 0;
+        expect_same_as_full_run(cache, patch.snapshot(), options, pool,
+                                "round " + std::to_string(round));
+    }
+}
+
+TEST(LayoutCheckCache, MatchesFullRunOnALargePatch) {
+    // Large enough that the first call and big batches take the sweep paths
+    LayoutSnapshot s;
+    random_patch(600, 500, 9, s.objects, s.cords);
+    for (size_t i = 0; i < s.objects.size(); ++i) {
+        s.object_keys.push_back(1000 + i);
+    }
+    for (size_t c = 0; c < s.cords.size(); ++c) {
+        s.cord_keys.push_back(5000 + c);
+        if (c % 4 == 1) {
+            // Some stacked vertical runs, for cord_cord
+            s.cords[c].midpoints = {{100.0, 200.0 + static_cast<double>(c % 7)},
+                                    {100.0, 900.0}};
+        }
+    }
+
+    parallel::WorkPool pool(3);
+    LayoutCheckCache cache;
+    expect_same_as_full_run(cache, s, LayoutCheckOptions{}, pool, "initial");
+    std::mt19937 rng(4);
+    for (int round = 0; round < 6; ++round) {
+        const size_t moves = round == 3 ? 250 : 3;
+        for (size_t m = 0; m < moves; ++m) {
+            s.objects[rng() % s.objects.size()].rect.origin.x += 37.0;
+            s.cords[rng() % s.cords.size()].end.y -= 11.0;
+        }
+        expect_same_as_full_run(cache, s, LayoutCheckOptions{}, pool,
+                                "round " + std::to_string(round));
+    }
+}
+
+TEST(LayoutCheckCache, RechecksOnlyWhatChanged) {
+    EditedPatch patch(3);
+    LayoutCheckCache cache;
+    LayoutSnapshot s = patch.snapshot();
+    cache.update(s, LayoutCheckOptions{});
+    EXPECT_TRUE(cache.last_update().rebuilt);
+    EXPECT_EQ(cache.last_update().objects_changed, s.objects.size());
+
+    cache.update(s, LayoutCheckOptions{});
+    EXPECT_FALSE(cache.last_update().rebuilt);
+    EXPECT_EQ(cache.last_update().objects_changed, 0u);
+    EXPECT_EQ(cache.last_update().cords_changed, 0u);
+
+    // A rename changes no geometry
+    s.objects[4].varname = "renamed";
+    s.objects[7].rect.origin.y += 5.0;
+    s.cords[2].midpoints.push_back({0.0, 0.0});
+    cache.update(s, LayoutCheckOptions{});
+    EXPECT_EQ(cache.last_update().objects_changed, 1u);
+    EXPECT_EQ(cache.last_update().cords_changed, 1u);
+
+    LayoutCheckOptions exact;
+    exact.epsilon = 0.0;
+    cache.update(s, exact);
+    EXPECT_TRUE(cache.last_update().rebuilt);
+}
+
+TEST(LayoutCheckCache, DeltaReportsAddedAndRemovedFindings) {
+    LayoutSnapshot s;
+    s.objects = {obj(0, "a", 0.0, 0.0, 100.0, 40.0), obj(1, "b", 50.0, 20.0, 100.0, 40.0),
+                 obj(2, "c", 400.0, 0.0, 50.0, 20.0)};
+    s.object_keys = {11, 12, 13};
+    LayoutCheckCache cache;
+
+    json first = cache.update(s, LayoutCheckOptions{}, true);
+    EXPECT_EQ(first.at("revision"), 1);
+    EXPECT_FALSE(first.contains("findings"));
+    EXPECT_EQ(first.at("delta").at("base_revision"), 0);
+    ASSERT_EQ(first.at("delta").at("added").size(), 1u);
+    EXPECT_TRUE(first.at("delta").at("removed").empty());
+
+    // Move b clear of a and onto c
+    s.objects[1].rect.origin = {420.0, 10.0};
+    json second = cache.update(s, LayoutCheckOptions{}, true);
+    EXPECT_EQ(second.at("revision"), 2);
+    EXPECT_EQ(second.at("delta").at("base_revision"), 1);
+    ASSERT_EQ(second.at("delta").at("added").size(), 1u);
+    ASSERT_EQ(second.at("delta").at("removed").size(), 1u);
+    EXPECT_EQ(second.at("delta").at("added")[0].at("objects"), json::array({"b", "c"}));
+    EXPECT_EQ(second.at("delta").at("removed")[0].at("objects"), json::array({"a", "b"}));
+    EXPECT_EQ(summary_of(second, "overlap"), 1);
+
+    json third = cache.update(s, LayoutCheckOptions{}, true);
+    EXPECT_TRUE(third.at("delta").at("added").empty());
+    EXPECT_TRUE(third.at("delta").at("removed").empty());
+}
+
+TEST(LayoutCheckCache, DuplicateKeysFallBackToAFullRun) {
+    LayoutSnapshot s;
+    s.objects = {obj(0, "a", 0.0, 0.0, 100.0, 40.0), obj(1, "b", 50.0, 20.0, 100.0, 40.0)};
+    s.object_keys = {5, 5};
+    LayoutCheckCache cache;
+    json result = cache.update(s, LayoutCheckOptions{});
+    EXPECT_EQ(summary_of(result, "overlap"), 1);
+    EXPECT_TRUE(cache.last_update().rebuilt);
+
+    s.object_keys = {5, 6};
+    cache.update(s, LayoutCheckOptions{});
+    EXPECT_TRUE(cache.last_update().rebuilt);
+}
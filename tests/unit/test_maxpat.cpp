@@ -0,0 +1,315 @@
+/**
+    @file test_maxpat.cpp
+    Unit tests for the .maxpat snapshot serializer, chunked export store and
+    fragment parser (src/utils/maxpat.cpp).
+*/
+
+#include "utils/maxpat.h"
+
+#include <array>
+#include <memory>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <nlohmann/json.hpp>
+
+using json = nlohmann::json;
+using maxpat::AtomValue;
+using maxpat::BoxSnapshot;
+using maxpat::LineSnapshot;
+using maxpat::PatcherSnapshot;
+
+namespace {
+
+AtomValue long_atom(long value) {
+    AtomValue atom;
+    atom.type = AtomValue::Type::Long;
+    atom.number = static_cast<double>(value);
+    return atom;
+}
+
+AtomValue float_atom(double value) {
+    AtomValue atom;
+    atom.type = AtomValue::Type::Float;
+    atom.number = value;
+    return atom;
+}
+
+AtomValue symbol_atom(const std::string& value) {
+    AtomValue atom;
+    atom.type = AtomValue::Type::Symbol;
+    atom.symbol = value;
+    return atom;
+}
+
+BoxSnapshot make_box(const std::string& maxclass, const std::string& text, double x, double y) {
+    BoxSnapshot box;
+    box.maxclass = maxclass;
+    box.text = text;
+    box.numinlets = 2;
+    box.numoutlets = 1;
+    box.attributes.push_back({"patching_rect",
+                              {float_atom(x), float_atom(y), float_atom(60.0), float_atom(22.0)}});
+    return box;
+}
+
+}  // namespace
+
+TEST(MaxpatTest, BoxIdsAreOneBased) {
+    EXPECT_EQ(maxpat::box_id(0), "obj-1");
+    EXPECT_EQ(maxpat::box_id(41), "obj-42");
+}
+
+TEST(MaxpatTest, WritesBoxesAndLines) {
+    PatcherSnapshot snapshot;
+    snapshot.boxes.push_back(make_box("newobj", "cycle~ 440", 10.0, 20.5));
+    snapshot.boxes.back().attributes.push_back({"varname", {symbol_atom("osc")}});
+    snapshot.boxes.back().attributes.push_back({"fontsize", {long_atom(12)}});
+    snapshot.boxes.push_back(make_box("newobj", "dac~", 10.0, 80.0));
+
+    LineSnapshot line;
+    line.source = 0;
+    line.outlet = 0;
+    line.destination = 1;
+    line.inlet = 1;
+    line.hidden = true;
+    line.midpoints = {15.0, 50.0, 30.0, 50.0};
+    snapshot.lines.push_back(line);
+
+    json doc = json::parse(maxpat::to_maxpat(snapshot));
+    const json& patcher = doc["patcher"];
+    EXPECT_EQ(patcher["fileversion"], 1);
+    ASSERT_EQ(patcher["boxes"].size(), 2u);
+
+    const json& osc = patcher["boxes"][0]["box"];
+    EXPECT_EQ(osc["id"], "obj-1");
+    EXPECT_EQ(osc["maxclass"], "newobj");
+    EXPECT_EQ(osc["text"], "cycle~ 440");
+    EXPECT_EQ(osc["numinlets"], 2);
+    EXPECT_EQ(osc["numoutlets"], 1);
+    EXPECT_EQ(osc["varname"], "osc");
+    EXPECT_TRUE(osc["fontsize"].is_number_integer());
+    EXPECT_EQ(osc["patching_rect"], json::array({10.0, 20.5, 60.0, 22.0}));
+
+    ASSERT_EQ(patcher["lines"].size(), 1u);
+    const json& patchline = patcher["lines"][0]["patchline"];
+    EXPECT_EQ(patchline["source"], json::array({"obj-1", 0}));
+    EXPECT_EQ(patchline["destination"], json::array({"obj-2", 1}));
+    EXPECT_EQ(patchline["hidden"], 1);
+    EXPECT_EQ(patchline["midpoints"], json::array({15.0, 50.0, 30.0, 50.0}));
+}
+
+TEST(MaxpatTest, OptionalKeysOmitted) {
+    PatcherSnapshot snapshot;
+    snapshot.boxes.push_back(make_box("toggle", "", 0.0, 0.0));
+    snapshot.boxes.push_back(make_box("toggle", "", 0.0, 40.0));
+    snapshot.lines.push_back({0, 0, 1, 0, false, {}});
+
+    json doc = json::parse(maxpat::to_maxpat(snapshot));
+    EXPECT_FALSE(doc["patcher"]["boxes"][0]["box"].contains("text"));
+    const json& patchline = doc["patcher"]["lines"][0]["patchline"];
+    EXPECT_FALSE(patchline.contains("hidden"));
+    EXPECT_FALSE(patchline.contains("midpoints"));
+}
+
+TEST(MaxpatTest, StructuralAttributesCannotShadowKeys) {
+    PatcherSnapshot snapshot;
+    snapshot.boxes.push_back(make_box("newobj", "metro 100", 0.0, 0.0));
+    snapshot.boxes.back().attributes.push_back({"maxclass", {symbol_atom("bogus")}});
+    snapshot.boxes.back().attributes.push_back({"id", {symbol_atom("bogus")}});
+
+    json box = json::parse(maxpat::to_maxpat(snapshot))["patcher"]["boxes"][0]["box"];
+    EXPECT_EQ(box["maxclass"], "newobj");
+    EXPECT_EQ(box["id"], "obj-1");
+}
+
+TEST(MaxpatTest, EmbedsSubpatchers) {
+    PatcherSnapshot snapshot;
+    snapshot.boxes.push_back(make_box("newobj", "p inner", 0.0, 0.0));
+    snapshot.boxes.back().subpatcher = std::make_unique<PatcherSnapshot>();
+    snapshot.boxes.back().subpatcher->boxes.push_back(make_box("inlet", "", 5.0, 5.0));
+
+    json box = json::parse(maxpat::to_maxpat(snapshot))["patcher"]["boxes"][0]["box"];
+    ASSERT_TRUE(box.contains("patcher"));
+    EXPECT_EQ(box["patcher"]["boxes"][0]["box"]["maxclass"], "inlet");
+    EXPECT_EQ(box["patcher"]["boxes"][0]["box"]["id"], "obj-1");
+    EXPECT_TRUE(box["patcher"]["lines"].empty());
+}
+
+TEST(MaxpatTest, SplitChunksReassembles) {
+    std::string text(10000, 'x');
+    auto chunks = maxpat::split_chunks(text, 1024);
+    ASSERT_EQ(chunks.size(), 10u);
+    std::string joined;
+    for (const auto& chunk : chunks) {
+        EXPECT_LE(chunk.size(), 1024u);
+        joined += chunk;
+    }
+    EXPECT_EQ(joined, text);
+    EXPECT_TRUE(maxpat::split_chunks("", 1024).empty());
+}
+
+TEST(MaxpatTest, SplitChunksKeepsUtf8SequencesWhole) {
+    // "é" is 2 bytes, "𝄞" is 4 bytes; odd sizes force boundaries inside them
+    std::string text;
+    for (int i = 0; i < 50; ++i) {
+        text += "a\xC3\xA9\xF0\x9D\x84\x9E";
+    }
+    for (size_t max_bytes : {4u, 5u, 6u, 7u, 9u}) {
+        std::string joined;
+        for (const auto& chunk : maxpat::split_chunks(text, max_bytes)) {
+            EXPECT_LE(chunk.size(), max_bytes);
+            EXPECT_NO_THROW(json(chunk).dump()) << "chunk is not valid UTF-8";
+            joined += chunk;
+        }
+        EXPECT_EQ(joined, text);
+    }
+}
+
+TEST(MaxpatTest, ExportStoreFetchAndRelease) {
+    maxpat::ExportStore store;
+    std::string id = store.put({"ab", "cd", "ef"});
+    EXPECT_EQ(store.size(), 1u);
+
+    std::string chunk;
+    size_t count = 0;
+    ASSERT_TRUE(store.fetch(id, 1, chunk, count));
+    EXPECT_EQ(chunk, "cd");
+    EXPECT_EQ(count, 3u);
+    EXPECT_FALSE(store.fetch(id, 3, chunk, count));
+    EXPECT_FALSE(store.fetch("export-unknown", 0, chunk, count));
+
+    // Fetching the last chunk releases the export
+    ASSERT_TRUE(store.fetch(id, 2, chunk, count));
+    EXPECT_EQ(chunk, "ef");
+    EXPECT_EQ(store.size(), 0u);
+    EXPECT_FALSE(store.fetch(id, 0, chunk, count));
+}
+
+TEST(MaxpatTest, ExportStoreEvictsOldest) {
+    maxpat::ExportStore store(2);
+    std::string first = store.put({"1", "1"});
+    std::string second = store.put({"2", "2"});
+    std::string third = store.put({"3", "3"});
+    EXPECT_NE(first, second);
+    EXPECT_EQ(store.size(), 2u);
+
+    std::string chunk;
+    size_t count = 0;
+    EXPECT_FALSE(store.fetch(first, 0, chunk, count));
+    EXPECT_TRUE(store.fetch(second, 0, chunk, count));
+    EXPECT_TRUE(store.fetch(third, 0, chunk, count));
+}
+
+// ============================================================================
+// Fragment import
+// ============================================================================
+
+TEST(MaxpatFragmentTest, ParsesBoxesLinesAndOffset) {
+    json boxes = json::array(
+        {{{"box",
+           {{"id", "obj-1"},
+            {"maxclass", "newobj"},
+            {"text", "cycle~ 440"},
+            {"varname", "osc"},
+            {"numinlets", 2},
+            {"outlettype", json::array({"signal"})},
+            {"patching_rect", json::array({10, 20, 80, 22})},
+            {"fontsize", 12}}}},
+         {{"id", "obj-2"},
+          {"maxclass", "toggle"},
+          {"presentation", 1},
+          {"presentation_rect", json::array({5, 5, 24, 24})}},
+         {{"id", "obj-3"},
+          {"maxclass", "toggle"},
+          {"presentation_rect", json::array({5, 5, 24, 24})}}});
+    json lines = json::array(
+        {{{"patchline",
+           {{"source", {"obj-1", 0}},
+            {"destination", {"obj-2", 0}},
+            {"hidden", 1},
+            {"midpoints", json::array({50, 60})}}}}});
+
+    maxpat::Fragment fragment;
+    json error = maxpat::parse_fragment(boxes, lines, 100.0, 200.0, fragment);
+    ASSERT_TRUE(error.is_null()) << error.dump();
+
+    ASSERT_EQ(fragment.boxes.size(), 3u);
+    const auto& osc = fragment.boxes[0];
+    EXPECT_EQ(osc.text, "cycle~ 440");
+    EXPECT_EQ(osc.varname, "osc");
+    ASSERT_TRUE(osc.has_rect);
+    EXPECT_EQ(osc.rect, (std::array<double, 4>{110.0, 220.0, 80.0, 22.0}));
+    // Derived and explicitly handled keys are not passed on as attributes
+    EXPECT_EQ(osc.attributes, (json{{"fontsize", 12}}));
+    EXPECT_FALSE(fragment.boxes[1].has_rect);
+    // presentation_rect moves only for boxes shown in presentation mode
+    EXPECT_EQ(fragment.boxes[1].attributes["presentation_rect"], json::array({105, 205, 24, 24}));
+    EXPECT_EQ(fragment.boxes[2].attributes["presentation_rect"], json::array({5, 5, 24, 24}));
+
+    ASSERT_EQ(fragment.lines.size(), 1u);
+    EXPECT_EQ(fragment.lines[0].source, 0u);
+    EXPECT_EQ(fragment.lines[0].destination, 1u);
+    EXPECT_TRUE(fragment.lines[0].hidden);
+    EXPECT_EQ(fragment.lines[0].midpoints, (std::vector<double>{150.0, 260.0}));
+}
+
+TEST(MaxpatFragmentTest, RejectsMalformedInput) {
+    maxpat::Fragment fragment;
+    auto fails = [&](const json& boxes, const json& lines) {
+        json error = maxpat::parse_fragment(boxes, lines, 0.0, 0.0, fragment);
+        return error.contains("error");
+    };
+    json toggle = {{"id", "a"}, {"maxclass", "toggle"}};
+
+    EXPECT_TRUE(fails(json::array(), nullptr));
+    EXPECT_TRUE(fails(json::array({{{"maxclass", "toggle"}}}), nullptr));
+    EXPECT_TRUE(fails(json::array({{{"id", "a"}, {"maxclass", "newobj"}}}), nullptr));
+    EXPECT_TRUE(fails(json::array({toggle, toggle}), nullptr));
+    EXPECT_TRUE(fails(json::array({{{"id", "a"},
+                                    {"maxclass", "toggle"},
+                                    {"patching_rect", json::array({0, 0})}}}),
+                      nullptr));
+    EXPECT_TRUE(fails(json::array({toggle}), json::object()));
+    EXPECT_TRUE(fails(json::array({toggle}),
+                      json::array({{{"source", {"a", 0}}, {"destination", {"b", 0}}}})));
+    EXPECT_TRUE(fails(json::array({toggle}),
+                      json::array({{{"source", {"a", -1}}, {"destination", {"a", 0}}}})));
+    EXPECT_TRUE(fails(json::array({toggle}), json::array({{{"source", {"a", 0}},
+                                                           {"destination", {"a", 0}},
+                                                           {"midpoints", json::array({1})}}})));
+    EXPECT_FALSE(fails(json::array({toggle}), nullptr));
+}
+
+TEST(MaxpatFragmentTest, VarnamesAvoidCollisions) {
+    json boxes = json::array({{{"id", "obj-1"}, {"maxclass", "toggle"}, {"varname", "osc"}},
+                              {{"id", "obj-2"}, {"maxclass", "toggle"}, {"varname", "osc"}},
+                              {{"id", "obj-3"}, {"maxclass", "toggle"}},
+                              {{"id", "obj-4"}, {"maxclass", "toggle"}, {"varname", "free"}}});
+    maxpat::Fragment fragment;
+    ASSERT_TRUE(maxpat::parse_fragment(boxes, nullptr, 0.0, 0.0, fragment).is_null());
+
+    std::unordered_set<std::string> taken = {"osc", "osc_2", "obj-3"};
+    auto names = maxpat::assign_fragment_varnames(fragment, taken);
+    EXPECT_EQ(names, (std::vector<std::string>{"osc_3", "osc_4", "obj-3_2", "free"}));
+    EXPECT_EQ(taken.size(), 7u);
+}
+
+TEST(MaxpatFragmentTest, ExportedDocumentImportsBack) {
+    PatcherSnapshot snapshot;
+    snapshot.boxes.push_back(make_box("newobj", "metro 100", 10.0, 10.0));
+    snapshot.boxes.push_back(make_box("newobj", "counter", 10.0, 60.0));
+    snapshot.lines.push_back({0, 0, 1, 0, false, {}});
+
+    json patcher = json::parse(maxpat::to_maxpat(snapshot))["patcher"];
+    maxpat::Fragment fragment;
+    ASSERT_TRUE(
+        maxpat::parse_fragment(patcher["boxes"], patcher["lines"], 0.0, 0.0, fragment).is_null());
+    ASSERT_EQ(fragment.boxes.size(), 2u);
+    EXPECT_EQ(fragment.boxes[1].text, "counter");
+    EXPECT_EQ(fragment.boxes[1].rect[1], 60.0);
+    ASSERT_EQ(fragment.lines.size(), 1u);
+    EXPECT_EQ(fragment.lines[0].destination, 1u);
+}
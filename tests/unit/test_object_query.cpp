@@ -0,0 +1,225 @@
+/**
+    @file test_object_query.cpp
+    Unit tests for the query_objects predicate language (src/utils/object_query.cpp).
+
+    Covers parsing (errors must name the offending predicate), the value
+    comparison rules and how each predicate matches a box, including the
+    split between frame (class/flags/region) and content (text/attributes).
+*/
+
+#include "utils/object_query.h"
+
+#include "tools/tool_common.h"
+
+#include <gtest/gtest.h>
+
+using object_query::BoxView;
+using object_query::CompareOp;
+using object_query::Query;
+using json = nlohmann::json;
+
+namespace {
+
+Query parse_ok(const json& params) {
+    Query query;
+    json error = object_query::parse_query(params, query);
+    EXPECT_TRUE(error.is_null()) << error.dump();
+    return query;
+}
+
+void expect_invalid(const json& params, const std::string& fragment) {
+    Query query;
+    json error = object_query::parse_query(params, query);
+    ASSERT_TRUE(error.contains("error")) << params.dump();
+    EXPECT_EQ(error["error"]["code"], ToolCommon::ErrorCode::INVALID_PARAMS);
+    EXPECT_NE(error["error"]["message"].get<std::string>().find(fragment), std::string::npos)
+        << error.dump();
+}
+
+BoxView object_box(const std::string& object_class, const std::string& text) {
+    BoxView box;
+    box.maxclass = "newobj";
+    box.object_class = object_class;
+    box.text = text;
+    box.patching_rect = {100, 100, 60, 22};
+    return box;
+}
+
+}  // namespace
+
+// ============================================================================
+// parse_query
+// ============================================================================
+
+TEST(ObjectQueryParseTest, EmptyRequestMatchesEverything) {
+    Query query = parse_ok(json::object());
+    EXPECT_FALSE(query.limit.has_value());
+    EXPECT_TRUE(query.matches(object_box("cycle~", "cycle~ 440")));
+}
+
+TEST(ObjectQueryParseTest, ParsesEveryPredicate) {
+    json fontsize = {{"name", "fontsize"}, {"op", ">="}, {"value", 12}};
+    json params = {{"where",
+                    {{"maxclass", json::array({"send~", "receive~"})},
+                     {"text", "^s(end)?~ "},
+                     {"attributes", json::array({fontsize})},
+                     {"region", {{"rect", json::array({0, 0, 500, 500})}, {"mode", "contain"}}},
+                     {"hidden", false},
+                     {"presentation", true}}},
+                   {"limit", 5}};
+    Query query = parse_ok(params);
+    EXPECT_EQ(query.maxclasses, (std::vector<std::string>{"send~", "receive~"}));
+    EXPECT_TRUE(query.needs_text());
+    ASSERT_EQ(query.attributes.size(), 1u);
+    EXPECT_EQ(query.attributes[0].name, "fontsize");
+    EXPECT_EQ(query.attributes[0].op, CompareOp::Ge);
+    ASSERT_TRUE(query.region.has_value());
+    EXPECT_EQ(query.region->mode, object_query::RegionMode::Contain);
+    EXPECT_FALSE(query.region->presentation);
+    EXPECT_EQ(query.hidden, false);
+    EXPECT_EQ(query.presentation, true);
+    EXPECT_EQ(query.limit, 5u);
+}
+
+TEST(ObjectQueryParseTest, OpDefaultsToEquality) {
+    Query query = parse_ok({{"where", {{"attributes", json::array({{{"name", "varname"},
+                                                                     {"value", "osc"}}})}}}});
+    ASSERT_EQ(query.attributes.size(), 1u);
+    EXPECT_EQ(query.attributes[0].op, CompareOp::Eq);
+}
+
+TEST(ObjectQueryParseTest, RejectsMalformedPredicates) {
+    expect_invalid({{"where", "send~"}}, "where must be an object");
+    expect_invalid({{"where", {{"maxclass", json::array()}}}}, "where.maxclass");
+    expect_invalid({{"where", {{"text", "("}}}}, "where.text is not a valid regular expression");
+    expect_invalid({{"where", {{"attributes", json::array({{{"name", "x"}}})}}}},
+                   "where.attributes[0] needs name and value");
+    expect_invalid(
+        {{"where", {{"attributes", json::array({{{"name", "x"}, {"op", "~"}, {"value", 1}}})}}}},
+        "where.attributes[0].op");
+    expect_invalid(
+        {{"where", {{"attributes", json::array({{{"name", "x"}, {"op", "<"}, {"value", "a"}}})}}}},
+        "must be a number for ordering operators");
+    expect_invalid({{"where", {{"region", {{"rect", json::array({0, 0, 10})}}}}}},
+                   "where.region.rect");
+    expect_invalid({{"where", {{"region", {{"rect", json::array({0, 0, 10, 10})},
+                                           {"mode", "touch"}}}}}},
+                   "where.region.mode");
+    expect_invalid({{"where", {{"hidden", "no"}}}}, "where.hidden must be a boolean");
+    expect_invalid({{"where", {{"colour", "red"}}}}, "Unknown predicate where.colour");
+    expect_invalid({{"limit", 0}}, "limit must be a positive integer");
+}
+
+// ============================================================================
+// compare
+// ============================================================================
+
+TEST(ObjectQueryCompareTest, EqualityIsNumericAndElementWise) {
+    EXPECT_TRUE(object_query::compare(12, CompareOp::Eq, 12.0));
+    EXPECT_TRUE(object_query::compare("osc", CompareOp::Eq, "osc"));
+    EXPECT_FALSE(object_query::compare("osc", CompareOp::Eq, "lfo"));
+    EXPECT_TRUE(object_query::compare(json::array({1, 0.5, 0, 1}), CompareOp::Eq,
+                                      json::array({1.0, 0.5, 0.0, 1.0})));
+    EXPECT_FALSE(
+        object_query::compare(json::array({1, 0, 0}), CompareOp::Eq, json::array({1, 0, 0, 1})));
+    EXPECT_TRUE(object_query::compare("12", CompareOp::Ne, 12));
+}
+
+TEST(ObjectQueryCompareTest, OrderingNeedsNumbers) {
+    EXPECT_TRUE(object_query::compare(14, CompareOp::Gt, 12));
+    EXPECT_TRUE(object_query::compare(12, CompareOp::Ge, 12));
+    EXPECT_TRUE(object_query::compare(10.5, CompareOp::Lt, 12));
+    EXPECT_FALSE(object_query::compare(12, CompareOp::Lt, 12));
+    EXPECT_FALSE(object_query::compare("14", CompareOp::Gt, 12));
+    EXPECT_FALSE(object_query::compare(json::array({14}), CompareOp::Gt, 12));
+}
+
+TEST(ObjectQueryCompareTest, MissingAttributeNeverMatches) {
+    for (CompareOp op : {CompareOp::Eq, CompareOp::Ne, CompareOp::Lt, CompareOp::Ge}) {
+        EXPECT_FALSE(object_query::compare(json(), op, 1));
+    }
+}
+
+// ============================================================================
+// Matching
+// ============================================================================
+
+TEST(ObjectQueryMatchTest, MaxclassMatchesBoxOrObjectClass) {
+    Query query = parse_ok({{"where", {{"maxclass", json::array({"send~", "message"})}}}});
+    EXPECT_TRUE(query.matches_frame(object_box("send~", "send~ out")));
+    EXPECT_FALSE(query.matches_frame(object_box("receive~", "receive~ out")));
+
+    BoxView message;
+    message.maxclass = "message";
+    message.object_class = "message";
+    EXPECT_TRUE(query.matches_frame(message));
+}
+
+TEST(ObjectQueryMatchTest, TextIsSearchedNotAnchored) {
+    Query query = parse_ok({{"where", {{"text", "^p voice"}}}});
+    EXPECT_TRUE(query.matches_content(object_box("jpatcher", "p voice_1")));
+    EXPECT_FALSE(query.matches_content(object_box("jpatcher", "p mixer voice")));
+
+    Query anywhere = parse_ok({{"where", {{"text", "voice"}}}});
+    EXPECT_TRUE(anywhere.matches_content(object_box("jpatcher", "p mixer voice")));
+
+    // The text stage alone, as run on copied-out texts; no predicate passes all
+    EXPECT_TRUE(query.matches_text("p voice_2"));
+    EXPECT_FALSE(query.matches_text("p mixer"));
+    EXPECT_TRUE(Query{}.matches_text("anything"));
+}
+
+TEST(ObjectQueryMatchTest, AttributePredicatesUseValuesInOrder) {
+    Query query = parse_ok(
+        {{"where", {{"attributes", json::array({{{"name", "fontsize"}, {"op", ">"}, {"value", 10}},
+                                                {{"name", "fontname"}, {"value", "Arial"}}})}}}});
+    BoxView box = object_box("comment", "");
+    box.attributes = {14, "Arial"};
+    EXPECT_TRUE(query.matches_content(box));
+    box.attributes = {9, "Arial"};
+    EXPECT_FALSE(query.matches_content(box));
+    box.attributes = {14, json()};
+    EXPECT_FALSE(query.matches_content(box));
+
+    // Values that were not read count as missing
+    box.attributes.clear();
+    EXPECT_FALSE(query.matches_content(box));
+}
+
+TEST(ObjectQueryMatchTest, RegionIntersectAndContain) {
+    json rect = json::array({0, 0, 120, 120});
+    Query intersect = parse_ok({{"where", {{"region", {{"rect", rect}}}}}});
+    Query contain = parse_ok({{"where", {{"region", {{"rect", rect}, {"mode", "contain"}}}}}});
+
+    BoxView box = object_box("cycle~", "");  // [100, 100, 60, 22] straddles the edge
+    EXPECT_TRUE(intersect.matches_frame(box));
+    EXPECT_FALSE(contain.matches_frame(box));
+
+    box.patching_rect = {10, 10, 60, 22};
+    EXPECT_TRUE(contain.matches_frame(box));
+
+    // Touching edges do not count as intersecting
+    box.patching_rect = {120, 0, 20, 20};
+    EXPECT_FALSE(intersect.matches_frame(box));
+}
+
+TEST(ObjectQueryMatchTest, RegionCanUsePresentationRect) {
+    Query query = parse_ok({{"where",
+                             {{"region", {{"rect", json::array({0, 0, 50, 50})},
+                                          {"space", "presentation"}}}}}});
+    BoxView box = object_box("dial", "");
+    box.presentation_rect = {5, 5, 40, 40};
+    EXPECT_TRUE(query.matches_frame(box));
+    box.presentation_rect = {200, 200, 40, 40};
+    EXPECT_FALSE(query.matches_frame(box));
+}
+
+TEST(ObjectQueryMatchTest, FlagsMustMatchWhenGiven) {
+    Query query = parse_ok({{"where", {{"hidden", true}, {"presentation", false}}}});
+    BoxView box = object_box("loadbang", "loadbang");
+    EXPECT_FALSE(query.matches_frame(box));
+    box.hidden = true;
+    EXPECT_TRUE(query.matches_frame(box));
+    box.presentation = true;
+    EXPECT_FALSE(query.matches_frame(box));
+}
@@ -0,0 +1,152 @@
+/**
+    @file test_pagination.cpp
+    Unit tests for cursor pagination (src/utils/pagination.cpp).
+
+    Pins the cursor wire format, the revision fingerprint's sensitivity to
+    listing membership, order and structure edits, and the page-window arithmetic shared by
+    get_objects_in_patch and get_patchlines.
+*/
+
+#include "utils/pagination.h"
+
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using pagination::Cursor;
+using pagination::PageRequest;
+using pagination::PageWindow;
+using pagination::RevisionHash;
+
+namespace {
+
+uint64_t revision_of(const std::vector<int*>& elements, uint64_t structure_edits = 0) {
+    RevisionHash hash(structure_edits);
+    for (int* e : elements) {
+        hash.add(e);
+    }
+    return hash.value();
+}
+
+}  // namespace
+
+TEST(PaginationTest, CursorRoundTrip) {
+    Cursor cursor{0x0123456789abcdefULL, 250};
+    std::string text = pagination::encode_cursor(cursor);
+    EXPECT_EQ(text, "0123456789abcdef.250");
+
+    auto decoded = pagination::decode_cursor(text);
+    ASSERT_TRUE(decoded.has_value());
+    EXPECT_EQ(decoded->revision, cursor.revision);
+    EXPECT_EQ(decoded->offset, cursor.offset);
+}
+
+TEST(PaginationTest, MalformedCursorRejected) {
+    EXPECT_FALSE(pagination::decode_cursor(""));
+    EXPECT_FALSE(pagination::decode_cursor("0123456789abcdef"));
+    EXPECT_FALSE(pagination::decode_cursor("0123456789abcdef."));
+    EXPECT_FALSE(pagination::decode_cursor("0123456789abcdeg.10"));
+    EXPECT_FALSE(pagination::decode_cursor("0123456789abcdef.1x"));
+    EXPECT_FALSE(pagination::decode_cursor("12345.10"));
+}
+
+TEST(PaginationTest, RevisionTracksMembershipAndOrder) {
+    int a = 0, b = 0, c = 0;
+    uint64_t base = revision_of({&a, &b, &c});
+
+    EXPECT_EQ(revision_of({&a, &b, &c}), base);
+    EXPECT_NE(revision_of({&a, &c, &b}), base);  // reordered
+    EXPECT_NE(revision_of({&a, &b}), base);      // removed
+    EXPECT_NE(revision_of({&a, &b, &c, &a}), base);
+}
+
+TEST(PaginationTest, RevisionTracksStructureEdits) {
+    // A box freed and re-created at the same address leaves the pointer list
+    // unchanged; only the patch's edit counter tells the listings apart.
+    int a = 0, b = 0;
+    uint64_t before = revision_of({&a, &b}, 4);
+
+    EXPECT_EQ(revision_of({&a, &b}, 4), before);
+    EXPECT_NE(revision_of({&a, &b}, 6), before);
+    EXPECT_NE(revision_of({&a, &b}), before);
+}
+
+TEST(PaginationTest, ParseRequestValidatesParams) {
+    PageRequest request;
+    EXPECT_TRUE(pagination::parse_page_request({{"patch_id", "p"}}, request).is_null());
+    EXPECT_FALSE(request.paginated);
+    EXPECT_EQ(request.limit, 0u);
+
+    EXPECT_TRUE(pagination::parse_page_request({{"limit", 50}}, request).is_null());
+    EXPECT_TRUE(request.paginated);
+    EXPECT_EQ(request.limit, 50u);
+    EXPECT_FALSE(request.cursor.has_value());
+
+    EXPECT_TRUE(pagination::parse_page_request({{"limit", 0}}, request).contains("error"));
+    EXPECT_TRUE(pagination::parse_page_request({{"limit", 2.5}}, request).contains("error"));
+    EXPECT_TRUE(pagination::parse_page_request({{"limit", "10"}}, request).contains("error"));
+    EXPECT_TRUE(pagination::parse_page_request({{"cursor", "bogus"}}, request).contains("error"));
+    EXPECT_TRUE(pagination::parse_page_request({{"cursor", 5}}, request).contains("error"));
+}
+
+TEST(PaginationTest, PagesCoverListingExactlyOnce) {
+    const size_t total = 23;
+    const uint64_t revision = 0xfeedULL;
+
+    PageRequest request;
+    request.paginated = true;
+    request.limit = 10;
+
+    std::vector<size_t> seen;
+    for (int guard = 0; guard < 10; ++guard) {
+        PageWindow window;
+        ASSERT_TRUE(pagination::resolve_page(request, total, revision, window).is_null());
+        for (size_t i = window.begin; i < window.end; ++i) {
+            seen.push_back(i);
+        }
+
+        nlohmann::json result = nlohmann::json::object();
+        pagination::add_page_fields(result, request, window, total, revision);
+        EXPECT_EQ(result["total"], total);
+        if (!window.has_more) {
+            EXPECT_FALSE(result.contains("next_cursor"));
+            break;
+        }
+        request.cursor = pagination::decode_cursor(result["next_cursor"].get<std::string>());
+        ASSERT_TRUE(request.cursor.has_value());
+    }
+
+    ASSERT_EQ(seen.size(), total);
+    for (size_t i = 0; i < total; ++i) {
+        EXPECT_EQ(seen[i], i);
+    }
+}
+
+TEST(PaginationTest, StaleCursorIsAnError) {
+    PageRequest request;
+    request.paginated = true;
+    request.limit = 10;
+    request.cursor = Cursor{0x1111ULL, 10};
+
+    PageWindow window;
+    auto error = pagination::resolve_page(request, 30, 0x2222ULL, window);
+    ASSERT_TRUE(error.contains("error"));
+    EXPECT_NE(error["error"]["message"].get<std::string>().find("changed"), std::string::npos);
+
+    request.cursor = Cursor{0x2222ULL, 31};
+    EXPECT_TRUE(pagination::resolve_page(request, 30, 0x2222ULL, window).contains("error"));
+}
+
+TEST(PaginationTest, UnpaginatedRequestKeepsResultShape) {
+    PageRequest request;
+    PageWindow window;
+    ASSERT_TRUE(pagination::resolve_page(request, 7, 1, window).is_null());
+    EXPECT_EQ(window.begin, 0u);
+    EXPECT_EQ(window.end, 7u);
+    EXPECT_FALSE(window.has_more);
+
+    nlohmann::json result = {{"count", 7}};
+    pagination::add_page_fields(result, request, window, 7, 1);
+    EXPECT_FALSE(result.contains("total"));
+    EXPECT_FALSE(result.contains("next_cursor"));
+}
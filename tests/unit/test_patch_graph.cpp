@@ -0,0 +1,218 @@
+/**
+    @file test_patch_graph.cpp
+    Unit tests for the patchcord graph analysis (src/utils/patch_graph.cpp).
+
+    Hand-built edge lists cover the CSR adjacency (parallel cords, self
+    loops, out-of-range ids), strongly connected components, the
+    cycle-tolerant topological order, depth-limited reachability and the
+    analyze_patch_graph report shape.
+*/
+
+#include "utils/patch_graph.h"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using patch_graph::AnalysisOptions;
+using patch_graph::EdgeList;
+using patch_graph::Graph;
+using json = nlohmann::json;
+
+namespace {
+
+// n unnamed boxes "obj#i" with one cord per (src, dst) pair, outlet/inlet 0.
+EdgeList make_list(size_t n, const std::vector<std::pair<int, int>>& cords) {
+    EdgeList list;
+    for (size_t i = 0; i < n; ++i) {
+        list.nodes.push_back({"", "obj"});
+    }
+    for (const auto& [src, dst] : cords) {
+        list.edges.push_back({src, 0, dst, 0});
+    }
+    return list;
+}
+
+std::vector<int> range(std::pair<const int*, const int*> r) {
+    return std::vector<int>(r.first, r.second);
+}
+
+}  // namespace
+
+// ============================================================================
+// Graph
+// ============================================================================
+
+TEST(PatchGraphTest, CsrDeduplicatesParallelCordsButCountsDegrees) {
+    EdgeList list = make_list(3, {{0, 2}, {0, 1}});
+    list.edges.push_back({0, 1, 2, 1});  // second cord 0 -> 2 on other ports
+    Graph graph(list);
+
+    EXPECT_EQ(graph.node_count(), 3u);
+    EXPECT_EQ(graph.edge_count(), 3u);
+    EXPECT_EQ(range(graph.successors(0)), (std::vector<int>{1, 2}));
+    EXPECT_EQ(range(graph.predecessors(2)), (std::vector<int>{0}));
+    EXPECT_EQ(graph.out_degree(0), 3u);
+    EXPECT_EQ(graph.in_degree(2), 2u);
+    EXPECT_TRUE(range(graph.successors(2)).empty());
+}
+
+TEST(PatchGraphTest, IgnoresEdgesToUnknownBoxes) {
+    Graph graph(make_list(2, {{0, 1}, {0, 5}, {-1, 1}}));
+    EXPECT_EQ(graph.edge_count(), 1u);
+    EXPECT_EQ(range(graph.successors(0)), (std::vector<int>{1}));
+}
+
+TEST(PatchGraphTest, SelfLoop) {
+    Graph graph(make_list(2, {{1, 1}, {0, 1}}));
+    EXPECT_FALSE(graph.has_self_loop(0));
+    EXPECT_TRUE(graph.has_self_loop(1));
+}
+
+// ============================================================================
+// Components and ordering
+// ============================================================================
+
+TEST(PatchGraphTest, ComponentsAreNumberedInEdgeOrder) {
+    // 0 -> {1 <-> 2} -> 3, plus an isolated 4
+    Graph graph(make_list(5, {{0, 1}, {1, 2}, {2, 1}, {2, 3}}));
+    int count = 0;
+    std::vector<int> component = patch_graph::strongly_connected_components(graph, count);
+    EXPECT_EQ(count, 4);
+    EXPECT_EQ(component[1], component[2]);
+    EXPECT_NE(component[0], component[1]);
+    for (int v = 0; v < 5; ++v) {
+        for (const int* w = graph.successors(v).first; w != graph.successors(v).second; ++w) {
+            EXPECT_LE(component[v], component[*w]) << v << " -> " << *w;
+        }
+    }
+}
+
+TEST(PatchGraphTest, TopologicalOrderBreaksTiesById) {
+    // 3 -> 1, 2 -> 0; sources 2 and 3 come first in id order
+    Graph graph(make_list(4, {{3, 1}, {2, 0}}));
+    EXPECT_EQ(patch_graph::topological_order(graph), (std::vector<int>{2, 0, 3, 1}));
+}
+
+TEST(PatchGraphTest, TopologicalOrderKeepsCyclesTogether) {
+    // 0 -> 3 -> 1 -> 3 (feedback between 1 and 3), 1 -> 2
+    Graph graph(make_list(4, {{0, 3}, {3, 1}, {1, 3}, {1, 2}}));
+    EXPECT_EQ(patch_graph::topological_order(graph), (std::vector<int>{0, 1, 3, 2}));
+}
+
+TEST(PatchGraphTest, TopologicalOrderIsValidOnRandomDag) {
+    std::mt19937 rng(11);
+    std::vector<std::pair<int, int>> cords;
+    const int n = 300;
+    std::uniform_int_distribution<int> pick(0, n - 1);
+    for (int i = 0; i < 1200; ++i) {
+        int a = pick(rng), b = pick(rng);
+        if (a != b) {
+            cords.emplace_back(std::min(a, b), std::max(a, b));
+        }
+    }
+    Graph graph(make_list(n, cords));
+    std::vector<int> order = patch_graph::topological_order(graph);
+    ASSERT_EQ(order.size(), static_cast<size_t>(n));
+
+    std::vector<int> position(n);
+    for (int i = 0; i < n; ++i) {
+        position[order[i]] = i;
+    }
+    for (const auto& [a, b] : cords) {
+        EXPECT_LT(position[a], position[b]);
+    }
+}
+
+TEST(PatchGraphTest, LongChainDoesNotRecurse) {
+    // Deep enough to overflow a recursive Tarjan on a small thread stack
+    const int n = 200000;
+    std::vector<std::pair<int, int>> cords;
+    for (int i = 0; i + 1 < n; ++i) {
+        cords.emplace_back(i, i + 1);
+    }
+    cords.emplace_back(n - 1, 0);
+    Graph graph(make_list(n, cords));
+    int count = 0;
+    patch_graph::strongly_connected_components(graph, count);
+    EXPECT_EQ(count, 1);
+}
+
+// ============================================================================
+// Reachability
+// ============================================================================
+
+TEST(PatchGraphTest, ReachableByDepth) {
+    // 0 -> 1 -> 3, 0 -> 2 -> 3 -> 4, and 4 feeds back to 0
+    Graph graph(make_list(5, {{0, 1}, {0, 2}, {1, 3}, {2, 3}, {3, 4}, {4, 0}}));
+    using Hops = std::vector<std::pair<int, int>>;
+    EXPECT_EQ(patch_graph::reachable(graph, 0, true, 0), (Hops{{1, 1}, {2, 1}, {3, 2}, {4, 3}}));
+    EXPECT_EQ(patch_graph::reachable(graph, 0, true, 2), (Hops{{1, 1}, {2, 1}, {3, 2}}));
+    EXPECT_EQ(patch_graph::reachable(graph, 3, false, 1), (Hops{{1, 1}, {2, 1}}));
+    EXPECT_TRUE(patch_graph::reachable(graph, 9, true, 0).empty());
+}
+
+// ============================================================================
+// analyze_report
+// ============================================================================
+
+TEST(PatchGraphReportTest, ReportsCyclesDegreesAndLabels) {
+    EdgeList list;
+    list.nodes = {{"osc", "newobj"}, {"", "newobj"}, {"", "newobj"}, {"out", "ezdac~"}};
+    // osc -> #1 <-> #2 -> out, osc -> out twice
+    list.edges = {{0, 0, 1, 0}, {1, 0, 2, 0}, {2, 0, 1, 1}, {2, 0, 3, 0},
+                  {0, 0, 3, 0}, {0, 0, 3, 1}};
+
+    json report = patch_graph::analyze_report(list, AnalysisOptions{});
+    EXPECT_EQ(report["node_count"], 4);
+    EXPECT_EQ(report["edge_count"], 6);
+    EXPECT_FALSE(report["acyclic"]);
+    EXPECT_EQ(report["scc_count"], 3);
+    EXPECT_EQ(report["topological_order"],
+              json::array({"osc", "newobj#1", "newobj#2", "out"}));
+
+    ASSERT_EQ(report["cycles"].size(), 1u);
+    EXPECT_EQ(report["cycles"][0]["objects"], json::array({"newobj#1", "newobj#2"}));
+    EXPECT_EQ(report["cycles"][0]["cords"], 2);
+
+    const json& degrees = report["degrees"];
+    EXPECT_EQ(degrees["sources"], 1);
+    EXPECT_EQ(degrees["sinks"], 1);
+    EXPECT_EQ(degrees["isolated"], 0);
+    EXPECT_EQ(degrees["max_fan_out"], 3);
+    EXPECT_EQ(degrees["max_fan_in"], 3);
+    EXPECT_EQ(degrees["top_fan_out"][0], (json{{"object", "osc"}, {"cords", 3}}));
+    EXPECT_EQ(degrees["top_fan_in"][0], (json{{"object", "out"}, {"cords", 3}}));
+    EXPECT_FALSE(report.contains("reachability"));
+}
+
+TEST(PatchGraphReportTest, SelfLoopIsACycle) {
+    json report = patch_graph::analyze_report(make_list(2, {{0, 1}, {1, 1}}), AnalysisOptions{});
+    EXPECT_FALSE(report["acyclic"]);
+    ASSERT_EQ(report["cycles"].size(), 1u);
+    EXPECT_EQ(report["cycles"][0]["objects"], json::array({"obj#1"}));
+}
+
+TEST(PatchGraphReportTest, OptionsSelectSections) {
+    AnalysisOptions options;
+    options.order = false;
+    options.degrees = false;
+    options.from = 1;
+    options.upstream = false;
+    options.max_depth = 1;
+    options.top = 0;
+
+    json report = patch_graph::analyze_report(make_list(3, {{0, 1}, {1, 2}}), options);
+    EXPECT_TRUE(report["acyclic"]);
+    EXPECT_TRUE(report["cycles"].empty());
+    EXPECT_FALSE(report.contains("topological_order"));
+    EXPECT_FALSE(report.contains("degrees"));
+
+    const json& reach = report["reachability"];
+    EXPECT_EQ(reach["from"], "obj#1");
+    EXPECT_EQ(reach["max_depth"], 1);
+    EXPECT_EQ(reach["downstream"], json::array({{{"object", "obj#2"}, {"depth", 1}}}));
+    EXPECT_FALSE(reach.contains("upstream"));
+}
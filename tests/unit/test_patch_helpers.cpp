@@ -13,6 +13,10 @@ typedef struct _atom t_atom;
 
 #include "patch_helpers.h"
 
+#include <set>
+#include <string>
+#include <vector>
+
 using json = nlohmann::json;
 
 // =============================================================================
@@ -118,6 +122,82 @@ TEST(IsTextfieldContentType, UnknownTypeIsNotTextfieldContent) {
     EXPECT_FALSE(PatchHelpers::is_textfield_content_type("cycle~"));
 }
 
+// =============================================================================
+// SaveableAttributeCache (SDK-independent, fully testable)
+// =============================================================================
+
+namespace {
+
+// One box as the cache sees it: its attribute names and which of them the
+// box saves. Class attributes are the ones in kClassAttrs.
+struct FakeBox {
+    std::vector<std::string> names;
+    std::set<std::string> saveable;
+};
+
+const std::set<std::string> kClassAttrs = {"patching_rect", "bgcolor", "border"};
+
+}  // namespace
+
+TEST(SaveableAttributeCache, KeepsEachBoxsInstanceAttributes) {
+    // Two jsui boxes running different scripts: same class, different
+    // declareattribute sets, and a shared instance name saved only by one
+    const FakeBox first{{"patching_rect", "bgcolor", "border", "gain", "mode"},
+                        {"patching_rect", "bgcolor", "gain", "mode"}};
+    const FakeBox second{{"patching_rect", "bgcolor", "border", "cutoff", "mode"},
+                         {"patching_rect", "bgcolor", "cutoff"}};
+
+    PatchHelpers::SaveableAttributeCache<std::string, std::string> cache;
+    int checks = 0;
+    int class_lookups = 0;
+    auto select = [&](const FakeBox& box) {
+        return cache.select(
+            std::string("jsui"), box.names,
+            [&](const std::string& name) {
+                ++class_lookups;
+                return kClassAttrs.count(name) > 0;
+            },
+            [&](const std::string& name) {
+                ++checks;
+                return box.saveable.count(name) > 0;
+            });
+    };
+
+    EXPECT_EQ(select(first),
+              (std::vector<std::string>{"patching_rect", "bgcolor", "gain", "mode"}));
+    EXPECT_EQ(checks, 5);
+    EXPECT_EQ(class_lookups, 5);
+
+    // The class list comes from the cache; instance attributes are checked again
+    checks = 0;
+    EXPECT_EQ(select(second), (std::vector<std::string>{"patching_rect", "bgcolor", "cutoff"}));
+    EXPECT_EQ(checks, 2);
+    EXPECT_EQ(class_lookups, 5);
+
+    checks = 0;
+    EXPECT_EQ(select(first),
+              (std::vector<std::string>{"patching_rect", "bgcolor", "gain", "mode"}));
+    EXPECT_EQ(checks, 2);
+}
+
+TEST(SaveableAttributeCache, SeparatesClasses) {
+    PatchHelpers::SaveableAttributeCache<std::string, std::string> cache;
+    auto is_class_attr = [](const std::string&) { return true; };
+    const std::vector<std::string> names{"bgcolor"};
+
+    EXPECT_EQ(cache.select(std::string("message"), names, is_class_attr,
+                           [](const std::string&) { return true; }),
+              names);
+    EXPECT_TRUE(cache
+                    .select(std::string("toggle"), names, is_class_attr,
+                            [](const std::string&) { return false; })
+                    .empty());
+    // Cached per class: the message verdict is not re-checked
+    EXPECT_EQ(cache.select(std::string("message"), names, is_class_attr,
+                           [](const std::string&) { return false; }),
+              names);
+}
+
 // =============================================================================
 // Test mode stubs (verify expected stub behavior)
 // =============================================================================
@@ -5,6 +5,7 @@
 
 #include "maxmcp.h"
 #include "patch_registry.h"
+#include "tools/tool_common.h"
 
 #include <gtest/gtest.h>
 #include <nlohmann/json.hpp>
@@ -34,10 +35,10 @@ class PatchRegistryTest : public ::testing::Test {
  */
 TEST_F(PatchRegistryTest, RegisterUnregister) {
     // Create mock patch object
-    t_maxmcp mock_patch;
-    new (&mock_patch.patch_id) std::string("test_12345678");
-    new (&mock_patch.display_name) std::string("Test Patch");
-    new (&mock_patch.patcher_name) std::string("test.maxpat");
+    t_maxmcp mock_patch{};
+    mock_patch.patch_id = "test_12345678";
+    mock_patch.display_name = "Test Patch";
+    mock_patch.patcher_name = "test.maxpat";
 
     // Register
     PatchRegistry::register_patch(&mock_patch);
@@ -54,21 +55,16 @@ TEST_F(PatchRegistryTest, RegisterUnregister) {
     // Verify unregistration
     result = PatchRegistry::list_patches();
     EXPECT_EQ(result["count"], 0);
-
-    // Cleanup
-    mock_patch.patch_id.~basic_string();
-    mock_patch.display_name.~basic_string();
-    mock_patch.patcher_name.~basic_string();
 }
 
 /**
  * Test: Find patch by ID
  */
 TEST_F(PatchRegistryTest, FindPatch) {
-    t_maxmcp mock_patch;
-    new (&mock_patch.patch_id) std::string("test_12345678");
-    new (&mock_patch.display_name) std::string("Test Patch");
-    new (&mock_patch.patcher_name) std::string("test.maxpat");
+    t_maxmcp mock_patch{};
+    mock_patch.patch_id = "test_12345678";
+    mock_patch.display_name = "Test Patch";
+    mock_patch.patcher_name = "test.maxpat";
 
     PatchRegistry::register_patch(&mock_patch);
 
@@ -83,28 +79,25 @@ TEST_F(PatchRegistryTest, FindPatch) {
 
     // Cleanup
     PatchRegistry::unregister_patch(&mock_patch);
-    mock_patch.patch_id.~basic_string();
-    mock_patch.display_name.~basic_string();
-    mock_patch.patcher_name.~basic_string();
 }
 
 /**
  * Test: Multiple patches
  */
 TEST_F(PatchRegistryTest, MultiplePatches) {
-    t_maxmcp patch1, patch2, patch3;
+    t_maxmcp patch1{}, patch2{}, patch3{};
 
-    new (&patch1.patch_id) std::string("patch1_aaaaaaaa");
-    new (&patch1.display_name) std::string("Patch 1");
-    new (&patch1.patcher_name) std::string("patch1.maxpat");
+    patch1.patch_id = "patch1_aaaaaaaa";
+    patch1.display_name = "Patch 1";
+    patch1.patcher_name = "patch1.maxpat";
 
-    new (&patch2.patch_id) std::string("patch2_bbbbbbbb");
-    new (&patch2.display_name) std::string("Patch 2");
-    new (&patch2.patcher_name) std::string("patch2.maxpat");
+    patch2.patch_id = "patch2_bbbbbbbb";
+    patch2.display_name = "Patch 2";
+    patch2.patcher_name = "patch2.maxpat";
 
-    new (&patch3.patch_id) std::string("patch3_cccccccc");
-    new (&patch3.display_name) std::string("Patch 3");
-    new (&patch3.patcher_name) std::string("patch3.maxpat");
+    patch3.patch_id = "patch3_cccccccc";
+    patch3.display_name = "Patch 3";
+    patch3.patcher_name = "patch3.maxpat";
 
     // Register all
     PatchRegistry::register_patch(&patch1);
@@ -123,28 +116,16 @@ TEST_F(PatchRegistryTest, MultiplePatches) {
     PatchRegistry::unregister_patch(&patch1);
     PatchRegistry::unregister_patch(&patch2);
     PatchRegistry::unregister_patch(&patch3);
-
-    patch1.patch_id.~basic_string();
-    patch1.display_name.~basic_string();
-    patch1.patcher_name.~basic_string();
-
-    patch2.patch_id.~basic_string();
-    patch2.display_name.~basic_string();
-    patch2.patcher_name.~basic_string();
-
-    patch3.patch_id.~basic_string();
-    patch3.display_name.~basic_string();
-    patch3.patcher_name.~basic_string();
 }
 
 /**
  * Test: Duplicate registration (should be idempotent)
  */
 TEST_F(PatchRegistryTest, DuplicateRegistration) {
-    t_maxmcp mock_patch;
-    new (&mock_patch.patch_id) std::string("test_12345678");
-    new (&mock_patch.display_name) std::string("Test Patch");
-    new (&mock_patch.patcher_name) std::string("test.maxpat");
+    t_maxmcp mock_patch{};
+    mock_patch.patch_id = "test_12345678";
+    mock_patch.display_name = "Test Patch";
+    mock_patch.patcher_name = "test.maxpat";
 
     // Register twice
     PatchRegistry::register_patch(&mock_patch);
@@ -152,12 +133,129 @@ TEST_F(PatchRegistryTest, DuplicateRegistration) {
 
     // Should still have only 1 patch
     auto result = PatchRegistry::list_patches();
-    // Note: Current implementation may allow duplicates
-    // This test documents expected behavior
+    EXPECT_EQ(result["count"], 1);
 
     // Cleanup
     PatchRegistry::unregister_patch(&mock_patch);
-    mock_patch.patch_id.~basic_string();
-    mock_patch.display_name.~basic_string();
-    mock_patch.patcher_name.~basic_string();
+}
+
+/**
+ * Test: Shared patch ID resolves to the first registration, then the next one
+ */
+TEST_F(PatchRegistryTest, SharedPatchIdHandoff) {
+    t_maxmcp first{}, second{};
+    first.patch_id = "shared_alias";
+    first.display_name = "First";
+    first.patcher_name = "first.maxpat";
+    second.patch_id = "shared_alias";
+    second.display_name = "Second";
+    second.patcher_name = "second.maxpat";
+
+    PatchRegistry::register_patch(&first);
+    PatchRegistry::register_patch(&second);
+    EXPECT_EQ(PatchRegistry::find_patch("shared_alias"), &first);
+
+    PatchRegistry::unregister_patch(&first);
+    EXPECT_EQ(PatchRegistry::find_patch("shared_alias"), &second);
+
+    PatchRegistry::unregister_patch(&second);
+    EXPECT_EQ(PatchRegistry::find_patch("shared_alias"), nullptr);
+}
+
+/**
+ * Test: Cached listing follows register/unregister in registration order
+ */
+TEST_F(PatchRegistryTest, ListingTracksRegistrationOrder) {
+    t_maxmcp patch1{}, patch2{};
+    patch1.patch_id = "order_one";
+    patch1.display_name = "One";
+    patch1.patcher_name = "one.maxpat";
+    patch2.patch_id = "order_two";
+    patch2.display_name = "Two";
+    patch2.patcher_name = "two.maxpat";
+
+    PatchRegistry::register_patch(&patch1);
+    PatchRegistry::register_patch(&patch2);
+
+    auto result = PatchRegistry::list_patches();
+    ASSERT_EQ(result["count"], 2);
+    EXPECT_EQ(result["patches"][0]["patch_id"], "order_one");
+    EXPECT_EQ(result["patches"][1]["patch_id"], "order_two");
+    EXPECT_EQ(PatchRegistry::get_frontmost_patch()["patch_id"], "order_one");
+    EXPECT_EQ(PatchRegistry::list_patches_text(), result.dump());
+
+    PatchRegistry::unregister_patch(&patch1);
+    result = PatchRegistry::list_patches();
+    ASSERT_EQ(result["count"], 1);
+    EXPECT_EQ(result["patches"][0]["patch_id"], "order_two");
+    EXPECT_EQ(PatchRegistry::get_patch_info("order_one")["error"]["code"],
+              ToolCommon::ErrorCode::INVALID_PARAMS);
+
+    PatchRegistry::unregister_patch(&patch2);
+}
+
+/**
+ * Test: Filtering by a group nobody belongs to returns an empty listing
+ */
+TEST_F(PatchRegistryTest, UnknownGroupFilter) {
+    auto result = PatchRegistry::list_patches("no_such_group");
+    EXPECT_EQ(result["count"], 0);
+    EXPECT_TRUE(result["patches"].empty());
+    EXPECT_EQ(result["filter"]["group"], "no_such_group");
+    EXPECT_EQ(PatchRegistry::list_patches_text("no_such_group"), result.dump());
+}
+
+/**
+ * Test: Group filtering, including a group change after registration
+ */
+TEST_F(PatchRegistryTest, GroupFilterFollowsGroupChanges) {
+    t_maxmcp synth1{}, synth2{}, drums{};
+    t_maxmcp* patches[] = {&synth1, &synth2, &drums};
+    const char* ids[] = {"group_synth1", "group_synth2", "group_drums"};
+    for (int i = 0; i < 3; ++i) {
+        patches[i]->patch_id = ids[i];
+        patches[i]->display_name = ids[i];
+        patches[i]->patcher_name = "group.maxpat";
+    }
+
+    PatchRegistry::set_group_for_testing(&synth1, "synth");
+    PatchRegistry::set_group_for_testing(&synth2, "synth");
+    PatchRegistry::set_group_for_testing(&drums, "drums");
+    for (auto* patch : patches) {
+        PatchRegistry::register_patch(patch);
+    }
+
+    auto synth = PatchRegistry::list_patches("synth");
+    ASSERT_EQ(synth["count"], 2);
+    EXPECT_EQ(synth["patches"][0]["patch_id"], "group_synth1");
+    EXPECT_EQ(synth["patches"][1]["patch_id"], "group_synth2");
+    EXPECT_EQ(synth["patches"][0]["group"], "synth");
+    EXPECT_EQ(synth["filter"]["group"], "synth");
+    EXPECT_EQ(PatchRegistry::list_patches("drums")["count"], 1);
+    EXPECT_EQ(PatchRegistry::list_patches()["count"], 3);
+    EXPECT_EQ(PatchRegistry::get_patch_info("group_drums")["group"], "drums");
+
+    // Moving synth1 to drums keeps the drums listing in registration order
+    PatchRegistry::set_group_for_testing(&synth1, "drums");
+    PatchRegistry::update_group(&synth1);
+    EXPECT_EQ(PatchRegistry::list_patches("synth")["count"], 1);
+    auto drums_listing = PatchRegistry::list_patches("drums");
+    ASSERT_EQ(drums_listing["count"], 2);
+    EXPECT_EQ(drums_listing["patches"][0]["patch_id"], "group_synth1");
+    EXPECT_EQ(drums_listing["patches"][1]["patch_id"], "group_drums");
+
+    // Clearing the group drops the patch from every group listing
+    PatchRegistry::set_group_for_testing(&synth1, "");
+    PatchRegistry::update_group(&synth1);
+    EXPECT_EQ(PatchRegistry::list_patches("drums")["count"], 1);
+    EXPECT_FALSE(PatchRegistry::get_patch_info("group_synth1").contains("group"));
+
+    // Unregistering the last member empties the group
+    PatchRegistry::unregister_patch(&drums);
+    EXPECT_EQ(PatchRegistry::list_patches("drums")["count"], 0);
+
+    for (auto* patch : patches) {
+        PatchRegistry::unregister_patch(patch);
+        PatchRegistry::set_group_for_testing(patch, "");
+    }
 }
@@ -0,0 +1,304 @@
+/**
+    @file test_spatial_index.cpp
+    Unit tests for the uniform-grid spatial index (src/utils/spatial_index.cpp).
+
+    Every query is checked against a brute-force scan of the same rects, on
+    hand-picked layouts and on a seeded random patch, including after
+    removals, re-inserts and for rects too large to rasterise into the grid.
+*/
+
+#include "utils/spatial_index.h"
+
+#include <algorithm>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using geometry::GridIndex;
+using geometry::Point;
+using geometry::Rect;
+using geometry::Segment;
+
+namespace {
+
+std::vector<int> brute_query(const std::vector<Rect>& rects, const Rect& region, double eps) {
+    std::vector<int> ids;
+    for (size_t i = 0; i < rects.size(); ++i) {
+        if (geometry::aabb_overlap(rects[i], region, eps)) {
+            ids.push_back(static_cast<int>(i));
+        }
+    }
+    return ids;
+}
+
+std::vector<std::pair<int, double>> brute_nearest(const std::vector<Rect>& rects, const Point& p,
+                                                  size_t k) {
+    std::vector<std::pair<int, double>> all;
+    for (size_t i = 0; i < rects.size(); ++i) {
+        all.emplace_back(static_cast<int>(i), geometry::point_rect_distance(p, rects[i]));
+    }
+    std::sort(all.begin(), all.end(), [](const auto& a, const auto& b) {
+        return a.second != b.second ? a.second < b.second : a.first < b.first;
+    });
+    all.resize(std::min(k, all.size()));
+    return all;
+}
+
+// A seeded "patch": mostly object-sized boxes spread over a large canvas.
+std::vector<Rect> random_patch(size_t n, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> pos(0.0, 3000.0);
+    std::uniform_real_distribution<double> width(20.0, 200.0);
+    std::uniform_real_distribution<double> height(18.0, 60.0);
+    std::vector<Rect> rects;
+    for (size_t i = 0; i < n; ++i) {
+        rects.push_back({pos(rng), pos(rng), width(rng), height(rng)});
+    }
+    return rects;
+}
+
+}  // namespace
+
+// ============================================================================
+// Basics
+// ============================================================================
+
+TEST(GridIndexTest, PointRectDistance) {
+    Rect r{10, 10, 20, 10};
+    EXPECT_DOUBLE_EQ(geometry::point_rect_distance({15, 15}, r), 0.0);
+    EXPECT_DOUBLE_EQ(geometry::point_rect_distance({0, 15}, r), 10.0);
+    EXPECT_DOUBLE_EQ(geometry::point_rect_distance({33, 24}, r), 5.0);  // 3-4-5 off the corner
+}
+
+TEST(GridIndexTest, QueryUsesStrictOverlapByDefault) {
+    GridIndex index(50.0);
+    index.insert(0, {0, 0, 100, 20});
+    index.insert(1, {100, 0, 50, 20});  // touches 0 on the right
+    index.insert(2, {400, 400, 10, 10});
+
+    EXPECT_EQ(index.query({90, 5, 5, 5}), (std::vector<int>{0}));
+    EXPECT_EQ(index.query({100, 0, 1, 1}), (std::vector<int>{1}));
+    EXPECT_TRUE(index.query({200, 200, 50, 50}).empty());
+    EXPECT_EQ(index.query({0, 0, 1000, 1000}), (std::vector<int>{0, 1, 2}));
+}
+
+TEST(GridIndexTest, NegativeEpsIsAClearanceTest) {
+    GridIndex index(50.0);
+    index.insert(7, {0, 0, 50, 20});
+    // 5 px to the right of the box: clear for a 4 px gap, too close for 8 px
+    Rect candidate{55, 0, 50, 20};
+    EXPECT_FALSE(index.any(candidate, -4.0));
+    EXPECT_TRUE(index.any(candidate, -8.0));
+    EXPECT_EQ(index.query(candidate, -8.0), (std::vector<int>{7}));
+}
+
+TEST(GridIndexTest, QueryContained) {
+    GridIndex index(32.0);
+    index.insert(0, {10, 10, 20, 20});
+    index.insert(1, {90, 10, 20, 20});  // straddles the region's right edge
+    index.insert(2, {40, 40, 60, 60});  // exactly fills the region's bottom-right
+    EXPECT_EQ(index.query_contained({0, 0, 100, 100}), (std::vector<int>{0, 2}));
+}
+
+TEST(GridIndexTest, InsertReplacesAndRemoveForgets) {
+    GridIndex index(50.0);
+    index.insert(3, {0, 0, 10, 10});
+    index.insert(3, {500, 500, 10, 10});
+    EXPECT_EQ(index.size(), 1u);
+    EXPECT_TRUE(index.query({0, 0, 20, 20}).empty());
+    EXPECT_EQ(index.query({495, 495, 20, 20}), (std::vector<int>{3}));
+
+    EXPECT_TRUE(index.remove(3));
+    EXPECT_FALSE(index.remove(3));
+    EXPECT_FALSE(index.contains(3));
+    EXPECT_TRUE(index.query({0, 0, 1000, 1000}).empty());
+    EXPECT_TRUE(index.nearest({0, 0}, 3).empty());
+}
+
+TEST(GridIndexTest, OversizedRectsAreStillFound) {
+    GridIndex index(16.0);
+    index.insert(0, {0, 0, 5000, 5000});  // far more cells than the grid rasterises
+    index.insert(1, {100, 100, 10, 10});
+    EXPECT_EQ(index.query({2000, 2000, 5, 5}), (std::vector<int>{0}));
+    EXPECT_EQ(index.query({101, 101, 2, 2}), (std::vector<int>{0, 1}));
+
+    auto near = index.nearest({6000, 6000}, 1);
+    ASSERT_EQ(near.size(), 1u);
+    EXPECT_EQ(near[0].first, 0);
+
+    EXPECT_TRUE(index.remove(0));
+    EXPECT_TRUE(index.query({2000, 2000, 5, 5}).empty());
+}
+
+TEST(GridIndexTest, NearestOrdersByDistanceThenId) {
+    GridIndex index(40.0);
+    index.insert(5, {100, 0, 10, 10});
+    index.insert(2, {0, 100, 10, 10});  // same distance from the origin as 5
+    index.insert(9, {0, 0, 10, 10});    // contains the point
+    auto near = index.nearest({5, 5}, 3);
+    ASSERT_EQ(near.size(), 3u);
+    EXPECT_EQ(near[0], std::make_pair(9, 0.0));
+    EXPECT_EQ(near[1].first, 2);
+    EXPECT_EQ(near[2].first, 5);
+    EXPECT_DOUBLE_EQ(near[1].second, near[2].second);
+}
+
+TEST(GridIndexTest, NearestFarFromThePatchFallsBackToAScan) {
+    GridIndex index(20.0);
+    index.insert(0, {0, 0, 10, 10});
+    index.insert(1, {30, 0, 10, 10});
+    auto near = index.nearest({1e6, 0}, 5);  // k larger than the index
+    ASSERT_EQ(near.size(), 2u);
+    EXPECT_EQ(near[0].first, 1);
+    EXPECT_EQ(near[1].first, 0);
+}
+
+TEST(GridIndexTest, SuggestedCellSizeIsClamped) {
+    EXPECT_DOUBLE_EQ(GridIndex::suggest_cell_size({}), GridIndex::kDefaultCellSize);
+    EXPECT_DOUBLE_EQ(GridIndex::suggest_cell_size({{0, 0, 60, 20}, {0, 0, 20, 100}}), 80.0);
+    EXPECT_DOUBLE_EQ(GridIndex::suggest_cell_size({{0, 0, 2, 2}}), 16.0);
+    EXPECT_DOUBLE_EQ(GridIndex::suggest_cell_size({{0, 0, 1e5, 2}}), 1024.0);
+}
+
+TEST(GridIndexTest, OverlappingPairsInIdOrder) {
+    // Ids deliberately not in x order; 3 only touches 0 and 2
+    std::vector<Rect> rects{{100, 0, 50, 20}, {0, 0, 120, 20}, {130, 10, 40, 20}, {150, 0, 10, 10}};
+    using Pairs = std::vector<std::pair<int, int>>;
+    EXPECT_EQ(geometry::overlapping_pairs(rects, 0.0), (Pairs{{0, 1}, {0, 2}}));
+    EXPECT_EQ(geometry::overlapping_pairs(rects, 15.0), (Pairs{{0, 1}}));  // 0/2 share only 10 px
+    EXPECT_EQ(geometry::overlapping_pairs(rects, -1.0), (Pairs{{0, 1}, {0, 2}, {0, 3}, {2, 3}}));
+    EXPECT_TRUE(geometry::overlapping_pairs({}, 0.0).empty());
+}
+
+TEST(GridIndexTest, CollinearOverlapPairs) {
+    std::vector<Segment> segs{
+        {{25, 0}, {25, 100}},    // 0: vertical at x=25
+        {{100, 50}, {0, 50}},    // 1: horizontal at y=50, drawn right to left
+        {{26, 80}, {26, 200}},   // 2: vertical, 1 px off 0, overlapping it by 20
+        {{40, 50}, {60, 50.5}},  // 3: horizontal within 1 px of 1, inside its span
+        {{25, 99}, {25, 300}},   // 4: only touches 0 (1 px shared), overlaps 2
+        {{0, 0}, {100, 100}},    // 5: diagonal
+        {{25, 10}, {25, 11}},    // 6: 1 px long, so only overlaps at eps 0
+    };
+    using Pairs = std::vector<std::pair<int, int>>;
+    EXPECT_EQ(geometry::collinear_overlap_pairs(segs, 2.0), (Pairs{{0, 2}, {1, 3}, {2, 4}}));
+    EXPECT_EQ(geometry::collinear_overlap_pairs(segs, 0.0), (Pairs{{0, 4}, {0, 6}}));
+    EXPECT_TRUE(geometry::collinear_overlap_pairs(segs, -1.0).empty());
+}
+
+// ============================================================================
+// Agreement with brute force
+// ============================================================================
+
+TEST(GridIndexTest, CollinearOverlapPairsMatchBruteForce) {
+    // Axis-aligned segments snapped to a coarse lattice (so many share a line),
+    // jittered by up to 3 px, plus some diagonals
+    std::mt19937 rng(17);
+    std::uniform_int_distribution<int> lattice(0, 40);
+    std::uniform_real_distribution<double> jitter(0.0, 3.0);
+    std::uniform_real_distribution<double> length(-200.0, 200.0);
+    std::vector<Segment> segs;
+    for (int i = 0; i < 3000; ++i) {
+        const Point a{lattice(rng) * 25.0 + jitter(rng), lattice(rng) * 25.0 + jitter(rng)};
+        switch (i % 5) {
+        case 0:
+            segs.push_back({a, {a.x + length(rng), a.y + length(rng)}});
+            break;
+        case 1:
+        case 2:
+            segs.push_back({a, {a.x + jitter(rng) - 1.5, a.y + length(rng)}});
+            break;
+        default:
+            segs.push_back({a, {a.x + length(rng), a.y + jitter(rng) - 1.5}});
+            break;
+        }
+    }
+
+    for (double eps : {0.0, 1.0, 2.0, 4.0}) {
+        std::vector<std::pair<int, int>> expected;
+        for (size_t i = 0; i < segs.size(); ++i) {
+            for (size_t j = i + 1; j < segs.size(); ++j) {
+                if (geometry::segments_overlap_collinear(segs[i], segs[j], eps)) {
+                    expected.emplace_back(static_cast<int>(i), static_cast<int>(j));
+                }
+            }
+        }
+        EXPECT_EQ(geometry::collinear_overlap_pairs(segs, eps), expected) << "eps " << eps;
+    }
+}
+
+TEST(GridIndexTest, OverlappingPairsMatchBruteForce) {
+    auto brute_pairs = [](const std::vector<Rect>& rects, double eps) {
+        std::vector<std::pair<int, int>> pairs;
+        for (size_t i = 0; i < rects.size(); ++i) {
+            for (size_t j = i + 1; j < rects.size(); ++j) {
+                if (geometry::aabb_overlap(rects[i], rects[j], eps)) {
+                    pairs.emplace_back(static_cast<int>(i), static_cast<int>(j));
+                }
+            }
+        }
+        return pairs;
+    };
+
+    // A scattered patch, then a single column (swept along y)
+    std::vector<Rect> scattered = random_patch(1500, 5);
+    std::vector<Rect> column;
+    std::mt19937 rng(9);
+    std::uniform_real_distribution<double> jitter(0.0, 6.0);
+    for (int i = 0; i < 400; ++i) {
+        column.push_back({100.0 + jitter(rng), i * 20.0 + jitter(rng), 80.0, 22.0});
+    }
+    for (const auto* rects : {&scattered, &column}) {
+        for (double eps : {0.0, 2.0, -8.0}) {
+            EXPECT_EQ(geometry::overlapping_pairs(*rects, eps), brute_pairs(*rects, eps))
+                << "eps " << eps;
+        }
+    }
+}
+
+TEST(GridIndexTest, MatchesBruteForceOnRandomPatch) {
+    std::vector<Rect> rects = random_patch(2000, 42);
+    GridIndex index = GridIndex::build(rects);
+    ASSERT_EQ(index.size(), rects.size());
+
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<double> pos(-200.0, 3200.0);
+    std::uniform_real_distribution<double> extent(0.0, 400.0);
+    for (int q = 0; q < 200; ++q) {
+        Rect region{pos(rng), pos(rng), extent(rng), extent(rng)};
+        for (double eps : {0.0, 2.0, -8.0}) {
+            ASSERT_EQ(index.query(region, eps), brute_query(rects, region, eps))
+                << "query " << q << " eps " << eps;
+            ASSERT_EQ(index.any(region, eps), !brute_query(rects, region, eps).empty());
+        }
+
+        Point p{pos(rng), pos(rng)};
+        ASSERT_EQ(index.nearest(p, 5), brute_nearest(rects, p, 5)) << "nearest " << q;
+    }
+}
+
+TEST(GridIndexTest, MatchesBruteForceAfterRemovals) {
+    std::vector<Rect> rects = random_patch(500, 3);
+    GridIndex index = GridIndex::build(rects);
+
+    // Drop every third rect from both the index and the reference list
+    std::vector<Rect> kept;
+    std::vector<int> kept_ids;
+    for (size_t i = 0; i < rects.size(); ++i) {
+        if (i % 3 == 0) {
+            ASSERT_TRUE(index.remove(static_cast<int>(i)));
+        } else {
+            kept.push_back(rects[i]);
+            kept_ids.push_back(static_cast<int>(i));
+        }
+    }
+
+    Rect region{500, 500, 1500, 1500};
+    std::vector<int> expected;
+    for (int local : brute_query(kept, region, 0.0)) {
+        expected.push_back(kept_ids[local]);
+    }
+    EXPECT_EQ(index.query(region), expected);
+}
@@ -50,22 +50,24 @@ class ToolSchemaTest : public ::testing::Test {
 
 TEST_F(ToolSchemaTest, PatchToolsSchemaCount) {
     auto schemas = PatchTools::get_tool_schemas();
-    ASSERT_EQ(schemas.size(), 3)
-        << "PatchTools should have 3 tools (list_active_patches, get_patch_info, "
-           "get_frontmost_patch)";
+    ASSERT_EQ(schemas.size(), 5)
+        << "PatchTools should have 5 tools (list_active_patches, get_patch_info, "
+           "get_frontmost_patch, export_patch, import_patch_fragment)";
 }
 
 TEST_F(ToolSchemaTest, ObjectToolsSchemaCount) {
     auto schemas = ObjectTools::get_tool_schemas();
-    ASSERT_EQ(schemas.size(), 12)
-        << "ObjectTools should have 12 tools (add, remove, get_objects, set_attr, get_attr, "
-           "get_value, get_io, get_hidden, set_hidden, redraw, replace_text, assign_varnames)";
+    ASSERT_EQ(schemas.size(), 17)
+        << "ObjectTools should have 17 tools (add, add_many, remove, get_objects, query, set_attr, "
+           "get_attr, set_attrs, get_attrs, get_value, get_io, get_hidden, set_hidden, redraw, "
+           "replace_text, replace_text_batch, assign_varnames)";
 }
 
 TEST_F(ToolSchemaTest, ConnectionToolsSchemaCount) {
     auto schemas = ConnectionTools::get_tool_schemas();
-    ASSERT_EQ(schemas.size(), 4) << "ConnectionTools should have 4 tools (connect, disconnect, "
-                                    "get_patchlines, set_patchline_midpoints)";
+    ASSERT_EQ(schemas.size(), 6) << "ConnectionTools should have 6 tools (connect, connect_batch, "
+                                    "disconnect, get_patchlines, set_patchline_midpoints, "
+                                    "analyze_patch_graph)";
 }
 
 TEST_F(ToolSchemaTest, StateToolsSchemaCount) {
@@ -82,8 +84,8 @@ TEST_F(ToolSchemaTest, HierarchyToolsSchemaCount) {
 
 TEST_F(ToolSchemaTest, UtilityToolsSchemaCount) {
     auto schemas = UtilityTools::get_tool_schemas();
-    ASSERT_EQ(schemas.size(), 2)
-        << "UtilityTools should have 2 tools (get_console_log, get_avoid_rect)";
+    ASSERT_EQ(schemas.size(), 3)
+        << "UtilityTools should have 3 tools (get_console_log, get_avoid_rect, place_objects)";
 }
 
 TEST_F(ToolSchemaTest, TotalToolCount) {
@@ -91,7 +93,7 @@ TEST_F(ToolSchemaTest, TotalToolCount) {
         PatchTools::get_tool_schemas().size() + ObjectTools::get_tool_schemas().size() +
         ConnectionTools::get_tool_schemas().size() + StateTools::get_tool_schemas().size() +
         HierarchyTools::get_tool_schemas().size() + UtilityTools::get_tool_schemas().size();
-    EXPECT_EQ(total, 26) << "Total tool count should be 26";
+    EXPECT_EQ(total, 36) << "Total tool count should be 36";
 }
 
 TEST_F(ToolSchemaTest, AllSchemasHaveRequiredFields) {
@@ -143,7 +145,10 @@ TEST_F(ToolSchemaTest, ExpectedToolNamesPresent) {
         "set_patch_lock_state", "get_patch_dirty",         "get_parent_patcher",
         "get_subpatchers",      "get_console_log",         "get_avoid_rect_position",
         "get_patchlines",       "set_patchline_midpoints", "replace_object_text",
-        "assign_varnames",      "get_object_value"};
+        "assign_varnames",      "get_object_value",        "export_patch",
+        "import_patch_fragment", "add_max_objects",        "connect_max_objects_batch",
+        "set_object_attributes", "get_object_attributes",  "replace_object_text_batch",
+        "query_objects",        "analyze_patch_graph",     "place_objects"};
 
     for (const auto& name : expected) {
         EXPECT_TRUE(names.count(name)) << "Missing expected tool: " << name;
@@ -238,7 +243,7 @@ TEST_F(MCPServerRoutingTest, ToolsListReturnsAllTools) {
 
     auto& tools = response["result"]["tools"];
     ASSERT_TRUE(tools.is_array());
-    EXPECT_EQ(tools.size(), 30) << "tools/list should return all 30 tools";
+    EXPECT_EQ(tools.size(), 43) << "tools/list should return all 43 tools";
 }
 
 TEST_F(MCPServerRoutingTest, ToolsListResponseFormat) {
@@ -304,6 +309,54 @@ TEST_F(MCPServerRoutingTest, NotificationReturnsEmpty) {
     EXPECT_TRUE(response_str.empty()) << "Notification should return empty string";
 }
 
+TEST_F(MCPServerRoutingTest, InitializeNegotiatesWireEncoding) {
+    json request = {
+        {"jsonrpc", "2.0"},
+        {"id", 1},
+        {"method", "initialize"},
+        {"params",
+         {{"protocolVersion", "2024-11-05"},
+          {"capabilities",
+           {{"experimental", {{"maxmcp", {{"wireEncodings", {"bson", "cbor", "msgpack"}}}}}}}}}}};
+
+    wire::Encoding session = wire::Encoding::Json;
+    std::string response_str = server->handle_request_frame(request.dump(), false, session);
+
+    // The initialize response itself is still JSON; the session switches afterwards.
+    auto response = json::parse(response_str);
+    EXPECT_EQ(response["result"]["capabilities"]["experimental"]["maxmcp"]["wireEncoding"], "cbor");
+    EXPECT_EQ(session, wire::Encoding::Cbor);
+
+    // Without an offer the capability is absent and JSON stays in effect.
+    auto plain = send_request({{"jsonrpc", "2.0"}, {"id", 2}, {"method", "initialize"}});
+    EXPECT_FALSE(plain["result"]["capabilities"].contains("experimental"));
+}
+
+TEST_F(MCPServerRoutingTest, BinaryFramesUseSessionEncoding) {
+    json request = {{"jsonrpc", "2.0"}, {"id", 7}, {"method", "tools/list"}};
+
+    wire::Encoding session = wire::Encoding::MessagePack;
+    std::string response_bytes =
+        server->handle_request_frame(wire::encode(request, session), true, session);
+    auto response = json::from_msgpack(response_bytes);
+    EXPECT_EQ(response["id"], 7);
+    EXPECT_EQ(response["result"]["tools"].size(), 43);
+
+    // Text frames stay JSON even in a binary session.
+    auto text_response = json::parse(server->handle_request_frame(request.dump(), false, session));
+    EXPECT_EQ(text_response["id"], 7);
+}
+
+TEST_F(MCPServerRoutingTest, BinaryFrameWithoutNegotiationIsParseError) {
+    wire::Encoding session = wire::Encoding::Json;
+    json request = {{"jsonrpc", "2.0"}, {"id", 1}, {"method", "tools/list"}};
+    std::string response_str =
+        server->handle_request_frame(wire::encode(request, wire::Encoding::Cbor), true, session);
+
+    auto response = json::parse(response_str);
+    EXPECT_EQ(response["error"]["code"], ToolCommon::ErrorCode::PARSE_ERROR);
+}
+
 // ============================================================================
 // Test Mode Execute Tests
 // ============================================================================
@@ -372,6 +425,51 @@ TEST_F(PatchToolsValidationTest, ListActivePatchesEmpty) {
     EXPECT_FALSE(result.contains("error"));
 }
 
+TEST_F(PatchToolsValidationTest, ExportPatchMissingPatchId) {
+    auto result = PatchTools::execute("export_patch", json::object());
+    ASSERT_TRUE(result.contains("error"));
+    EXPECT_EQ(result["error"]["code"], ToolCommon::ErrorCode::INVALID_PARAMS);
+}
+
+TEST_F(PatchToolsValidationTest, ExportPatchRejectsTinyChunks) {
+    json params = {{"patch_id", "any"}, {"chunk_bytes", 16}};
+    auto result = PatchTools::execute("export_patch", params);
+    ASSERT_TRUE(result.contains("error"));
+    EXPECT_EQ(result["error"]["code"], ToolCommon::ErrorCode::INVALID_PARAMS);
+}
+
+TEST_F(PatchToolsValidationTest, ExportPatchUnknownExportId) {
+    json params = {{"export_id", "export-does-not-exist"}, {"chunk", 1}};
+    auto result = PatchTools::execute("export_patch", params);
+    ASSERT_TRUE(result.contains("error"));
+    EXPECT_EQ(result["error"]["code"], ToolCommon::ErrorCode::INVALID_PARAMS);
+
+    params.erase("chunk");
+    result = PatchTools::execute("export_patch", params);
+    ASSERT_TRUE(result.contains("error"));
+    EXPECT_EQ(result["error"]["code"], ToolCommon::ErrorCode::INVALID_PARAMS);
+}
+
+TEST_F(PatchToolsValidationTest, ImportFragmentValidatesBeforeDeferring) {
+    json boxes = json::array({{{"box", {{"id", "obj-1"}, {"maxclass", "toggle"}}}}});
+    json params = {{"patch_id", "any"}, {"boxes", boxes}, {"offset", json::array({10})}};
+    auto result = PatchTools::execute("import_patch_fragment", params);
+    ASSERT_TRUE(result.contains("error"));
+    EXPECT_EQ(result["error"]["code"], ToolCommon::ErrorCode::INVALID_PARAMS);
+
+    params["offset"] = json::array({10, 20});
+    params["lines"] = json::array(
+        {{{"patchline", {{"source", {"obj-1", 0}}, {"destination", {"obj-9", 0}}}}}});
+    result = PatchTools::execute("import_patch_fragment", params);
+    ASSERT_TRUE(result.contains("error"));
+    EXPECT_EQ(result["error"]["code"], ToolCommon::ErrorCode::INVALID_PARAMS);
+
+    params.erase("lines");
+    result = PatchTools::execute("import_patch_fragment", params);
+    ASSERT_TRUE(result.contains("error"));
+    EXPECT_EQ(result["error"]["message"], "Not available in test mode");
+}
+
 // ============================================================================
 // Connection Tools Test Mode (returns test_mode_error for all known tools)
 // ============================================================================
@@ -384,6 +482,12 @@ TEST_F(ConnectionToolsTestModeTest, ConnectReturnsTestModeError) {
     EXPECT_EQ(result["error"]["code"], ToolCommon::ErrorCode::INTERNAL_ERROR);
 }
 
+TEST_F(ConnectionToolsTestModeTest, ConnectBatchReturnsTestModeError) {
+    auto result = ConnectionTools::execute("connect_max_objects_batch", json::object());
+    ASSERT_TRUE(result.contains("error"));
+    EXPECT_EQ(result["error"]["code"], ToolCommon::ErrorCode::INTERNAL_ERROR);
+}
+
 TEST_F(ConnectionToolsTestModeTest, DisconnectReturnsTestModeError) {
     auto result = ConnectionTools::execute("disconnect_max_objects", json::object());
     ASSERT_TRUE(result.contains("error"));
@@ -402,6 +506,12 @@ TEST_F(ConnectionToolsTestModeTest, SetPatchlineMidpointsReturnsTestModeError) {
     EXPECT_EQ(result["error"]["code"], ToolCommon::ErrorCode::INTERNAL_ERROR);
 }
 
+TEST_F(ConnectionToolsTestModeTest, AnalyzePatchGraphReturnsTestModeError) {
+    auto result = ConnectionTools::execute("analyze_patch_graph", json::object());
+    ASSERT_TRUE(result.contains("error"));
+    EXPECT_EQ(result["error"]["code"], ToolCommon::ErrorCode::INTERNAL_ERROR);
+}
+
 TEST_F(ConnectionToolsTestModeTest, UnknownToolReturnsNull) {
     auto result = ConnectionTools::execute("unknown_tool", json::object());
     EXPECT_TRUE(result.is_null());
@@ -426,3 +536,9 @@ TEST_F(UtilityToolsTest, GetAvoidRectReturnsTestModeError) {
     ASSERT_TRUE(result.contains("error"));
     EXPECT_EQ(result["error"]["code"], ToolCommon::ErrorCode::INTERNAL_ERROR);
 }
+
+TEST_F(UtilityToolsTest, PlaceObjectsReturnsTestModeError) {
+    auto result = UtilityTools::execute("place_objects", json::object());
+    ASSERT_TRUE(result.contains("error"));
+    EXPECT_EQ(result["error"]["code"], ToolCommon::ErrorCode::INTERNAL_ERROR);
+}
@@ -45,7 +45,7 @@ int TestWebSocketClient::callback(struct lws* wsi, enum lws_callback_reasons rea
     case LWS_CALLBACK_CLIENT_RECEIVE:
         if (in && len > 0) {
             std::string message(static_cast<const char*>(in), len);
-            client->on_message_received(message);
+            client->on_message_received(message, lws_frame_is_binary(wsi) != 0);
         }
         break;
 
@@ -72,13 +72,18 @@ int TestWebSocketClient::callback(struct lws* wsi, enum lws_callback_reasons rea
 }
 
 bool TestWebSocketClient::connect(const std::string& url) {
-    // Set up protocols (must be static)
+    // Set up protocols (must be static). Every subprotocol the server may
+    // accept is listed so the handshake can bind to the one it answers with.
     static const struct lws_protocols protocols[] = {{
                                                          "mcp",
                                                          TestWebSocketClient::callback,
                                                          0,
                                                          4096,
                                                      },
+                                                     {"mcp.cbor", TestWebSocketClient::callback,
+                                                      0, 4096},
+                                                     {"mcp.msgpack", TestWebSocketClient::callback,
+                                                      0, 4096},
                                                      {nullptr, nullptr, 0, 0}};
 
     // Create context
@@ -104,7 +109,7 @@ bool TestWebSocketClient::connect(const std::string& url) {
     ccinfo.path = "/";
     ccinfo.host = "localhost";
     ccinfo.origin = "localhost";
-    ccinfo.protocol = "mcp";
+    ccinfo.protocol = protocol_.c_str();
     ccinfo.pwsi = &wsi_;
     // Auth header will be added in LWS_CALLBACK_CLIENT_APPEND_HANDSHAKE_HEADER
 
@@ -147,7 +152,7 @@ void TestWebSocketClient::disconnect() {
     connected_ = false;
 }
 
-bool TestWebSocketClient::send(const std::string& message) {
+bool TestWebSocketClient::send(const std::string& message, bool binary) {
     if (!connected_ || !wsi_) {
         return false;
     }
@@ -158,7 +163,7 @@ bool TestWebSocketClient::send(const std::string& message) {
 
     memcpy(buf + LWS_PRE, message.c_str(), len);
 
-    int written = lws_write(wsi_, buf + LWS_PRE, len, LWS_WRITE_TEXT);
+    int written = lws_write(wsi_, buf + LWS_PRE, len, binary ? LWS_WRITE_BINARY : LWS_WRITE_TEXT);
 
     delete[] buf;
 
@@ -200,13 +205,14 @@ std::string TestWebSocketClient::wait_for_message(std::chrono::milliseconds time
         }
     }
 
-    std::string message = message_queue_.front();
+    std::string message = std::move(message_queue_.front().first);
+    last_message_binary_ = message_queue_.front().second;
     message_queue_.pop();
     return message;
 }
 
-void TestWebSocketClient::on_message_received(const std::string& message) {
+void TestWebSocketClient::on_message_received(const std::string& message, bool binary) {
     std::lock_guard<std::mutex> lock(queue_mutex_);
-    message_queue_.push(message);
+    message_queue_.emplace(message, binary);
     queue_cv_.notify_one();
 }
@@ -15,10 +15,12 @@
 #include <mutex>
 #include <queue>
 #include <string>
+#include <utility>
 
 class TestWebSocketClient {
   public:
-    TestWebSocketClient() : wsi_(nullptr), context_(nullptr), connected_(false) {}
+    TestWebSocketClient()
+        : wsi_(nullptr), context_(nullptr), connected_(false), last_message_binary_(false) {}
 
     ~TestWebSocketClient() {
         disconnect();
@@ -39,9 +41,10 @@ class TestWebSocketClient {
     /**
      * Send message to server
      * @param message Message to send
+     * @param binary Send a binary frame instead of a text frame
      * @return true if send successful
      */
-    bool send(const std::string& message);
+    bool send(const std::string& message, bool binary = false);
 
     /**
      * Wait for incoming message
@@ -50,6 +53,21 @@ class TestWebSocketClient {
      */
     std::string wait_for_message(std::chrono::milliseconds timeout);
 
+    /**
+     * Whether the message last returned by wait_for_message() came in a binary frame
+     */
+    bool last_message_binary() const {
+        return last_message_binary_;
+    }
+
+    /**
+     * Set the WebSocket subprotocol requested on connect (default "mcp")
+     * @param protocol "mcp", "mcp.cbor" or "mcp.msgpack"
+     */
+    void set_protocol(const std::string& protocol) {
+        protocol_ = protocol;
+    }
+
     /**
      * Set authentication header
      * @param auth Authorization header value (e.g., "Bearer token")
@@ -70,9 +88,11 @@ class TestWebSocketClient {
     struct lws_context* context_;
     bool connected_;
     std::string auth_header_;
+    std::string protocol_ = "mcp";
 
-    // Message queue
-    std::queue<std::string> message_queue_;
+    // Message queue (payload, binary frame)
+    std::queue<std::pair<std::string, bool>> message_queue_;
+    bool last_message_binary_;
     std::mutex queue_mutex_;
     std::condition_variable queue_cv_;
 
@@ -81,7 +101,7 @@ class TestWebSocketClient {
                         size_t len);
 
     // Internal message handler
-    void on_message_received(const std::string& message);
+    void on_message_received(const std::string& message, bool binary);
 };
 
 #endif  // TEST_WEBSOCKET_CLIENT_H
@@ -7,6 +7,7 @@
  * - Message sending/receiving
  * - Multi-client support
  * - Request queueing
+ * - Binary wire encodings (subprotocol negotiation and frame types)
  * - Authentication
  *
  * Following TDD principles: Write tests first, then implement.
@@ -26,7 +27,10 @@
 
 #include <chrono>
 #include <future>
+#include <mutex>
 #include <thread>
+#include <utility>
+#include <vector>
 
 #include <gtest/gtest.h>
 #include <nlohmann/json.hpp>
@@ -230,6 +234,52 @@ TEST_F(WebSocketServerTest, DISABLED_MultiClientRequestsAreQueued) {
     EXPECT_EQ(processed_count, 2);
 }
 
+// ============================================================================
+// Wire Encoding Tests
+// ============================================================================
+
+TEST_F(WebSocketServerTest, CborSubprotocolFramesMirrorTheRequest) {
+    // Echo the decoded request back as the result, in the frame's encoding
+    std::mutex seen_mutex;
+    std::vector<std::pair<bool, wire::Encoding>> seen;
+    server->set_sync_message_callback([&](const std::string&, const std::string& payload,
+                                          bool binary, wire::Encoding& session) {
+        wire::Encoding encoding = binary ? session : wire::Encoding::Json;
+        {
+            std::lock_guard<std::mutex> lock(seen_mutex);
+            seen.emplace_back(binary, session);
+        }
+        nlohmann::json request = wire::decode(payload, encoding);
+        return wire::encode({{"jsonrpc", "2.0"}, {"id", request["id"]}, {"result", request}},
+                            encoding);
+    });
+
+    TestWebSocketClient client;
+    client.set_protocol("mcp.cbor");
+    ASSERT_TRUE(client.connect("ws://localhost:" + std::to_string(TEST_PORT)));
+
+    nlohmann::json request = {{"jsonrpc", "2.0"}, {"method", "ping"}, {"id", 1}};
+    ASSERT_TRUE(client.send(wire::encode(request, wire::Encoding::Cbor), true));
+    std::string reply = client.wait_for_message(1s);
+    ASSERT_FALSE(reply.empty());
+    EXPECT_TRUE(client.last_message_binary());
+    EXPECT_EQ(wire::decode(reply, wire::Encoding::Cbor)["result"], request);
+
+    // A text frame in the same session is still JSON, answered in a text frame
+    request["id"] = 2;
+    ASSERT_TRUE(client.send(request.dump()));
+    reply = client.wait_for_message(1s);
+    ASSERT_FALSE(reply.empty());
+    EXPECT_FALSE(client.last_message_binary());
+    EXPECT_EQ(nlohmann::json::parse(reply)["result"], request);
+
+    std::lock_guard<std::mutex> lock(seen_mutex);
+    ASSERT_EQ(seen.size(), 2u);
+    EXPECT_TRUE(seen[0].first);
+    EXPECT_EQ(seen[0].second, wire::Encoding::Cbor);
+    EXPECT_FALSE(seen[1].first);
+}
+
 // ============================================================================
 // Authentication Tests
 // ============================================================================
@@ -0,0 +1,51 @@
+/**
+    @file test_wire_codec.cpp
+    Unit tests for the per-session wire encoding (src/utils/wire_codec.cpp).
+
+    Covers name/subprotocol mapping, initialize negotiation and lossless
+    round trips. Sizes and timings are in tests/bench/bench_wire_codec.cpp.
+*/
+
+#include "utils/wire_codec.h"
+
+#include <string>
+
+#include <gtest/gtest.h>
+#include <nlohmann/json.hpp>
+
+using json = nlohmann::json;
+using wire::Encoding;
+
+TEST(WireCodecTest, NamesAndSubprotocols) {
+    for (Encoding e : {Encoding::Json, Encoding::Cbor, Encoding::MessagePack}) {
+        EXPECT_EQ(wire::parse_encoding(wire::encoding_name(e)), e);
+        EXPECT_EQ(wire::encoding_for_subprotocol(wire::subprotocol_name(e)), e);
+    }
+    EXPECT_STREQ(wire::subprotocol_name(Encoding::Json), "mcp");
+    EXPECT_FALSE(wire::parse_encoding("bson").has_value());
+    EXPECT_FALSE(wire::encoding_for_subprotocol("mcp.bson").has_value());
+    EXPECT_FALSE(wire::is_binary(Encoding::Json));
+    EXPECT_TRUE(wire::is_binary(Encoding::Cbor));
+}
+
+TEST(WireCodecTest, NegotiatePicksFirstSupported) {
+    auto offer = [](json list) {
+        return json{{"capabilities", {{"experimental", {{"maxmcp", {{"wireEncodings", list}}}}}}}};
+    };
+    EXPECT_EQ(wire::negotiate(offer({"msgpack", "cbor"})), Encoding::MessagePack);
+    EXPECT_EQ(wire::negotiate(offer({"bson", 3, "cbor"})), Encoding::Cbor);
+    EXPECT_EQ(wire::negotiate(offer({"bson"})), Encoding::Json);
+    EXPECT_FALSE(wire::negotiate(json::object()).has_value());
+    EXPECT_FALSE(wire::negotiate(offer("cbor")).has_value());
+    EXPECT_FALSE(wire::negotiate(json{{"capabilities", {{"experimental", 1}}}}).has_value());
+}
+
+TEST(WireCodecTest, RoundTripsEveryEncoding) {
+    json message = {{"jsonrpc", "2.0"},
+                    {"id", 3},
+                    {"result", {{"text", "caf\xc3\xa9 \"q\""}, {"n", -1.25}, {"ok", true}}}};
+    for (Encoding e : {Encoding::Json, Encoding::Cbor, Encoding::MessagePack}) {
+        EXPECT_EQ(wire::decode(wire::encode(message, e), e), message) << wire::encoding_name(e);
+    }
+    EXPECT_THROW(wire::decode("\xff\xff", Encoding::Cbor), json::exception);
+}
@@ -0,0 +1,76 @@
+/**
+    @file test_work_pool.cpp
+    Unit tests for parallel::WorkPool (src/utils/work_pool.cpp).
+
+    Every index of a batch runs exactly once whatever the worker count,
+    an inline pool keeps index order, exceptions reach the caller, and the
+    pool can be reused for many batches, including from several threads.
+*/
+
+#include "utils/work_pool.h"
+
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using parallel::WorkPool;
+
+TEST(WorkPoolTest, RunsEveryIndexOnce) {
+    for (size_t workers : {0u, 1u, 3u}) {
+        WorkPool pool(workers);
+        EXPECT_EQ(pool.concurrency(), workers + 1);
+        for (size_t count : {0u, 1u, 2u, 7u, 1000u}) {
+            std::vector<std::atomic<int>> runs(count);
+            pool.run(count, [&](size_t i) { runs[i]++; });
+            for (size_t i = 0; i < count; ++i) {
+                EXPECT_EQ(runs[i].load(), 1) << workers << " workers, index " << i;
+            }
+        }
+    }
+}
+
+TEST(WorkPoolTest, InlinePoolKeepsIndexOrder) {
+    WorkPool pool(0);
+    std::vector<size_t> seen;
+    pool.run(5, [&](size_t i) { seen.push_back(i); });
+    EXPECT_EQ(seen, (std::vector<size_t>{0, 1, 2, 3, 4}));
+}
+
+TEST(WorkPoolTest, RethrowsAfterFinishingTheBatch) {
+    WorkPool pool(2);
+    std::atomic<int> ran{0};
+    EXPECT_THROW(pool.run(50,
+                          [&](size_t i) {
+                              ran++;
+                              if (i == 10) {
+                                  throw std::runtime_error("task failed");
+                              }
+                          }),
+                 std::runtime_error);
+    EXPECT_EQ(ran.load(), 50);
+
+    // The pool is still usable afterwards
+    std::atomic<int> after{0};
+    pool.run(20, [&](size_t) { after++; });
+    EXPECT_EQ(after.load(), 20);
+}
+
+TEST(WorkPoolTest, ManyBatchesFromSeveralThreads) {
+    WorkPool pool(3);
+    std::atomic<long> total{0};
+    std::vector<std::thread> callers;
+    for (int t = 0; t < 3; ++t) {
+        callers.emplace_back([&] {
+            for (int batch = 0; batch < 200; ++batch) {
+                pool.run(16, [&](size_t i) { total += static_cast<long>(i); });
+            }
+        });
+    }
+    for (std::thread& caller : callers) {
+        caller.join();
+    }
+    EXPECT_EQ(total.load(), 3L * 200L * (15L * 16L / 2L));
+}